@@ -4,12 +4,16 @@
 //            -V<verification file> Output file: verification data for decided machines
 //            -I<input file>        Input file: list of machines to be analysed (default=all machines)
 //            -U<undecided file>    Output file: remaining undecided machines
+//            -G                    Write a compressed umf and a compact dvf
+//            -XI                   Write a dvf index along with the dvf (see ../DvfIndex.h)
 //            -X<test machine>      Machine to test
 //            -M<machine spec>      Compact machine code (ASCII spec) to test
 //            -L<machine limit>     Max no. of machines to test
+//            -R<start>:<end>       Machines <start> to <end>-1 of the input file or database
 //            -H<threads>           Number of threads to use
 //            -O                    Print trace output
-//            -S<depth limit>        Max search depth
+//            -S<depth limit>       Max search depth
+//            -E<initial depth>     Escalate search depth from <initial depth> up to <depth limit>
 //
 // The Backward Reasoning Decider starts from the HALT state and recursively generates 
 // all possible predecessor states. If it can determine that all possible states lie
@@ -20,25 +24,29 @@
 // In practice we don't need to detect the starting state, because all the machines
 // that we analyse are known to run for at least 12289 steps, and we never search that
 // deep.
+//
+// Depth escalation (-E): a machine that is decided at depth d is decided in exactly
+// the same way at any greater depth, but an undecided machine can take a long time
+// to reach the depth limit. So with -E<initial depth>, every machine is first searched
+// to the initial depth; the machines that reach the limit are then searched to twice
+// that depth, and so on up to the -S limit. Machines are processed in batches of
+// BATCH_SIZE, so the output files are identical to those of a single run at the -S limit.
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
 #include <time.h>
+#include <inttypes.h> // for PRIu64
 #include <string>
 #include <vector>
+#include <algorithm>
 
-#include "../TuringMachine.h"
+#include "BackwardReasoningDecider.h"
 #include "../Params.h"
 
-// This Decider can't offer much in the way of verification data. It just saves
-// Leftmost, Rightmost, MaxDepth, and nNodes. No verifier program has been written:
-#define VERIF_INFO_LENGTH 16
-
-// We need a special value to indicate that the contents of a cell on the tape
-// are so far undetermined:
-#define TAPE_UNSET 3
+// Number of machines to read into memory for depth escalation
+#define BATCH_SIZE 65536
 
 //
 // Command-line parameters
@@ -48,69 +56,30 @@ class CommandLineParams : public DeciderParams
   {
 public:
   uint32_t DepthLimit ; bool DepthLimitPresent = false ;
+  uint32_t InitialDepth ; bool InitialDepthPresent = false ;
+  std::vector<uint32_t> DepthSchedule ; // Depth limit for each round
   void Parse (int argc, char** argv) ;
   void PrintHelpAndExit [[noreturn]] (int status) ;
   } ;
 
 static CommandLineParams Params ;
 
-//
-// BackwardReasoning class
-//
-
-class BackwardReasoning : public TuringMachineSpec
+// Each undecided machine in the current batch carries the depth limit
+// for its next search:
+struct WorkItem
   {
-public:
-  BackwardReasoning (int MachineStates, int DepthLimit, int SpaceLimit)
-  : TuringMachineSpec (MachineStates)
-  , DepthLimit (DepthLimit)
-  , SpaceLimit (SpaceLimit)
-    {
-    // Allocate the tape workspace
-    Tape = new uint8_t[2 * SpaceLimit + 1] ;
-    Tape[0] = Tape[2 * SpaceLimit] = TAPE_SENTINEL ;
-    Tape += SpaceLimit ; // so Tape[0] is in the middle
-
-    // Reserve maximum possible lengths for the predecessor vectors,
-    // to avoid having to re-allocate them in the middle of the search (a
-    // mini-optimisation)
-    for (int i = 0 ; i <= MachineStates ; i++)
-      PredecessorTable[i].reserve (2 * MachineStates) ;
-    }
-
-  // Call Run to analyse a single machine
-  bool Run (const uint8_t* MachineSpec) ;
-
-  uint8_t* Tape ;
-
-  // Predecessor struct contains the parameters of a possible predecessor state
-  struct Predecessor : public Transition
-    {
-    uint8_t State ;
-    uint8_t Read ;
-    } ;
-
-  // Each state can be reached from a number of predecessor states:
-  std::vector<Predecessor> PredecessorTable[MAX_MACHINE_STATES + 1] ;
-
-  // The Configuration struct doesn't need to contain the tape contents,
-  // because we update the tape dynamically as we recurse
-  struct Configuration
-    {
-    uint8_t State ;
-    int16_t TapeHead ;
-    } ;
-
-  // Call Recurse with Depth = 0 to start the search
-  bool Recurse (uint32_t Depth, const Configuration& Config) ;
-
+  uint32_t Entry ; // Index into the batch
   uint32_t DepthLimit ;
-  uint32_t SpaceLimit ;
+  } ;
 
-  // Stats
-  int Leftmost, Rightmost ;
-  uint32_t MaxDepth ;
-  uint32_t nNodes ;
+// Statistics for each round of depth escalation
+struct RoundStats
+  {
+  uint64_t nTried = 0 ;
+  uint64_t nDecided = 0 ;
+  uint32_t MaxDecidingDepth = 0 ;
+  uint64_t MaxDecidingDepthMachine = 0 ;
+  clock_t Time = 0 ;
   } ;
 
 int main (int argc, char** argv)
@@ -122,150 +91,109 @@ int main (int argc, char** argv)
 
   TuringMachineReader Reader (&Params) ;
 
-  // Write dummy dvf header
-  Write32 (Params.fpVerify, 0) ;
+  // Write umf header and dummy dvf header
+  Reader.WriteUndecidedHeader (Params.fpUndecided) ;
+  Reader.WriteVerificationHeader (Params.fpVerify, 0) ;
 
   clock_t Timer = clock() ;
 
-  uint32_t nDecided = 0 ;
+  uint32_t nRounds = Params.DepthSchedule.size() ;
+  std::vector<RoundStats> Stats (nRounds) ;
+
+  uint32_t BatchSize = std::min (Reader.nMachines, (uint64_t)BATCH_SIZE) ;
+  uint64_t* MachineIndexList = new uint64_t[BatchSize] ;
+  uint8_t* MachineSpecList = new uint8_t[BatchSize * Reader.MachineSpecSize] ;
+  uint8_t* VerificationEntryList = new uint8_t[BatchSize * VERIF_ENTRY_LENGTH] ;
+  std::vector<WorkItem> Queue, NextQueue ;
+
+  uint64_t nDecided = 0 ;
+  uint64_t nCompleted = 0 ;
   int LastPercent = -1 ;
-  uint8_t MachineSpec[MAX_MACHINE_SPEC_SIZE] ;
-  uint8_t VerificationEntry[VERIF_ENTRY_LENGTH] ;
-  Save32 (VerificationEntry + 4, uint32_t (DeciderTag::BACKWARD_REASONING)) ;
-  Save32 (VerificationEntry + 8, VERIF_INFO_LENGTH) ;
 
-  BackwardReasoning Decider (Params.MachineStates, Params.DepthLimit, MAX_SPACE) ;
-  for (uint32_t Entry = 0 ; Entry < Reader.nMachines ; Entry++)
+  BackwardReasoning Decider (Params.MachineStates, MAX_SPACE) ;
+  while (nCompleted < Reader.nMachines)
     {
-    uint32_t MachineIndex = Reader.Next (MachineSpec) ;
-    if (Decider.Run (MachineSpec))
+    uint32_t nBatch = std::min (Reader.nMachines - nCompleted, (uint64_t)BatchSize) ;
+    Queue.clear() ;
+    for (uint32_t Entry = 0 ; Entry < nBatch ; Entry++)
       {
-      Save32 (VerificationEntry, MachineIndex) ;
-      Save32 (VerificationEntry + 12, Decider.Leftmost) ;
-      Save32 (VerificationEntry + 16, Decider.Rightmost) ;
-      Save32 (VerificationEntry + 20, Decider.MaxDepth) ;
-      Save32 (VerificationEntry + 24, Decider.nNodes) ;
-      if (Params.fpVerify && fwrite (VerificationEntry, VERIF_ENTRY_LENGTH, 1, Params.fpVerify) != 1)
-        printf ("Write error\n"), exit (1) ;
-      nDecided++ ;
+      MachineIndexList[Entry] = Reader.Next (MachineSpecList + Entry * Reader.MachineSpecSize) ;
+      Save32 (VerificationEntryList + Entry * VERIF_ENTRY_LENGTH + 4, uint32_t (DeciderTag::NONE)) ;
+      Queue.push_back ({ Entry, Params.DepthSchedule[0] }) ;
+      }
+
+    for (uint32_t Round = 0 ; Round < nRounds && !Queue.empty() ; Round++)
+      {
+      clock_t RoundTimer = clock() ;
+      NextQueue.clear() ;
+      for (const WorkItem& Item : Queue)
+        {
+        uint8_t* VerificationEntry = VerificationEntryList + Item.Entry * VERIF_ENTRY_LENGTH ;
+        Stats[Round].nTried++ ;
+        if (Decider.RunDecider (MachineIndexList[Item.Entry],
+          MachineSpecList + Item.Entry * Reader.MachineSpecSize, Item.DepthLimit, VerificationEntry))
+          {
+          Stats[Round].nDecided++ ;
+          if (Decider.MaxDepth > Stats[Round].MaxDecidingDepth)
+            {
+            Stats[Round].MaxDecidingDepth = Decider.MaxDepth ;
+            Stats[Round].MaxDecidingDepthMachine = MachineIndexList[Item.Entry] ;
+            }
+          }
+        else if (Round + 1 < nRounds)
+          NextQueue.push_back ({ Item.Entry, Params.DepthSchedule[Round + 1] }) ;
+        }
+      std::swap (Queue, NextQueue) ;
+      Stats[Round].Time += clock() - RoundTimer ;
       }
-    else Write32 (Params.fpUndecided, MachineIndex) ;
 
-    int Percent = ((Entry + 1) * 100LL) / Reader.nMachines ;
+    // Write the output files in input order
+    for (uint32_t Entry = 0 ; Entry < nBatch ; Entry++)
+      {
+      const uint8_t* VerificationEntry = VerificationEntryList + Entry * VERIF_ENTRY_LENGTH ;
+      if (Load32 (VerificationEntry + 4))
+        {
+        Reader.WriteVerificationEntry (Params.fpVerify, MachineIndexList[Entry],
+          VerificationEntry, VERIF_ENTRY_LENGTH) ;
+        nDecided++ ;
+        }
+      else Reader.WriteUndecided (Params.fpUndecided, MachineIndexList[Entry]) ;
+      }
+    nCompleted += nBatch ;
+
+    int Percent = (nCompleted * 100LL) / Reader.nMachines ;
     if (Percent != LastPercent)
       {
       LastPercent = Percent ;
-      printf ("\r%d%% %d %d", Percent, Entry + 1, nDecided) ;
+      printf ("\r%d%% %" PRIu64 " %" PRIu64, Percent, nCompleted, nDecided) ;
       fflush (stdout) ;
       }
     }
   printf ("\n") ;
 
-  if (Params.fpUndecided) fclose (Params.fpUndecided) ;
+  if (Params.fpUndecided) Reader.CloseUndecided (Params.fpUndecided) ;
 
-  if (Params.fpVerify)
-    {
-    // Write the verification file header
-    if (fseek (Params.fpVerify, 0 , SEEK_SET))
-      printf ("\nfseek failed\n"), exit (1) ;
-    Write32 (Params.fpVerify, nDecided) ;
-    fclose (Params.fpVerify) ;
-    }
+  // Write the verification file header, and finish off the dvf index
+  if (Params.fpVerify) Reader.CloseVerification (Params.fpVerify, nDecided) ;
   if (Params.fpInput) fclose (Params.fpInput) ;
 
   Timer = clock() - Timer ;
 
-  printf ("\nDecided %d out of %d\n", nDecided, Reader.nMachines) ;
+  printf ("\nDecided %" PRIu64 " out of %" PRIu64 "\n", nDecided, Reader.nMachines) ;
   printf ("Elapsed time %.3f\n", (double)Timer / CLOCKS_PER_SEC) ;
-  }
-
-bool BackwardReasoning::Run (const uint8_t* MachineSpec)
-  {
-  for (uint32_t i = 0 ; i <= MachineStates ; i++) PredecessorTable[i].clear() ;
 
-  // Built the backward transition table from the MachineSpec
-  for (uint8_t State = 1 ; State <= MachineStates ; State++)
+  if (nRounds > 1)
     {
-    for (uint8_t Cell = 0 ; Cell <= 1 ; Cell++)
+    printf ("\nDecided machines by depth limit:\n") ;
+    for (uint32_t Round = 0 ; Round < nRounds ; Round++)
       {
-      Predecessor T ;
-      UnpackSpec (&T, MachineSpec) ;
-      T.State = State ;
-      T.Read = Cell ;
-
-      PredecessorTable[T.Next].push_back (T) ;
-
-      MachineSpec += 3 ;
-      }
-    }
-
-  // Start in state 0 with unspecified tape
-  memset (Tape - SpaceLimit + 1, TAPE_UNSET, 2 * SpaceLimit - 1) ;
-  Configuration StartConfig ;
-  StartConfig.State = 0 ;
-  StartConfig.TapeHead = 0 ;
-
-  MaxDepth = nNodes = 0 ;
-  Leftmost = Rightmost = 0 ;
-
-  return Recurse (0, StartConfig) ;
-  }
-
-bool BackwardReasoning::Recurse (uint32_t Depth, const Configuration& Config)
-  {
-  if (Depth == DepthLimit) return false ; // Search too deep, no decision possible
-
-  nNodes++ ;
-  if (Depth > MaxDepth) MaxDepth = Depth ;
-
-  Configuration PrevConfig ;
-  for (const auto& T : PredecessorTable[Config.State])
-    {
-    // Update the tape head
-    if (T.Move)
-      {
-      PrevConfig.TapeHead = Config.TapeHead + 1 ;
-      if (PrevConfig.TapeHead > Rightmost) Rightmost = PrevConfig.TapeHead ;
-      }
-    else
-      {
-      PrevConfig.TapeHead = Config.TapeHead - 1 ;
-      if (PrevConfig.TapeHead < Leftmost) Leftmost = PrevConfig.TapeHead ;
-      }
-
-    uint8_t Cell = Tape[PrevConfig.TapeHead] ;
-    switch (Cell)
-      {
-      case TAPE_SENTINEL: // Tape bounds exceeded (if this happens, it's a bug)
-        printf ("Tape bounds exceeded!\n") ;
-        exit (0) ;
-
-      case TAPE_UNSET: // New tape cell reached, so just write the expected value
-        Tape[PrevConfig.TapeHead] = T.Read ;
-        break ;
-
-      default:
-        if (Tape[PrevConfig.TapeHead] != T.Write)
-          {
-          // Clash with required tape cell value, so this is an impossible path
-          Tape[PrevConfig.TapeHead] = Cell ; // Restore the previous value
-          continue ;
-          }
-
-        // Update the tape with the value that it had to contain to reach this state
-        Tape[PrevConfig.TapeHead] = T.Read ;
-        break ;
+      const RoundStats& S = Stats[Round] ;
+      printf ("%d: %" PRIu64 " out of %" PRIu64 ", time %.3f", Params.DepthSchedule[Round],
+        S.nDecided, S.nTried, (double)S.Time / CLOCKS_PER_SEC) ;
+      if (S.nDecided) printf (", max depth %d (#%" PRIu64 ")", S.MaxDecidingDepth, S.MaxDecidingDepthMachine) ;
+      printf ("\n") ;
       }
-
-    // Perform a backwards step and search deeper
-    PrevConfig.State = T.State ;
-    if (!Recurse (Depth + 1, PrevConfig)) return false ;
-    Tape[PrevConfig.TapeHead] = Cell ;
     }
-
-  // No search returned false, i.e. all searches terminated at a finite depth.
-  // So we can't reach this state from the starting position:
-  return true ;
   }
 
 void CommandLineParams::Parse (int argc, char** argv)
@@ -283,6 +211,11 @@ void CommandLineParams::Parse (int argc, char** argv)
         DepthLimitPresent = true ;
         break ;
 
+      case 'E':
+        InitialDepth = atoi (&argv[0][2]) ;
+        InitialDepthPresent = true ;
+        break ;
+
       default:
         printf ("Invalid parameter \"%s\"\n", argv[0]) ;
         PrintHelpAndExit (1) ;
@@ -290,6 +223,15 @@ void CommandLineParams::Parse (int argc, char** argv)
     }
 
   if (!DepthLimitPresent) printf ("Depth limit not specified\n"), PrintHelpAndExit (1) ;
+
+  // Build the depth escalation schedule: InitialDepth, 2*InitialDepth, ..., DepthLimit
+  if (InitialDepthPresent)
+    {
+    if (InitialDepth == 0) printf ("Initial depth must be positive\n"), exit (1) ;
+    for (uint32_t Depth = InitialDepth ; Depth < DepthLimit ; Depth *= 2)
+      DepthSchedule.push_back (Depth) ;
+    }
+  DepthSchedule.push_back (DepthLimit) ;
   }
 
 void CommandLineParams::PrintHelpAndExit (int status)
@@ -298,6 +240,7 @@ void CommandLineParams::PrintHelpAndExit (int status)
   DeciderParams::PrintHelp() ;
   printf (R"*RAW*(
            -S<depth limit>       Max search depth
+           -E<initial depth>     Escalate search depth from <initial depth> up to <depth limit>
 )*RAW*") ;
   exit (status) ;
   }
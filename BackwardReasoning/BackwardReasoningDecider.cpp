@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "BackwardReasoningDecider.h"
+
+// We need a special value to indicate that the contents of a cell on the tape
+// are so far undetermined:
+#define TAPE_UNSET 3
+
+bool BackwardReasoning::RunDecider (uint32_t MachineIndex, const uint8_t* MachineSpec,
+  uint32_t DepthLimit, uint8_t* VerificationEntry)
+  {
+  if (!Run (MachineSpec, DepthLimit))
+    {
+    Save32 (VerificationEntry + 4, uint32_t (DeciderTag::NONE)) ;
+    return false ;
+    }
+  Save32 (VerificationEntry, MachineIndex) ;
+  Save32 (VerificationEntry + 4, uint32_t (DeciderTag::BACKWARD_REASONING)) ;
+  Save32 (VerificationEntry + 8, VERIF_INFO_LENGTH) ;
+  Save32 (VerificationEntry + 12, Leftmost) ;
+  Save32 (VerificationEntry + 16, Rightmost) ;
+  Save32 (VerificationEntry + 20, MaxDepth) ;
+  Save32 (VerificationEntry + 24, nNodes) ;
+  return true ;
+  }
+
+bool BackwardReasoning::Run (const uint8_t* MachineSpec, uint32_t DepthLimit)
+  {
+  this -> DepthLimit = DepthLimit ;
+
+  for (uint32_t i = 0 ; i <= MachineStates ; i++) PredecessorTable[i].clear() ;
+
+  // Built the backward transition table from the MachineSpec
+  for (uint8_t State = 1 ; State <= MachineStates ; State++)
+    {
+    for (uint8_t Cell = 0 ; Cell <= 1 ; Cell++)
+      {
+      Predecessor T ;
+      UnpackSpec (&T, MachineSpec) ;
+      T.State = State ;
+      T.Read = Cell ;
+
+      PredecessorTable[T.Next].push_back (T) ;
+
+      MachineSpec += 3 ;
+      }
+    }
+
+  // Start in state 0 with unspecified tape
+  memset (Tape - SpaceLimit + 1, TAPE_UNSET, 2 * SpaceLimit - 1) ;
+  Configuration StartConfig ;
+  StartConfig.State = 0 ;
+  StartConfig.TapeHead = 0 ;
+
+  MaxDepth = nNodes = 0 ;
+  Leftmost = Rightmost = 0 ;
+
+  return Recurse (0, StartConfig) ;
+  }
+
+bool BackwardReasoning::Recurse (uint32_t Depth, const Configuration& Config)
+  {
+  if (Depth == DepthLimit) return false ; // Search too deep, no decision possible
+
+  nNodes++ ;
+  if (Depth > MaxDepth) MaxDepth = Depth ;
+
+  Configuration PrevConfig ;
+  for (const auto& T : PredecessorTable[Config.State])
+    {
+    // Update the tape head
+    if (T.Move)
+      {
+      PrevConfig.TapeHead = Config.TapeHead + 1 ;
+      if (PrevConfig.TapeHead > Rightmost) Rightmost = PrevConfig.TapeHead ;
+      }
+    else
+      {
+      PrevConfig.TapeHead = Config.TapeHead - 1 ;
+      if (PrevConfig.TapeHead < Leftmost) Leftmost = PrevConfig.TapeHead ;
+      }
+
+    uint8_t Cell = Tape[PrevConfig.TapeHead] ;
+    switch (Cell)
+      {
+      case TAPE_SENTINEL: // Tape bounds exceeded (if this happens, it's a bug)
+        printf ("Tape bounds exceeded!\n") ;
+        exit (0) ;
+
+      case TAPE_UNSET: // New tape cell reached, so just write the expected value
+        Tape[PrevConfig.TapeHead] = T.Read ;
+        break ;
+
+      default:
+        if (Tape[PrevConfig.TapeHead] != T.Write)
+          {
+          // Clash with required tape cell value, so this is an impossible path
+          Tape[PrevConfig.TapeHead] = Cell ; // Restore the previous value
+          continue ;
+          }
+
+        // Update the tape with the value that it had to contain to reach this state
+        Tape[PrevConfig.TapeHead] = T.Read ;
+        break ;
+      }
+
+    // Perform a backwards step and search deeper
+    PrevConfig.State = T.State ;
+    if (!Recurse (Depth + 1, PrevConfig)) return false ;
+    Tape[PrevConfig.TapeHead] = Cell ;
+    }
+
+  // No search returned false, i.e. all searches terminated at a finite depth.
+  // So we can't reach this state from the starting position:
+  return true ;
+  }
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+
+#include "../TuringMachine.h"
+
+// This Decider can't offer much in the way of verification data. It just saves
+// Leftmost, Rightmost, MaxDepth, and nNodes. No verifier program has been written:
+#define VERIF_INFO_LENGTH 16
+
+class BackwardReasoning : public TuringMachineSpec
+  {
+public:
+  BackwardReasoning (int MachineStates, int SpaceLimit)
+  : TuringMachineSpec (MachineStates)
+  , SpaceLimit (SpaceLimit)
+    {
+    // Allocate the tape workspace
+    Tape = new uint8_t[2 * SpaceLimit + 1] ;
+    Tape[0] = Tape[2 * SpaceLimit] = TAPE_SENTINEL ;
+    Tape += SpaceLimit ; // so Tape[0] is in the middle
+
+    // Reserve maximum possible lengths for the predecessor vectors,
+    // to avoid having to re-allocate them in the middle of the search (a
+    // mini-optimisation)
+    for (int i = 0 ; i <= MachineStates ; i++)
+      PredecessorTable[i].reserve (2 * MachineStates) ;
+    }
+
+  // Call Run to analyse a single machine
+  bool Run (const uint8_t* MachineSpec, uint32_t DepthLimit) ;
+
+  // Call RunDecider to analyse a single machine and fill in its VerificationEntry
+  // (if the machine is undecided, the DeciderType is NONE)
+  bool RunDecider (uint32_t MachineIndex, const uint8_t* MachineSpec,
+    uint32_t DepthLimit, uint8_t* VerificationEntry) ;
+
+  uint8_t* Tape ;
+
+  // Predecessor struct contains the parameters of a possible predecessor state
+  struct Predecessor : public Transition
+    {
+    uint8_t State ;
+    uint8_t Read ;
+    } ;
+
+  // Each state can be reached from a number of predecessor states:
+  std::vector<Predecessor> PredecessorTable[MAX_MACHINE_STATES + 1] ;
+
+  // The Configuration struct doesn't need to contain the tape contents,
+  // because we update the tape dynamically as we recurse
+  struct Configuration
+    {
+    uint8_t State ;
+    int16_t TapeHead ;
+    } ;
+
+  // Call Recurse with Depth = 0 to start the search
+  bool Recurse (uint32_t Depth, const Configuration& Config) ;
+
+  uint32_t DepthLimit ;
+  uint32_t SpaceLimit ;
+
+  // Stats
+  int Leftmost, Rightmost ;
+  uint32_t MaxDepth ;
+  uint32_t nNodes ;
+  } ;
@@ -1 +1 @@
-g++ -std=c++20 -Wall -O3 -oBackwardReasoning BackwardReasoning.cpp ../Params.obj ../Reader.obj ../TuringMachine.obj
\ No newline at end of file
+g++ -std=c++20 -Wall -O3 -oBackwardReasoning BackwardReasoning.cpp BackwardReasoningDecider.cpp ../Params.obj ../Reader.obj ../CompressedUmf.obj ../Enumerator.obj ../DvfIndex.obj ../MappedFile.obj ../CompactDvf.obj ../TuringMachine.obj
\ No newline at end of file
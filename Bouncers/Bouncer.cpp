@@ -30,7 +30,7 @@ void Bouncer::CheckTape (const TuringMachine* TM, const TapeDescriptor& TD)
   if (TP.WallOffset + TD.TapeHeadOffset != TM -> TapeHead) TM_ERROR() ;
   }
 
-void Bouncer::CheckTransition (const SegmentTransition& Tr) const
+void Bouncer::CheckTransition (const TransitionView& Tr)
   {
   // Initial and Final tapes must be the same size
   if (Tr.Initial.Tape.size() != Tr.Final.Tape.size()) TM_ERROR() ;
@@ -53,7 +53,8 @@ void Bouncer::CheckTransition (const SegmentTransition& Tr) const
 
   // Check that executing nSteps transforms Initial to Final without
   // exceeding the tape boundaries
-  auto Tape = Tr.Initial.Tape ;
+  ustring& Tape = TransitionTape ;
+  Tape = Tr.Initial.Tape ;
   uint8_t State = Tr.Initial.State ;
   int TapeHead = Tr.Initial.TapeHead ;
   for (uint32_t i = 0 ; i < Tr.nSteps ; i++)
@@ -76,8 +77,8 @@ void Bouncer::CheckTransition (const SegmentTransition& Tr) const
   if (Tape != Tr.Final.Tape) TM_ERROR() ;
   }
 
-// void Bouncer::CheckFollowOn (const Segment& Seg1, const Segment& Seg2)
-// bool Bouncer::TestFollowOn (const Segment& Seg1, const Segment& Seg2)
+// void Bouncer::CheckFollowOn (const SegmentView& Seg1, const SegmentView& Seg2)
+// bool Bouncer::TestFollowOn (const SegmentView& Seg1, const SegmentView& Seg2)
 //
 // Check that Seg2 follows on from Seg1:
 //  - Seg2.State = Seg1.State;
@@ -86,12 +87,12 @@ void Bouncer::CheckTransition (const SegmentTransition& Tr) const
 //
 // If the checks fail, CheckFollowOn aborts with TM_ERROR but TestFollowOn just returns false.
 
-void Bouncer::CheckFollowOn (const Segment& Seg1, const Segment& Seg2)
+void Bouncer::CheckFollowOn (const SegmentView& Seg1, const SegmentView& Seg2)
   {
   if (!TestFollowOn (Seg1, Seg2)) TM_ERROR() ;
   }
 
-bool Bouncer::TestFollowOn (const Segment& Seg1, const Segment& Seg2)
+bool Bouncer::TestFollowOn (const SegmentView& Seg1, const SegmentView& Seg2)
   {
   if (Seg1.State != Seg2.State) return false ;
 
@@ -120,11 +120,37 @@ public:
     Segment Final ;
     } ;
 
+  // SegmentView and TransitionView are the same, but they don't own their tapes:
+  // the Verifier reads them straight from the mapped verification file, and the
+  // Decider passes its Segments and SegmentTransitions to the verification
+  // functions as views
+  struct SegmentView
+    {
+    SegmentView() { }
+    SegmentView (const Segment& Seg)
+    : Tape (Seg.Tape), State (Seg.State), TapeHead (Seg.TapeHead) { }
+
+    ustring_view Tape ;
+    uint8_t State ;
+    int TapeHead ;
+    } ;
+
+  struct TransitionView
+    {
+    TransitionView() { }
+    TransitionView (const SegmentTransition& Tr)
+    : nSteps (Tr.nSteps), Initial (Tr.Initial), Final (Tr.Final) { }
+
+    uint32_t nSteps ;
+    SegmentView Initial ;
+    SegmentView Final ;
+    } ;
+
   // Verification functions
-  void CheckFollowOn (const Segment& Seg1, const Segment& Seg2) ;
-  bool TestFollowOn (const Segment& Seg1, const Segment& Seg2) ;
+  void CheckFollowOn (const SegmentView& Seg1, const SegmentView& Seg2) ;
+  bool TestFollowOn (const SegmentView& Seg1, const SegmentView& Seg2) ;
   void CheckTape (const TuringMachine* TM, const TapeDescriptor& TD) ;
-  void CheckTransition (const SegmentTransition& Tr) const ;
+  void CheckTransition (const TransitionView& Tr) ;
   void ExpandTapeLeftward (TapeDescriptor& TD, int Amount) ;
   void ExpandTapeRightward (TapeDescriptor& TD, int Amount) ;
 
@@ -132,6 +158,8 @@ public:
 
   bool TraceOutput = false ;
 
+  ustring TransitionTape ; // CheckTransition work area
+
   // Statistics
   uint32_t nUnilateral ;
   uint32_t nBilateral ;
@@ -6,6 +6,8 @@ static uint32_t GCD (uint32_t x, uint32_t y) ;
 bool BouncerDecider::RunDecider (const uint8_t* MachineSpec, uint8_t* VerificationEntry)
   {
   Initialise (SeedDatabaseIndex, MachineSpec) ;
+  if (StartSnapshot && StartSnapshot -> StepCount && Resume (*StartSnapshot)) nResumed++ ;
+  uint64_t StepLimit = StepCount + TimeLimit ;
   if (VerificationEntry)
     Save32 (VerificationEntry + 8, 0) ; // InfoLength = 0 for now
 
@@ -14,13 +16,15 @@ bool BouncerDecider::RunDecider (const uint8_t* MachineSpec, uint8_t* Verificati
   memset (LatestLeftRecord, 0, sizeof (LatestLeftRecord)) ;
   memset (LatestRightRecord, 0, sizeof (LatestRightRecord)) ;
 
+  // Set Type first, so that a machine that stops early doesn't inherit the
+  // Type of the previous machine (and come out as a Probable Bell)
+  Type = BouncerType::Unknown ;
+
   // Give the machine time to settle down
   for (uint32_t i = 0 ; i < 1000 ; i++)
     if (Step() != StepResult::OK) return false ;
 
-  Type = BouncerType::Unknown ;
-
-  while (StepCount < TimeLimit)
+  while (StepCount < StepLimit)
     {
     if (RecordBroken == 1)
       {
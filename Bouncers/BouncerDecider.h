@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Bouncer.h"
+#include "../ResultCache.h"
+#include "../CostHints.h"
 
 class BouncerDecider : public Bouncer
   {
@@ -22,7 +24,7 @@ public:
     ConfigWorkspace = new Config[ConfigWorkspaceSize] ;
     }
 
-  void ThreadFunction (int nMachines, const uint32_t* MachineIndexList,
+  void ThreadFunction (int nMachines, const uint64_t* MachineIndexList,
     const uint8_t* MachineSpecList, uint32_t MachineSpecSize, uint8_t* VerificationEntryList, uint32_t VerifLength) ;
 
   bool RunDecider (const uint8_t* MachineSpec, uint8_t* VerificationEntry) ;
@@ -40,6 +42,15 @@ public:
   uint32_t TimeLimit ;
   uint32_t RecordLimit ;
 
+  ResultCache* Cache = nullptr ; // -C
+  MachineCost* CostList = nullptr ; // -Y: ThreadFunction records the cost of each machine here
+  const MachineSnapshot** SnapshotList = nullptr ; // -J: ThreadFunction resumes each machine from here
+
+  // If StartSnapshot is set, RunDecider resumes the machine from it (if it fits in
+  // SpaceLimit), and the time limit counts from there
+  const MachineSnapshot* StartSnapshot = nullptr ;
+  uint32_t nResumed = 0 ;
+
   struct Config
     {
     int TapeHead ;
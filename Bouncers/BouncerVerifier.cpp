@@ -1,34 +1,31 @@
 #include "BouncerVerifier.h"
 
-void BouncerVerifier::Verify (FILE* fp)
+void BouncerVerifier::Verify (ByteReader Info)
   {
-  int InfoLength = Read32 (fp) ;
-  long StartPos = ftell (fp) ;
-
   // Check bouncer type
-  Type = (BouncerType)Read8u (fp) ;
+  Type = (BouncerType)Info.Read8u() ;
   if ((uint32_t)Type < (uint32_t)BouncerType::Unilateral ||
     (uint32_t)Type > (uint32_t)BouncerType::Translated) VERIFY_ERROR() ;
 
-  nPartitions = Read8u (fp) ;
+  nPartitions = Info.Read8u() ;
   if (nPartitions > MAX_PARTITIONS) VERIFY_ERROR() ;
 
-  nRuns = Read16u (fp) ;
+  nRuns = Info.Read16u() ;
   if (nRuns > MAX_RUNS) VERIFY_ERROR() ;
 
   // Read initial stats
-  uint32_t InitialSteps = Read32 (fp) ;
-  int InitialLeftmost = Read32 (fp) ;
-  int InitialRightmost = Read32 (fp) ;
+  uint32_t InitialSteps = Info.Read32() ;
+  int InitialLeftmost = Info.Read32() ;
+  int InitialRightmost = Info.Read32() ;
 
   // Read final stats
-  uint32_t FinalSteps = Read32 (fp) ;
-  FinalLeftmost = Read32 (fp) ;
-  FinalRightmost = Read32 (fp) ;
+  uint32_t FinalSteps = Info.Read32() ;
+  FinalLeftmost = Info.Read32() ;
+  FinalRightmost = Info.Read32() ;
 
   // Read the RepeaterCount array
   for (uint32_t i = 0 ; i < nPartitions ; i++)
-    RepeaterCount[i] = Read16u (fp) ;
+    RepeaterCount[i] = Info.Read16u() ;
 
   // Run machine up to the start of the Cycle, and check the initial stats
   while (StepCount < InitialSteps)
@@ -38,17 +35,17 @@ void BouncerVerifier::Verify (FILE* fp)
 
   // Read the initial TapeDescriptor and check that it describes the
   // initial machine configuration
-  ReadTapeDescriptor (fp, InitialTape) ;
+  ReadTapeDescriptor (Info, InitialTape) ;
   CheckTape (this, InitialTape) ;
 
   RunDescriptor RD ;
-  Segment PreviousSeg ;
-  Segment FirstSeg ;
-  TapeDescriptor CurrentTape = InitialTape ;
+  SegmentView PreviousSeg ;
+  SegmentView FirstSeg ;
+  CurrentTape = InitialTape ;
   for (uint32_t i = 0 ; i < nRuns ; i++)
     {
     // Read the next RunDescriptor
-    ReadRunDescriptor (fp, RD) ;
+    ReadRunDescriptor (Info, RD) ;
 
     // Check that each SegmentTransition is compatible with its predecessor and follower.
     // This includes checking that a RepeaterTransition is compatible with itself:
@@ -73,7 +70,7 @@ void BouncerVerifier::Verify (FILE* fp)
       if (CurrentTape.TapeHeadWall != 0 && CurrentTape.TapeHeadWall != nPartitions) VERIFY_ERROR() ;
 
       // The final wall might require adjustment to the repeater boundaries
-      uint32_t FinalAdjustment = Read16u (fp) ;
+      uint32_t FinalAdjustment = Info.Read16u() ;
       while (FinalAdjustment--)
         {
         if (CurrentTape.TapeHeadWall == 0)
@@ -118,8 +115,7 @@ void BouncerVerifier::Verify (FILE* fp)
     VERIFY_ERROR() ;
 
   // Check that CurrentTape is equivalent to the final tape from the verification file
-  TapeDescriptor FinalTape (this) ;
-  ReadTapeDescriptor (fp, FinalTape) ;
+  ReadTapeDescriptor (Info, FinalTape) ;
   CheckTapesEquivalent (FinalTape, CurrentTape) ;
 
   // Augmenting all the walls in the InitialTape by appending a single copy
@@ -149,14 +145,14 @@ void BouncerVerifier::Verify (FILE* fp)
   CheckTape (this, FinalTape) ;
 
   // Check that the InfoLength field was correct
-  if (ftell (fp) != StartPos + InfoLength) VERIFY_ERROR() ;
+  if (!Info.AtEnd()) VERIFY_ERROR() ;
   }
 
-// void BouncerVerifier::CheckWallTransition (TapeDescriptor& TD, const SegmentTransition& Tr)
+// void BouncerVerifier::CheckWallTransition (TapeDescriptor& TD, const TransitionView& Tr, bool Final)
 //
 // Check that Tr.Initial matches TD, and update TD to match Tr.Final
 
-void BouncerVerifier::CheckWallTransition (TapeDescriptor& TD, const SegmentTransition& Tr, bool Final)
+void BouncerVerifier::CheckWallTransition (TapeDescriptor& TD, const TransitionView& Tr, bool Final)
   {
   // Check that Tr.Initial matches TD
   if (TD.State != Tr.Initial.State) TM_ERROR() ;
@@ -174,12 +170,12 @@ void BouncerVerifier::CheckWallTransition (TapeDescriptor& TD, const SegmentTran
   }
 
 // void BouncerVerifier::CheckRepeaterTransition (uint32_t Partition,
-//   TapeDescriptor& TD, const SegmentTransition& Tr)
+//   TapeDescriptor& TD, const TransitionView& Tr)
 //
 // Check that Tr.Initial matches TD, and update TD to match Tr.Final
 
 void BouncerVerifier::CheckRepeaterTransition (uint32_t Partition,
-  TapeDescriptor& TD, const SegmentTransition& Tr)
+  TapeDescriptor& TD, const TransitionView& Tr)
   {
   if (TD.State != Tr.Initial.State) TM_ERROR() ;
 
@@ -263,57 +259,55 @@ void BouncerVerifier::CheckRepeaterTransition (uint32_t Partition,
   else TM_ERROR() ; // Partition is invalid
   }
 
-void BouncerVerifier::ReadRunDescriptor (FILE* fp, RunDescriptor& RD)
+void BouncerVerifier::ReadRunDescriptor (ByteReader& Info, RunDescriptor& RD)
   {
-  RD.Partition = Read8u (fp) ;
-  ReadTransition (fp, RD.RepeaterTransition) ;
-  ReadTransition (fp, RD.WallTransition) ;
+  RD.Partition = Info.Read8u() ;
+  ReadTransition (Info, RD.RepeaterTransition) ;
+  ReadTransition (Info, RD.WallTransition) ;
   }
 
-void BouncerVerifier::ReadTransition (FILE* fp, SegmentTransition& Tr)
+void BouncerVerifier::ReadTransition (ByteReader& Info, TransitionView& Tr)
   {
-  Tr.nSteps = Read16u (fp) ;
-  ReadSegment (fp, Tr.Initial) ;
-  ReadSegment (fp, Tr.Final) ;
+  Tr.nSteps = Info.Read16u() ;
+  ReadSegment (Info, Tr.Initial) ;
+  ReadSegment (Info, Tr.Final) ;
   CheckTransition (Tr) ;
   }
 
-void BouncerVerifier::ReadSegment (FILE* fp, Segment& Seg)
+void BouncerVerifier::ReadSegment (ByteReader& Info, SegmentView& Seg)
   {
-  Seg.State = Read8u (fp) ;
+  Seg.State = Info.Read8u() ;
   if (Seg.State < 1 || Seg.State > MachineStates) VERIFY_ERROR() ;
-  Seg.TapeHead = Read16s (fp) ;
-  ReadByteArray (fp, Seg.Tape) ;
+  Seg.TapeHead = Info.Read16s() ;
+  Seg.Tape = ReadByteArray (Info) ;
   }
 
-void BouncerVerifier::ReadTapeDescriptor (FILE* fp, TapeDescriptor& TD)
+void BouncerVerifier::ReadTapeDescriptor (ByteReader& Info, TapeDescriptor& TD)
   {
   memcpy (TD.RepeaterCount, RepeaterCount, nPartitions * sizeof (uint32_t)) ;
 
   TD.Leftmost = FinalLeftmost ;
   TD.Rightmost = FinalRightmost ;
-  TD.State = Read8u (fp) ;
+  TD.State = Info.Read8u() ;
   if (TD.State < 1 || TD.State > MachineStates) VERIFY_ERROR() ;
-  TD.TapeHeadWall = Read8u (fp) ;
-  TD.TapeHeadOffset = Read16s (fp) ;
+  TD.TapeHeadWall = Info.Read8u() ;
+  TD.TapeHeadOffset = Info.Read16s() ;
   for (uint32_t i = 0 ; i <= nPartitions ; i++)
-    ReadByteArray (fp, TD.Wall[i]) ;
+    TD.Wall[i] = ReadByteArray (Info) ;
   for (uint32_t i = 0 ; i < nPartitions ; i++)
-    ReadByteArray (fp, TD.Repeater[i]) ;
+    TD.Repeater[i] = ReadByteArray (Info) ;
   }
 
-void BouncerVerifier::ReadByteArray (FILE* fp, ustring& Data)
+ustring_view BouncerVerifier::ReadByteArray (ByteReader& Info)
   {
-  uint32_t Len = Read16u (fp) ;
-  Data.clear() ;
-  Data.resize (Len) ;
-  Read (fp, &Data[0], Len) ;
+  uint32_t Len = Info.Read16u() ;
+  return Info.Bytes (Len) ;
   }
 
-void BouncerVerifier::VerifyHalter (FILE* fp)
+void BouncerVerifier::VerifyHalter (ByteReader Info)
   {
-  if (Read32 (fp) != 4) VERIFY_ERROR() ; // InfoLength
-  uint32_t nSteps = Read32 (fp) ;
+  if (Info.Remaining() != 4) VERIFY_ERROR() ; // InfoLength
+  uint32_t nSteps = Info.Read32() ;
   while (--nSteps) if (Step() != StepResult::OK) VERIFY_ERROR() ;
   if (Step() != StepResult::HALT) VERIFY_ERROR() ;
   }
@@ -2,40 +2,51 @@
 
 #include "Bouncer.h"
 
+#include <inttypes.h> // for PRIX64
+
 #define VERIFY_ERROR() \
-  printf ("\n#%d: Error at line %d in %s (fpos 0x%lX)\n", \
-  SeedDatabaseIndex, __LINE__, __FUNCTION__, ftell (fp)), exit (1)
+  printf ("\n#%d: Error at line %d in %s (fpos 0x%" PRIX64 ")\n", \
+  SeedDatabaseIndex, __LINE__, __FUNCTION__, Info.Offset()), exit (1)
+
+// The Verifier reads the VerificationInfo straight from the mapped verification
+// file (see ../MappedFile.h): the Segments in each RunDescriptor are views of the
+// file, and the TapeDescriptors, which it updates as it goes, are copied into
+// members whose buffers are re-used from one machine to the next
 
 class BouncerVerifier : public Bouncer
   {
 public:
   BouncerVerifier (uint32_t MachineStates, uint32_t SpaceLimit)
   : Bouncer (MachineStates, SpaceLimit, false)
+  , CurrentTape (this)
+  , FinalTape (this)
     {
     }
 
   struct RunDescriptor
     {
     uint32_t Partition ;
-    SegmentTransition RepeaterTransition ;
-    SegmentTransition WallTransition ;
+    TransitionView RepeaterTransition ;
+    TransitionView WallTransition ;
     } ;
 
-  void Verify (FILE* fp) ;
-  void VerifyHalter (FILE* fp) ;
+  void Verify (ByteReader Info) ;
+  void VerifyHalter (ByteReader Info) ;
 
-  void ReadRunDescriptor (FILE* fp, RunDescriptor& RD) ;
-  void ReadTransition (FILE* fp, SegmentTransition& Tr) ;
-  void ReadSegment (FILE* fp, Segment& Seg) ;
-  void ReadByteArray (FILE* fp, ustring& Data) ;
-  void ReadTapeDescriptor (FILE* fp, TapeDescriptor& TD) ;
+  void ReadRunDescriptor (ByteReader& Info, RunDescriptor& RD) ;
+  void ReadTransition (ByteReader& Info, TransitionView& Tr) ;
+  void ReadSegment (ByteReader& Info, SegmentView& Seg) ;
+  ustring_view ReadByteArray (ByteReader& Info) ;
+  void ReadTapeDescriptor (ByteReader& Info, TapeDescriptor& TD) ;
 
-  void CheckWallTransition (TapeDescriptor& TD, const SegmentTransition& Tr, bool Final) ;
+  void CheckWallTransition (TapeDescriptor& TD, const TransitionView& Tr, bool Final) ;
   void CheckRepeaterTransition (uint32_t Partition,TapeDescriptor& TD,
-    const SegmentTransition& Tr) ;
+    const TransitionView& Tr) ;
 
   virtual bool Verifying() const override { return true ; }
 
   uint32_t RepeaterCount[MAX_PARTITIONS] ;
   int FinalLeftmost, FinalRightmost ;
+  TapeDescriptor CurrentTape ;
+  TapeDescriptor FinalTape ;
   } ;
@@ -4,25 +4,57 @@
 //            -V<verification file> Output file: verification data for decided machines
 //            -I<input file>        Input file: list of machines to be analysed (default=all machines)
 //            -U<undecided file>    Output file: remaining undecided machines
+//            -G                    Write a compressed umf and a compact dvf
+//            -XI                   Write a dvf index along with the dvf (see ../DvfIndex.h)
 //            -X<test machine>      Machine to test
 //            -M<machine spec>      Compact machine code (ASCII spec) to test
 //            -L<machine limit>     Max no. of machines to test
+//            -R<start>:<end>       Machines <start> to <end>-1 of the input file or database
 //            -H<threads>           Number of threads to use
 //            -O                    Print trace output
 //            -T<time limit>        Max no. of steps
 //            -S<space limit>       Max absolute value of tape head
 //            -B[<bells-file>]      Output <bells-file>.txt and <bells-file>.umf (default ProbableBells)
+//            -C<cache file>        Result cache: skip machines whose result is known
+//            -Q<cost hint file>    Give the most expensive machines of each batch out first (see ../CostHints.h)
+//            -Y<cost hint file>    Output file: steps and time for each machine
+//            -J<snapshot file>     Input file: snapshots of the input machines (see ../Snapshot.h)
+//
+// With -C, each machine is first looked up in the result cache (see ../ResultCache.h).
+// A machine that was decided with no larger time and space limits, or left undecided
+// with no smaller ones, is not run again. The results of all the machines that are
+// run are added to the cache, which is saved at the end.
+//
+// Each batch of machines is read into memory and shared out between the threads,
+// in contiguous chunks. With -Q, the machines are given out longest first, each to
+// the thread with the least work so far, so that a few slow machines don't all land
+// in the same chunk. Either way, the output files are written in input order.
+//
+// With -J, each machine is resumed from its snapshot (written alongside the input
+// file by e.g. DecideTranslatedCyclers -Z<snapshot file>), and the time limit counts
+// from there, instead of running it again from a blank tape. The Verification Entries
+// are still valid, but they are not the same as those of a run without snapshots.
+//
+// A checkpoint is saved every few minutes, after a batch has been written, so that
+// if the run is interrupted, running it again with the same parameters resumes from
+// the last checkpoint (see ../Checkpoint.h). The result cache is saved with each
+// checkpoint. The statistics printed at the end only count the machines run since
+// the last restart.
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <inttypes.h> // for PRIu64
 #include <ctype.h>
 #include <string>
 #include <vector>
+#include <numeric>
+#include <chrono>
 
 #include "BouncerDecider.h"
 #include "../Params.h"
+#include "../Checkpoint.h"
 
 #if NEED_BOOST_THREADS
   #include <boost/thread.hpp>
@@ -42,11 +74,17 @@ class CommandLineParams : public DeciderParams
   {
 public:
   std::string BellsFile ;
+  std::string CacheFilename ;
+  std::string CostHintFilename ;
+  std::string CostOutputFilename ;
+  std::string SnapshotFilename ;
   uint32_t TimeLimit ;  bool TimeLimitPresent = false ;
   uint32_t SpaceLimit ; bool SpaceLimitPresent = false ;
   bool OutputBells = false ;
   FILE* fpBellTxt = 0 ;
   FILE* fpBellUmf = 0 ;
+  FILE* fpCostOutput = 0 ;
+  FILE* fpSnapshot = 0 ;
 
   void Parse (int argc, char** argv) ;
   void PrintHelpAndExit [[noreturn]] (int status) ;
@@ -57,9 +95,11 @@ public:
     if (OutputBells)
       {
       if (BellsFile.empty()) BellsFile = "ProbableBells" ;
-      fpBellTxt = OpenFile ((BellsFile + ".txt").c_str(), "wt") ;
-      fpBellUmf = OpenFile ((BellsFile + ".umf").c_str(), "wb") ;
+      fpBellTxt = OpenOutputFile (BellsFile + ".txt", true) ;
+      fpBellUmf = OpenOutputFile (BellsFile + ".umf") ;
       }
+    fpCostOutput = OpenOutputFile (CostOutputFilename) ;
+    fpSnapshot = OpenFile (SnapshotFilename, "rb") ;
     }
   } ;
 
@@ -70,9 +110,13 @@ int main (int argc, char** argv)
   {
   Params.Parse (argc, argv) ;
   Params.CheckParameters() ;
+  if (!Params.CostOutputFilename.empty()) TuringMachineReader::CheckIndex32 (Params, "-Y") ;
+  if (!Params.SnapshotFilename.empty()) TuringMachineReader::CheckIndex32 (Params, "-J") ;
+  Checkpoint Check (Params, Reader, argc, argv) ;
   Params.OpenFiles() ;
 
   Reader.SetParams (&Params) ;
+  Reader.SetSnapshotFile (Params.fpSnapshot) ;
 
   if (!Params.nThreadsPresent)
     {
@@ -95,37 +139,87 @@ int main (int argc, char** argv)
   if (Params.nThreads * ChunkSize * 50 > Reader.nMachines)
     ChunkSize = 1 + Reader.nMachines / (50 * Params.nThreads) ;
 
-  // Write dummy dvf header
-  Write32 (Params.fpVerify, 0) ;
+  uint64_t nDecided = 0 ;
+  uint64_t nCompleted = 0 ;
+  uint64_t nProbableBells = 0 ;
+  uint64_t nTimeLimitedDecided = 0 ;
+  uint64_t nSpaceLimitedDecided = 0 ;
+
+  Check.AddOutputFile (Params.fpUndecided, true) ;
+  Check.AddOutputFile (Params.fpBellUmf, true) ;
+  Check.AddOutputFile (Params.fpBellTxt) ;
+  Check.AddOutputFile (Params.fpVerify) ;
+  Check.AddOutputFile (Params.fpVerifyIndex) ;
+  Check.AddOutputFile (Params.fpCostOutput) ;
+  Check.AddCounter (nDecided) ;
+  Check.AddCounter (nCompleted) ;
+  Check.AddCounter (nProbableBells) ;
+  Check.AddCounter (nTimeLimitedDecided) ;
+  Check.AddCounter (nSpaceLimitedDecided) ;
+  if (!Check.Resume())
+    {
+    // Write umf header and dummy dvf header
+    Reader.WriteUndecidedHeader (Params.fpUndecided) ;
+    Reader.WriteUndecidedHeader (Params.fpBellUmf) ;
+    Reader.WriteVerificationHeader (Params.fpVerify, 0) ;
+    }
+
+  ResultCache* Cache = nullptr ;
+  if (!Params.CacheFilename.empty())
+    Cache = new ResultCache (Params.CacheFilename, DeciderTag::NEW_BOUNCER, Params.MachineStates, 2) ;
+
+  // A decided machine stays decided with more time and space, and an undecided
+  // machine stays undecided with less
+  const ResultCache::Range DecidedRange[2] = { { Params.TimeLimit, UINT32_MAX }, { Params.SpaceLimit, UINT32_MAX } } ;
+  const ResultCache::Range UndecidedRange[2] = { { 0, Params.TimeLimit }, { 0, Params.SpaceLimit } } ;
+
+  // With cost hints, a thread may be given more than its share of the (cheaper) machines
+  CostHints* Hints = nullptr ;
+  uint32_t MaxPerThread = ChunkSize ;
+  if (!Params.CostHintFilename.empty())
+    {
+    Hints = new CostHints (Params.CostHintFilename) ;
+    printf ("%d cost hints\n", Hints -> nHints) ;
+    MaxPerThread = 2 * ChunkSize ;
+    }
+  uint32_t VerifLength = VERIF_AVERAGE_LENGTH * DEFAULT_CHUNK_SIZE * (MaxPerThread / ChunkSize) ;
 
   clock_t Timer = clock() ;
 
   BouncerDecider** DeciderArray = new BouncerDecider*[Params.nThreads] ;
-  uint32_t** MachineIndexList = new uint32_t*[Params.nThreads] ;
+  uint64_t** MachineIndexList = new uint64_t*[Params.nThreads] ;
   uint8_t** MachineSpecList = new uint8_t*[Params.nThreads] ;
   uint8_t** VerificationEntryList = new uint8_t*[Params.nThreads] ;
   uint32_t* ChunkSizeArray = new uint32_t[Params.nThreads] ;
+  const uint32_t** ThreadOrder = new const uint32_t*[Params.nThreads] ;
   for (uint32_t i = 0 ; i < Params.nThreads ; i++)
     {
     DeciderArray[i] = new BouncerDecider (Params.MachineStates, Params.TimeLimit,
       Params.SpaceLimit, Params.TraceOutput) ;
     DeciderArray[i] -> Clone = new BouncerDecider (Params.MachineStates, Params.TimeLimit,
       Params.SpaceLimit, Params.TraceOutput) ;
-    MachineIndexList[i] = new uint32_t[ChunkSize] ;
-    MachineSpecList[i] = new uint8_t[Reader.MachineSpecSize * ChunkSize] ;
-    VerificationEntryList[i] = new uint8_t[VERIF_AVERAGE_LENGTH * DEFAULT_CHUNK_SIZE] ;
+    DeciderArray[i] -> Cache = Cache ;
+    if (Params.fpCostOutput) DeciderArray[i] -> CostList = new MachineCost[MaxPerThread] ;
+    if (Params.fpSnapshot) DeciderArray[i] -> SnapshotList = new const MachineSnapshot*[MaxPerThread] ;
+    MachineIndexList[i] = new uint64_t[MaxPerThread] ;
+    MachineSpecList[i] = new uint8_t[Reader.MachineSpecSize * MaxPerThread] ;
+    VerificationEntryList[i] = new uint8_t[VerifLength] ;
     }
 
-  uint32_t nDecided = 0 ;
-  uint32_t nCompleted = 0 ;
-  uint32_t nProbableBells = 0 ;
+  // The current batch, in input order
+  uint32_t BatchSize = Params.nThreads * ChunkSize ;
+  uint64_t* BatchIndexList = new uint64_t[BatchSize] ;
+  uint8_t* BatchSpecList = new uint8_t[Reader.MachineSpecSize * BatchSize] ;
+  uint32_t* Order = new uint32_t[BatchSize] ; // Batch entries for thread 0, then thread 1...
+  const uint8_t** EntryList = new const uint8_t*[BatchSize] ; // Verification entry of each machine
+  MachineCost* BatchCostList = new MachineCost[BatchSize] ;
+  MachineSnapshot* BatchSnapshotList = Params.fpSnapshot ? new MachineSnapshot[BatchSize] : nullptr ;
+
   int LastPercent = -1 ;
-  uint32_t nTimeLimitedDecided = 0 ;
-  uint32_t nSpaceLimitedDecided = 0 ;
 
   while (nCompleted < Reader.nMachines)
     {
-    uint32_t nRemaining = Reader.nMachines - nCompleted ;
+    uint64_t nRemaining = Reader.nMachines - nCompleted ;
     if (nRemaining >= Params.nThreads * ChunkSize)
       {
       for (uint32_t i = 0 ; i < Params.nThreads ; i++) ChunkSizeArray[i] = ChunkSize ;
@@ -139,22 +233,41 @@ int main (int argc, char** argv)
         }
       }
 
+    uint32_t nBatch = 0 ;
+    for (uint32_t i = 0 ; i < Params.nThreads ; i++) nBatch += ChunkSizeArray[i] ;
+    for (uint32_t Entry = 0 ; Entry < nBatch ; Entry++)
+      {
+      uint8_t* MachineSpec = BatchSpecList + Entry * Reader.MachineSpecSize ;
+      if (BatchSnapshotList) BatchIndexList[Entry] = Reader.Next (MachineSpec, BatchSnapshotList[Entry]) ;
+      else BatchIndexList[Entry] = Reader.Next (MachineSpec) ;
+      }
+
+    // Share the batch out between the threads
+    if (Hints) Hints -> Schedule (BatchIndexList, nBatch, Params.nThreads, MaxPerThread, Order, ChunkSizeArray) ;
+    else std::iota (Order, Order + nBatch, 0) ;
+
     std::vector<thread*> ThreadList (Params.nThreads) ;
+    const uint32_t* Entry = Order ;
     for (uint32_t i = 0 ; i < Params.nThreads ; i++)
       {
-      for (uint32_t j = 0 ; j < ChunkSizeArray[i] ; j++)
-        MachineIndexList[i][j] = Reader.Next (MachineSpecList[i] + j * Reader.MachineSpecSize) ;
+      ThreadOrder[i] = Entry ;
+      for (uint32_t j = 0 ; j < ChunkSizeArray[i] ; j++, Entry++)
+        {
+        MachineIndexList[i][j] = BatchIndexList[*Entry] ;
+        memcpy (MachineSpecList[i] + j * Reader.MachineSpecSize,
+          BatchSpecList + *Entry * Reader.MachineSpecSize, Reader.MachineSpecSize) ;
+        if (BatchSnapshotList) DeciderArray[i] -> SnapshotList[j] = &BatchSnapshotList[*Entry] ;
+        }
 
       // Run inline if single thread (for ease of debugging)
       if (Params.nThreads == 1) DeciderArray[0] -> ThreadFunction (ChunkSizeArray[0],
         MachineIndexList[0], MachineSpecList[0], Reader.MachineSpecSize,
-          VerificationEntryList[0], VERIF_AVERAGE_LENGTH * DEFAULT_CHUNK_SIZE) ;
+          VerificationEntryList[0], VerifLength) ;
       else ThreadList[i] = new thread (&BouncerDecider::ThreadFunction, DeciderArray[i],
         ChunkSizeArray[i], MachineIndexList[i], MachineSpecList[i], Reader.MachineSpecSize,
-          VerificationEntryList[i], VERIF_AVERAGE_LENGTH * DEFAULT_CHUNK_SIZE) ;
-
-      nCompleted += ChunkSizeArray[i] ;
+          VerificationEntryList[i], VerifLength) ;
       }
+    nCompleted += nBatch ;
 
     for (uint32_t i = 0 ; i < Params.nThreads ; i++)
       {
@@ -164,70 +277,86 @@ int main (int argc, char** argv)
         delete ThreadList[i] ;
         }
 
-      const uint8_t* MachineSpec = MachineSpecList[i] ;
+      // Note where each machine's entry is (undecided entries are 4 bytes)
       const uint8_t* VerificationEntry = VerificationEntryList[i] ;
       for (uint32_t j = 0 ; j < ChunkSizeArray[i] ; j++)
         {
-        switch ((int)Load32 (VerificationEntry))
-          {
-          case -1:
-            Write32 (Params.fpUndecided, MachineIndexList[i][j]) ;
-            Write32 (Params.fpBellUmf, MachineIndexList[i][j]) ;
-            if (Params.fpBellTxt) fprintf (Params.fpBellTxt, "%d\n", MachineIndexList[i][j]) ;
-            nProbableBells++ ;
-            VerificationEntry += 4 ;
-            break ;
-
-          case -2:
-            Write32 (Params.fpUndecided, MachineIndexList[i][j]) ;
-            VerificationEntry += 4 ;
-            break ;
-
-          default:
-            {
-            uint32_t InfoLength = Load32 (VerificationEntry + 8) ;
-            Write (Params.fpVerify, VerificationEntry, VERIF_HEADER_LENGTH + InfoLength) ;
-            nDecided++ ;
-            if (MachineIndexList[i][j] < Reader.nTimeLimited) nTimeLimitedDecided++ ;
-            else nSpaceLimitedDecided++ ;
-            VerificationEntry += VERIF_HEADER_LENGTH + InfoLength ;
-            }
-            break ;
-          }
-        MachineSpec += Reader.MachineSpecSize ;
+        uint32_t Entry = ThreadOrder[i][j] ;
+        EntryList[Entry] = VerificationEntry ;
+        if (Params.fpCostOutput) BatchCostList[Entry] = DeciderArray[i] -> CostList[j] ;
+        int Result = Load32 (VerificationEntry) ;
+        VerificationEntry += Result == -1 || Result == -2 ? 4 : VERIF_HEADER_LENGTH + Load32 (VerificationEntry + 8) ;
         }
       }
 
+    // Write the output files in input order
+    const uint8_t* MachineSpec = BatchSpecList ;
+    for (uint32_t Entry = 0 ; Entry < nBatch ; Entry++)
+      {
+      const uint8_t* VerificationEntry = EntryList[Entry] ;
+      uint64_t MachineIndex = BatchIndexList[Entry] ;
+      switch ((int)Load32 (VerificationEntry))
+        {
+        case -1:
+          if (Cache) Cache -> Add (MachineSpec, UndecidedRange, -1) ;
+          Reader.WriteUndecided (Params.fpUndecided, MachineIndex) ;
+          Reader.WriteUndecided (Params.fpBellUmf, MachineIndex) ;
+          if (Params.fpBellTxt) fprintf (Params.fpBellTxt, "%" PRIu64 "\n", MachineIndex) ;
+          nProbableBells++ ;
+          break ;
+
+        case -2:
+          if (Cache) Cache -> Add (MachineSpec, UndecidedRange, -2) ;
+          Reader.WriteUndecided (Params.fpUndecided, MachineIndex) ;
+          break ;
+
+        default:
+          Reader.WriteVerificationEntry (Params.fpVerify, MachineIndex,
+            VerificationEntry, VERIF_HEADER_LENGTH + Load32 (VerificationEntry + 8)) ;
+          if (Cache) Cache -> Add (MachineSpec, DecidedRange, ResultCache::DECIDED, VerificationEntry) ;
+          nDecided++ ;
+          if (MachineIndex < Reader.nTimeLimited) nTimeLimitedDecided++ ;
+          else nSpaceLimitedDecided++ ;
+          break ;
+        }
+      if (Params.fpCostOutput) CostHints::Write (Params.fpCostOutput, MachineIndex, BatchCostList[Entry]) ;
+      MachineSpec += Reader.MachineSpecSize ;
+      }
+    if (Check.Save (nCompleted) && Cache) Cache -> Save() ;
+
     int Percent = (nCompleted * 100LL) / Reader.nMachines ;
     if (Percent != LastPercent)
       {
       LastPercent = Percent ;
-      printf ("\r%d%% %d %d", Percent, nCompleted, nDecided) ;
+      printf ("\r%d%% %" PRIu64 " %" PRIu64, Percent, nCompleted, nDecided) ;
       fflush (stdout) ;
       }
     }
   printf ("\n") ;
 
-  if (Params.fpUndecided) fclose (Params.fpUndecided) ;
+  if (Params.fpUndecided) Reader.CloseUndecided (Params.fpUndecided) ;
   if (Params.fpInput) fclose (Params.fpInput) ;
 
   Timer = clock() - Timer ;
 
-  if (Params.fpVerify)
-    {
-    // Write the verification file header
-    if (fseek (Params.fpVerify, 0 , SEEK_SET))
-      printf ("\nfseek failed\n"), exit (1) ;
-    Write32 (Params.fpVerify, nDecided) ;
-    fclose (Params.fpVerify) ;
-    }
+  // Write the verification file header, and finish off the dvf index
+  if (Params.fpVerify) Reader.CloseVerification (Params.fpVerify, nDecided) ;
 
-  if (Params.fpBellUmf) fclose (Params.fpBellUmf) ;
+  if (Params.fpBellUmf) Reader.CloseUndecided (Params.fpBellUmf) ;
   if (Params.fpBellTxt) fclose (Params.fpBellTxt) ;
+  if (Params.fpCostOutput) fclose (Params.fpCostOutput) ;
+  if (Params.fpSnapshot) fclose (Params.fpSnapshot) ;
+  Check.Remove() ;
 
-  printf ("\nDecided %d out of %d\n", nDecided, Reader.nMachines) ;
+  printf ("\nDecided %" PRIu64 " out of %" PRIu64 "\n", nDecided, Reader.nMachines) ;
   printf ("Elapsed time %.3f\n", (double)Timer / CLOCKS_PER_SEC) ;
 
+  if (Cache)
+    {
+    Cache -> PrintStats() ;
+    Cache -> Save() ;
+    }
+
   uint32_t nUnilateral = 0 ;
   uint32_t nBilateral = 0 ;
   uint32_t nTranslated = 0 ;
@@ -276,6 +405,13 @@ int main (int argc, char** argv)
       MinStatMachine = DeciderArray[i] -> MinStatMachine ;
       }
     }
+  if (Params.fpSnapshot)
+    {
+    uint32_t nResumed = 0 ;
+    for (uint32_t i = 0 ; i < Params.nThreads ; i++) nResumed += DeciderArray[i] -> nResumed ;
+    printf ("%d machines resumed from snapshots\n\n", nResumed) ;
+    }
+
   printf ("%d Unilateral\n", nUnilateral) ;
   printf ("%d Bilateral\n", nBilateral) ;
   printf ("%d Translated\n", nTranslated) ;
@@ -285,24 +421,39 @@ int main (int argc, char** argv)
   printf ("\n%d Double\n", nDouble) ;
   printf ("%d Multiple\n", nMultiple) ;
   printf ("%d Partitioned\n", nPartitioned) ;
-  printf ("%d Probable Bells\n", nProbableBells) ;
+  printf ("%" PRIu64 " Probable Bells\n", nProbableBells) ;
   printf ("\n%d: %d runs\n", nRunsMachine, nRunsMax) ;
   printf ("%d: RepeaterPeriod %d\n", MaxRepeaterMachine, MaxRepeaterPeriod) ;
   if (MinStat != INT_MAX) printf ("\n%d: MinStat = %d\n", MinStatMachine, MinStat) ;
   if (MaxStat != INT_MIN) printf ("\n%d: MaxStat = %d\n", MaxStatMachine, MaxStat) ;
   }
 
-void BouncerDecider::ThreadFunction (int nMachines, const uint32_t* MachineIndexList,
+void BouncerDecider::ThreadFunction (int nMachines, const uint64_t* MachineIndexList,
   const uint8_t* MachineSpecList, uint32_t MachineSpecSize, uint8_t* VerificationEntryList, uint32_t VerifLength)
   {
   const uint8_t* VerificationEntryLimit = VerificationEntryList + VerifLength ;
   VerificationEntryLimit -= VERIF_INFO_MAX_LENGTH ;
-  while (nMachines--)
+  for (int i = 0 ; i < nMachines ; i++)
     {
+    auto StartTime = std::chrono::steady_clock::now() ;
+    StepCount = 0 ;
     SeedDatabaseIndex = *MachineIndexList++ ;
+    if (SnapshotList) StartSnapshot = SnapshotList[i] ;
     Save32 (VerificationEntryList, SeedDatabaseIndex) ;
     Save32 (VerificationEntryList + 4, uint32_t (DeciderTag::NEW_BOUNCER)) ;
-    if (RunDecider (MachineSpecList, VerificationEntryList))
+    uint32_t Limits[2] = { TimeLimit, SpaceLimit } ;
+    uint32_t Result ;
+    if (Cache && Cache -> Lookup (MachineSpecList, SeedDatabaseIndex, Limits, VerificationEntryList, Result))
+      {
+      if (Result == ResultCache::DECIDED)
+        VerificationEntryList += VERIF_HEADER_LENGTH + Load32 (VerificationEntryList + 8) ;
+      else
+        {
+        Save32 (VerificationEntryList, Result) ;
+        VerificationEntryList += 4 ;
+        }
+      }
+    else if (RunDecider (MachineSpecList, VerificationEntryList))
       VerificationEntryList += VERIF_HEADER_LENGTH + Load32 (VerificationEntryList + 8) ;
     else
       {
@@ -313,6 +464,13 @@ void BouncerDecider::ThreadFunction (int nMachines, const uint32_t* MachineIndex
     if (VerificationEntryList > VerificationEntryLimit)
       printf ("\nVerificationEntryLimit exceeded\n"), exit (1) ;
 
+    if (CostList)
+      {
+      CostList[i].Steps = StepCount ;
+      CostList[i].Microseconds = std::chrono::duration_cast<std::chrono::microseconds>
+        (std::chrono::steady_clock::now() - StartTime).count() ;
+      }
+
     MachineSpecList += MachineSpecSize ;
     }
   }
@@ -342,6 +500,26 @@ void CommandLineParams::Parse (int argc, char** argv)
         if (argv[0][2]) BellsFile = std::string (&argv[0][2]) ;
         break ;
 
+      case 'C':
+        if (argv[0][2] == 0) printf ("%s: filename expected\n", argv[0]), PrintHelpAndExit (1) ;
+        CacheFilename = std::string (&argv[0][2]) ;
+        break ;
+
+      case 'Q':
+        if (argv[0][2] == 0) printf ("%s: filename expected\n", argv[0]), PrintHelpAndExit (1) ;
+        CostHintFilename = std::string (&argv[0][2]) ;
+        break ;
+
+      case 'Y':
+        if (argv[0][2] == 0) printf ("%s: filename expected\n", argv[0]), PrintHelpAndExit (1) ;
+        CostOutputFilename = std::string (&argv[0][2]) ;
+        break ;
+
+      case 'J':
+        if (argv[0][2] == 0) printf ("%s: filename expected\n", argv[0]), PrintHelpAndExit (1) ;
+        SnapshotFilename = std::string (&argv[0][2]) ;
+        break ;
+
       default:
         printf ("Invalid parameter \"%s\"\n", argv[0]) ;
         PrintHelpAndExit (1) ;
@@ -350,6 +528,10 @@ void CommandLineParams::Parse (int argc, char** argv)
 
   if (!TimeLimitPresent) printf ("Time limit not specified\n"), PrintHelpAndExit (1) ;
   if (!SpaceLimitPresent) printf ("Space limit not specified\n"), PrintHelpAndExit (1) ;
+
+  // Cached results are only valid for runs from a blank tape
+  if (!SnapshotFilename.empty() && !CacheFilename.empty())
+    printf ("-J and -C can't be used together\n"), exit (1) ;
   }
 
 void CommandLineParams::PrintHelpAndExit (int status)
@@ -360,6 +542,10 @@ void CommandLineParams::PrintHelpAndExit (int status)
            -T<time limit>        Max no. of steps
            -S<space limit>       Max absolute value of tape head
            -B[<bells-file>]      Output <bells-file>.txt and <bells-file>.umf (default ProbableBells)
+           -C<cache file>        Result cache: skip machines whose result is known
+           -Q<cost hint file>    Give the most expensive machines of each batch out first
+           -Y<cost hint file>    Output file: steps and time for each machine
+           -J<snapshot file>     Input file: snapshots of the input machines
 )*RAW*") ;
   exit (status) ;
   }
@@ -2,6 +2,7 @@
 //   <param>: -N<states>            Machine states (2, 3, 4, 5, or 6)
 //            -D<database>          Seed database file (defaults to ../SeedDatabase.bin)
 //            -V<verification file> Input file: verification data to be checked
+//            -X<test machine>      Machine to verify (see ../DvfIndex.h)
 //            -S<space limit>       Max absolute value of tape head
 //
 // Format of verification info:
@@ -59,6 +60,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <time.h>
+#include <inttypes.h> // for PRIu64
 #include <string>
 
 #include "BouncerVerifier.h"
@@ -89,8 +91,8 @@ int main (int argc, char** argv)
 
   clock_t Timer = clock() ;
 
-  uint32_t nHalters = 0 ;
-  for (uint32_t Entry = 0 ; Entry < Reader.nMachines ; Entry++)
+  uint64_t nHalters = 0 ;
+  for (uint64_t Entry = 0 ; Entry < Reader.nMachines ; Entry++)
     {
     int Percent = ((Entry + 1) * 100LL) / Reader.nMachines ;
     if (Percent != LastPercent)
@@ -100,14 +102,15 @@ int main (int argc, char** argv)
       LastPercent = Percent ;
       }
 
-    uint32_t MachineIndex = Read32 (Params.fpVerify) ;
+    TuringMachineReader::DvfEntry VerifEntry = Reader.ReadVerificationEntry() ;
+    uint64_t MachineIndex = VerifEntry.MachineIndex ;
     Reader.Read (MachineIndex, MachineSpec) ;
     Verifier.Initialise (MachineIndex, MachineSpec) ;
 
-    switch (DeciderTag (Read32 (Params.fpVerify)))
+    switch (VerifEntry.Tag)
       {
       case DeciderTag::NEW_BOUNCER:
-        Verifier.Verify (Params.fpVerify) ;
+        Verifier.Verify (VerifEntry.Info) ;
         break ;
 
       case DeciderTag::BOUNCER:
@@ -115,21 +118,21 @@ int main (int argc, char** argv)
         exit (1) ;
 
       case DeciderTag::HALT:
-        Verifier.VerifyHalter (Params.fpVerify) ;
+        Verifier.VerifyHalter (VerifEntry.Info) ;
         nHalters++ ;
         break ;
 
       default:
-        printf ("\n%d: Unrecognised DeciderTag\n", MachineIndex), exit (1) ;
+        printf ("\n%" PRIu64 ": Unrecognised DeciderTag\n", MachineIndex), exit (1) ;
       }
     }
 
   Timer = clock() - Timer ;
 
-  if (!CheckEndOfFile (Params.fpVerify)) printf ("File too long!\n"), exit (1) ;
+  if (!Reader.SingleEntry && !Reader.VerificationAtEnd()) printf ("File too long!\n"), exit (1) ;
   fclose (Params.fpVerify) ;
-  printf ("\n%d Bouncers verified\n", Reader.nMachines - nHalters) ;
-  if (nHalters) printf ("%d Halters verified\n", nHalters) ;
+  printf ("\n%" PRIu64 " Bouncers verified\n", Reader.nMachines - nHalters) ;
+  if (nHalters) printf ("%" PRIu64 " Halters verified\n", nHalters) ;
   printf ("Elapsed time %.3f\n", (double)Timer / CLOCKS_PER_SEC) ;
   }
 
@@ -0,0 +1,132 @@
+// CanonicalReport <param> <param>...
+//   <param>: -N<states>            Machine states (2, 3, 4, 5, or 6)
+//            -D<database>          Seed database file (defaults to ../SeedDatabase.bin)
+//            -I<input file>        Input file: list of machines to be analysed (default=all machines)
+//            -X<test machine>      Machine to test
+//            -M<machine spec>      Compact machine code (ASCII spec) to test
+//            -L<machine limit>     Max no. of machines to test
+//            -R<start>:<end>       Machines <start> to <end>-1 of the input file or database
+//
+// Counts the classes of machines that have the same canonical form (see
+// TuringMachineSpec::CanonicalKey), allowing first for state renaming, then also
+// for unused transitions, and then also for mirror images. A Decider that decides
+// each class once (like DecideFAR with -K) saves one simulation or search for
+// every machine after the first in each class.
+//
+// The keys of all the machines are held in memory (8 bytes per machine). Each
+// level of canonical form is computed from the one before, since a key stands
+// for a machine in the same class as the original.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <ctype.h>
+#include <time.h>
+#include <inttypes.h> // for PRIu64
+#include <vector>
+#include <algorithm>
+
+#include "../TuringMachine.h"
+#include "../Params.h"
+
+class CommandLineParams : public DeciderParams
+  {
+public:
+  void Parse (int argc, char** argv) ;
+  void PrintHelpAndExit [[noreturn]] (int status) ;
+  } ;
+
+static CommandLineParams Params ;
+static TuringMachineReader Reader ;
+
+struct Level
+  {
+  uint32_t Flags ;
+  const char* Title ;
+  } ;
+
+static const Level LevelList[] =
+  {
+  { 0,                                                                       "Distinct machines" },
+  { TuringMachineSpec::CANONICAL_RENAME,                                     "Up to state renaming" },
+  { TuringMachineSpec::CANONICAL_RENAME | TuringMachineSpec::CANONICAL_UNUSED, "...and unused transitions" },
+  { TuringMachineSpec::CANONICAL_ALL,                                        "...and mirror images" },
+  } ;
+
+int main (int argc, char** argv)
+  {
+  Params.Parse (argc, argv) ;
+  Params.CheckParameters() ;
+  Params.OpenFiles() ;
+
+  Reader.SetParams (&Params) ;
+
+  clock_t Timer = clock() ;
+
+  TuringMachineSpec TM (Params.MachineStates) ;
+  uint8_t MachineSpec[MAX_MACHINE_SPEC_SIZE] ;
+  std::vector<uint64_t> KeyList (Reader.nMachines) ;
+  uint32_t LastPercent = -1 ;
+  for (uint64_t i = 0 ; i < Reader.nMachines ; i++)
+    {
+    TM.Initialise (Reader.Next (MachineSpec), MachineSpec) ;
+    KeyList[i] = TM.CanonicalKey (0) ;
+
+    uint32_t Percent = (i * 100LL) / Reader.nMachines ;
+    if (Percent != LastPercent)
+      {
+      LastPercent = Percent ;
+      printf ("\r%d%%", Percent) ;
+      fflush (stdout) ;
+      }
+    }
+  printf ("\r%" PRIu64 " machines\n\n", Reader.nMachines) ;
+
+  printf ("%-28s %12s %12s\n", "", "Classes", "Saved") ;
+  for (const Level& L : LevelList)
+    {
+    if (L.Flags) for (uint64_t& Key : KeyList)
+      {
+      TM.KeyToSpec (Key, MachineSpec) ;
+      TM.Initialise (0, MachineSpec) ;
+      Key = TM.CanonicalKey (L.Flags) ;
+      }
+
+    std::sort (KeyList.begin(), KeyList.end()) ;
+    uint64_t nClasses = 0 ;
+    uint64_t LargestClass = 0 ;
+    for (uint64_t i = 0, j ; i < Reader.nMachines ; i = j)
+      {
+      for (j = i + 1 ; j < Reader.nMachines && KeyList[j] == KeyList[i] ; j++) ;
+      nClasses++ ;
+      LargestClass = std::max (LargestClass, j - i) ;
+      }
+
+    uint64_t nSaved = Reader.nMachines - nClasses ;
+    printf ("%-28s %12" PRIu64 " %12" PRIu64 " (%.2f%%, largest class %" PRIu64 ")\n", L.Title, nClasses, nSaved,
+      Reader.nMachines ? 100.0 * nSaved / Reader.nMachines : 0.0, LargestClass) ;
+    }
+
+  Timer = clock() - Timer ;
+  printf ("\nElapsed time %.3f\n", (double)Timer / CLOCKS_PER_SEC) ;
+  }
+
+void CommandLineParams::Parse (int argc, char** argv)
+  {
+  if (argc == 1) PrintHelpAndExit (0) ;
+
+  for (argc--, argv++ ; argc ; argc--, argv++)
+    {
+    if (DeciderParams::ParseParam (argv[0])) continue ;
+    printf ("Invalid parameter \"%s\"\n", argv[0]) ;
+    PrintHelpAndExit (1) ;
+    }
+  }
+
+void CommandLineParams::PrintHelpAndExit (int status)
+  {
+  printf ("CanonicalReport <param> <param>...") ;
+  DeciderParams::PrintHelp() ;
+  printf ("\n(-V, -U, -H and -O are ignored)\n") ;
+  exit (status) ;
+  }
@@ -0,0 +1 @@
+g++ -std=c++20 -Wall -O3 -oCanonicalReport CanonicalReport.cpp ../Params.obj ../Reader.obj ../CompressedUmf.obj ../Enumerator.obj ../DvfIndex.obj ../MappedFile.obj ../CompactDvf.obj ../TuringMachine.obj
\ No newline at end of file
@@ -0,0 +1 @@
+CanonicalReport -D../SeedDatabase.bin
\ No newline at end of file
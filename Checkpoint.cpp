@@ -0,0 +1,147 @@
+#include <unistd.h>
+#include <inttypes.h> // for PRIu64
+#include <filesystem>
+
+#include "Params.h"
+#include "Checkpoint.h"
+
+Checkpoint::Checkpoint (DeciderParams& Params, TuringMachineReader& Reader, int argc, char** argv,
+  bool Allowed) : Params (Params), Reader (Reader)
+  {
+  if (!Allowed || Params.TestMachinePresent || !Params.MachineSpec.empty()) return ;
+  if (!Params.VerificationFilename.empty()) Filename = Params.VerificationFilename ;
+  else if (!Params.UndecidedFilename.empty()) Filename = Params.UndecidedFilename ;
+  else return ;
+  Filename += ".checkpoint" ;
+  Enabled = true ;
+  LastSave = time (nullptr) ;
+
+  for (int i = 1 ; i < argc ; i++) ArgList.push_back (argv[i]) ;
+
+  fpResume = fopen (Filename.c_str(), "rb") ;
+  if (fpResume == nullptr) return ;
+
+  // Resume only if the parameters are the same
+  bool Match = Read32 (fpResume) == CHECKPOINT_MAGIC && Read32 (fpResume) == ArgList.size() ;
+  for (uint32_t i = 0 ; Match && i < ArgList.size() ; i++)
+    {
+    std::string Arg (Read32 (fpResume), 0) ;
+    Read (fpResume, Arg.data(), Arg.length()) ;
+    Match = Arg == ArgList[i] ;
+    }
+  if (Match) Params.Resuming = true ;
+  else
+    {
+    printf ("Checkpoint file %s is for a different run: starting again\n", Filename.c_str()) ;
+    fclose (fpResume) ;
+    fpResume = nullptr ;
+    }
+  }
+
+Checkpoint::~Checkpoint()
+  {
+  if (fpResume) fclose (fpResume) ;
+  }
+
+void Checkpoint::AddOutputFile (FILE* fp, bool Umf)
+  {
+  if (fp) FileList.push_back ({ fp, Umf }) ;
+  }
+
+void Checkpoint::AddCounter (uint64_t& Counter)
+  {
+  CounterList.push_back (&Counter) ;
+  }
+
+bool Checkpoint::Resume (void (*LoadData) (FILE* fp))
+  {
+  if (fpResume == nullptr) return false ;
+
+  uint64_t nMachines = Read64 (fpResume) ;
+  EntriesDone = Read64 (fpResume) ;
+  bool Valid = nMachines == Reader.nMachines && EntriesDone <= nMachines
+    && Read32 (fpResume) == FileList.size() ;
+  std::vector<uint64_t> LengthList (FileList.size()) ;
+  for (uint32_t i = 0 ; Valid && i < FileList.size() ; i++)
+    {
+    LengthList[i] = Read64 (fpResume) ;
+
+    // If the machine crashed, the end of the file may not have been written
+    if (fseeko64 (FileList[i].fp, 0, SEEK_END)) printf ("fseek failed\n"), exit (1) ;
+    Valid = ftello64 (FileList[i].fp) >= (off64_t)LengthList[i] ;
+    }
+  Valid = Valid && Read32 (fpResume) == CounterList.size() ;
+  if (!Valid)
+    {
+    printf ("Checkpoint file %s doesn't match the input or output files: starting again\n",
+      Filename.c_str()) ;
+    for (OutputFile& F : FileList)
+      {
+      if (ftruncate64 (fileno (F.fp), 0)) printf ("Can't truncate output file\n"), exit (1) ;
+      rewind (F.fp) ;
+      }
+    EntriesDone = 0 ;
+    return false ;
+    }
+
+  for (uint64_t* Counter : CounterList) *Counter = Read64 (fpResume) ;
+  for (uint32_t i = 0 ; i < FileList.size() ; i++)
+    {
+    FILE* fp = FileList[i].fp ;
+    if (ftruncate64 (fileno (fp), LengthList[i])) printf ("Can't truncate output file\n"), exit (1) ;
+    if (fseeko64 (fp, 0, SEEK_END)) printf ("fseek failed\n"), exit (1) ;
+    if (FileList[i].Umf) Reader.ResumeUndecided (fp, fpResume) ;
+    if (fp == Params.fpVerify) Reader.ResumeVerification (fpResume) ;
+    }
+  if (LoadData) LoadData (fpResume) ;
+  fclose (fpResume) ;
+  fpResume = nullptr ;
+
+  Reader.SkipEntries (EntriesDone) ;
+  printf ("Resuming from %s: %" PRIu64 " machines done\n", Filename.c_str(), EntriesDone) ;
+  return true ;
+  }
+
+bool Checkpoint::Save (uint64_t EntriesDone, void (*SaveData) (FILE* fp))
+  {
+  if (!Enabled || time (nullptr) - LastSave < CHECKPOINT_INTERVAL) return false ;
+
+  std::string TempFilename = Filename + ".tmp" ;
+  FILE* fp = CommonParams::OpenFile (TempFilename, "wb") ;
+  Write32 (fp, CHECKPOINT_MAGIC) ;
+  Write32 (fp, ArgList.size()) ;
+  for (const std::string& Arg : ArgList)
+    {
+    Write32 (fp, Arg.length()) ;
+    Write (fp, Arg.data(), Arg.length()) ;
+    }
+  Write64 (fp, Reader.nMachines) ;
+  Write64 (fp, EntriesDone) ;
+
+  Write32 (fp, FileList.size()) ;
+  for (OutputFile& F : FileList)
+    {
+    fflush (F.fp) ;
+    Write64 (fp, ftello64 (F.fp)) ;
+    }
+  Write32 (fp, CounterList.size()) ;
+  for (uint64_t* Counter : CounterList) Write64 (fp, *Counter) ;
+  for (OutputFile& F : FileList)
+    {
+    if (F.Umf) Reader.SaveUndecided (F.fp, fp) ;
+    if (F.fp == Params.fpVerify) Reader.SaveVerification (fp) ;
+    }
+  if (SaveData) SaveData (fp) ;
+  fclose (fp) ;
+
+  std::error_code Error ;
+  std::filesystem::rename (TempFilename, Filename, Error) ;
+  if (Error) printf ("\nCan't rename %s\n", TempFilename.c_str()), exit (1) ;
+  LastSave = time (nullptr) ;
+  return true ;
+  }
+
+void Checkpoint::Remove()
+  {
+  if (Enabled) remove (Filename.c_str()) ;
+  }
@@ -0,0 +1,109 @@
+// Checkpoint.h
+//
+// Checkpoint class
+
+#pragma once
+
+// class Checkpoint
+//
+// Lets a long Decider run that is interrupted (by a crash, a reboot or Ctrl-C) carry
+// on from where it left off, instead of starting again from the beginning.
+//
+// Constructor:
+//
+//   Checkpoint (DeciderParams& Params, TuringMachineReader& Reader, int argc, char** argv,
+//     bool Allowed = true)
+//
+// The checkpoint file is named after the dvf (or the umf, if there is no dvf), with
+// ".checkpoint" appended. If it exists, and was written by a run with exactly the
+// same parameters, the constructor sets Params.Resuming, so that OpenFiles opens the
+// output files for update instead of truncating them (see DeciderParams::OpenOutputFile).
+// The constructor must therefore be called before OpenFiles. There are no checkpoints
+// without an output file, for a single machine (-X or -M), or if Allowed is false.
+//
+// The Decider registers its output files (AddOutputFile) and the counters that it
+// keeps as it writes them (AddCounter), and then calls Resume: if there is no
+// checkpoint to resume from, Resume returns false, and the Decider writes its file
+// headers as usual. Otherwise Resume truncates each output file to the length it had
+// when the checkpoint was saved, restores the counters and the state of any
+// compressed umf writers and of a compact dvf writer, and skips the input entries that were completed (see
+// TuringMachineReader::SkipEntries); the Decider carries on from the next entry, and
+// its output files end up the same, byte for byte, as those of an uninterrupted run.
+//
+// Whenever its output files are complete up to some input entry, the Decider can call
+// Save, which flushes them and writes a new checkpoint if CHECKPOINT_INTERVAL seconds
+// have passed since the last one, and returns true if it did (so that the Decider can
+// save anything that it keeps in a file of its own, such as a result cache). The
+// checkpoint is written to <file>.tmp and then renamed, so there is always a complete
+// checkpoint file. Remove deletes it at the end of the run.
+//
+// Format of checkpoint file:
+//
+//   uint CHECKPOINT_MAGIC
+//   uint nArgs
+//   Arg[nArgs]          -- Command line parameters (not including the program name)
+//   ulong nMachines     -- Machines in the run (after -R and -L)
+//   ulong EntriesDone   -- Input entries completed
+//   uint nFiles
+//   ulong FileLength[nFiles]
+//   uint nCounters
+//   ulong Counter[nCounters]
+//   WriterState[]       -- One for each compressed umf (see CompressedUmfWriter::SaveState),
+//                       -- and one for a compact dvf (see TuringMachineReader::SaveVerification),
+//                       -- in the order in which the files were added
+//   byte DeciderData[]  -- Anything else the Decider saves (see Save)
+//
+//   Arg format:
+//     uint Length
+//     char Arg[Length]
+
+#include <string>
+#include <vector>
+#include <time.h>
+
+#include "bbchallenge.h"
+
+#define CHECKPOINT_MAGIC 0x43484B50 // "CHKP"
+
+#ifndef CHECKPOINT_INTERVAL
+#define CHECKPOINT_INTERVAL 600 // Seconds
+#endif
+
+class DeciderParams ;
+class TuringMachineReader ;
+
+class Checkpoint
+  {
+public:
+  Checkpoint (DeciderParams& Params, TuringMachineReader& Reader, int argc, char** argv,
+    bool Allowed = true) ;
+  ~Checkpoint() ;
+
+  // Umf is true for a umf written through TuringMachineReader::WriteUndecided
+  void AddOutputFile (FILE* fp, bool Umf = false) ;
+  void AddCounter (uint64_t& Counter) ;
+
+  // LoadData reads whatever SaveData wrote (e.g. a Decider's caches)
+  bool Resume (void (*LoadData) (FILE* fp) = nullptr) ;
+  bool Save (uint64_t EntriesDone, void (*SaveData) (FILE* fp) = nullptr) ;
+  void Remove() ;
+
+  bool Enabled = false ;
+  uint64_t EntriesDone = 0 ; // On Resume
+
+private:
+  struct OutputFile
+    {
+    FILE* fp ;
+    bool Umf ;
+    } ;
+
+  DeciderParams& Params ;
+  TuringMachineReader& Reader ;
+  std::string Filename ;
+  std::vector<std::string> ArgList ;
+  std::vector<OutputFile> FileList ;
+  std::vector<uint64_t*> CounterList ;
+  FILE* fpResume = nullptr ; // The checkpoint file, from just after the parameters
+  time_t LastSave ;
+  } ;
@@ -0,0 +1,315 @@
+#include "CompactDvf.h"
+
+static void PutVarint (ustring& Out, uint64_t n)
+  {
+  while (n >= 0x80)
+    {
+    Out.push_back (uint8_t (n | 0x80)) ;
+    n >>= 7 ;
+    }
+  Out.push_back (uint8_t (n)) ;
+  }
+
+static uint64_t ReadVarint (FILE* fp)
+  {
+  uint64_t n = 0 ;
+  for (uint32_t Shift = 0 ; Shift < 64 ; Shift += 7)
+    {
+    uint32_t Byte = Read8u (fp) ;
+    n |= uint64_t (Byte & 0x7F) << Shift ;
+    if ((Byte & 0x80) == 0) return n ;
+    }
+  printf ("\nInvalid varint\n"), exit (1) ;
+  }
+
+static uint64_t ZigZag (int64_t n) { return (uint64_t (n) << 1) ^ uint64_t (n >> 63) ; }
+static int64_t UnZigZag (uint64_t n) { return int64_t (n >> 1) ^ -int64_t (n & 1) ; }
+
+static void InvalidEntry [[noreturn]] ()
+  {
+  printf ("\nInvalid compact dvf entry\n") ;
+  exit (1) ;
+  }
+
+// class InfoEncoder
+// class InfoDecoder
+//
+// Code and expand a VerificationInfo field by field. Unsigned and Signed handle
+// integer fields of 1, 2 or 4 bytes, and ByteArray a ushort length followed by that
+// many bytes. The encoder doesn't trust the VerificationInfo: if it runs off the end,
+// it sets Failed, and the entry is written as it stands.
+
+class InfoEncoder
+  {
+public:
+  InfoEncoder (ustring_view Info, ustring& Out)
+  : p (Info.data()), End (Info.data() + Info.size()), Out (Out) { }
+
+  uint32_t Unsigned (uint32_t Width)
+    {
+    uint32_t n = Take (Width) ;
+    PutVarint (Out, n) ;
+    return n ;
+    }
+
+  void Signed (uint32_t Width)
+    {
+    uint32_t n = Take (Width) ;
+    int32_t Value = Width == 2 ? int16_t (n) : int32_t (n) ;
+    PutVarint (Out, uint32_t (Value << 1) ^ uint32_t (Value >> 31)) ;
+    }
+
+  void ByteArray()
+    {
+    uint32_t Len = Take (2) ;
+    if (Failed || Len > uint32_t (End - p)) { Failed = true ; return ; }
+    bool Packed = true ;
+    for (uint32_t i = 0 ; i < Len ; i++)
+      if (p[i] > 1) Packed = false ;
+    PutVarint (Out, (Len << 1) | Packed) ;
+    if (Packed)
+      {
+      for (uint32_t i = 0 ; i < Len ; i += 8)
+        {
+        uint8_t Byte = 0 ;
+        for (uint32_t j = 0 ; j < 8 && i + j < Len ; j++)
+          Byte |= p[i + j] << j ;
+        Out.push_back (Byte) ;
+        }
+      }
+    else Out.append (p, Len) ;
+    p += Len ;
+    }
+
+  bool AtEnd() const { return Failed || p == End ; }
+  bool Failed = false ;
+
+private:
+  uint32_t Take (uint32_t Width)
+    {
+    if (Failed || Width > uint32_t (End - p)) { Failed = true ; return 0 ; }
+    uint32_t n = Width == 1 ? *p : Width == 2 ? Load16 (p) : Load32 (p) ;
+    p += Width ;
+    return n ;
+    }
+
+  const uint8_t* p ;
+  const uint8_t* End ;
+  ustring& Out ;
+  } ;
+
+class InfoDecoder
+  {
+public:
+  InfoDecoder (ByteReader& In, ustring& Out) : In (In), Out (Out) { }
+
+  uint32_t Unsigned (uint32_t Width)
+    {
+    uint64_t n = In.ReadVarint() ;
+    if (n >> (8 * Width)) InvalidEntry() ;
+    Put (n, Width) ;
+    return n ;
+    }
+
+  void Signed (uint32_t Width)
+    {
+    uint64_t n = In.ReadVarint() ;
+    if (n >> (8 * Width)) InvalidEntry() ;
+    Put (uint32_t (n >> 1) ^ -uint32_t (n & 1), Width) ;
+    }
+
+  void ByteArray()
+    {
+    uint64_t LenCode = In.ReadVarint() ;
+    uint32_t Len = LenCode >> 1 ;
+    if (LenCode >> 17) InvalidEntry() ;
+    Put (Len, 2) ;
+    if (LenCode & 1)
+      {
+      ustring_view Packed = In.Bytes ((Len + 7) >> 3) ;
+      for (uint32_t i = 0 ; i < Len ; i++)
+        Out.push_back ((Packed[i >> 3] >> (i & 7)) & 1) ;
+      }
+    else Out.append (In.Bytes (Len)) ;
+    }
+
+  bool AtEnd() const { return In.AtEnd() ; }
+
+private:
+  void Put (uint32_t n, uint32_t Width)
+    {
+    for (int Shift = 8 * (Width - 1) ; Shift >= 0 ; Shift -= 8)
+      Out.push_back (uint8_t (n >> Shift)) ;
+    }
+
+  ByteReader& In ;
+  ustring& Out ;
+  } ;
+
+// template <class Coder> static void TranscodeBouncer (Coder& C)
+//
+// Walks through the fields of a NEW_BOUNCER VerificationInfo (see
+// Bouncers/VerifyBouncers.cpp), in the order in which they are stored
+
+template <class Coder> static void TranscodeTape (Coder& C, uint32_t nPartitions)
+  {
+  C.Unsigned (1) ; // State
+  C.Unsigned (1) ; // TapeHeadWall
+  C.Signed (2) ;   // TapeHeadOffset
+  for (uint32_t i = 0 ; i < 2 * nPartitions + 1 ; i++) C.ByteArray() ; // Walls and Repeaters
+  }
+
+template <class Coder> static void TranscodeBouncer (Coder& C)
+  {
+  C.Unsigned (1) ; // BouncerType
+  uint32_t nPartitions = C.Unsigned (1) ;
+  uint32_t nRuns = C.Unsigned (2) ;
+  for (uint32_t i = 0 ; i < 2 ; i++)
+    {
+    C.Unsigned (4) ; // Steps
+    C.Signed (4) ;   // Leftmost
+    C.Signed (4) ;   // Rightmost
+    }
+  for (uint32_t i = 0 ; i < nPartitions ; i++) C.Unsigned (2) ; // RepeaterCount
+  TranscodeTape (C, nPartitions) ;
+  for (uint32_t i = 0 ; i < nRuns && !C.AtEnd() ; i++)
+    {
+    C.Unsigned (1) ; // Partition
+    for (uint32_t j = 0 ; j < 2 ; j++) // RepeaterTransition and WallTransition
+      {
+      C.Unsigned (2) ; // nSteps
+      for (uint32_t k = 0 ; k < 2 ; k++) // Initial and Final Segments
+        {
+        C.Unsigned (1) ; // State
+        C.Signed (2) ;   // TapeHead
+        C.ByteArray() ;
+        }
+      }
+    }
+  if (nRuns) C.Unsigned (2) ; // FinalAdjustment
+  TranscodeTape (C, nPartitions) ;
+  }
+
+template <class Coder> static void TranscodeInts (Coder& C)
+  {
+  while (!C.AtEnd()) C.Signed (4) ;
+  }
+
+// static bool EncodeInfo (ustring& Coded, DeciderTag Tag, ustring_view Info)
+// static void ExpandInfo (ustring& Expanded, DeciderTag Tag, ByteReader Coded)
+//
+// EncodeInfo returns false if the VerificationInfo should be written as it stands
+
+static bool EncodeInfo (ustring& Coded, DeciderTag Tag, ustring_view Info)
+  {
+  Coded.clear() ;
+  InfoEncoder C (Info, Coded) ;
+  switch (Tag)
+    {
+    case DeciderTag::CYCLER:
+    case DeciderTag::TRANSLATED_CYCLER_RIGHT:
+    case DeciderTag::TRANSLATED_CYCLER_LEFT:
+    case DeciderTag::BACKWARD_REASONING:
+    case DeciderTag::HALTING_SEGMENT:
+    case DeciderTag::HALT:
+      if (Info.size() & 3) return false ;
+      TranscodeInts (C) ;
+      break ;
+
+    case DeciderTag::NEW_BOUNCER:
+      TranscodeBouncer (C) ;
+      break ;
+
+    default: return false ;
+    }
+  return !C.Failed && C.AtEnd() && Coded.size() < Info.size() ;
+  }
+
+static void ExpandInfo (ustring& Expanded, DeciderTag Tag, ByteReader Coded)
+  {
+  Expanded.clear() ;
+  InfoDecoder C (Coded, Expanded) ;
+  switch (Tag)
+    {
+    case DeciderTag::CYCLER:
+    case DeciderTag::TRANSLATED_CYCLER_RIGHT:
+    case DeciderTag::TRANSLATED_CYCLER_LEFT:
+    case DeciderTag::BACKWARD_REASONING:
+    case DeciderTag::HALTING_SEGMENT:
+    case DeciderTag::HALT:
+      TranscodeInts (C) ;
+      break ;
+
+    case DeciderTag::NEW_BOUNCER:
+      TranscodeBouncer (C) ;
+      if (!C.AtEnd()) InvalidEntry() ;
+      break ;
+
+    default: InvalidEntry() ;
+    }
+  }
+
+//
+// CompactDvfReader
+//
+
+void CompactDvfReader::ReadEntry (ByteReader& Dvf)
+  {
+  MachineIndex = LastIndex + UnZigZag (Dvf.ReadVarint()) ;
+  uint64_t TagCode = Dvf.ReadVarint() ;
+  if (TagCode >> 33) InvalidEntry() ;
+  Tag = DeciderTag (TagCode >> 1) ;
+  Encoded = TagCode & 1 ;
+  StoredInfo = Dvf.Block (Dvf.ReadVarint()) ;
+  LastIndex = MachineIndex ;
+  }
+
+void CompactDvfReader::ReadEntry (FILE* fp)
+  {
+  MachineIndex = LastIndex + UnZigZag (ReadVarint (fp)) ;
+  uint64_t TagCode = ReadVarint (fp) ;
+  if (TagCode >> 33) InvalidEntry() ;
+  Tag = DeciderTag (TagCode >> 1) ;
+  Encoded = TagCode & 1 ;
+  uint64_t InfoLength = ReadVarint (fp) ;
+  if (InfoLength >> 32) InvalidEntry() ;
+  Buffer.resize (InfoLength) ;
+  Read (fp, Buffer.data(), InfoLength) ;
+  StoredInfo = ByteReader (Buffer) ;
+  LastIndex = MachineIndex ;
+  }
+
+ByteReader CompactDvfReader::Info()
+  {
+  if (!Encoded) return StoredInfo ;
+  ExpandInfo (Expanded, Tag, StoredInfo) ;
+  return ByteReader (Expanded) ;
+  }
+
+//
+// CompactDvfWriter
+//
+
+void CompactDvfWriter::Write (FILE* fp, uint64_t MachineIndex, DeciderTag Tag, ustring_view Info)
+  {
+  if (EncodeInfo (Coded, Tag, Info)) WriteEntry (fp, MachineIndex, Tag, 1, Coded) ;
+  else WriteEntry (fp, MachineIndex, Tag, 0, Info) ;
+  }
+
+void CompactDvfWriter::Copy (FILE* fp, const CompactDvfReader& Reader)
+  {
+  ByteReader Info = Reader.StoredInfo ;
+  WriteEntry (fp, Reader.MachineIndex, Reader.Tag, Reader.Encoded, Info.Bytes (Info.Remaining())) ;
+  }
+
+void CompactDvfWriter::WriteEntry (FILE* fp, uint64_t MachineIndex, DeciderTag Tag,
+  uint32_t Encoded, ustring_view Info)
+  {
+  Entry.clear() ;
+  PutVarint (Entry, ZigZag (MachineIndex - LastIndex)) ;
+  PutVarint (Entry, (uint64_t (Tag) << 1) | Encoded) ;
+  PutVarint (Entry, Info.size()) ;
+  Entry.append (Info) ;
+  ::Write (fp, Entry.data(), Entry.size()) ;
+  LastIndex = MachineIndex ;
+  }
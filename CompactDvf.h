@@ -0,0 +1,115 @@
+// CompactDvf.h
+//
+// CompactDvfReader and CompactDvfWriter classes
+
+#pragma once
+
+// Compact dvf files
+//
+// Most of a version 1 or 2 dvf is made up of fixed-width 32-bit fields holding small
+// numbers: a Cyclers entry is 36 bytes, most of them zeros, and a Bouncers entry
+// stores every tape segment a byte per cell. A compact (version 4) dvf holds the same
+// entries with the machine index delta-coded, every integer field as a varint, and
+// the tape segments of a Bouncers entry packed a bit per cell. A Decider writes a
+// compact dvf along with a compressed umf (-G, or a compressed input file), and the
+// Verifiers read one directly, expanding each entry's VerificationInfo back to its
+// version 1 form, so the Verifiers themselves are the same for every version.
+// Convert/ConvertFiles converts a dvf to and from version 4 without loss.
+//
+// Format of compact dvf:
+//
+//   uint FILE_VERSION_MARK (0xFFFFFFFF)
+//   uint Version (4)
+//   ulong nEntries
+//   Entry[nEntries]
+//
+//   Entry format:
+//     varint IndexDelta -- zigzag (SeedDatabaseIndex - previous SeedDatabaseIndex),
+//                       -- with a previous index of 0 for the first entry
+//     varint TagCode    -- (DeciderTag << 1) | Encoded
+//     varint InfoLength -- Length of Info
+//     byte Info[InfoLength]
+//
+// A varint holds 7 bits in each byte, least significant first, with the top bit set
+// in every byte but the last; zigzag (n) is (n << 1) ^ (n >> 63), so that small
+// negative numbers have short varints too.
+//
+// If Encoded is 0, Info is the VerificationInfo as it stands. Otherwise it is coded
+// according to DeciderTag:
+//
+//   CYCLER, TRANSLATED_CYCLER_RIGHT/LEFT, BACKWARD_REASONING, HALTING_SEGMENT, HALT:
+//     Each int of the VerificationInfo as a zigzag varint
+//
+//   NEW_BOUNCER (see Bouncers/VerifyBouncers.cpp):
+//     Each field as a varint (zigzag for signed fields), in the same order, except
+//     that each ByteArray is coded as
+//       varint LenCode -- (Len << 1) | Packed
+//       byte Data[Packed ? (Len + 7) / 8 : Len]
+//     where a Packed array has only 0s and 1s in it, and holds cell i in bit (i & 7)
+//     of Data[i >> 3]
+//
+// The FAR entries are bitmaps already, and any entry that can't be coded (such as a
+// VerificationInfo that doesn't parse) is written with Encoded = 0, so every dvf
+// converts to version 4 and back to exactly the same file.
+//
+// Because of the delta coding, an entry can only be read on its own if the machine
+// index of the entry before it is known. A dvf index (see DvfIndex.h) gives the
+// machine index of each entry, so a Verifier given -X sets LastIndex to match the
+// entry that it finds (see TuringMachineReader::SeekVerificationEntry). The
+// Coordinator and MergeFiles copy entries from one compact dvf to another with
+// CompactDvfWriter::Copy, which re-codes IndexDelta and nothing else.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "bbchallenge.h"
+
+#define COMPACT_DVF_VERSION 4
+
+class CompactDvfReader
+  {
+public:
+  // Read the next entry, from a mapped dvf (see MappedFile.h) or a file, leaving
+  // its machine index in MachineIndex and its tag in Tag
+  void ReadEntry (ByteReader& Dvf) ;
+  void ReadEntry (FILE* fp) ;
+
+  // The VerificationInfo of the entry, in version 1 form. It is only valid until
+  // the next entry is read; if the entry wasn't coded, and was read from a mapped
+  // dvf, it reads straight from the mapping.
+  ByteReader Info() ;
+
+  // The machine index of the entry before the next one
+  uint64_t LastIndex = 0 ;
+
+  uint64_t MachineIndex ;
+  DeciderTag Tag ;
+
+private:
+  friend class CompactDvfWriter ;
+
+  uint32_t Encoded ;
+  ByteReader StoredInfo ; // As it is in the file
+  ustring Buffer ;        // For an entry read from a file
+  ustring Expanded ;
+  } ;
+
+class CompactDvfWriter
+  {
+public:
+  void Write (FILE* fp, uint64_t MachineIndex, DeciderTag Tag, ustring_view Info) ;
+
+  // Writes the last entry read by Reader as it stands, re-coding only IndexDelta
+  void Copy (FILE* fp, const CompactDvfReader& Reader) ;
+
+  // The machine index of the last entry written (see Checkpoint.h)
+  uint64_t LastIndex = 0 ;
+
+private:
+  void WriteEntry (FILE* fp, uint64_t MachineIndex, DeciderTag Tag, uint32_t Encoded,
+    ustring_view Info) ;
+
+  ustring Entry ;
+  ustring Coded ;
+  } ;
@@ -1,3 +1,11 @@
 g++ -std=c++20 -Wall -O3 -c -o TuringMachine.obj TuringMachine.cpp
 g++ -std=c++20 -Wall -O3 -c -o Params.obj Params.cpp
-g++ -std=c++20 -Wall -O3 -c -o Reader.obj Reader.cpp
\ No newline at end of file
+g++ -std=c++20 -Wall -O3 -c -o Reader.obj Reader.cpp
+g++ -std=c++20 -Wall -O3 -c -o CompressedUmf.obj CompressedUmf.cpp
+g++ -std=c++20 -Wall -O3 -c -o Enumerator.obj Enumerator.cpp
+g++ -std=c++20 -Wall -O3 -c -o DvfIndex.obj DvfIndex.cpp
+g++ -std=c++20 -Wall -O3 -c -o MappedFile.obj MappedFile.cpp
+g++ -std=c++20 -Wall -O3 -c -o CompactDvf.obj CompactDvf.cpp
+g++ -std=c++20 -Wall -O3 -c -o ResultCache.obj ResultCache.cpp
+g++ -std=c++20 -Wall -O3 -c -o CostHints.obj CostHints.cpp
+g++ -std=c++20 -Wall -O3 -c -o Checkpoint.obj Checkpoint.cpp
\ No newline at end of file
@@ -0,0 +1,254 @@
+#include <string.h>
+#include <inttypes.h> // for PRIu64
+
+#include "CompressedUmf.h"
+
+//
+// UmfContainer
+//
+
+void UmfContainer::Clear (uint64_t Key)
+  {
+  this -> Key = Key ;
+  Cardinality = 0 ;
+  memset (Bits, 0, sizeof (Bits)) ;
+  }
+
+void UmfContainer::Read (FILE* fp)
+  {
+  Clear (Read64 (fp)) ;
+  uint32_t n = Read32 (fp) ;
+  if (n == 0 || n > 65536) printf ("Invalid compressed umf container\n"), exit (1) ;
+  if (n <= MaxArraySize)
+    {
+    int Last = -1 ;
+    for (uint32_t i = 0 ; i < n ; i++)
+      {
+      int Low = Read16u (fp) ;
+      if (Low <= Last) printf ("Compressed umf container not in increasing order\n"), exit (1) ;
+      Add (Low) ;
+      Last = Low ;
+      }
+    }
+  else
+    {
+    for (uint32_t i = 0 ; i < 1024 ; i++)
+      Cardinality += __builtin_popcountll (Bits[i] = Read64 (fp)) ;
+    if (Cardinality != n) printf ("Invalid compressed umf container\n"), exit (1) ;
+    }
+  }
+
+void UmfContainer::Write (FILE* fp) const
+  {
+  Write64 (fp, Key) ;
+  Write32 (fp, Cardinality) ;
+  if (Cardinality <= MaxArraySize)
+    {
+    for (uint32_t i = 0 ; i < 1024 ; i++)
+      for (uint64_t w = Bits[i] ; w ; w &= w - 1)
+        Write16 (fp, (i << 6) + __builtin_ctzll (w)) ;
+    }
+  else for (uint32_t i = 0 ; i < 1024 ; i++) Write64 (fp, Bits[i]) ;
+  }
+
+void UmfContainer::Combine (const UmfContainer& C, SetOperation Op)
+  {
+  Cardinality = 0 ;
+  for (uint32_t i = 0 ; i < 1024 ; i++)
+    {
+    switch (Op)
+      {
+      case SetOperation::Union: Bits[i] |= C.Bits[i] ; break ;
+      case SetOperation::Intersection: Bits[i] &= C.Bits[i] ; break ;
+      case SetOperation::Difference: Bits[i] &= ~C.Bits[i] ; break ;
+      }
+    Cardinality += __builtin_popcountll (Bits[i]) ;
+    }
+  }
+
+//
+// CompressedUmfReader
+//
+
+void CompressedUmfReader::Open (FILE* fp, uint32_t Version)
+  {
+  if (Version > COMPRESSED_UMF_VERSION) printf ("Version %d file is not a umf\n", Version), exit (1) ;
+  this -> fp = fp ;
+  this -> Version = Version ;
+  DataOffset = ftello64 (fp) ;
+
+  if (Version == COMPRESSED_UMF_VERSION)
+    {
+    // Count the indices, skipping over the contents of each container
+    nIndices = nContainers = 0 ;
+    uint64_t LastKey = 0 ;
+    for (;;)
+      {
+      uint8_t Header[12] ;
+      size_t n = fread (Header, 1, 12, fp) ;
+      if (n == 0) break ;
+      if (n != 12) printf ("Compressed umf file truncated\n"), exit (1) ;
+      uint64_t Key = Load64 (Header) ;
+      uint32_t Cardinality = Load32 (Header + 8) ;
+      if ((nContainers && Key <= LastKey) || Cardinality == 0 || Cardinality > 65536)
+        printf ("Invalid compressed umf file\n"), exit (1) ;
+      if (fseeko64 (fp, Cardinality <= UmfContainer::MaxArraySize ? 2 * Cardinality : 8192, SEEK_CUR))
+        printf ("fseek failed\n"), exit (1) ;
+      nIndices += Cardinality ;
+      nContainers++ ;
+      LastKey = Key ;
+      }
+
+    // fseeko64 can go past the end of the file, so check that the last container
+    // was complete
+    off64_t End = ftello64 (fp) ;
+    if (fseeko64 (fp, 0, SEEK_END)) printf ("fseek failed\n"), exit (1) ;
+    if (ftello64 (fp) != End) printf ("Compressed umf file truncated\n"), exit (1) ;
+    }
+  else
+    {
+    if (fseeko64 (fp, 0, SEEK_END)) printf ("fseek failed\n"), exit (1) ;
+    uint64_t Size = ftello64 (fp) - DataOffset ;
+    uint32_t IndexSize = Version == 1 ? 4 : 8 ;
+    if (Size % IndexSize) printf ("Invalid input file size\n"), exit (1) ;
+    nIndices = Size / IndexSize ;
+    }
+
+  Rewind() ;
+  }
+
+void CompressedUmfReader::Rewind()
+  {
+  if (fseeko64 (fp, DataOffset, SEEK_SET)) printf ("fseek failed\n"), exit (1) ;
+  IndicesRead = ContainersRead = 0 ;
+  WordIndex = 1023 ;
+  Word = 0 ;
+  PendingValid = false ;
+  }
+
+uint64_t CompressedUmfReader::Next()
+  {
+  if (IndicesRead >= nIndices) printf ("Read past end of umf\n"), exit (1) ;
+  IndicesRead++ ;
+  if (Version == 1) return Read32 (fp) ;
+  if (Version == 2) return Read64 (fp) ;
+
+  while (Word == 0)
+    {
+    if (++WordIndex == 1024)
+      {
+      Container.Read (fp) ;
+      ContainersRead++ ;
+      WordIndex = 0 ;
+      }
+    Word = Container.Bits[WordIndex] ;
+    }
+  uint64_t MachineIndex = (Container.Key << 16) + (WordIndex << 6) + __builtin_ctzll (Word) ;
+  Word &= Word - 1 ;
+  return MachineIndex ;
+  }
+
+bool CompressedUmfReader::NextContainer (UmfContainer& C)
+  {
+  if (Version == COMPRESSED_UMF_VERSION)
+    {
+    if (ContainersRead == nContainers) return false ;
+    C.Read (fp) ;
+    ContainersRead++ ;
+    IndicesRead += C.Cardinality ;
+    return true ;
+    }
+
+  // Uncompressed: collect the indices with the same Key as the first one
+  if (!PendingValid)
+    {
+    if (IndicesRead == nIndices) return false ;
+    PendingIndex = Version == 1 ? Read32 (fp) : Read64 (fp) ;
+    IndicesRead++ ;
+    }
+  C.Clear (PendingIndex >> 16) ;
+  for (;;)
+    {
+    C.Add (PendingIndex & 0xFFFF) ;
+    PendingValid = false ;
+    if (IndicesRead == nIndices) break ;
+    uint64_t MachineIndex = Version == 1 ? Read32 (fp) : Read64 (fp) ;
+    IndicesRead++ ;
+    if (MachineIndex <= PendingIndex)
+      printf ("umf not in increasing order at machine %" PRIu64 "\n", MachineIndex), exit (1) ;
+    PendingIndex = MachineIndex ;
+    PendingValid = true ;
+    if ((MachineIndex >> 16) != C.Key) break ;
+    }
+  return true ;
+  }
+
+//
+// CompressedUmfWriter
+//
+
+void CompressedUmfWriter::Open (FILE* fp)
+  {
+  this -> fp = fp ;
+  Write32 (fp, FILE_VERSION_MARK) ;
+  Write32 (fp, COMPRESSED_UMF_VERSION) ;
+  nIndices = 0 ;
+  ContainerValid = false ;
+  }
+
+void CompressedUmfWriter::Add (uint64_t MachineIndex)
+  {
+  if (nIndices && MachineIndex <= LastIndex)
+    printf ("\nCompressed umf must be in increasing order (machine %" PRIu64 ")\n", MachineIndex), exit (1) ;
+  if (ContainerValid && (MachineIndex >> 16) != Container.Key)
+    {
+    Container.Write (fp) ;
+    ContainerValid = false ;
+    }
+  if (!ContainerValid)
+    {
+    Container.Clear (MachineIndex >> 16) ;
+    ContainerValid = true ;
+    }
+  Container.Add (MachineIndex & 0xFFFF) ;
+  LastIndex = MachineIndex ;
+  nIndices++ ;
+  }
+
+void CompressedUmfWriter::AddContainer (const UmfContainer& C)
+  {
+  if (C.Cardinality == 0) return ;
+  if (ContainerValid)
+    {
+    Container.Write (fp) ;
+    ContainerValid = false ;
+    }
+  if (nIndices && (C.Key << 16) <= LastIndex)
+    printf ("\nCompressed umf must be in increasing order\n"), exit (1) ;
+  C.Write (fp) ;
+  nIndices += C.Cardinality ;
+  LastIndex = (C.Key << 16) | 0xFFFF ;
+  }
+
+void CompressedUmfWriter::Flush()
+  {
+  if (ContainerValid) Container.Write (fp) ;
+  ContainerValid = false ;
+  }
+
+void CompressedUmfWriter::SaveState (FILE* fpState) const
+  {
+  Write64 (fpState, nIndices) ;
+  Write64 (fpState, nIndices ? LastIndex : 0) ;
+  Write8 (fpState, ContainerValid) ;
+  if (ContainerValid) Container.Write (fpState) ;
+  }
+
+void CompressedUmfWriter::RestoreState (FILE* fp, FILE* fpState)
+  {
+  this -> fp = fp ;
+  nIndices = Read64 (fpState) ;
+  LastIndex = Read64 (fpState) ;
+  ContainerValid = Read8u (fpState) ;
+  if (ContainerValid) Container.Read (fpState) ;
+  }
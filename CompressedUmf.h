@@ -0,0 +1,134 @@
+// CompressedUmf.h
+//
+// UmfContainer, CompressedUmfReader and CompressedUmfWriter classes
+
+#pragma once
+
+// Compressed umf files
+//
+// A umf is a sorted list of machine indices, and a version 1 umf spends 4 bytes on
+// each of them. A compressed (version 3) umf divides the indices into containers
+// of 65536 consecutive indices, in the same way as a roaring bitmap: a container
+// with up to 4096 indices stores the low 16 bits of each (2 bytes per index), and
+// a fuller one stores a bitmap of all 65536 (8KB, or 1 bit per machine). The
+// early umfs of the pipeline, which hold most of the database, shrink by a factor
+// of 30 or so; a sparse umf still shrinks by a factor of 2.
+//
+// The machine indices in a compressed umf must be strictly increasing, as they are
+// in every umf written by the Deciders from a database. The indices of an
+// enumeration (see Enumerator.h) are in the order of the TNF walk, so a umf written
+// from one can't be compressed, and -G is refused (see DeciderParams::CheckParameters).
+//
+// Format of compressed umf:
+//
+//   uint FILE_VERSION_MARK (0xFFFFFFFF)
+//   uint Version (3)
+//   Container[]
+//
+//   Container format:
+//     ulong Key          -- Machine index >> 16 (strictly increasing)
+//     uint Cardinality   -- Number of indices in the container (1 to 65536)
+//     (if Cardinality <= 4096:)
+//     ushort Low[Cardinality] -- Machine index & 0xFFFF (strictly increasing)
+//     (otherwise:)
+//     ulong Bits[1024]   -- Bit (Low & 63) of Bits[Low >> 6] is set for each index
+//
+// In memory, a container is always held as a bitmap, so set operations work on
+// whole containers, 64 indices at a time (see UmfContainer::Combine).
+//
+// CompressedUmfReader reads the indices of a umf of any version one at a time (Next),
+// or a container at a time (NextContainer); it counts them when it is opened. It
+// reads a compressed umf directly, and groups the indices of an uncompressed one
+// into containers. CompressedUmfWriter writes a compressed umf an index at a time,
+// holding back one container; Flush must be called before the file is closed.
+// SaveState saves the rest of its state (including the container it is holding
+// back) so that RestoreState can carry on writing the file after a restart (see
+// Checkpoint.h).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "bbchallenge.h"
+
+#define COMPRESSED_UMF_VERSION 3
+
+enum class SetOperation { Union, Intersection, Difference } ;
+
+class UmfContainer
+  {
+public:
+  static const uint32_t MaxArraySize = 4096 ;
+
+  uint64_t Key ;
+  uint32_t Cardinality ;
+  uint64_t Bits[1024] ;
+
+  void Clear (uint64_t Key) ;
+  void Add (uint32_t Low)
+    {
+    Bits[Low >> 6] |= 1ULL << (Low & 63) ;
+    Cardinality++ ;
+    }
+
+  void Read (FILE* fp) ;
+  void Write (FILE* fp) const ;
+
+  // Replaces this container with its union, intersection or difference with C
+  // (which must have the same Key)
+  void Combine (const UmfContainer& C, SetOperation Op) ;
+  } ;
+
+class CompressedUmfReader
+  {
+public:
+  // fp must be positioned just after the version header (if any); see
+  // TuringMachineReader::ReadFileVersion
+  void Open (FILE* fp, uint32_t Version) ;
+  void Rewind() ;
+
+  uint64_t Next() ;
+  bool NextContainer (UmfContainer& C) ;
+  bool AtEnd() const { return IndicesRead == nIndices ; }
+
+  uint64_t nIndices ;
+  uint64_t IndicesRead ;
+
+private:
+  FILE* fp ;
+  uint32_t Version ;
+  uint64_t nContainers ;   // Compressed umf only
+  uint64_t ContainersRead ;
+  off64_t DataOffset ;
+
+  // Next, for a compressed umf: the current container, and the bits of Bits[WordIndex]
+  // that haven't been returned yet
+  UmfContainer Container ;
+  uint32_t WordIndex ;
+  uint64_t Word ;
+
+  // NextContainer, for an uncompressed umf: the first index of the next container
+  uint64_t PendingIndex ;
+  bool PendingValid ;
+  } ;
+
+class CompressedUmfWriter
+  {
+public:
+  // Writes the version header
+  void Open (FILE* fp) ;
+  void Add (uint64_t MachineIndex) ;
+  void AddContainer (const UmfContainer& C) ;
+  void Flush() ;
+
+  void SaveState (FILE* fpState) const ;
+  void RestoreState (FILE* fp, FILE* fpState) ;
+
+  uint64_t nIndices ;
+
+private:
+  FILE* fp = nullptr ;
+  UmfContainer Container ;
+  bool ContainerValid ;
+  uint64_t LastIndex ;
+  } ;
@@ -0,0 +1,183 @@
+// CombineUmf <param> <param>...
+//   <param>: -A<umf file>          First umf (version 1, 2 or 3)
+//            -B<umf file>          Second umf (version 1, 2 or 3)
+//            -P<operation>         union, intersection or difference (A minus B)
+//            -O<output file>       Output umf
+//            -W<version>           Version of output file (1, 2 or 3, default 3)
+//
+// Combines two lists of machines. The umfs must be in increasing order (as they are
+// when written by the Deciders from a database, but not from an enumeration; see
+// ../Enumerator.h), and are read a container of 65536 machine indices at a time
+// (see ../CompressedUmf.h), so the set operation works on whole bitmaps and
+// neither file is ever held in memory. A compressed umf is never decompressed:
+// a container that has no counterpart in the other file is copied as it stands.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <inttypes.h> // for PRIu64
+#include <string>
+
+#include "../Params.h"
+
+class CommandLineParams
+  {
+public:
+  std::string InputFilename[2] ;
+  std::string OutputFilename ;
+  SetOperation Op ; bool OpPresent = false ;
+  uint32_t Version = COMPRESSED_UMF_VERSION ;
+  void Parse (int argc, char** argv) ;
+  void PrintHelpAndExit [[noreturn]] (int status) ;
+  } ;
+
+static CommandLineParams Params ;
+
+static void OpenInput (int i, FILE*& fp, CompressedUmfReader& Reader) ;
+static void WriteContainer (FILE* fpOut, const UmfContainer& C) ;
+
+static CompressedUmfWriter Writer ;
+static uint64_t nOutput ;
+
+int main (int argc, char** argv)
+  {
+  Params.Parse (argc, argv) ;
+
+  FILE* fpIn[2] ;
+  CompressedUmfReader Reader[2] ;
+  for (int i = 0 ; i < 2 ; i++) OpenInput (i, fpIn[i], Reader[i]) ;
+
+  FILE* fpOut = CommonParams::OpenFile (Params.OutputFilename, "wb") ;
+  if (Params.Version == COMPRESSED_UMF_VERSION) Writer.Open (fpOut) ;
+  else TuringMachineReader::WriteFileVersion (fpOut, Params.Version) ;
+
+  clock_t Timer = clock() ;
+
+  // Merge the two lists of containers by Key
+  static UmfContainer A, B ;
+  bool HaveA = Reader[0].NextContainer (A) ;
+  bool HaveB = Reader[1].NextContainer (B) ;
+  while (HaveA || HaveB)
+    {
+    if (HaveA && (!HaveB || A.Key < B.Key))
+      {
+      if (Params.Op != SetOperation::Intersection) WriteContainer (fpOut, A) ;
+      HaveA = Reader[0].NextContainer (A) ;
+      }
+    else if (HaveB && (!HaveA || B.Key < A.Key))
+      {
+      if (Params.Op == SetOperation::Union) WriteContainer (fpOut, B) ;
+      HaveB = Reader[1].NextContainer (B) ;
+      }
+    else
+      {
+      A.Combine (B, Params.Op) ;
+      WriteContainer (fpOut, A) ;
+      HaveA = Reader[0].NextContainer (A) ;
+      HaveB = Reader[1].NextContainer (B) ;
+      }
+    }
+
+  if (Params.Version == COMPRESSED_UMF_VERSION) Writer.Flush() ;
+  fclose (fpIn[0]) ;
+  fclose (fpIn[1]) ;
+  fclose (fpOut) ;
+
+  Timer = clock() - Timer ;
+
+  printf ("%" PRIu64 " machines written to version %d file %s\n", nOutput, Params.Version,
+    Params.OutputFilename.c_str()) ;
+  printf ("Elapsed time %.3f\n", (double)Timer / CLOCKS_PER_SEC) ;
+  }
+
+static void OpenInput (int i, FILE*& fp, CompressedUmfReader& Reader)
+  {
+  fp = CommonParams::OpenFile (Params.InputFilename[i], "rb") ;
+  if (fseeko64 (fp, 0, SEEK_END)) printf ("fseek failed\n"), exit (1) ;
+  uint64_t FileSize = ftello64 (fp) ;
+  if (fseeko64 (fp, 0, SEEK_SET)) printf ("fseek failed\n"), exit (1) ;
+
+  uint32_t Version = FileSize ? TuringMachineReader::ReadFileVersion (fp) : 1 ;
+  Reader.Open (fp, Version) ;
+  printf ("%s: version %d, %" PRIu64 " machines\n", Params.InputFilename[i].c_str(),
+    Version, Reader.nIndices) ;
+  }
+
+static void WriteContainer (FILE* fpOut, const UmfContainer& C)
+  {
+  nOutput += C.Cardinality ;
+  if (Params.Version == COMPRESSED_UMF_VERSION)
+    {
+    Writer.AddContainer (C) ;
+    return ;
+    }
+
+  for (uint32_t i = 0 ; i < 1024 ; i++)
+    for (uint64_t w = C.Bits[i] ; w ; w &= w - 1)
+      {
+      uint64_t MachineIndex = (C.Key << 16) + (i << 6) + __builtin_ctzll (w) ;
+      if (Params.Version == 1 && MachineIndex >= FILE_VERSION_MARK)
+        printf ("Machine index %" PRIu64 " is too large for a version 1 file\n", MachineIndex), exit (1) ;
+      TuringMachineReader::WriteIndex (fpOut, Params.Version, MachineIndex) ;
+      }
+  }
+
+void CommandLineParams::Parse (int argc, char** argv)
+  {
+  if (argc == 1) PrintHelpAndExit (0) ;
+
+  for (argc--, argv++ ; argc ; argc--, argv++)
+    {
+    if (argv[0][0] != '-') printf ("Invalid parameter \"%s\"\n", argv[0]), PrintHelpAndExit (1) ;
+    switch (toupper (argv[0][1]))
+      {
+      case 'A':
+      case 'B':
+        if (argv[0][2] == 0) printf ("%s: filename expected\n", argv[0]), PrintHelpAndExit (1) ;
+        InputFilename[toupper (argv[0][1]) - 'A'] = std::string (&argv[0][2]) ;
+        break ;
+
+      case 'O':
+        if (argv[0][2] == 0) printf ("%s: filename expected\n", argv[0]), PrintHelpAndExit (1) ;
+        OutputFilename = std::string (&argv[0][2]) ;
+        break ;
+
+      case 'P':
+        if (strcasecmp (&argv[0][2], "union") == 0) Op = SetOperation::Union ;
+        else if (strcasecmp (&argv[0][2], "intersection") == 0) Op = SetOperation::Intersection ;
+        else if (strcasecmp (&argv[0][2], "difference") == 0) Op = SetOperation::Difference ;
+        else printf ("%s: union, intersection or difference expected\n", argv[0]), PrintHelpAndExit (1) ;
+        OpPresent = true ;
+        break ;
+
+      case 'W':
+        Version = CommonParams::ParseInt (argv[0], &argv[0][2]) ;
+        if (Version < 1 || Version > COMPRESSED_UMF_VERSION) printf ("Invalid version %d\n", Version), exit (1) ;
+        break ;
+
+      default:
+        printf ("Invalid parameter \"%s\"\n", argv[0]) ;
+        PrintHelpAndExit (1) ;
+      }
+    }
+
+  if (InputFilename[0].empty() || InputFilename[1].empty())
+    printf ("Two input files expected\n"), PrintHelpAndExit (1) ;
+  if (OutputFilename.empty()) printf ("Output file not specified\n"), PrintHelpAndExit (1) ;
+  if (!OpPresent) printf ("Operation not specified\n"), PrintHelpAndExit (1) ;
+  }
+
+void CommandLineParams::PrintHelpAndExit (int status)
+  {
+  printf (R"*RAW*(CombineUmf <param> <param>...
+  <param>: -A<umf file>          First umf (version 1, 2 or 3)
+           -B<umf file>          Second umf (version 1, 2 or 3)
+           -P<operation>         union, intersection or difference (A minus B)
+           -O<output file>       Output umf
+           -W<version>           Version of output file (1, 2 or 3, default 3)
+)*RAW*") ;
+  exit (status) ;
+  }
@@ -0,0 +1,4 @@
+g++ -std=c++20 -Wall -O3 -oConvertFiles ConvertFiles.cpp ../Params.obj ../Reader.obj ../CompressedUmf.obj ../Enumerator.obj ../DvfIndex.obj ../MappedFile.obj ../CompactDvf.obj ../TuringMachine.obj
+g++ -std=c++20 -Wall -O3 -oCombineUmf CombineUmf.cpp ../Params.obj ../Reader.obj ../CompressedUmf.obj ../Enumerator.obj ../DvfIndex.obj ../MappedFile.obj ../CompactDvf.obj ../TuringMachine.obj
+g++ -std=c++20 -Wall -O3 -oConvertDatabase ConvertDatabase.cpp ../Params.obj ../Reader.obj ../CompressedUmf.obj ../Enumerator.obj ../DvfIndex.obj ../MappedFile.obj ../CompactDvf.obj ../TuringMachine.obj
+g++ -std=c++20 -Wall -O3 -oMergeFiles MergeFiles.cpp ../Params.obj ../Reader.obj ../CompressedUmf.obj ../Enumerator.obj ../DvfIndex.obj ../MappedFile.obj ../CompactDvf.obj ../TuringMachine.obj
\ No newline at end of file
@@ -0,0 +1,202 @@
+// ConvertDatabase <param> <param>...
+//   <param>: -N<states>            Machine states (2, 3, 4, 5, or 6)
+//            -D<database>          Seed database file (defaults to ../SeedDatabase.bin)
+//            -O<output file>       Packed database file
+//
+// Converts a seed database to a packed database (see ../Reader.h), which the
+// Deciders and Verifiers read in place of the original; the machines keep their
+// indices, so umf and dvf files can be used with either.
+//
+// The input can be SeedDatabase.bin (with -N5), a text file of compact machine
+// specs, or another packed database. Lines of a text file can end in LF or CR/LF,
+// and need not all be the same length (although each must hold a complete spec).
+// Every spec is checked as it is converted, so the Reader doesn't check them again.
+// The time-limited/space-limited split of SeedDatabase.bin is kept.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <inttypes.h> // for PRIu64
+#include <string>
+
+#include "../Params.h"
+
+class CommandLineParams : public DeciderParams
+  {
+public:
+  std::string OutputFilename ;
+  void Parse (int argc, char** argv) ;
+  void PrintHelpAndExit [[noreturn]] (int status) ;
+  } ;
+
+static CommandLineParams Params ;
+static TuringMachineReader Reader ;
+
+static uint64_t ConvertText (FILE* fpOut) ;
+static uint64_t ConvertBinary (FILE* fpOut) ;
+static void WriteHeader (FILE* fpOut, uint32_t Flags, uint64_t nMachines,
+  uint32_t nTimeLimited, uint32_t nSpaceLimited) ;
+static void PrintProgress (uint64_t Done, uint64_t Total) ;
+
+int main (int argc, char** argv)
+  {
+  Params.Parse (argc, argv) ;
+  Params.CheckParameters() ;
+  Params.OpenFiles() ;
+  if (TNFEnumerator::IsEnumeration (Params.DatabaseFilename))
+    printf ("An enumeration can't be converted to a packed database\n"), exit (1) ;
+
+  FILE* fpOut = CommonParams::OpenFile (Params.OutputFilename, "wb") ;
+
+  clock_t Timer = clock() ;
+
+  // The Reader can read the 5-state binary database and packed databases directly,
+  // but it needs text lines of a fixed length, so we read those ourselves
+  uint32_t Magic = 0 ;
+  if (Params.fpDatabase)
+    {
+    uint8_t Buffer[4] ;
+    if (fread (Buffer, 1, 4, Params.fpDatabase) == 4) Magic = Load32 (Buffer) ;
+    rewind (Params.fpDatabase) ;
+    }
+
+  uint64_t nMachines ;
+  if (Params.BinaryMachineSpecs || Magic == PACKED_DATABASE_MAGIC)
+    nMachines = ConvertBinary (fpOut) ;
+  else nMachines = ConvertText (fpOut) ;
+
+  fclose (fpOut) ;
+
+  Timer = clock() - Timer ;
+
+  printf ("\r%" PRIu64 " %d-state machines written to %s\n", nMachines,
+    Params.MachineStates, Params.OutputFilename.c_str()) ;
+  printf ("Elapsed time %.3f\n", (double)Timer / CLOCKS_PER_SEC) ;
+  }
+
+static uint64_t ConvertBinary (FILE* fpOut)
+  {
+  Reader.SetParams (&Params) ;
+
+  uint32_t Flags = PACKED_DATABASE_VALIDATED ;
+  if (Reader.OrigSeedDatabase) Flags |= PACKED_DATABASE_TIME_LIMITED ;
+  else Reader.nTimeLimited = Reader.nSpaceLimited = 0 ;
+  WriteHeader (fpOut, Flags, Reader.MachinesInDatabase, Reader.nTimeLimited, Reader.nSpaceLimited) ;
+
+  uint8_t MachineSpec[MAX_MACHINE_SPEC_SIZE] ;
+  uint8_t Packed[2 * MAX_MACHINE_STATES] ;
+  for (uint64_t i = 0 ; i < Reader.MachinesInDatabase ; i++)
+    {
+    Reader.Read (i, MachineSpec) ; // Checks the spec
+    TuringMachineReader::PackMachineSpec (Packed, MachineSpec, Params.MachineStates) ;
+    Write (fpOut, Packed, 2 * Params.MachineStates) ;
+    PrintProgress (i + 1, Reader.MachinesInDatabase) ;
+    }
+
+  return Reader.MachinesInDatabase ;
+  }
+
+static uint64_t ConvertText (FILE* fpOut)
+  {
+  if (Params.fpDatabase == nullptr) printf ("Database file not specified\n"), exit (1) ;
+
+  // Write a dummy header, and fill in the number of machines at the end
+  WriteHeader (fpOut, PACKED_DATABASE_VALIDATED, 0, 0, 0) ;
+
+  if (fseeko64 (Params.fpDatabase, 0, SEEK_END)) printf ("fseek failed\n"), exit (1) ;
+  uint64_t FileSize = ftello64 (Params.fpDatabase) ;
+  rewind (Params.fpDatabase) ;
+
+  uint32_t SpecLength = 7 * Params.MachineStates - 1 ;
+  uint8_t MachineSpec[MAX_MACHINE_SPEC_SIZE] ;
+  uint8_t Packed[2 * MAX_MACHINE_STATES] ;
+  char Line[256] ;
+  uint64_t nMachines = 0 ;
+  uint64_t LineNumber = 0 ;
+  while (fgets (Line, sizeof (Line), Params.fpDatabase))
+    {
+    LineNumber++ ;
+    size_t Length = strlen (Line) ;
+    while (Length && isspace (Line[Length - 1])) Length-- ;
+    if (Length == 0) continue ;
+    if (Length != SpecLength)
+      printf ("\nInvalid machine spec at line %" PRIu64 "\n", LineNumber), exit (1) ;
+
+    TuringMachineReader::ConvertToBinary (MachineSpec, (const uint8_t*)Line, Params.MachineStates) ;
+    TuringMachineReader::CheckMachineSpec (MachineSpec, Params.MachineStates) ;
+    TuringMachineReader::PackMachineSpec (Packed, MachineSpec, Params.MachineStates) ;
+    Write (fpOut, Packed, 2 * Params.MachineStates) ;
+    nMachines++ ;
+    PrintProgress (ftello64 (Params.fpDatabase), FileSize) ;
+    }
+
+  if (fseek (fpOut, 0, SEEK_SET)) printf ("\nfseek failed\n"), exit (1) ;
+  WriteHeader (fpOut, PACKED_DATABASE_VALIDATED, nMachines, 0, 0) ;
+
+  return nMachines ;
+  }
+
+static void WriteHeader (FILE* fpOut, uint32_t Flags, uint64_t nMachines,
+  uint32_t nTimeLimited, uint32_t nSpaceLimited)
+  {
+  Write32 (fpOut, PACKED_DATABASE_MAGIC) ;
+  Write32 (fpOut, PACKED_DATABASE_VERSION) ;
+  Write32 (fpOut, Params.MachineStates) ;
+  Write32 (fpOut, Flags) ;
+  Write64 (fpOut, nMachines) ;
+  Write32 (fpOut, nTimeLimited) ;
+  Write32 (fpOut, nSpaceLimited) ;
+  }
+
+static void PrintProgress (uint64_t Done, uint64_t Total)
+  {
+  static int LastPercent = -1 ;
+  int Percent = Total ? (Done * 100) / Total : 100 ;
+  if (Percent != LastPercent)
+    {
+    printf ("\r%d%%", Percent) ;
+    fflush (stdout) ;
+    LastPercent = Percent ;
+    }
+  }
+
+void CommandLineParams::Parse (int argc, char** argv)
+  {
+  if (argc == 1) PrintHelpAndExit (0) ;
+
+  for (argc--, argv++ ; argc ; argc--, argv++)
+    {
+    if (argv[0][0] != '-') printf ("Invalid parameter \"%s\"\n", argv[0]), PrintHelpAndExit (1) ;
+    switch (toupper (argv[0][1]))
+      {
+      case 'N':
+      case 'D':
+        CommonParams::ParseParam (argv[0]) ;
+        break ;
+
+      case 'O':
+        if (argv[0][2] == 0) printf ("%s: filename expected\n", argv[0]), PrintHelpAndExit (1) ;
+        OutputFilename = std::string (&argv[0][2]) ;
+        break ;
+
+      default:
+        printf ("Invalid parameter \"%s\"\n", argv[0]) ;
+        PrintHelpAndExit (1) ;
+      }
+    }
+
+  if (OutputFilename.empty()) printf ("Output file not specified\n"), PrintHelpAndExit (1) ;
+  }
+
+void CommandLineParams::PrintHelpAndExit (int status)
+  {
+  printf (R"*RAW*(ConvertDatabase <param> <param>...
+  <param>: -N<states>            Machine states (2, 3, 4, 5, or 6)
+           -D<database>          Seed database file (defaults to ../SeedDatabase.bin)
+           -O<output file>       Packed database file
+)*RAW*") ;
+  exit (status) ;
+  }
@@ -0,0 +1,252 @@
+// ConvertFiles <param> <param>...
+//   <param>: -I<input file>        umf or dvf file to be converted (version 1, 2, 3 or 4)
+//            -O<output file>       Output file
+//            -W<version>           Version of output file (1, 2, 3 or 4, default 2)
+//            -T<type>              File type: umf or dvf (default=from input file extension)
+//            -XI                   Write a dvf index along with an output dvf (see ../DvfIndex.h)
+//
+// Converts a list of machines (umf) or a verification file (dvf) from one version
+// to the other (see ../Reader.h). The version of the input file is detected
+// automatically. Version 2 files have 64-bit machine indices and counts, so they
+// can hold machines from a database of any size; a file can only be converted to
+// version 1 if all its machine indices fit in 32 bits. Version 3 is a compressed umf
+// (see ../CompressedUmf.h), and version 4 a compact dvf (see ../CompactDvf.h); there
+// is no version 3 dvf or version 4 umf.
+//
+// The Verification Info of each entry is copied unchanged (or coded and expanded
+// without loss, for a compact dvf), so converting a file and converting it back
+// gives the original file. With -XI, a dvf index (see ../DvfIndex.h) is written
+// along with an output dvf, so converting a dvf to its own version is a way of
+// indexing a dvf that doesn't have one.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <inttypes.h> // for PRIu64
+#include <string>
+
+#include "../Params.h"
+
+class CommandLineParams
+  {
+public:
+  std::string InputFilename ;
+  std::string OutputFilename ;
+  uint32_t Version = 2 ;
+  bool Verification ; bool TypePresent = false ;
+  bool WriteDvfIndex = false ;
+  void Parse (int argc, char** argv) ;
+  void PrintHelpAndExit [[noreturn]] (int status) ;
+  } ;
+
+static CommandLineParams Params ;
+
+static void ConvertUndecided (FILE* fpIn, uint32_t InputVersion, FILE* fpOut) ;
+static void ConvertVerification (FILE* fpIn, uint32_t InputVersion, FILE* fpOut) ;
+static void WriteIndex (FILE* fpOut, uint64_t MachineIndex) ;
+
+static uint64_t nEntries ;
+static CompressedUmfWriter Writer ;
+
+int main (int argc, char** argv)
+  {
+  Params.Parse (argc, argv) ;
+
+  FILE* fpIn = CommonParams::OpenFile (Params.InputFilename, "rb") ;
+  if (fseeko64 (fpIn, 0, SEEK_END)) printf ("fseek failed\n"), exit (1) ;
+  uint64_t FileSize = ftello64 (fpIn) ;
+  if (fseeko64 (fpIn, 0, SEEK_SET)) printf ("fseek failed\n"), exit (1) ;
+
+  uint32_t InputVersion = FileSize ? TuringMachineReader::ReadFileVersion (fpIn) : 1 ;
+  printf ("%s is a version %d %s file\n", Params.InputFilename.c_str(), InputVersion,
+    Params.Verification ? "dvf" : "umf") ;
+
+  if (Params.Verification && (InputVersion == COMPRESSED_UMF_VERSION || Params.Version == COMPRESSED_UMF_VERSION))
+    printf ("There is no compressed dvf format\n"), exit (1) ;
+  if (!Params.Verification && (InputVersion == COMPACT_DVF_VERSION || Params.Version == COMPACT_DVF_VERSION))
+    printf ("There is no compact umf format\n"), exit (1) ;
+
+  FILE* fpOut = CommonParams::OpenFile (Params.OutputFilename, "wb") ;
+  if (Params.Version == COMPRESSED_UMF_VERSION) Writer.Open (fpOut) ;
+  else TuringMachineReader::WriteFileVersion (fpOut, Params.Version) ;
+
+  clock_t Timer = clock() ;
+
+  if (Params.Verification) ConvertVerification (fpIn, InputVersion, fpOut) ;
+  else ConvertUndecided (fpIn, InputVersion, fpOut) ;
+  if (Params.Version == COMPRESSED_UMF_VERSION) Writer.Flush() ;
+
+  fclose (fpIn) ;
+  fclose (fpOut) ;
+
+  Timer = clock() - Timer ;
+
+  printf ("\r%" PRIu64 " %s written to version %d file %s\n", nEntries,
+    Params.Verification ? "entries" : "machines", Params.Version, Params.OutputFilename.c_str()) ;
+  printf ("Elapsed time %.3f\n", (double)Timer / CLOCKS_PER_SEC) ;
+  }
+
+static void ConvertUndecided (FILE* fpIn, uint32_t InputVersion, FILE* fpOut)
+  {
+  CompressedUmfReader Reader ;
+  Reader.Open (fpIn, InputVersion) ;
+  nEntries = Reader.nIndices ;
+
+  int LastPercent = -1 ;
+  for (uint64_t Entry = 0 ; Entry < nEntries ; Entry++)
+    {
+    WriteIndex (fpOut, Reader.Next()) ;
+
+    int Percent = ((Entry + 1) * 100) / nEntries ;
+    if (Percent != LastPercent)
+      {
+      printf ("\r%d%%", Percent) ;
+      fflush (stdout) ;
+      LastPercent = Percent ;
+      }
+    }
+  }
+
+static void ConvertVerification (FILE* fpIn, uint32_t InputVersion, FILE* fpOut)
+  {
+  nEntries = InputVersion == 1 ? Read32 (fpIn) : Read64 (fpIn) ;
+  if (Params.Version == 1)
+    {
+    if (nEntries >= FILE_VERSION_MARK)
+      printf ("Too many entries for a version 1 file\n"), exit (1) ;
+    Write32 (fpOut, nEntries) ;
+    }
+  else Write64 (fpOut, nEntries) ;
+
+  // The offsets of the entries change with the version, so the output file gets
+  // its own dvf index
+  DvfIndexWriter Index ;
+  if (Params.WriteDvfIndex)
+    Index.Open (CommonParams::OpenFile (DvfIndex::IndexFilename (Params.OutputFilename), "w+b")) ;
+
+  CompactDvfReader CompactReader ;
+  CompactDvfWriter CompactWriter ;
+  ustring VerificationInfo ;
+  int LastPercent = -1 ;
+  for (uint64_t Entry = 0 ; Entry < nEntries ; Entry++)
+    {
+    uint64_t MachineIndex ;
+    DeciderTag Tag ;
+    ByteReader Info ;
+    if (InputVersion == COMPACT_DVF_VERSION)
+      {
+      CompactReader.ReadEntry (fpIn) ;
+      MachineIndex = CompactReader.MachineIndex ;
+      Tag = CompactReader.Tag ;
+      Info = CompactReader.Info() ;
+      }
+    else
+      {
+      MachineIndex = TuringMachineReader::ReadIndex (fpIn, InputVersion) ;
+      Tag = DeciderTag (Read32 (fpIn)) ;
+      VerificationInfo.resize (Read32 (fpIn)) ;
+      Read (fpIn, VerificationInfo.data(), VerificationInfo.length()) ;
+      Info = ByteReader (VerificationInfo) ;
+      }
+    ustring_view InfoBytes = Info.Bytes (Info.Remaining()) ;
+
+    if (Index.IsOpen()) Index.Add (MachineIndex, ftello64 (fpOut)) ;
+    if (Params.Version == COMPACT_DVF_VERSION) CompactWriter.Write (fpOut, MachineIndex, Tag, InfoBytes) ;
+    else
+      {
+      WriteIndex (fpOut, MachineIndex) ;
+      Write32 (fpOut, (uint32_t)Tag) ;
+      Write32 (fpOut, InfoBytes.length()) ;
+      Write (fpOut, InfoBytes.data(), InfoBytes.length()) ;
+      }
+
+    int Percent = ((Entry + 1) * 100) / nEntries ;
+    if (Percent != LastPercent)
+      {
+      printf ("\r%d%%", Percent) ;
+      fflush (stdout) ;
+      LastPercent = Percent ;
+      }
+    }
+
+  if (!CheckEndOfFile (fpIn)) printf ("\nInput file too long!\n"), exit (1) ;
+  if (Index.IsOpen()) Index.Close (ftello64 (fpOut)) ;
+  }
+
+static void WriteIndex (FILE* fpOut, uint64_t MachineIndex)
+  {
+  if (Params.Version == 1 && MachineIndex >= FILE_VERSION_MARK)
+    printf ("\nMachine index %" PRIu64 " is too large for a version 1 file\n", MachineIndex), exit (1) ;
+  if (Params.Version == COMPRESSED_UMF_VERSION) Writer.Add (MachineIndex) ;
+  else TuringMachineReader::WriteIndex (fpOut, Params.Version, MachineIndex) ;
+  }
+
+void CommandLineParams::Parse (int argc, char** argv)
+  {
+  if (argc == 1) PrintHelpAndExit (0) ;
+
+  for (argc--, argv++ ; argc ; argc--, argv++)
+    {
+    if (argv[0][0] != '-') printf ("Invalid parameter \"%s\"\n", argv[0]), PrintHelpAndExit (1) ;
+    switch (toupper (argv[0][1]))
+      {
+      case 'I':
+        if (argv[0][2] == 0) printf ("%s: filename expected\n", argv[0]), PrintHelpAndExit (1) ;
+        InputFilename = std::string (&argv[0][2]) ;
+        break ;
+
+      case 'O':
+        if (argv[0][2] == 0) printf ("%s: filename expected\n", argv[0]), PrintHelpAndExit (1) ;
+        OutputFilename = std::string (&argv[0][2]) ;
+        break ;
+
+      case 'W':
+        Version = CommonParams::ParseInt (argv[0], &argv[0][2]) ;
+        if (Version < 1 || Version > COMPACT_DVF_VERSION) printf ("Invalid version %d\n", Version), exit (1) ;
+        break ;
+
+      case 'T':
+        if (strcasecmp (&argv[0][2], "umf") == 0) Verification = false ;
+        else if (strcasecmp (&argv[0][2], "dvf") == 0) Verification = true ;
+        else printf ("%s: umf or dvf expected\n", argv[0]), PrintHelpAndExit (1) ;
+        TypePresent = true ;
+        break ;
+
+      case 'X':
+        if (toupper (argv[0][2]) != 'I' || argv[0][3] != 0)
+          printf ("Invalid parameter \"%s\"\n", argv[0]), PrintHelpAndExit (1) ;
+        WriteDvfIndex = true ;
+        break ;
+
+      default:
+        printf ("Invalid parameter \"%s\"\n", argv[0]) ;
+        PrintHelpAndExit (1) ;
+      }
+    }
+
+  if (InputFilename.empty()) printf ("Input file not specified\n"), PrintHelpAndExit (1) ;
+  if (OutputFilename.empty()) printf ("Output file not specified\n"), PrintHelpAndExit (1) ;
+  if (!TypePresent)
+    {
+    size_t Dot = InputFilename.rfind ('.') ;
+    std::string Extension = Dot == std::string::npos ? "" : InputFilename.substr (Dot + 1) ;
+    if (strcasecmp (Extension.c_str(), "umf") == 0) Verification = false ;
+    else if (strcasecmp (Extension.c_str(), "dvf") == 0) Verification = true ;
+    else printf ("Can't tell the file type of %s: use -T\n", InputFilename.c_str()), exit (1) ;
+    }
+  }
+
+void CommandLineParams::PrintHelpAndExit (int status)
+  {
+  printf (R"*RAW*(ConvertFiles <param> <param>...
+  <param>: -I<input file>        umf or dvf file to be converted (version 1, 2, 3 or 4)
+           -O<output file>       Output file
+           -W<version>           Version of output file (1, 2, 3 or 4, default 2)
+           -T<type>              File type: umf or dvf (default=from input file extension)
+           -XI                   Write a dvf index along with an output dvf (see ../DvfIndex.h)
+)*RAW*") ;
+  exit (status) ;
+  }
@@ -0,0 +1,275 @@
+// MergeFiles <param> <param>...
+//   <param>: -I<input file>        umf or dvf file from one shard (repeat for each shard,
+//                                  in range order)
+//            -O<output file>       Merged file
+//            -T<type>              File type: umf or dvf (default=from input file extension)
+//            -XI                   Write a dvf index along with an output dvf (see ../DvfIndex.h)
+//
+// Merges the umfs or dvfs written by a Decider run on separate ranges of the same
+// input file or database (-R<start>:<end>; see ../Reader.h) into the file that a
+// single run would have written. A Decider writes the machines of its range in the
+// order in which it reads them, so the files are concatenated, entry by entry, in
+// the order in which they are given, which must be the order of their ranges (as
+// in the Coordinator). The dvf header is rewritten with the total number of
+// entries, and with -XI a dvf index is written for the merged dvf.
+//
+// The machine indices of a database are in increasing order, but those of an
+// enumeration (-DTNF; see ../Enumerator.h) are packed machine specs, in the order
+// of the TNF walk, so the order of the merged file can't be checked; if it isn't
+// increasing, MergeFiles warns that the files may have been given out of order.
+//
+// The input files must all have the same version, which is also the version of the
+// output file; a compressed umf is merged into a compressed umf, and a compact dvf
+// into a compact dvf (see ../CompactDvf.h), re-coding only the machine index of each
+// entry.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <inttypes.h> // for PRIu64
+#include <string>
+#include <vector>
+
+#include "../Params.h"
+
+class CommandLineParams
+  {
+public:
+  std::vector<std::string> InputFilenames ;
+  std::string OutputFilename ;
+  bool Verification ; bool TypePresent = false ;
+  bool WriteDvfIndex = false ;
+  void Parse (int argc, char** argv) ;
+  void PrintHelpAndExit [[noreturn]] (int status) ;
+  } ;
+
+static CommandLineParams Params ;
+
+// The current entry of each input file
+struct Shard
+  {
+  FILE* fp ;
+  uint64_t nEntries ;
+  uint64_t EntriesRead ;
+  CompressedUmfReader UmfReader ; // umf only
+  uint64_t MachineIndex ;         // Of the current entry
+  uint32_t DeciderTag ;           // dvf only
+  ustring VerificationInfo ;
+  CompactDvfReader DvfReader ;    // Compact dvf only
+  } ;
+
+static uint32_t OpenShards (std::vector<Shard>& ShardList) ;
+static bool NextEntry (Shard& S, uint32_t Version) ;
+
+static uint64_t nEntries ;
+
+int main (int argc, char** argv)
+  {
+  Params.Parse (argc, argv) ;
+
+  std::vector<Shard> ShardList (Params.InputFilenames.size()) ;
+  uint32_t Version = OpenShards (ShardList) ;
+
+  FILE* fpOut = CommonParams::OpenFile (Params.OutputFilename, "wb") ;
+  CompressedUmfWriter Writer ;
+  CompactDvfWriter DvfWriter ;
+  if (Version == COMPRESSED_UMF_VERSION) Writer.Open (fpOut) ;
+  else TuringMachineReader::WriteFileVersion (fpOut, Version) ;
+
+  // The merged dvf gets its own dvf index (see ../DvfIndex.h)
+  DvfIndexWriter Index ;
+  uint64_t nOutput = 0 ;
+  if (Params.Verification)
+    {
+    if (Params.WriteDvfIndex)
+      Index.Open (CommonParams::OpenFile (DvfIndex::IndexFilename (Params.OutputFilename), "w+b")) ;
+    for (const Shard& S : ShardList) nOutput += S.nEntries ;
+    if (Version == 1) Write32 (fpOut, nOutput) ;
+    else Write64 (fpOut, nOutput) ;
+    }
+  else for (const Shard& S : ShardList) nOutput += S.UmfReader.nIndices ;
+
+  clock_t Timer = clock() ;
+
+  int LastPercent = -1 ;
+  uint64_t LastIndex = 0 ;
+  bool Increasing = true ;
+  for (Shard& S : ShardList) while (NextEntry (S, Version))
+    {
+    if (nEntries && S.MachineIndex <= LastIndex) Increasing = false ;
+    LastIndex = S.MachineIndex ;
+
+    if (Params.Verification)
+      {
+      if (Index.IsOpen()) Index.Add (S.MachineIndex, ftello64 (fpOut)) ;
+      if (Version == COMPACT_DVF_VERSION) DvfWriter.Copy (fpOut, S.DvfReader) ;
+      else
+        {
+        TuringMachineReader::WriteIndex (fpOut, Version, S.MachineIndex) ;
+        Write32 (fpOut, S.DeciderTag) ;
+        Write32 (fpOut, S.VerificationInfo.length()) ;
+        Write (fpOut, S.VerificationInfo.data(), S.VerificationInfo.length()) ;
+        }
+      }
+    else if (Version == COMPRESSED_UMF_VERSION) Writer.Add (S.MachineIndex) ;
+    else TuringMachineReader::WriteIndex (fpOut, Version, S.MachineIndex) ;
+    nEntries++ ;
+
+    int Percent = (nEntries * 100) / nOutput ;
+    if (Percent != LastPercent)
+      {
+      printf ("\r%d%%", Percent) ;
+      fflush (stdout) ;
+      LastPercent = Percent ;
+      }
+    }
+
+  if (Version == COMPRESSED_UMF_VERSION) Writer.Flush() ;
+  for (Shard& S : ShardList)
+    {
+    if (Params.Verification && !CheckEndOfFile (S.fp)) printf ("\nInput file too long!\n"), exit (1) ;
+    fclose (S.fp) ;
+    }
+  if (Index.IsOpen()) Index.Close (ftello64 (fpOut)) ;
+  fclose (fpOut) ;
+
+  Timer = clock() - Timer ;
+
+  printf ("\r%" PRIu64 " %s from %d files written to version %d file %s\n", nEntries,
+    Params.Verification ? "entries" : "machines", (int)ShardList.size(), Version,
+    Params.OutputFilename.c_str()) ;
+  if (!Increasing)
+    printf ("Warning: machine indices not in increasing order. That is expected for an\n"
+            "enumeration (-DTNF); otherwise, check that the files were given in range order\n") ;
+  printf ("Elapsed time %.3f\n", (double)Timer / CLOCKS_PER_SEC) ;
+  }
+
+// static uint32_t OpenShards (std::vector<Shard>& ShardList)
+//
+// Opens the input files, reads their headers, and returns their version
+
+static uint32_t OpenShards (std::vector<Shard>& ShardList)
+  {
+  uint32_t Version = 0 ;
+  for (uint32_t i = 0 ; i < ShardList.size() ; i++)
+    {
+    Shard& S = ShardList[i] ;
+    const char* Filename = Params.InputFilenames[i].c_str() ;
+    S.fp = CommonParams::OpenFile (Params.InputFilenames[i], "rb") ;
+    if (fseeko64 (S.fp, 0, SEEK_END)) printf ("fseek failed\n"), exit (1) ;
+    uint64_t FileSize = ftello64 (S.fp) ;
+    if (fseeko64 (S.fp, 0, SEEK_SET)) printf ("fseek failed\n"), exit (1) ;
+
+    uint32_t FileVersion = FileSize ? TuringMachineReader::ReadFileVersion (S.fp) : 1 ;
+    if (i && FileVersion != Version)
+      printf ("%s is a version %d file, but %s is version %d\n", Filename, FileVersion,
+        Params.InputFilenames[0].c_str(), Version), exit (1) ;
+    Version = FileVersion ;
+
+    if (Params.Verification)
+      {
+      if (Version == COMPRESSED_UMF_VERSION) printf ("%s is a compressed umf\n", Filename), exit (1) ;
+      S.nEntries = TuringMachineReader::ReadIndex (S.fp, Version) ; // Same size as an index
+      }
+    else
+      {
+      if (Version == COMPACT_DVF_VERSION) printf ("%s is a compact dvf\n", Filename), exit (1) ;
+      S.UmfReader.Open (S.fp, Version) ;
+      S.nEntries = S.UmfReader.nIndices ;
+      }
+    S.EntriesRead = 0 ;
+    printf ("%s: version %d, %" PRIu64 " %s\n", Filename, Version, S.nEntries,
+      Params.Verification ? "entries" : "machines") ;
+    }
+  return Version ;
+  }
+
+static bool NextEntry (Shard& S, uint32_t Version)
+  {
+  if (S.EntriesRead == S.nEntries) return false ;
+  S.EntriesRead++ ;
+  if (!Params.Verification)
+    {
+    S.MachineIndex = S.UmfReader.Next() ;
+    return true ;
+    }
+
+  if (Version == COMPACT_DVF_VERSION)
+    {
+    S.DvfReader.ReadEntry (S.fp) ;
+    S.MachineIndex = S.DvfReader.MachineIndex ;
+    return true ;
+    }
+
+  S.MachineIndex = TuringMachineReader::ReadIndex (S.fp, Version) ;
+  S.DeciderTag = Read32 (S.fp) ;
+  S.VerificationInfo.resize (Read32 (S.fp)) ;
+  Read (S.fp, S.VerificationInfo.data(), S.VerificationInfo.length()) ;
+  return true ;
+  }
+
+void CommandLineParams::Parse (int argc, char** argv)
+  {
+  if (argc == 1) PrintHelpAndExit (0) ;
+
+  for (argc--, argv++ ; argc ; argc--, argv++)
+    {
+    if (argv[0][0] != '-') printf ("Invalid parameter \"%s\"\n", argv[0]), PrintHelpAndExit (1) ;
+    switch (toupper (argv[0][1]))
+      {
+      case 'I':
+        if (argv[0][2] == 0) printf ("%s: filename expected\n", argv[0]), PrintHelpAndExit (1) ;
+        InputFilenames.push_back (std::string (&argv[0][2])) ;
+        break ;
+
+      case 'O':
+        if (argv[0][2] == 0) printf ("%s: filename expected\n", argv[0]), PrintHelpAndExit (1) ;
+        OutputFilename = std::string (&argv[0][2]) ;
+        break ;
+
+      case 'T':
+        if (strcasecmp (&argv[0][2], "umf") == 0) Verification = false ;
+        else if (strcasecmp (&argv[0][2], "dvf") == 0) Verification = true ;
+        else printf ("%s: umf or dvf expected\n", argv[0]), PrintHelpAndExit (1) ;
+        TypePresent = true ;
+        break ;
+
+      case 'X':
+        if (toupper (argv[0][2]) != 'I' || argv[0][3] != 0)
+          printf ("Invalid parameter \"%s\"\n", argv[0]), PrintHelpAndExit (1) ;
+        WriteDvfIndex = true ;
+        break ;
+
+      default:
+        printf ("Invalid parameter \"%s\"\n", argv[0]) ;
+        PrintHelpAndExit (1) ;
+      }
+    }
+
+  if (InputFilenames.empty()) printf ("Input files not specified\n"), PrintHelpAndExit (1) ;
+  if (OutputFilename.empty()) printf ("Output file not specified\n"), PrintHelpAndExit (1) ;
+  if (!TypePresent)
+    {
+    const std::string& Filename = InputFilenames[0] ;
+    size_t Dot = Filename.rfind ('.') ;
+    std::string Extension = Dot == std::string::npos ? "" : Filename.substr (Dot + 1) ;
+    if (strcasecmp (Extension.c_str(), "umf") == 0) Verification = false ;
+    else if (strcasecmp (Extension.c_str(), "dvf") == 0) Verification = true ;
+    else printf ("Can't tell the file type of %s: use -T\n", Filename.c_str()), exit (1) ;
+    }
+  }
+
+void CommandLineParams::PrintHelpAndExit (int status)
+  {
+  printf (R"*RAW*(MergeFiles <param> <param>...
+  <param>: -I<input file>        umf or dvf file from one shard (repeat for each shard,
+                                 in range order)
+           -O<output file>       Merged file
+           -T<type>              File type: umf or dvf (default=from input file extension)
+           -XI                   Write a dvf index along with an output dvf (see ../DvfIndex.h)
+)*RAW*") ;
+  exit (status) ;
+  }
@@ -0,0 +1,417 @@
+// Coordinator <param> <param>... -- <decider> <decider param>...
+//   <param>: -W<workers>           Worker processes to run at once (default=number of processors)
+//            -B<range size>        Machines in each range (default 100000)
+//            -S<spool directory>   Directory for the files of each range (default Spool)
+//            -A<attempts>          Max attempts at each range (default 3)
+//            -V<verification file> Output file: verification data for decided machines
+//            -U<undecided file>    Output file: remaining undecided machines
+//
+// Runs a Decider in many processes. The machines (of the Decider's input file, or
+// of its database or enumeration) are split into ranges of <range size>, and each
+// range is run by a worker process: the Decider command line given after "--", with
+// -R<start>:<end> and its own umf and dvf in the spool directory added. A range
+// whose worker fails (or is killed) is run again, up to <attempts> times in all.
+//
+// As soon as a range and all the ranges before it have finished, its umf and dvf
+// are appended to the output files and deleted, so the output files grow as the
+// run goes on, and end up the same, byte for byte, as those of a single run of the
+// Decider. The ranges are handed out in order, so only a few of them are ever
+// waiting to be merged. If the Decider parameters include -XI, the dvf index of
+// the output dvf (see ../DvfIndex.h) is put together from those of the ranges. The
+// entries of a compact dvf (see ../CompactDvf.h) are copied one at a time instead,
+// since the first machine index of each range is coded relative to the last one of
+// the range before it.
+//
+// The Coordinator reads the Decider's -N, -D, -I, -G and -XI parameters to count
+// the machines and find the versions of its output files, in the same way as the
+// Decider itself (see ../Reader.h). The Decider parameters can't include -U, -V,
+// -R, -L, -X or -M, which would clash with the ranges; and any other files they
+// name (such as cost hint files) are shared by all the workers, so they should
+// only be read, not written.
+//
+// A worker is started with the system() function, so the Decider command line can
+// start with anything that runs a command elsewhere (such as ssh), as long as the
+// spool directory is shared. Each worker's output goes to range<n>.log in the
+// spool directory.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <inttypes.h> // for PRIu64
+#include <string>
+#include <vector>
+#include <deque>
+#include <filesystem>
+
+#include "../Params.h"
+
+#if NEED_BOOST_THREADS
+  #include <boost/thread.hpp>
+  #include <boost/thread/mutex.hpp>
+  #include <boost/thread/lock_guard.hpp>
+  using boost::thread ;
+  using boost::mutex ;
+  using boost::lock_guard ;
+#else
+  #include <thread>
+  #include <mutex>
+  using std::thread ;
+  using std::mutex ;
+  using std::lock_guard ;
+#endif
+
+class CommandLineParams : public DeciderParams
+  {
+public:
+  uint32_t nWorkers ;      bool nWorkersPresent = false ;
+  uint64_t RangeSize = 100000 ;
+  std::string SpoolDirectory = "Spool" ;
+  uint32_t MaxAttempts = 3 ;
+  std::string MergedVerificationFilename ;
+  std::string MergedUndecidedFilename ;
+  std::vector<std::string> DeciderCommand ;
+  void Parse (int argc, char** argv) ;
+  void PrintHelpAndExit [[noreturn]] (int status) ;
+  } ;
+
+static CommandLineParams Params ;
+static TuringMachineReader Reader ;
+
+struct Range
+  {
+  uint64_t Start ;
+  uint64_t End ;
+  uint32_t Attempts = 0 ;
+  bool Done = false ;
+  } ;
+
+static std::vector<Range> RangeList ;
+static std::deque<uint32_t> Queue ;  // Ranges waiting for a worker
+static uint32_t nMerged ;            // Ranges 0 to nMerged - 1 have been merged
+static mutex RangeMutex ;
+
+static FILE* fpUndecided ;
+static FILE* fpVerify ;
+static DvfIndexWriter VerificationIndex ;
+static CompactDvfWriter VerificationWriter ; // Compact dvf only
+static uint64_t nMachinesMerged ;
+static uint64_t nEntriesMerged ;
+
+static void WorkerThread() ;
+static std::string RangeFilename (uint32_t RangeIndex, const char* Extension) ;
+static std::string WorkerCommand (uint32_t RangeIndex) ;
+static void MergeRange (uint32_t RangeIndex) ;
+
+int main (int argc, char** argv)
+  {
+  Params.Parse (argc, argv) ;
+  Params.CheckParameters() ;
+
+  // Open the Decider's database and input file, to count its machines
+  Params.CommonParams::OpenFiles() ;
+  Params.fpInput = CommonParams::OpenFile (Params.InputFilename, "rb") ;
+  Params.fpVerify = Params.fpUndecided = nullptr ;
+  Reader.SetParams (&Params) ;
+
+  for (uint64_t Start = 0 ; Start < Reader.nMachines ; Start += Params.RangeSize)
+    {
+    Range R ;
+    R.Start = Start ;
+    R.End = std::min (Start + Params.RangeSize, Reader.nMachines) ;
+    Queue.push_back (RangeList.size()) ;
+    RangeList.push_back (R) ;
+    }
+
+  std::error_code Error ;
+  std::filesystem::create_directories (Params.SpoolDirectory, Error) ;
+  if (Error) printf ("Can't create directory %s\n", Params.SpoolDirectory.c_str()), exit (1) ;
+
+  // The output files start as the Decider's would
+  fpUndecided = CommonParams::OpenFile (Params.MergedUndecidedFilename, "wb") ;
+  fpVerify = CommonParams::OpenFile (Params.MergedVerificationFilename, "wb") ;
+  Reader.WriteUndecidedHeader (fpUndecided) ;
+  if (fpVerify)
+    {
+    Reader.WriteVerificationHeader (fpVerify, 0) ;
+    if (Params.WriteDvfIndex)
+      VerificationIndex.Open (CommonParams::OpenFile (DvfIndex::IndexFilename
+        (Params.MergedVerificationFilename), "w+b")) ;
+    }
+
+  if (!Params.nWorkersPresent)
+    {
+    Params.nWorkers = 4 ;
+    char* env = getenv ("NUMBER_OF_PROCESSORS") ;
+    if (env)
+      {
+      Params.nWorkers = atoi (env) ;
+      if (Params.nWorkers == 0) Params.nWorkers = 4 ;
+      }
+    }
+  if (Params.nWorkers > RangeList.size()) Params.nWorkers = RangeList.size() ;
+  printf ("%" PRIu64 " machines in %d ranges, %d workers\n", Reader.nMachines,
+    (int)RangeList.size(), Params.nWorkers) ;
+
+  time_t StartTime = time (nullptr) ;
+
+  std::vector<thread*> ThreadList (Params.nWorkers) ;
+  for (uint32_t i = 0 ; i < Params.nWorkers ; i++)
+    ThreadList[i] = new thread (WorkerThread) ;
+  for (uint32_t i = 0 ; i < Params.nWorkers ; i++)
+    {
+    ThreadList[i] -> join() ;
+    delete ThreadList[i] ;
+    }
+
+  if (nMerged != RangeList.size()) printf ("\nNot all ranges were merged!\n"), exit (1) ;
+
+  Reader.CloseUndecided (fpUndecided) ;
+  if (fpVerify)
+    {
+    uint64_t DvfLength = ftello64 (fpVerify) ;
+    if (fseek (fpVerify, 0, SEEK_SET)) printf ("\nfseek failed\n"), exit (1) ;
+    Reader.WriteVerificationHeader (fpVerify, nEntriesMerged) ;
+    fclose (fpVerify) ;
+    if (VerificationIndex.IsOpen()) VerificationIndex.Close (DvfLength) ;
+    }
+
+  printf ("\n%" PRIu64 " machines decided, %" PRIu64 " undecided\n", nEntriesMerged, nMachinesMerged) ;
+  printf ("Elapsed time %" PRIu64 "s\n", (uint64_t)(time (nullptr) - StartTime)) ;
+  }
+
+static void WorkerThread()
+  {
+  for (;;)
+    {
+    uint32_t RangeIndex ;
+      {
+      lock_guard<mutex> Lock (RangeMutex) ;
+      if (Queue.empty()) return ;
+      RangeIndex = Queue.front() ;
+      Queue.pop_front() ;
+      RangeList[RangeIndex].Attempts++ ;
+      }
+
+    int Status = system (WorkerCommand (RangeIndex).c_str()) ;
+
+    lock_guard<mutex> Lock (RangeMutex) ;
+    Range& R = RangeList[RangeIndex] ;
+    if (Status != 0)
+      {
+      printf ("\nRange %d (machines %" PRIu64 " to %" PRIu64 ") failed with status %d",
+        RangeIndex, R.Start, R.End - 1, Status) ;
+      if (R.Attempts == Params.MaxAttempts)
+        printf (" %d times: see %s\n", R.Attempts, RangeFilename (RangeIndex, "log").c_str()), exit (1) ;
+      printf (", requeued\n") ;
+
+      // Run it again as soon as possible, so that it doesn't hold up the merge
+      Queue.push_front (RangeIndex) ;
+      continue ;
+      }
+
+    R.Done = true ;
+    while (nMerged < RangeList.size() && RangeList[nMerged].Done) MergeRange (nMerged++) ;
+
+    printf ("\r%d%% %d ranges merged", (int)((nMerged * 100LL) / RangeList.size()), nMerged) ;
+    fflush (stdout) ;
+    }
+  }
+
+static std::string RangeFilename (uint32_t RangeIndex, const char* Extension)
+  {
+  return Params.SpoolDirectory + "/range" + std::to_string (RangeIndex) + "." + Extension ;
+  }
+
+static std::string WorkerCommand (uint32_t RangeIndex)
+  {
+  std::string Command ;
+  for (const std::string& Arg : Params.DeciderCommand)
+    {
+    if (Arg.find (' ') == std::string::npos) Command += Arg ;
+    else Command += "\"" + Arg + "\"" ;
+    Command += " " ;
+    }
+  const Range& R = RangeList[RangeIndex] ;
+  Command += "-R" + std::to_string (R.Start) + ":" + std::to_string (R.End) ;
+  if (fpUndecided) Command += " -U" + RangeFilename (RangeIndex, "umf") ;
+  if (fpVerify) Command += " -V" + RangeFilename (RangeIndex, "dvf") ;
+  Command += " > " + RangeFilename (RangeIndex, "log") + " 2>&1" ;
+  return Command ;
+  }
+
+// static void MergeRange (uint32_t RangeIndex)
+//
+// Appends the umf and dvf of a range to the output files, and deletes them
+
+static void MergeRange (uint32_t RangeIndex)
+  {
+  if (fpUndecided)
+    {
+    std::string Filename = RangeFilename (RangeIndex, "umf") ;
+    FILE* fp = CommonParams::OpenFile (Filename, "rb") ;
+    if (fseeko64 (fp, 0, SEEK_END)) printf ("fseek failed\n"), exit (1) ;
+    uint64_t FileSize = ftello64 (fp) ;
+    if (fseeko64 (fp, 0, SEEK_SET)) printf ("fseek failed\n"), exit (1) ;
+    uint32_t Version = FileSize ? TuringMachineReader::ReadFileVersion (fp) : 1 ;
+    if (Version != (Reader.CompressedOutput ? COMPRESSED_UMF_VERSION : Reader.FileVersion))
+      printf ("\n%s is a version %d file\n", Filename.c_str(), Version), exit (1) ;
+
+    CompressedUmfReader UmfReader ;
+    UmfReader.Open (fp, Version) ;
+    while (!UmfReader.AtEnd()) Reader.WriteUndecided (fpUndecided, UmfReader.Next()) ;
+    nMachinesMerged += UmfReader.nIndices ;
+    fclose (fp) ;
+    remove (Filename.c_str()) ;
+    }
+
+  if (fpVerify)
+    {
+    std::string Filename = RangeFilename (RangeIndex, "dvf") ;
+    FILE* fp = CommonParams::OpenFile (Filename, "rb") ;
+    if (fseeko64 (fp, 0, SEEK_END)) printf ("fseek failed\n"), exit (1) ;
+    uint64_t FileSize = ftello64 (fp) ;
+    if (fseeko64 (fp, 0, SEEK_SET)) printf ("fseek failed\n"), exit (1) ;
+    uint32_t Version = TuringMachineReader::ReadFileVersion (fp) ;
+    if (Version != Reader.VerificationVersion())
+      printf ("\n%s is a version %d file\n", Filename.c_str(), Version), exit (1) ;
+    uint64_t nEntries = TuringMachineReader::ReadIndex (fp, Version) ; // Same size as an index
+    nEntriesMerged += nEntries ;
+
+    if (Reader.CompactVerification)
+      {
+      // The machine index of each entry is coded relative to the one before it, so
+      // the entries are copied one at a time, and indexed as they are written
+      CompactDvfReader RangeReader ;
+      for (uint64_t i = 0 ; i < nEntries ; i++)
+        {
+        RangeReader.ReadEntry (fp) ;
+        if (VerificationIndex.IsOpen())
+          VerificationIndex.Add (RangeReader.MachineIndex, ftello64 (fpVerify)) ;
+        VerificationWriter.Copy (fpVerify, RangeReader) ;
+        }
+      if (!CheckEndOfFile (fp)) printf ("\n%s is too long\n", Filename.c_str()), exit (1) ;
+      }
+    else
+      {
+      if (VerificationIndex.IsOpen())
+        {
+        // The entries of the range's dvf index move up to where the entries will be
+        uint64_t Shift = ftello64 (fpVerify) - ftello64 (fp) ;
+        DvfIndex Index ;
+        if (!Index.Open (Filename, FileSize, nEntries))
+          printf ("\n%s has no dvf index\n", Filename.c_str()), exit (1) ;
+        for (uint64_t i = 0 ; i < nEntries ; i++)
+          {
+          uint64_t MachineIndex, Offset ;
+          Index.Entry (i, MachineIndex, Offset) ;
+          VerificationIndex.Add (MachineIndex, Offset + Shift) ;
+          }
+        Index.Close() ;
+        }
+
+      // The entries can be copied as they stand
+      uint8_t Buffer[65536] ;
+      size_t n ;
+      while ((n = fread (Buffer, 1, sizeof (Buffer), fp)) != 0) Write (fpVerify, Buffer, n) ;
+      }
+    remove (DvfIndex::IndexFilename (Filename).c_str()) ;
+    fclose (fp) ;
+    remove (Filename.c_str()) ;
+    }
+
+  remove (RangeFilename (RangeIndex, "log").c_str()) ;
+  }
+
+void CommandLineParams::Parse (int argc, char** argv)
+  {
+  if (argc == 1) PrintHelpAndExit (0) ;
+
+  for (argc--, argv++ ; argc ; argc--, argv++)
+    {
+    if (strcmp (argv[0], "--") == 0)
+      {
+      for (argc--, argv++ ; argc ; argc--, argv++) DeciderCommand.push_back (argv[0]) ;
+      break ;
+      }
+    if (argv[0][0] != '-') printf ("Invalid parameter \"%s\"\n", argv[0]), PrintHelpAndExit (1) ;
+    switch (toupper (argv[0][1]))
+      {
+      case 'W':
+        nWorkers = ParseInt (argv[0], &argv[0][2]) ;
+        if (nWorkers == 0) printf ("%s: at least one worker needed\n", argv[0]), exit (1) ;
+        nWorkersPresent = true ;
+        break ;
+
+      case 'B':
+        RangeSize = ParseInt64 (argv[0], &argv[0][2]) ;
+        if (RangeSize == 0) printf ("%s: invalid range size\n", argv[0]), exit (1) ;
+        break ;
+
+      case 'S':
+        if (argv[0][2] == 0) printf ("%s: directory expected\n", argv[0]), PrintHelpAndExit (1) ;
+        SpoolDirectory = std::string (&argv[0][2]) ;
+        break ;
+
+      case 'A':
+        MaxAttempts = ParseInt (argv[0], &argv[0][2]) ;
+        if (MaxAttempts == 0) printf ("%s: invalid number of attempts\n", argv[0]), exit (1) ;
+        break ;
+
+      case 'V':
+        if (argv[0][2] == 0) printf ("%s: filename expected\n", argv[0]), PrintHelpAndExit (1) ;
+        MergedVerificationFilename = std::string (&argv[0][2]) ;
+        break ;
+
+      case 'U':
+        if (argv[0][2] == 0) printf ("%s: filename expected\n", argv[0]), PrintHelpAndExit (1) ;
+        MergedUndecidedFilename = std::string (&argv[0][2]) ;
+        break ;
+
+      default:
+        printf ("Invalid parameter \"%s\"\n", argv[0]) ;
+        PrintHelpAndExit (1) ;
+      }
+    }
+
+  if (DeciderCommand.empty()) printf ("Decider command not specified\n"), PrintHelpAndExit (1) ;
+  if (MergedVerificationFilename.empty() && MergedUndecidedFilename.empty())
+    printf ("No output files specified\n"), PrintHelpAndExit (1) ;
+
+  // Pick out the parameters that tell us which machines the Decider will read; the
+  // Decider's own parameters use other letters
+  for (uint32_t i = 1 ; i < DeciderCommand.size() ; i++)
+    {
+    const char* arg = DeciderCommand[i].c_str() ;
+    if (arg[0] != '-') continue ;
+    switch (toupper (arg[1]))
+      {
+      case 'N': case 'D': case 'I': case 'G':
+        DeciderParams::ParseParam (arg) ;
+        break ;
+
+      case 'X':
+        if (toupper (arg[2]) == 'I' && arg[3] == 0) DeciderParams::ParseParam (arg) ; // -XI
+        else printf ("Decider parameter %s can't be used with the Coordinator\n", arg), exit (1) ;
+        break ;
+
+      case 'U': case 'V': case 'R': case 'L': case 'M':
+        printf ("Decider parameter %s can't be used with the Coordinator\n", arg), exit (1) ;
+      }
+    }
+  }
+
+void CommandLineParams::PrintHelpAndExit (int status)
+  {
+  printf (R"*RAW*(Coordinator <param> <param>... -- <decider> <decider param>...
+  <param>: -W<workers>           Worker processes to run at once (default=number of processors)
+           -B<range size>        Machines in each range (default 100000)
+           -S<spool directory>   Directory for the files of each range (default Spool)
+           -A<attempts>          Max attempts at each range (default 3)
+           -V<verification file> Output file: verification data for decided machines
+           -U<undecided file>    Output file: remaining undecided machines
+)*RAW*") ;
+  exit (status) ;
+  }
@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <numeric>
+
+#include "CostHints.h"
+
+CostHints::CostHints (const std::string& Filename)
+  {
+  FILE* fp = fopen (Filename.c_str(), "rb") ;
+  if (fp == nullptr) printf ("Can't open cost hint file \"%s\"\n", Filename.c_str()), exit (1) ;
+  if (fseek (fp, 0, SEEK_END)) printf ("fseek failed\n"), exit (1) ;
+  long FileSize = ftell (fp) ;
+  if (FileSize % 12) printf ("Cost hint file \"%s\" is invalid\n", Filename.c_str()), exit (1) ;
+  rewind (fp) ;
+
+  RecordList.resize (FileSize / 12) ;
+  for (Record& R : RecordList)
+    {
+    R.SeedDatabaseIndex = Read32 (fp) ;
+    uint64_t Steps = Read32 (fp) ;
+    uint64_t Microseconds = Read32 (fp) ;
+
+    // Time is what we want to balance, but it is noisy for cheap machines, so
+    // Steps break ties; and every known machine costs something
+    R.Cost = ((Microseconds << 32) | Steps) + 1 ;
+    }
+  fclose (fp) ;
+
+  // If a machine appears more than once (e.g. several files concatenated), the
+  // last record wins
+  std::stable_sort (RecordList.begin(), RecordList.end(), [] (const Record& a, const Record& b)
+    { return a.SeedDatabaseIndex < b.SeedDatabaseIndex ; }) ;
+  auto Last = std::unique (RecordList.rbegin(), RecordList.rend(), [] (const Record& a, const Record& b)
+    { return a.SeedDatabaseIndex == b.SeedDatabaseIndex ; }) ;
+  RecordList.erase (RecordList.begin(), Last.base()) ;
+
+  nHints = RecordList.size() ;
+  }
+
+uint64_t CostHints::Cost (uint64_t SeedDatabaseIndex) const
+  {
+  auto Iter = std::lower_bound (RecordList.begin(), RecordList.end(), SeedDatabaseIndex,
+    [] (const Record& R, uint64_t Index) { return R.SeedDatabaseIndex < Index ; }) ;
+  if (Iter == RecordList.end() || Iter -> SeedDatabaseIndex != SeedDatabaseIndex) return 0 ;
+  return Iter -> Cost ;
+  }
+
+void CostHints::Sort (const uint64_t* MachineIndexList, uint32_t nMachines, uint32_t* Order) const
+  {
+  std::vector<uint64_t> CostList ;
+  GetCosts (MachineIndexList, nMachines, CostList) ;
+  std::iota (Order, Order + nMachines, 0) ;
+  std::stable_sort (Order, Order + nMachines, [&] (uint32_t a, uint32_t b)
+    { return CostList[a] > CostList[b] ; }) ;
+  }
+
+void CostHints::Schedule (const uint64_t* MachineIndexList, uint32_t nMachines, uint32_t nThreads,
+  uint32_t MaxPerThread, uint32_t* Order, uint32_t* nAssigned) const
+  {
+  if (uint64_t (nThreads) * MaxPerThread < nMachines)
+    printf ("CostHints::Schedule: not enough room\n"), exit (1) ;
+
+  std::vector<uint64_t> CostList ;
+  GetCosts (MachineIndexList, nMachines, CostList) ;
+  std::vector<uint32_t> Sorted (nMachines) ;
+  std::iota (Sorted.begin(), Sorted.end(), 0) ;
+  std::stable_sort (Sorted.begin(), Sorted.end(), [&] (uint32_t a, uint32_t b)
+    { return CostList[a] > CostList[b] ; }) ;
+
+  // Each machine goes to the thread with the least work so far that still has room
+  std::vector<std::vector<uint32_t>> ThreadList (nThreads) ;
+  std::vector<double> Load (nThreads) ; // double, as a sum of Costs could overflow
+  for (uint32_t Entry : Sorted)
+    {
+    uint32_t Best = nThreads ;
+    for (uint32_t i = 0 ; i < nThreads ; i++)
+      if (ThreadList[i].size() < MaxPerThread && (Best == nThreads || Load[i] < Load[Best]))
+        Best = i ;
+    ThreadList[Best].push_back (Entry) ;
+    Load[Best] += CostList[Entry] ;
+    }
+
+  for (uint32_t i = 0 ; i < nThreads ; i++)
+    {
+    nAssigned[i] = ThreadList[i].size() ;
+    Order = std::copy (ThreadList[i].begin(), ThreadList[i].end(), Order) ;
+    }
+  }
+
+void CostHints::Write (FILE* fp, uint32_t SeedDatabaseIndex, const MachineCost& Cost)
+  {
+  Write32 (fp, SeedDatabaseIndex) ;
+  Write32 (fp, Cost.Steps) ;
+  Write32 (fp, Cost.Microseconds) ;
+  }
+
+// void CostHints::GetCosts (const uint64_t* MachineIndexList, uint32_t nMachines,
+//   std::vector<uint64_t>& CostList) const
+//
+// Sets CostList[i] to the cost of MachineIndexList[i]; machines with no hint are
+// given the average cost of those that have one
+
+void CostHints::GetCosts (const uint64_t* MachineIndexList, uint32_t nMachines,
+  std::vector<uint64_t>& CostList) const
+  {
+  CostList.resize (nMachines) ;
+  double Total = 0 ;
+  uint32_t nKnown = 0 ;
+  for (uint32_t i = 0 ; i < nMachines ; i++)
+    {
+    CostList[i] = Cost (MachineIndexList[i]) ;
+    if (CostList[i])
+      {
+      Total += CostList[i] ;
+      nKnown++ ;
+      }
+    }
+
+  uint64_t Average = nKnown ? uint64_t (Total / nKnown) : 1 ;
+  for (uint32_t i = 0 ; i < nMachines ; i++)
+    if (CostList[i] == 0) CostList[i] = Average ;
+  }
@@ -0,0 +1,77 @@
+// CostHints.h
+//
+// CostHints class
+
+#pragma once
+
+// class CostHints
+//
+// Per-machine cost hints, so that a Decider can start the most expensive machines
+// of each batch first. A few machines take far longer than the rest, and if one of
+// them is started last, all the other threads have to wait for it.
+//
+// Constructor:
+//
+//   CostHints (const std::string& Filename)
+//
+// Loads a Cost Hint File, written by an earlier run of the same Decider, or by an
+// earlier Decider in the pipeline (with -Y<cost hint file>).
+//
+// Sort lists the entries of a batch of machines in order of decreasing cost. Schedule
+// shares them out between a number of threads (each of which works through its own
+// list), giving each machine in turn, most expensive first, to the thread with the
+// least work so far. Machines that have no hint are assumed to have the average cost
+// of the machines in the batch that do. Either way, a Decider still writes its output
+// files in input order.
+//
+// Format of Cost Hint File (one record for each machine, in the order in which they
+// were written to the dvf and umf):
+//
+//   uint SeedDatabaseIndex
+//   uint Steps        -- Steps simulated (or nodes searched, for HaltingSegments)
+//   uint Microseconds -- Thread time
+
+#include <string>
+#include <vector>
+
+#include "bbchallenge.h"
+
+// Cost of one machine, as recorded by a Decider
+struct MachineCost
+  {
+  uint32_t Steps = 0 ;
+  uint32_t Microseconds = 0 ;
+  } ;
+
+class CostHints
+  {
+public:
+  CostHints (const std::string& Filename) ;
+
+  // Returns the cost of a machine (0 if it has no hint)
+  uint64_t Cost (uint64_t SeedDatabaseIndex) const ;
+
+  // Sets Order[0...nMachines-1] to the entries of MachineIndexList, most expensive first
+  void Sort (const uint64_t* MachineIndexList, uint32_t nMachines, uint32_t* Order) const ;
+
+  // Shares the entries of MachineIndexList out between nThreads threads, with no more
+  // than MaxPerThread each. Order lists the entries for thread 0 (most expensive
+  // first), then those for thread 1, and so on; nAssigned[i] is the number for thread i
+  void Schedule (const uint64_t* MachineIndexList, uint32_t nMachines, uint32_t nThreads,
+    uint32_t MaxPerThread, uint32_t* Order, uint32_t* nAssigned) const ;
+
+  // Writes a Cost Hint File record
+  static void Write (FILE* fp, uint32_t SeedDatabaseIndex, const MachineCost& Cost) ;
+
+  uint32_t nHints ;
+
+private:
+  struct Record
+    {
+    uint32_t SeedDatabaseIndex ;
+    uint64_t Cost ;
+    } ;
+  std::vector<Record> RecordList ; // Sorted by SeedDatabaseIndex
+
+  void GetCosts (const uint64_t* MachineIndexList, uint32_t nMachines, std::vector<uint64_t>& CostList) const ;
+  } ;
@@ -1,2 +1,2 @@
-g++ -std=c++20 -Wall -O3 -oDecideCyclers DecideCyclers.cpp ../Params.obj ../Reader.obj ../TuringMachine.obj
-g++ -std=c++20 -Wall -O3 -oVerifyCyclers VerifyCyclers.cpp ../Params.obj ../Reader.obj ../TuringMachine.obj
+g++ -std=c++20 -Wall -O3 -oDecideCyclers DecideCyclers.cpp Cycler.cpp ../Params.obj ../Reader.obj ../CompressedUmf.obj ../Enumerator.obj ../DvfIndex.obj ../MappedFile.obj ../CompactDvf.obj ../TuringMachine.obj
+g++ -std=c++20 -Wall -O3 -oVerifyCyclers VerifyCyclers.cpp ../Params.obj ../Reader.obj ../CompressedUmf.obj ../Enumerator.obj ../DvfIndex.obj ../MappedFile.obj ../CompactDvf.obj ../TuringMachine.obj
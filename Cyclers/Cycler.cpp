@@ -0,0 +1,84 @@
+// Cycler.cpp
+//
+// The Cycler class runs a machine for up to TimeLimit steps, looking for a
+// configuration that exactly repeats an earlier one (see DecideCyclers.cpp for
+// the format of the Verification Entry)
+
+#include <string.h>
+
+#include "Cycler.h"
+
+void Cycler::ThreadFunction (int nMachines, const uint64_t* MachineIndexList,
+  const uint8_t* MachineSpecList, uint8_t* VerificationEntryList, const uint8_t* SkipList)
+  {
+  while (nMachines--)
+    {
+    if (!SkipList || !*SkipList++)
+      {
+      Save32 (VerificationEntryList + 4, uint32_t (DeciderTag::NONE)) ;
+      Run (*MachineIndexList, MachineSpecList, VerificationEntryList) ;
+      }
+    MachineIndexList++ ;
+    MachineSpecList += MachineSpecSize ;
+    VerificationEntryList += VERIF_ENTRY_LENGTH ;
+    }
+  }
+
+void Cycler::Run (uint32_t MachineIndex, const uint8_t* MachineSpec, uint8_t* VerificationEntry)
+  {
+  Save32 (VerificationEntry + 4, uint32_t (DeciderTag::NONE)) ; // i.e. undecided
+  Initialise (MachineIndex, MachineSpec) ;
+  memset (HistoryWorkspace, 0, (2 * SpaceLimit + 1) * TimeLimit) ;
+  memset (PreviousConfig, 0, sizeof (int) * TimeLimit) ;
+  memset (PreviousWorkspace, 0xFF, sizeof (int) * MachineStates * (2 * SpaceLimit + 1)) ;
+
+  // We only check for matches when the tape head has just moved right, then left. This will occur
+  // in every Cycler, and it reduces the checks (and the workspace) by 75%. So remember the last
+  // two tape head positions:
+  int TapeHeadMinus1 = 99, TapeHeadMinus2 = 99 ;
+
+  while (StepCount < TimeLimit)
+    {
+    if (TapeHead == TapeHeadMinus2 && TapeHead + 1 == TapeHeadMinus1)
+      {
+      int prev = Previous[State][TapeHead] ;
+      PreviousConfig[StepCount] = prev ;
+      Previous[State][TapeHead] = StepCount ;
+      while (prev != -1)
+        {
+        if (!memcmp (Tape + Leftmost, TapeHistory[prev] + Leftmost, Rightmost - Leftmost + 1))
+          {
+          Save32 (VerificationEntry, MachineIndex) ;
+          Save32 (VerificationEntry + 4, uint32_t (DeciderTag::CYCLER)) ;
+          Save32 (VerificationEntry + 8, VERIF_INFO_LENGTH) ;
+  
+          // Leftmost
+          // Rightmost
+          // State
+          // TapeHead
+          // InititialStepCount
+          // FinalStepCount
+          Save32 (VerificationEntry + 12, Leftmost) ;
+          Save32 (VerificationEntry + 16, Rightmost) ;
+          Save32 (VerificationEntry + 20, State) ;
+          Save32 (VerificationEntry + 24, TapeHead) ;
+          Save32 (VerificationEntry + 28, prev) ;
+          Save32 (VerificationEntry + 32, StepCount) ;
+          return ;
+          }
+        prev = PreviousConfig[prev] ;
+        }
+
+      memcpy (TapeHistory[StepCount] + Leftmost, Tape + Leftmost, Rightmost - Leftmost + 1) ;
+      }
+    TapeHeadMinus2 = TapeHeadMinus1 ;
+    TapeHeadMinus1 = TapeHead ;
+
+    switch (Step())
+      {
+      case StepResult::OK: break ;
+      case StepResult::HALT: return ; // The BouncerDecider knows what to do with these
+      case StepResult::OUT_OF_BOUNDS: return ;
+      }
+    }
+  }
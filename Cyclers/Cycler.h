@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../TuringMachine.h"
+
+#define VERIF_INFO_LENGTH 24 // Length of DeciderSpecificInfo in Verification File
+
+class Cycler : public TuringMachine
+  {
+public:
+  Cycler (uint32_t  MachineStates, uint32_t TimeLimit, uint32_t SpaceLimit)
+  : TuringMachine (MachineStates, SpaceLimit)
+  , TimeLimit (TimeLimit)
+    {
+    HistoryWorkspace = new uint8_t[(2 * SpaceLimit + 1) * TimeLimit] ;
+
+    TapeHistory = new uint8_t*[TimeLimit] ;
+    for (uint32_t i = 0 ; i < TimeLimit ; i++)
+      TapeHistory[i] = HistoryWorkspace + i * (2 * SpaceLimit + 1) ;
+
+    // For each combination of State and TapeHead, we maintain a chain of
+    // configurations, so that we only have to compare tape contents for
+    // a fraction of previous configurations:
+    PreviousConfig = new int[TimeLimit] ;
+    PreviousWorkspace = new int[MachineStates * (2 * SpaceLimit + 1)] ;
+    Previous[0] = 0 ;
+    Previous[1] = PreviousWorkspace + SpaceLimit ;
+    for (uint32_t i = 2 ; i <= MachineStates ; i++)
+      Previous[i] = Previous[i - 1] + 2 * SpaceLimit + 1 ;
+    }
+
+  // Machines flagged in SkipList (if given) already have their Verification
+  // Entries, and are not run
+  void ThreadFunction (int nMachines, const uint64_t* MachineIndexList,
+    const uint8_t* MachineSpecList, uint8_t* VerificationEntryList,
+    const uint8_t* SkipList = nullptr) ;
+
+  // Call Run to analyse a single machine. If the machine is undecided, the
+  // DeciderType in the VerificationEntry is NONE:
+  void Run (uint32_t MachineIndex, const uint8_t* MachineSpec, uint8_t* VerificationEntry) ;
+
+private:
+
+  uint32_t TimeLimit ;
+
+  uint8_t* HistoryWorkspace ;
+  uint8_t** TapeHistory ;
+
+  int* PreviousConfig ;
+  int* PreviousWorkspace ;
+  int* Previous[MAX_MACHINE_STATES + 1] ;
+  } ;
@@ -4,22 +4,40 @@
 //            -V<verification file> Output file: verification data for decided machines
 //            -I<input file>        Input file: list of machines to be analysed (default=all machines)
 //            -U<undecided file>    Output file: remaining undecided machines
+//            -G                    Write a compressed umf and a compact dvf
+//            -XI                   Write a dvf index along with the dvf (see ../DvfIndex.h)
 //            -X<test machine>      Machine to test
 //            -M<machine spec>      Compact machine code (ASCII spec) to test
 //            -L<machine limit>     Max no. of machines to test
+//            -R<start>:<end>       Machines <start> to <end>-1 of the input file or database
 //            -H<threads>           Number of threads to use
 //            -O                    Print trace output
 //            -T<time limit>        Max no. of steps
-//            -S<space limit>       Max absolute value of tape head)*RAW*") ;
+//            -S<space limit>       Max absolute value of tape head
+//            -K                    Decide each canonical class of machines once
+//
+// With -K, machines that are the same up to state renaming, unused transitions and
+// mirror images (see TuringMachineSpec::CanonicalKey) are only run once: the first
+// machine of each class to be decided gives its Verification Entry to the rest, with
+// the states renumbered, and for a mirror image, Leftmost and Rightmost swapped and
+// negated and TapeHead negated. A Cycler only ever uses the transitions that it reaches, so the entry holds
+// for every machine of the class. A machine left undecided only shares its verdict
+// with machines that differ from it by state renaming and unused transitions, as the
+// search looks for repeats at different points in a mirror image, and so can reach
+// the time limit first. The verdicts of each batch of machines are added to the cache
+// after the batch, so the output depends on -H, but not on thread timing.
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
 #include <vector>
+#include <unordered_map>
+#include <unordered_set>
 #include <time.h>
+#include <inttypes.h> // for PRIu64
 
-#include "../TuringMachine.h"
+#include "Cycler.h"
 #include "../Params.h"
 
 #if NEED_BOOST_THREADS
@@ -32,13 +50,12 @@
 
 #define CHUNK_SIZE 1024 // Number of machines to assign to each thread
 
-#define VERIF_INFO_LENGTH 24 // Length of DeciderSpecificInfo in Verification File
-
 class CommandLineParams : public DeciderParams
   {
 public:
   uint32_t TimeLimit ;     bool TimeLimitPresent = false ;
   uint32_t SpaceLimit ;    bool SpaceLimitPresent = false ;
+  bool CanonicalCache = false ;
   void Parse (int argc, char** argv) ;
   void PrintHelpAndExit [[noreturn]] (int status) ;
   } ;
@@ -46,46 +63,29 @@ public:
 static CommandLineParams Params ;
 static TuringMachineReader Reader ;
 
-class Cycler : public TuringMachine
+// Canonical class cache (-K): the Verification Info of the first machine of each
+// class to be decided, with its states numbered and its tape the way round that
+// they are in the canonical key, and the keys of the undecided classes
+struct ClassVerdict
   {
-public:
-  Cycler (uint32_t  MachineStates, uint32_t TimeLimit, uint32_t SpaceLimit)
-  : TuringMachine (MachineStates, SpaceLimit)
-  , TimeLimit (TimeLimit)
-    {
-    HistoryWorkspace = new uint8_t[(2 * SpaceLimit + 1) * TimeLimit] ;
-
-    TapeHistory = new uint8_t*[TimeLimit] ;
-    for (uint32_t i = 0 ; i < TimeLimit ; i++)
-      TapeHistory[i] = HistoryWorkspace + i * (2 * SpaceLimit + 1) ;
-
-    // For each combination of State and TapeHead, we maintain a chain of
-    // configurations, so that we only have to compare tape contents for
-    // a fraction of previous configurations:
-    PreviousConfig = new int[TimeLimit] ;
-    PreviousWorkspace = new int[MachineStates * (2 * SpaceLimit + 1)] ;
-    Previous[0] = 0 ;
-    Previous[1] = PreviousWorkspace + SpaceLimit ;
-    for (uint32_t i = 2 ; i <= MachineStates ; i++)
-      Previous[i] = Previous[i - 1] + 2 * SpaceLimit + 1 ;
-    }
-
-  void ThreadFunction (int nMachines, const uint32_t* MachineIndexList,
-    const uint8_t* MachineSpecList, uint8_t* VerificationEntryList) ;
-
-private:
-
-  void Run (uint32_t MachineIndex, const uint8_t* MachineSpec, uint8_t* VerificationEntry) ;
+  int Leftmost ;
+  int Rightmost ;
+  uint32_t State ;
+  int TapeHead ;
+  uint32_t InitialStepCount ;
+  uint32_t FinalStepCount ;
+  } ;
+static std::unordered_map<uint64_t, ClassVerdict> ClassCache ;
+static std::unordered_set<uint64_t> UndecidedClasses ;
+static uint64_t nClassDecided = 0 ;
+static uint64_t nClassUndecided = 0 ;
 
-  uint32_t TimeLimit ;
+#define UNDECIDED_CLASS_FLAGS (TuringMachineSpec::CANONICAL_RENAME | TuringMachineSpec::CANONICAL_UNUSED)
 
-  uint8_t* HistoryWorkspace ;
-  uint8_t** TapeHistory ;
-
-  int* PreviousConfig ;
-  int* PreviousWorkspace ;
-  int* Previous[MAX_MACHINE_STATES + 1] ;
-  } ;
+static bool LookUpClass (TuringMachineSpec& TM, uint64_t MachineIndex,
+  const uint8_t* MachineSpec, uint8_t* VerificationEntry) ;
+static void RecordClass (TuringMachineSpec& TM, const uint8_t* MachineSpec,
+  const uint8_t* VerificationEntry) ;
 
 int main (int argc, char** argv)
   {
@@ -98,32 +98,32 @@ int main (int argc, char** argv)
   // If we are using the 5-state seed database, then we know which machines
   // are time-limited and which are space-limited, so we can restrict the
   // search to time-limited machines:
-  uint32_t nTimeLimited = Reader.nMachines ;
-  uint32_t nSpaceLimited = 0 ;
+  uint64_t nTimeLimited = Reader.nMachines ;
+  uint64_t nSpaceLimited = 0 ;
   if (Reader.OrigSeedDatabase)
     {
     if (Params.fpInput == 0)
       {
-      nTimeLimited = Reader.nTimeLimited ;
-      nSpaceLimited = Reader.nSpaceLimited ;
+      nTimeLimited = Reader.TimeLimitedInRange() ;
+      nSpaceLimited = Reader.RangeEnd - Reader.RangeStart - nTimeLimited ;
       }
     else
       {
       // Count the space-limited machines in the input file (this is just
       // so we can give informative percentages in the progress report)
       nSpaceLimited = 0 ;
-      for (uint32_t i = 0 ; i < Reader.nMachines ; i++)
+      for (uint64_t i = 0 ; i < Reader.nMachines ; i++)
         {
-        if (Read32 (Params.fpInput) < Reader.nTimeLimited) nTimeLimited++ ;
+        if (Reader.ReadInputIndex() < Reader.nTimeLimited) nTimeLimited++ ;
         else nSpaceLimited++ ;
         }
-      if (fseek (Params.fpInput, 0, SEEK_SET))
-        printf ("fseek failed\n"), exit (1) ;
+      Reader.RewindInput() ;
       }
     }
 
-  // Write dummy dvf header
-  Write32 (Params.fpVerify, 0) ;
+  // Write umf header and dummy dvf header
+  Reader.WriteUndecidedHeader (Params.fpUndecided) ;
+  Reader.WriteVerificationHeader (Params.fpVerify, 0) ;
 
   if (!Params.nThreadsPresent)
     {
@@ -145,32 +145,34 @@ int main (int argc, char** argv)
   clock_t Timer = clock() ;
 
   Cycler** CyclerArray = new Cycler*[Params.nThreads] ;
-  uint32_t** MachineIndexList = new uint32_t*[Params.nThreads] ;
+  uint64_t** MachineIndexList = new uint64_t*[Params.nThreads] ;
   uint8_t** MachineSpecList = new uint8_t*[Params.nThreads] ;
   uint8_t** VerificationEntryList = new uint8_t*[Params.nThreads] ;
   uint32_t* ChunkSize = new uint32_t[Params.nThreads] ;
+  uint8_t** SkipList = new uint8_t*[Params.nThreads] ; // -K: machines decided by their class
+  TuringMachineSpec TM (Params.MachineStates) ;
 
   // Allocate the per-thread workspace
   for (uint32_t i = 0 ; i < Params.nThreads ; i++)
     {
     CyclerArray[i] = new Cycler (Params.MachineStates, Params.TimeLimit, Params.SpaceLimit) ;
-    MachineIndexList[i] = new uint32_t[CHUNK_SIZE] ;
+    MachineIndexList[i] = new uint64_t[CHUNK_SIZE] ;
     MachineSpecList[i] = new uint8_t[Reader.MachineSpecSize * CHUNK_SIZE] ;
     VerificationEntryList[i] = new uint8_t[VERIF_ENTRY_LENGTH * CHUNK_SIZE] ;
+    SkipList[i] = Params.CanonicalCache ? new uint8_t[CHUNK_SIZE] : nullptr ;
     }
 
-  uint32_t nDecided = 0 ;
-  uint32_t nTimeLimitedComplete = 0 ;
-  uint32_t nSpaceLimitedComplete = 0 ;
+  uint64_t nDecided = 0 ;
+  uint64_t nTimeLimitedComplete = 0 ;
+  uint64_t nSpaceLimitedComplete = 0 ;
   int LastPercent = -1 ;
 
   // Analyse the time-limited machines in the seed database
   if (Params.MachineLimitPresent && nTimeLimited > Params.MachineLimit)
     nTimeLimited = Params.MachineLimit ;
-  uint32_t MachineCounter = 0 ;
   while (nTimeLimitedComplete < nTimeLimited)
     {
-    uint32_t nRemaining = nTimeLimited - nTimeLimitedComplete ;
+    uint64_t nRemaining = nTimeLimited - nTimeLimitedComplete ;
     if (nRemaining >= Params.nThreads * CHUNK_SIZE)
       {
       for (uint32_t i = 0 ; i < Params.nThreads ; i++) ChunkSize[i] = CHUNK_SIZE ;
@@ -197,24 +199,27 @@ int main (int argc, char** argv)
           }
         else
           {
-          uint32_t MachineIndex = Params.fpInput ? Read32 (Params.fpInput) : MachineCounter++ ;
+          uint64_t MachineIndex = Reader.NextIndex() ;
           if (Reader.OrigSeedDatabase) while (MachineIndex >= Reader.nTimeLimited)
             {
-            Write32 (Params.fpUndecided, MachineIndex) ;
+            Reader.WriteUndecided (Params.fpUndecided, MachineIndex) ;
             nSpaceLimitedComplete++ ;
-            MachineIndex = Params.fpInput ? Read32 (Params.fpInput) : MachineCounter++ ;
+            MachineIndex = Reader.NextIndex() ;
             }
           MachineIndexList[i][j] = MachineIndex ;
           Reader.Read (MachineIndex, MachineSpecList[i] + j * Reader.MachineSpecSize) ;
           }
+        if (Params.CanonicalCache)
+          SkipList[i][j] = LookUpClass (TM, MachineIndexList[i][j],
+            MachineSpecList[i] + j * Reader.MachineSpecSize, VerificationEntryList[i] + j * VERIF_ENTRY_LENGTH) ;
         }
       nTimeLimitedComplete += ChunkSize[i] ;
 
       // Run inline if single thread (for ease of debugging)
       if (Params.nThreads == 1) CyclerArray[i] -> ThreadFunction (ChunkSize[i],
-        MachineIndexList[i], MachineSpecList[i], VerificationEntryList[i]) ;
-      else ThreadList[i] = new thread (&Cycler::ThreadFunction,
-        CyclerArray[i], ChunkSize[i], MachineIndexList[i], MachineSpecList[i], VerificationEntryList[i]) ;
+        MachineIndexList[i], MachineSpecList[i], VerificationEntryList[i], SkipList[i]) ;
+      else ThreadList[i] = new thread (&Cycler::ThreadFunction, CyclerArray[i], ChunkSize[i],
+        MachineIndexList[i], MachineSpecList[i], VerificationEntryList[i], SkipList[i]) ;
       }
 
     for (uint32_t i = 0 ; i < Params.nThreads ; i++)
@@ -229,12 +234,14 @@ int main (int argc, char** argv)
       const uint8_t* VerificationEntry = VerificationEntryList[i] ;
       for (uint32_t j = 0 ; j < ChunkSize[i] ; j++)
         {
+        if (Params.CanonicalCache && !SkipList[i][j]) RecordClass (TM, MachineSpec, VerificationEntry) ;
         if (Load32 (VerificationEntry + 4))
           {
-          Write (Params.fpVerify, VerificationEntry, VERIF_ENTRY_LENGTH) ;
+          Reader.WriteVerificationEntry (Params.fpVerify, MachineIndexList[i][j],
+            VerificationEntry, VERIF_ENTRY_LENGTH) ;
           nDecided++ ;
           }
-        else Write32 (Params.fpUndecided, MachineIndexList[i][j]) ;
+        else Reader.WriteUndecided (Params.fpUndecided, MachineIndexList[i][j]) ;
         MachineSpec += Reader.MachineSpecSize ;
         VerificationEntry += VERIF_ENTRY_LENGTH ;
         }
@@ -244,7 +251,7 @@ int main (int argc, char** argv)
     if (Percent != LastPercent)
       {
       LastPercent = Percent ;
-      printf ("\r%d%% %d %d", Percent, nTimeLimitedComplete, nDecided) ;
+      printf ("\r%d%% %" PRIu64 " %" PRIu64, Percent, nTimeLimitedComplete, nDecided) ;
       fflush (stdout) ;
       }
     }
@@ -253,26 +260,20 @@ int main (int argc, char** argv)
     {
     while (nSpaceLimitedComplete++ < nSpaceLimited)
       {
-      uint32_t MachineIndex = Params.fpInput ? Read32 (Params.fpInput) : MachineCounter++ ;
-      Write32 (Params.fpUndecided, MachineIndex) ;
+      uint64_t MachineIndex = Reader.NextIndex() ;
+      Reader.WriteUndecided (Params.fpUndecided, MachineIndex) ;
       }
-    fclose (Params.fpUndecided) ;
+    Reader.CloseUndecided (Params.fpUndecided) ;
     }
 
   printf ("\n") ;
 
   // Check that we've reached the end of the input file
-  if (!Params.MachineLimitPresent && Params.fpInput && !CheckEndOfFile (Params.fpInput))
+  if (!Params.MachineLimitPresent && Params.fpInput && !Reader.InputAtEnd())
     printf ("\nInput file too long!\n"), exit (1) ;
 
-  if (Params.fpVerify)
-    {
-    // Write the verification file header
-    if (fseek (Params.fpVerify, 0 , SEEK_SET))
-      printf ("\nfseek failed\n"), exit (1) ;
-    Write32 (Params.fpVerify, nDecided) ;
-    fclose (Params.fpVerify) ;
-    }
+  // Write the verification file header, and finish off the dvf index
+  if (Params.fpVerify) Reader.CloseVerification (Params.fpVerify, nDecided) ;
 
   Timer = clock() - Timer ;
 
@@ -280,80 +281,90 @@ int main (int argc, char** argv)
 
 
   if (Reader.OrigSeedDatabase)
-    printf ("\nDecided %d out of %d time-limited machines\n", nDecided, Reader.nTimeLimited) ;
-  else printf ("\nDecided %d out of %d\n", nDecided, Reader.nMachines) ;
+    printf ("\nDecided %" PRIu64 " out of %d time-limited machines\n", nDecided, Reader.nTimeLimited) ;
+  else printf ("\nDecided %" PRIu64 " out of %" PRIu64 "\n", nDecided, Reader.nMachines) ;
   printf ("Elapsed time %.3f\n", (double)Timer / CLOCKS_PER_SEC) ;
-  }
 
-void Cycler::ThreadFunction (int nMachines, const uint32_t* MachineIndexList,
-  const uint8_t* MachineSpecList, uint8_t* VerificationEntryList)
-  {
-  while (nMachines--)
+  if (Params.CanonicalCache)
     {
-    Save32 (VerificationEntryList + 4, uint32_t (DeciderTag::NONE)) ;
-    Run (*MachineIndexList++, MachineSpecList, VerificationEntryList) ;
-    MachineSpecList += MachineSpecSize ;
-    VerificationEntryList += VERIF_ENTRY_LENGTH ;
+    printf ("\nCanonical classes: %d decided, %d undecided\n", (int)ClassCache.size(),
+      (int)UndecidedClasses.size()) ;
+    printf ("Verdicts shared: %" PRIu64 " decided, %" PRIu64 " undecided\n", nClassDecided, nClassUndecided) ;
     }
   }
 
-void Cycler::Run (uint32_t MachineIndex, const uint8_t* MachineSpec, uint8_t* VerificationEntry)
+// static bool LookUpClass (TuringMachineSpec& TM, uint64_t MachineIndex,
+//   const uint8_t* MachineSpec, uint8_t* VerificationEntry)
+//
+// If the machine's class has a verdict (-K), fills in its Verification Entry from it
+// and returns true
+
+static bool LookUpClass (TuringMachineSpec& TM, uint64_t MachineIndex,
+  const uint8_t* MachineSpec, uint8_t* VerificationEntry)
   {
-  Save32 (VerificationEntry + 4, uint32_t (DeciderTag::NONE)) ; // i.e. undecided
-  Initialise (MachineIndex, MachineSpec) ;
-  memset (HistoryWorkspace, 0, (2 * SpaceLimit + 1) * TimeLimit) ;
-  memset (PreviousConfig, 0, sizeof (int) * TimeLimit) ;
-  memset (PreviousWorkspace, 0xFF, sizeof (int) * MachineStates * (2 * SpaceLimit + 1)) ;
-
-  // We only check for matches when the tape head has just moved right, then left. This will occur
-  // in every Cycler, and it reduces the checks (and the workspace) by 75%. So remember the last
-  // two tape head positions:
-  int TapeHeadMinus1 = 99, TapeHeadMinus2 = 99 ;
-
-  while (StepCount < TimeLimit)
+  TM.Initialise (0, MachineSpec) ;
+  bool Mirrored ;
+  uint8_t StateMap[MAX_MACHINE_STATES + 1] ;
+  auto Iter = ClassCache.find (TM.CanonicalKey (TuringMachineSpec::CANONICAL_ALL, &Mirrored, StateMap)) ;
+  if (Iter != ClassCache.end())
     {
-    if (TapeHead == TapeHeadMinus2 && TapeHead + 1 == TapeHeadMinus1)
-      {
-      int prev = Previous[State][TapeHead] ;
-      PreviousConfig[StepCount] = prev ;
-      Previous[State][TapeHead] = StepCount ;
-      while (prev != -1)
-        {
-        if (!memcmp (Tape + Leftmost, TapeHistory[prev] + Leftmost, Rightmost - Leftmost + 1))
-          {
-          Save32 (VerificationEntry, MachineIndex) ;
-          Save32 (VerificationEntry + 4, uint32_t (DeciderTag::CYCLER)) ;
-          Save32 (VerificationEntry + 8, VERIF_INFO_LENGTH) ;
-  
-          // Leftmost
-          // Rightmost
-          // State
-          // TapeHead
-          // InititialStepCount
-          // FinalStepCount
-          Save32 (VerificationEntry + 12, Leftmost) ;
-          Save32 (VerificationEntry + 16, Rightmost) ;
-          Save32 (VerificationEntry + 20, State) ;
-          Save32 (VerificationEntry + 24, TapeHead) ;
-          Save32 (VerificationEntry + 28, prev) ;
-          Save32 (VerificationEntry + 32, StepCount) ;
-          return ;
-          }
-        prev = PreviousConfig[prev] ;
-        }
+    const ClassVerdict& V = Iter -> second ;
+    uint32_t State = 1 ;
+    while (StateMap[State] != V.State) State++ ;
+    Save32 (VerificationEntry, MachineIndex) ;
+    Save32 (VerificationEntry + 4, uint32_t (DeciderTag::CYCLER)) ;
+    Save32 (VerificationEntry + 8, VERIF_INFO_LENGTH) ;
+    Save32 (VerificationEntry + 12, Mirrored ? -V.Rightmost : V.Leftmost) ;
+    Save32 (VerificationEntry + 16, Mirrored ? -V.Leftmost : V.Rightmost) ;
+    Save32 (VerificationEntry + 20, State) ;
+    Save32 (VerificationEntry + 24, Mirrored ? -V.TapeHead : V.TapeHead) ;
+    Save32 (VerificationEntry + 28, V.InitialStepCount) ;
+    Save32 (VerificationEntry + 32, V.FinalStepCount) ;
+    nClassDecided++ ;
+    return true ;
+    }
 
-      memcpy (TapeHistory[StepCount] + Leftmost, Tape + Leftmost, Rightmost - Leftmost + 1) ;
-      }
-    TapeHeadMinus2 = TapeHeadMinus1 ;
-    TapeHeadMinus1 = TapeHead ;
+  if (UndecidedClasses.contains (TM.CanonicalKey (UNDECIDED_CLASS_FLAGS)))
+    {
+    Save32 (VerificationEntry + 4, uint32_t (DeciderTag::NONE)) ;
+    nClassUndecided++ ;
+    return true ;
+    }
 
-    switch (Step())
-      {
-      case StepResult::OK: break ;
-      case StepResult::HALT: return ; // The BouncerDecider knows what to do with these
-      case StepResult::OUT_OF_BOUNDS: return ;
-      }
+  return false ;
+  }
+
+// static void RecordClass (TuringMachineSpec& TM, const uint8_t* MachineSpec,
+//   const uint8_t* VerificationEntry)
+//
+// Records the verdict of a machine that was run as the verdict of its class (-K),
+// unless the class has one already
+
+static void RecordClass (TuringMachineSpec& TM, const uint8_t* MachineSpec,
+  const uint8_t* VerificationEntry)
+  {
+  TM.Initialise (0, MachineSpec) ;
+  if (Load32 (VerificationEntry + 4) == uint32_t (DeciderTag::NONE))
+    {
+    UndecidedClasses.insert (TM.CanonicalKey (UNDECIDED_CLASS_FLAGS)) ;
+    return ;
     }
+
+  bool Mirrored ;
+  uint8_t StateMap[MAX_MACHINE_STATES + 1] ;
+  uint64_t Key = TM.CanonicalKey (TuringMachineSpec::CANONICAL_ALL, &Mirrored, StateMap) ;
+  int Leftmost = Load32 (VerificationEntry + 12) ;
+  int Rightmost = Load32 (VerificationEntry + 16) ;
+  int TapeHead = Load32 (VerificationEntry + 24) ;
+
+  ClassVerdict V ;
+  V.Leftmost = Mirrored ? -Rightmost : Leftmost ;
+  V.Rightmost = Mirrored ? -Leftmost : Rightmost ;
+  V.State = StateMap[Load32 (VerificationEntry + 20)] ;
+  V.TapeHead = Mirrored ? -TapeHead : TapeHead ;
+  V.InitialStepCount = Load32 (VerificationEntry + 28) ;
+  V.FinalStepCount = Load32 (VerificationEntry + 32) ;
+  ClassCache.emplace (Key, V) ;
   }
 
 void CommandLineParams::Parse (int argc, char** argv)
@@ -376,6 +387,10 @@ void CommandLineParams::Parse (int argc, char** argv)
         SpaceLimitPresent = true ;
         break ;
 
+      case 'K':
+        CanonicalCache = true ;
+        break ;
+
       default:
         printf ("Invalid parameter \"%s\"\n", argv[0]) ;
         PrintHelpAndExit (1) ;
@@ -392,6 +407,7 @@ void CommandLineParams::PrintHelpAndExit (int status)
   DeciderParams::PrintHelp() ;
   printf (R"*RAW*(
            -T<time limit>        Max no. of steps
-           -S<space limit>       Max absolute value of tape head)*RAW*") ;
+           -S<space limit>       Max absolute value of tape head
+           -K                    Decide each canonical class of machines once)*RAW*") ;
   exit (status) ;
   }
@@ -2,6 +2,7 @@
 //   <param>: -N<states>            Machine states (2, 3, 4, 5, or 6)
 //            -D<database>          Seed database file (defaults to ../SeedDatabase.bin)
 //            -V<verification file> Input file: verification data to be checked
+//            -X<test machine>      Machine to verify (see ../DvfIndex.h)
 //
 // Format of verification info:
 //
@@ -17,6 +18,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <time.h>
+#include <inttypes.h> // for PRIu64
 #include <string>
 
 #include "../TuringMachine.h"
@@ -43,7 +45,7 @@ public:
     InitialTape = new uint8_t[2 * MAX_SPACE + 1] ;
     MaxSteps = 0 ;
     }
-  void Verify (uint32_t SeedDatabaseIndex, const uint8_t* MachineSpec, FILE* fp) ;
+  void Verify (uint32_t SeedDatabaseIndex, const uint8_t* MachineSpec, ByteReader Info) ;
   uint8_t* InitialTape ;
 
   // Stats
@@ -64,7 +66,7 @@ int main (int argc, char** argv)
 
   clock_t Timer = clock() ;
 
-  for (uint32_t Entry = 0 ; Entry < Reader.nMachines ; Entry++)
+  for (uint64_t Entry = 0 ; Entry < Reader.nMachines ; Entry++)
     {
     int Percent = ((Entry + 1) * 100LL) / Reader.nMachines ;
     if (Percent != LastPercent)
@@ -74,38 +76,39 @@ int main (int argc, char** argv)
       LastPercent = Percent ;
       }
 
-    uint32_t SeedDatabaseIndex = Read32 (Params.fpVerify) ;
-    if (DeciderTag (Read32 (Params.fpVerify)) != DeciderTag::CYCLER)
+    TuringMachineReader::DvfEntry VerifEntry = Reader.ReadVerificationEntry() ;
+    if (VerifEntry.Tag != DeciderTag::CYCLER)
       printf ("\nUnrecognised DeciderTag\n") ;
 
-    Reader.Read (SeedDatabaseIndex, MachineSpec) ;
-    Verifier.Verify (SeedDatabaseIndex, MachineSpec, Params.fpVerify) ;
+    Reader.Read (VerifEntry.MachineIndex, MachineSpec) ;
+    Verifier.Verify (VerifEntry.MachineIndex, MachineSpec, VerifEntry.Info) ;
     }
 
   Timer = clock() - Timer ;
 
-  // Check that we have reached the end of the verification file
-  if (!CheckEndOfFile (Params.fpVerify)) printf ("File too long!\n"), exit (1) ;
+  // Check that we have reached the end of the verification file (unless we were
+  // only verifying one machine)
+  if (!Reader.SingleEntry && !Reader.VerificationAtEnd()) printf ("File too long!\n"), exit (1) ;
   fclose (Params.fpVerify) ;
 
-  printf ("\n%d Cyclers verified\n", Reader.nMachines) ;
+  printf ("\n%" PRIu64 " Cyclers verified\n", Reader.nMachines) ;
   printf ("Max %d steps\n", Verifier.MaxSteps) ;
   printf ("Elapsed time %.3f\n", (double)Timer / CLOCKS_PER_SEC) ;
   }
 
-void CyclerVerifier::Verify (uint32_t SeedDatabaseIndex, const uint8_t* MachineSpec, FILE* fpVerify)
+void CyclerVerifier::Verify (uint32_t SeedDatabaseIndex, const uint8_t* MachineSpec, ByteReader Info)
   {
   Initialise (SeedDatabaseIndex, MachineSpec) ;
 
   // Read the verification data from the input file
-  if (Read32 (fpVerify) != VERIF_INFO_LENGTH)
+  if (Info.Remaining() != VERIF_INFO_LENGTH)
     printf ("Invalid Cyclers verification data length\n"), exit (1) ;
-  int32_t ExpectedLeftmost = Read32 (fpVerify) ;
-  int32_t ExpectedRightmost = Read32 (fpVerify) ;
-  uint32_t ExpectedState = Read32 (fpVerify) ;
-  int32_t ExpectedTapeHead = Read32 (fpVerify) ;
-  uint32_t InitialStepCount = Read32 (fpVerify) ;
-  uint32_t FinalStepCount = Read32 (fpVerify) ;
+  int32_t ExpectedLeftmost = Info.Read32() ;
+  int32_t ExpectedRightmost = Info.Read32() ;
+  uint32_t ExpectedState = Info.Read32() ;
+  int32_t ExpectedTapeHead = Info.Read32() ;
+  uint32_t InitialStepCount = Info.Read32() ;
+  uint32_t FinalStepCount = Info.Read32() ;
 
   // Perform some sanity checks on the data
   if (ExpectedLeftmost > 0)
@@ -0,0 +1,144 @@
+#include <string.h>
+#include <inttypes.h> // for PRIu64
+#include <vector>
+#include <algorithm>
+
+#include "DvfIndex.h"
+
+//
+// DvfIndex
+//
+
+std::string DvfIndex::IndexFilename (const std::string& DvfFilename)
+  {
+  size_t n = DvfFilename.length() ;
+  if (n >= 4 && strcasecmp (DvfFilename.c_str() + n - 4, ".dvf") == 0) return DvfFilename + "idx" ;
+  return DvfFilename + ".dvfidx" ;
+  }
+
+bool DvfIndex::Open (const std::string& DvfFilename, uint64_t DvfLength, uint64_t nDvfEntries)
+  {
+  Close() ;
+  std::string Filename = IndexFilename (DvfFilename) ;
+  fp = fopen (Filename.c_str(), "rb") ;
+  if (fp == nullptr) return false ;
+
+  if (fseeko64 (fp, 0, SEEK_END)) printf ("fseek failed\n"), exit (1) ;
+  uint64_t FileSize = ftello64 (fp) ;
+  rewind (fp) ;
+
+  bool Valid = FileSize >= DVF_INDEX_HEADER_LENGTH && Read32 (fp) == DVF_INDEX_MAGIC
+    && Read32 (fp) == DVF_INDEX_VERSION ;
+  if (Valid)
+    {
+    nEntries = Read64 (fp) ;
+    Valid = Read64 (fp) == DvfLength && nEntries == nDvfEntries
+      && FileSize == DVF_INDEX_HEADER_LENGTH + nEntries * DVF_INDEX_ENTRY_LENGTH ;
+    }
+  if (!Valid)
+    {
+    printf ("%s doesn't match %s: ignored\n", Filename.c_str(), DvfFilename.c_str()) ;
+    Close() ;
+    return false ;
+    }
+  NextEntry = 0 ;
+  return true ;
+  }
+
+void DvfIndex::Close()
+  {
+  if (fp) fclose (fp) ;
+  fp = nullptr ;
+  nEntries = 0 ;
+  }
+
+bool DvfIndex::Find (uint64_t MachineIndex, uint64_t& Offset)
+  {
+  // Binary search for the first entry with an index >= MachineIndex
+  uint64_t Low = 0, High = nEntries ;
+  while (Low < High)
+    {
+    uint64_t Mid = Low + (High - Low) / 2 ;
+    uint64_t Index ;
+    Entry (Mid, Index, Offset) ;
+    if (Index < MachineIndex) Low = Mid + 1 ;
+    else High = Mid ;
+    }
+  if (Low == nEntries) return false ;
+
+  uint64_t Index ;
+  Entry (Low, Index, Offset) ;
+  return Index == MachineIndex ;
+  }
+
+void DvfIndex::Entry (uint64_t n, uint64_t& MachineIndex, uint64_t& Offset)
+  {
+  if (n >= nEntries) printf ("Dvf index entry %" PRIu64 " out of range\n", n), exit (1) ;
+  if (n != NextEntry && fseeko64 (fp, DVF_INDEX_HEADER_LENGTH + n * DVF_INDEX_ENTRY_LENGTH, SEEK_SET))
+    printf ("fseek failed\n"), exit (1) ;
+  MachineIndex = Read64 (fp) ;
+  Offset = Read64 (fp) ;
+  NextEntry = n + 1 ;
+  }
+
+//
+// DvfIndexWriter
+//
+
+void DvfIndexWriter::Open (FILE* fp)
+  {
+  this -> fp = fp ;
+  if (ftello64 (fp) != 0) return ;
+  Write32 (fp, DVF_INDEX_MAGIC) ;
+  Write32 (fp, DVF_INDEX_VERSION) ;
+  Write64 (fp, 0) ; // nEntries and DvfLength, filled in by Close
+  Write64 (fp, 0) ;
+  }
+
+void DvfIndexWriter::Add (uint64_t MachineIndex, uint64_t Offset)
+  {
+  Write64 (fp, MachineIndex) ;
+  Write64 (fp, Offset) ;
+  }
+
+void DvfIndexWriter::Close (uint64_t DvfLength)
+  {
+  if (fseeko64 (fp, 0, SEEK_END)) printf ("fseek failed\n"), exit (1) ;
+  uint64_t nEntries = (ftello64 (fp) - DVF_INDEX_HEADER_LENGTH) / DVF_INDEX_ENTRY_LENGTH ;
+
+  // The Deciders nearly always write their entries in increasing order of machine
+  // index, so we read the index back to check, and only load it into memory to
+  // sort it if we have to
+  if (fseeko64 (fp, DVF_INDEX_HEADER_LENGTH, SEEK_SET)) printf ("fseek failed\n"), exit (1) ;
+  bool Sorted = true ;
+  uint64_t LastIndex = 0 ;
+  for (uint64_t i = 0 ; Sorted && i < nEntries ; i++)
+    {
+    uint64_t MachineIndex = Read64 (fp) ;
+    Read64 (fp) ;
+    if (i && MachineIndex <= LastIndex) Sorted = false ;
+    LastIndex = MachineIndex ;
+    }
+
+  if (!Sorted)
+    {
+    std::vector<std::pair<uint64_t, uint64_t>> EntryList (nEntries) ;
+    if (fseeko64 (fp, DVF_INDEX_HEADER_LENGTH, SEEK_SET)) printf ("fseek failed\n"), exit (1) ;
+    for (auto& E : EntryList)
+      {
+      E.first = Read64 (fp) ;
+      E.second = Read64 (fp) ;
+      }
+    std::sort (EntryList.begin(), EntryList.end()) ;
+    if (fseeko64 (fp, DVF_INDEX_HEADER_LENGTH, SEEK_SET)) printf ("fseek failed\n"), exit (1) ;
+    for (const auto& E : EntryList) Add (E.first, E.second) ;
+    }
+
+  if (fseeko64 (fp, 0, SEEK_SET)) printf ("fseek failed\n"), exit (1) ;
+  Write32 (fp, DVF_INDEX_MAGIC) ;
+  Write32 (fp, DVF_INDEX_VERSION) ;
+  Write64 (fp, nEntries) ;
+  Write64 (fp, DvfLength) ;
+  fclose (fp) ;
+  fp = nullptr ;
+  }
@@ -0,0 +1,92 @@
+// DvfIndex.h
+//
+// DvfIndex and DvfIndexWriter classes
+
+#pragma once
+
+// Verification file index
+//
+// The entries of a dvf have different lengths (a Bouncer's Verification Info can be
+// up to 259,075 bytes), so finding the entry of one machine means reading the dvf
+// from the start. A dvf index is a sidecar file, named after the dvf (see
+// IndexFilename), which lists the file offset of each entry in order of machine
+// index, so that the entry of any machine can be found with a binary search, and
+// a dvf can be split into pieces (e.g. to verify them in parallel) without reading it.
+//
+// An index takes 16 bytes per entry, more than most entries of a compact dvf (see
+// CompactDvf.h), so it is only written on request (-XI). The Deciders write the
+// index of their dvf along with its entries (see
+// TuringMachineReader::WriteVerificationEntry and CloseVerification), as do the
+// Coordinator and the Convert programs that write dvfs. A Verifier given -X uses it
+// to go straight to the entry of the test machine; if the index is missing, or
+// doesn't match the dvf, it reads the dvf until it finds the entry instead.
+//
+// DvfIndexWriter writes an index an entry at a time, in the order in which the
+// entries are written to the dvf; Close sorts the index if the machine indices
+// weren't in increasing order (as for an enumeration), and fills in the header.
+// The index file must be open for update. The index is written to the same FILE*
+// all the way through, so if a Decider resumes from a checkpoint, the index file is
+// cut back along with the dvf (see Checkpoint.h).
+//
+// DvfIndex reads an index. Open checks that it matches the dvf; Find returns the
+// offset of the entry of a machine; Entry returns the nth entry of the index.
+//
+// Format of dvf index:
+//
+//   uint DVF_INDEX_MAGIC
+//   uint Version (1)
+//   ulong nEntries
+//   ulong DvfLength -- Of the dvf that the index was written for
+//   Entry[nEntries] -- In increasing order of SeedDatabaseIndex
+//
+//   Entry format:
+//     ulong SeedDatabaseIndex
+//     ulong Offset    -- Of the dvf entry, from the start of the dvf
+
+#include <string>
+
+#include "bbchallenge.h"
+
+#define DVF_INDEX_MAGIC 0x44564649 // "DVFI"
+#define DVF_INDEX_VERSION 1
+#define DVF_INDEX_HEADER_LENGTH 24
+#define DVF_INDEX_ENTRY_LENGTH 16
+
+class DvfIndex
+  {
+public:
+  ~DvfIndex() { Close() ; }
+
+  // <dvf>.dvfidx, or <dvf>idx if the dvf has a .dvf extension
+  static std::string IndexFilename (const std::string& DvfFilename) ;
+
+  // Returns false if there is no index, or if it doesn't match the dvf
+  bool Open (const std::string& DvfFilename, uint64_t DvfLength, uint64_t nDvfEntries) ;
+  void Close() ;
+
+  // Returns false if the machine isn't in the dvf
+  bool Find (uint64_t MachineIndex, uint64_t& Offset) ;
+  void Entry (uint64_t n, uint64_t& MachineIndex, uint64_t& Offset) ;
+
+  uint64_t nEntries = 0 ;
+
+private:
+  FILE* fp = nullptr ;
+  uint64_t NextEntry ; // So that reading the entries in order doesn't need a seek each time
+  } ;
+
+class DvfIndexWriter
+  {
+public:
+  // Writes a dummy header if fp is at the start of the file; otherwise carries on
+  // from the end of it
+  void Open (FILE* fp) ;
+  bool IsOpen() const { return fp != nullptr ; }
+  void Add (uint64_t MachineIndex, uint64_t Offset) ;
+
+  // Sorts the index if need be, writes the header and closes the file
+  void Close (uint64_t DvfLength) ;
+
+private:
+  FILE* fp = nullptr ;
+  } ;
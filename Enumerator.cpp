@@ -0,0 +1,213 @@
+#include <string.h>
+#include <strings.h>
+#include <algorithm>
+
+#include "Params.h"
+
+bool TNFEnumerator::IsEnumeration (const std::string& DatabaseName)
+  {
+  return strncasecmp (DatabaseName.c_str(), "TNF", 3) == 0
+    && (DatabaseName.length() == 3 || DatabaseName[3] == ':') ;
+  }
+
+void TNFEnumerator::Initialise (const std::string& DatabaseName, uint32_t MachineStates)
+  {
+  this -> MachineStates = MachineStates ;
+  if (MachineStates <= 4) TimeLimit = SpaceLimit = 1000 ;
+  else
+    {
+    TimeLimit = 47176870 ;
+    SpaceLimit = MAX_SPACE ;
+    }
+
+  // Options are separated by commas
+  size_t Pos = 3 ;
+  while (Pos < DatabaseName.length())
+    {
+    size_t End = DatabaseName.find (',', Pos + 1) ;
+    if (End == std::string::npos) End = DatabaseName.length() ;
+    std::string Option = DatabaseName.substr (Pos + 1, End - Pos - 1) ;
+    const char* arg = Option.c_str() ;
+    switch (toupper (arg[0]))
+      {
+      case 'T':
+        TimeLimit = CommonParams::ParseInt64 (arg, arg + 1) ;
+        break ;
+
+      case 'S':
+        SpaceLimit = CommonParams::ParseInt (arg, arg + 1) ;
+        if (SpaceLimit == 0) printf ("%s: space limit must be positive\n", arg), exit (1) ;
+        break ;
+
+      case 'K':
+        {
+        size_t Slash = Option.find ('/') ;
+        if (Slash == std::string::npos)
+          printf ("%s: K<shard>/<shards> expected\n", arg), exit (1) ;
+        std::string ShardString = Option.substr (1, Slash - 1) ;
+        Shard = CommonParams::ParseInt (arg, ShardString.c_str()) ;
+        nShards = CommonParams::ParseInt (arg, arg + Slash + 1) ;
+        if (nShards == 0 || Shard >= nShards)
+          printf ("%s: invalid shard\n", arg), exit (1) ;
+        }
+        break ;
+
+      default:
+        printf ("Invalid enumeration option \"%s\"\n", arg), exit (1) ;
+      }
+    Pos = End ;
+    }
+
+  // Deep enough for a few thousand subtrees to share out between the shards, even
+  // though the machines at this depth still have at least two undefined transitions
+  ShardDepth = std::min (5U, 2 * MachineStates - 2) ;
+
+  Stack.resize (2 * MachineStates + 1) ;
+  for (Level& L : Stack)
+    {
+    L.Tape.assign (2 * SpaceLimit + 1, 0) ;
+    L.Leftmost = L.Rightmost = 0 ;
+    }
+
+  Reset() ;
+  }
+
+void TNFEnumerator::Reset()
+  {
+  Level& Root = Stack[0] ;
+  memset (Root.Tape.data() + SpaceLimit + Root.Leftmost, 0, Root.Rightmost - Root.Leftmost + 1) ;
+  memset (Root.TM, 0, sizeof (Root.TM)) ;
+  Root.nDefined = 0 ;
+  Root.MaxState = 1 ;
+  Root.TapeHead = Root.Leftmost = Root.Rightmost = 0 ;
+  Root.State = 1 ;
+  Root.StepCount = 0 ;
+  Root.Choice = 0 ;
+  Root.nChoices = 1 ; // A0 = 1RB
+
+  Depth = 1 ;
+  nUnits = 0 ;
+  }
+
+bool TNFEnumerator::Next (uint64_t& MachineIndex)
+  {
+  while (Depth)
+    {
+    Level& Parent = Stack[Depth - 1] ;
+    if (Parent.Choice == Parent.nChoices)
+      {
+      Depth-- ;
+      continue ;
+      }
+
+    Level& Child = Stack[Depth] ;
+    MakeChild (Child, Parent, Parent.Choice++) ;
+    RunResult Result = Run (Child) ;
+
+    // With one undefined transition left, the machine can only halt when it gets there
+    if (Result == RunResult::UNDEFINED && Child.nDefined == 2 * MachineStates - 1)
+      continue ;
+
+    if (Child.nDefined == ShardDepth || (Result == RunResult::LIMIT && Child.nDefined < ShardDepth))
+      if (nUnits++ % nShards != Shard) continue ;
+
+    if (Result == RunResult::LIMIT)
+      {
+      MachineIndex = PackKey (Child) ;
+      return true ;
+      }
+
+    Child.Choice = 0 ;
+    Child.nChoices = 4 * std::min (Child.MaxState + 1, MachineStates) ;
+    Depth++ ;
+    }
+
+  return false ;
+  }
+
+uint64_t TNFEnumerator::Count (uint64_t Limit)
+  {
+  Reset() ;
+  uint64_t n = 0 ;
+  uint64_t MachineIndex ;
+  while (n < Limit && Next (MachineIndex)) n++ ;
+  Reset() ;
+  return n ;
+  }
+
+// void TNFEnumerator::MakeChild (Level& Child, const Level& Parent, uint32_t Choice)
+//
+// Child becomes a copy of Parent, in the same configuration, with the transition
+// that Parent reached defined by Choice:
+//
+//   Write = (Choice >> 1) & 1, Move = Choice & 1, Next = (Choice >> 2) + 1
+//
+// except that the root's only child has A0 = 1RB
+
+void TNFEnumerator::MakeChild (Level& Child, const Level& Parent, uint32_t Choice)
+  {
+  // Clear the cells that Child last used before copying Parent's
+  memset (Child.Tape.data() + SpaceLimit + Child.Leftmost, 0, Child.Rightmost - Child.Leftmost + 1) ;
+  memcpy (Child.Tape.data() + SpaceLimit + Parent.Leftmost, Parent.Tape.data() + SpaceLimit + Parent.Leftmost,
+    Parent.Rightmost - Parent.Leftmost + 1) ;
+  Child.TapeHead = Parent.TapeHead ;
+  Child.Leftmost = Parent.Leftmost ;
+  Child.Rightmost = Parent.Rightmost ;
+  Child.State = Parent.State ;
+  Child.StepCount = Parent.StepCount ;
+
+  memcpy (Child.TM, Parent.TM, sizeof (Child.TM)) ;
+  Transition& T = Child.TM[Parent.State][Parent.Tape[SpaceLimit + Parent.TapeHead]] ;
+  if (Parent.nDefined == 0)
+    {
+    T.Write = 1 ;
+    T.Move = 0 ;
+    T.Next = 2 ;
+    }
+  else
+    {
+    T.Write = (Choice >> 1) & 1 ;
+    T.Move = Choice & 1 ;
+    T.Next = (Choice >> 2) + 1 ;
+    }
+  Child.nDefined = Parent.nDefined + 1 ;
+  Child.MaxState = std::max (Parent.MaxState, (uint32_t)T.Next) ;
+  }
+
+// RunResult TNFEnumerator::Run (Level& L)
+//
+// Runs L until it reaches an undefined transition or one of its limits
+
+TNFEnumerator::RunResult TNFEnumerator::Run (Level& L)
+  {
+  uint8_t* Tape = L.Tape.data() + SpaceLimit ;
+  for (;;)
+    {
+    const Transition& T = L.TM[L.State][Tape[L.TapeHead]] ;
+    if (T.Next == 0) return RunResult::UNDEFINED ;
+    if (L.StepCount == TimeLimit) return RunResult::LIMIT ;
+
+    Tape[L.TapeHead] = T.Write ;
+    if (T.Move)
+      {
+      if (--L.TapeHead < L.Leftmost) L.Leftmost = L.TapeHead ;
+      }
+    else if (++L.TapeHead > L.Rightmost) L.Rightmost = L.TapeHead ;
+    L.State = T.Next ;
+    L.StepCount++ ;
+
+    if (L.Rightmost - L.Leftmost >= (int)SpaceLimit) return RunResult::LIMIT ;
+    }
+  }
+
+uint64_t TNFEnumerator::PackKey (const Level& L) const
+  {
+  uint64_t Key = 0 ;
+  for (uint32_t s = 1 ; s <= MachineStates ; s++)
+    for (uint32_t r = 0 ; r <= 1 ; r++)
+      {
+      const Transition& T = L.TM[s][r] ;
+      Key = (Key << 5) | T.Write | (T.Move << 1) | (T.Next << 2) ;
+      }
+  return Key ;
+  }
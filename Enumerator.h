@@ -0,0 +1,121 @@
+// Enumerator.h
+//
+// TNFEnumerator class
+
+#pragma once
+
+// class TNFEnumerator
+//
+// Generates the machines of a Tree Normal Form (TNF) enumeration one at a time, so
+// the Deciders can run on all the machines with a given number of states without a
+// database file ever being written. A database name of the form
+//
+//   -DTNF[:<option>,<option>...]
+//     <option>: T<time limit>          Steps before a machine is emitted
+//               S<space limit>         Tape cells before a machine is emitted
+//               K<shard>/<shards>      Emit only shard <shard> (0 to <shards>-1)
+//
+// selects the enumerator instead of a database file (see TuringMachineReader).
+//
+// The enumeration starts from the machine whose only transition is A0 = 1RB, and
+// runs each machine from a blank tape until it reaches an undefined transition.
+// If that is the last undefined transition, the machine can only halt, so it is
+// dropped; otherwise the enumeration branches over every way of defining the
+// transition: Write 0 or 1, Move R or L, and a state that has already been used or
+// the next new one. A machine that runs for more than the time limit, or visits
+// more than the space limit of tape cells, is emitted, with its remaining
+// transitions undefined (---). The time and space limits default to 1000 for up to
+// 4 states, and to the limits of the 5-state seed database (47176870 and 12289)
+// for 5 and 6 states.
+//
+// Each machine is identified by its spec, packed into 5 bits per transition in
+// the same way as TuringMachineSpec::CanonicalKey with Flags = 0 (A0 in the most
+// significant bits). This key is its machine index, in umfs, dvfs, and with -X,
+// so an index is the same whatever the limits and sharding, and a machine can be
+// read back from its index alone (see TuringMachineSpec::KeyToSpec). The machine
+// indices of an enumeration are not consecutive, or in increasing order, so -G
+// can't be used with one (see CompressedUmf.h).
+//
+// The enumeration tree is walked depth first, with one level of an explicit stack
+// for each defined transition, so Next can return each machine as it is found.
+// Every level holds the configuration in which its machine reached its undefined
+// transition, so each child machine carries on from there rather than starting
+// again from a blank tape.
+//
+// Sharding: the machines with ShardDepth transitions defined (and any machines
+// emitted with fewer) are numbered in the order in which they are reached, and
+// shard K of N takes those whose number is K modulo N, together with all their
+// descendants. Every shard walks the (small) tree above ShardDepth in full, so the
+// numbering is the same for all of them, and the shards are disjoint and cover the
+// whole enumeration.
+
+#include <string>
+#include <vector>
+
+#include "bbchallenge.h"
+
+class TNFEnumerator
+  {
+public:
+  // True if DatabaseName selects the enumerator
+  static bool IsEnumeration (const std::string& DatabaseName) ;
+
+  // Parses the options in DatabaseName
+  void Initialise (const std::string& DatabaseName, uint32_t MachineStates) ;
+
+  // Starts the enumeration again
+  void Reset() ;
+
+  // Returns false when the enumeration (or its shard) is complete
+  bool Next (uint64_t& MachineIndex) ;
+
+  // Counts the machines in the enumeration (stopping at Limit), and resets it
+  uint64_t Count (uint64_t Limit = UINT64_MAX) ;
+
+  static uint64_t MachineIndexLimit (uint32_t MachineStates)
+    {
+    return 1ULL << (10 * MachineStates) ;
+    }
+
+  uint32_t MachineStates ;
+  uint64_t TimeLimit ;
+  uint32_t SpaceLimit ;
+  uint32_t Shard = 0 ;
+  uint32_t nShards = 1 ;
+
+private:
+  struct Transition
+    {
+    uint8_t Write ;
+    uint8_t Move ; // 1 = Left, 0 = Right
+    uint8_t Next ; // 0 = undefined
+    } ;
+
+  // A machine in the enumeration, and the configuration in which it reached an
+  // undefined transition (or its limit)
+  struct Level
+    {
+    Transition TM[MAX_MACHINE_STATES + 1][2] ;
+    uint32_t nDefined ;
+    uint32_t MaxState ; // Highest state used so far
+    std::vector<uint8_t> Tape ; // Cell 0 is Tape[SpaceLimit]
+    int TapeHead ;
+    int Leftmost ;
+    int Rightmost ;
+    uint8_t State ;
+    uint64_t StepCount ;
+    uint32_t Choice ;   // Next child to be generated
+    uint32_t nChoices ;
+    } ;
+
+  enum class RunResult { UNDEFINED, LIMIT } ;
+
+  void MakeChild (Level& Child, const Level& Parent, uint32_t Choice) ;
+  RunResult Run (Level& L) ;
+  uint64_t PackKey (const Level& L) const ;
+
+  std::vector<Level> Stack ;
+  uint32_t Depth ;
+  uint32_t ShardDepth ;
+  uint64_t nUnits ; // Machines numbered for sharding so far
+  } ;
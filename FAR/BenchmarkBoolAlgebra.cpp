@@ -0,0 +1,98 @@
+// BenchmarkBoolAlgebra
+//
+// Compares the two boolean matrix product kernels in BoolAlgebra.h on random
+// matrices, for NFA widths from 11 to 121:
+//
+//   Multiply             -- BoolMatrix::Multiply, one row of W for each 1-bit of V
+//   FourRussians         -- BoolMatrix::MultiplyFourRussians (including building the tables)
+//   v*M, Table           -- single vector-matrix products, with and without a prebuilt
+//                           BoolMatrixTable
+//   Build                -- time to build the BoolMatrixTable
+//   Break-even           -- number of vector-matrix products needed to repay Build
+//
+// Times are in microseconds per matrix product or per vector product. Every
+// product is checked against the plain kernel.
+
+#include <time.h>
+#include <random>
+
+#include "FAR.h"
+
+using Vector = FiniteAutomataReduction::Vector ;
+using Matrix = FiniteAutomataReduction::Matrix ;
+using MatrixTable = BoolMatrixTable<FiniteAutomataReduction::MaxNFA_States> ;
+
+static std::mt19937 Random (12345) ;
+
+static void RandomVector (Vector& v, uint32_t Width, uint32_t Density) ;
+static void RandomMatrix (Matrix& M, uint32_t Width, uint32_t Density) ;
+template<class F> static double TimeIt (F Function) ;
+
+static Matrix V, W, U1, U2 ;
+static Vector VectorList[256] ;
+static uint32_t Checksum ;
+
+int main()
+  {
+  printf ("Width Density   Multiply FourRussians     v*M   Table   Build Break-even\n") ;
+  for (uint32_t Width = 11 ; Width <= 121 ; Width += 10)
+    for (uint32_t Density : { 10, 25, 50 })
+      {
+      RandomMatrix (V, Width, Density) ;
+      RandomMatrix (W, Width, Density) ;
+      for (Vector& v : VectorList) RandomVector (v, Width, Density) ;
+
+      double MultiplyTime = TimeIt ([] { Matrix::Multiply (U1, V, W) ; Checksum += U1[0].d[0] ; }) ;
+      double FourRussiansTime = TimeIt ([] { Matrix::MultiplyFourRussians (U2, V, W) ; Checksum += U2[0].d[0] ; }) ;
+      Matrix::Multiply (U1, V, W) ;
+      Matrix::MultiplyFourRussians (U2, V, W) ;
+      for (uint32_t i = 0 ; i < Width ; i++)
+        if (U1[i] != U2[i]) printf ("\nProduct mismatch at width %d\n", Width), exit (1) ;
+
+      static MatrixTable Table ;
+      double BuildTime = TimeIt ([] { Table.Set (W) ; Checksum += Table.nGroups ; }) ;
+      Table.Set (W) ;
+      for (const Vector& v : VectorList)
+        if (v * W != Table.Multiply (v)) printf ("\nVector product mismatch at width %d\n", Width), exit (1) ;
+
+      double VectorTime = TimeIt ([] { for (const Vector& v : VectorList) Checksum += (v * W).d[0] ; }) / 256 ;
+      double TableTime = TimeIt ([] { for (const Vector& v : VectorList) Checksum += Table.Multiply (v).d[0] ; }) / 256 ;
+
+      printf ("%5d %6d%% %10.3f %12.3f %7.3f %7.3f %7.3f", Width, Density,
+        MultiplyTime, FourRussiansTime, VectorTime, TableTime, BuildTime) ;
+      if (TableTime < VectorTime) printf (" %10.0f\n", BuildTime / (VectorTime - TableTime)) ;
+      else printf ("      never\n") ;
+      }
+
+  printf ("(checksum %08X)\n", Checksum) ;
+  }
+
+static void RandomVector (Vector& v, uint32_t Width, uint32_t Density)
+  {
+  v.SetBitWidth (Width) ;
+  for (uint32_t i = 0 ; i < Width ; i++)
+    if (Random() % 100 < Density) v.SetBit (i) ;
+  }
+
+static void RandomMatrix (Matrix& M, uint32_t Width, uint32_t Density)
+  {
+  M.SetBitWidth (Width) ;
+  for (uint32_t i = 0 ; i < Width ; i++)
+    RandomVector (M[i], Width, Density) ;
+  }
+
+// template<class F> static double TimeIt (F Function)
+//
+// Returns the time taken by Function in microseconds, calling it often enough
+// to get a reasonably accurate figure
+
+template<class F> static double TimeIt (F Function)
+  {
+  for (uint32_t nCalls = 1 ; ; nCalls *= 2)
+    {
+    clock_t Timer = clock() ;
+    for (uint32_t n = 0 ; n < nCalls ; n++) Function() ;
+    Timer = clock() - Timer ;
+    if (Timer > CLOCKS_PER_SEC / 50) return 1e6 * Timer / CLOCKS_PER_SEC / nCalls ;
+    }
+  }
@@ -1,6 +1,16 @@
 // BoolAlgebra.h
 //
 // Boolean vectors and matrices
+//
+// Vectors of up to 256 bits (which covers every NFA that FAR can generate) are
+// "fixed-width": the operations process all MaxWords words whatever the BitWidth,
+// relying on the unused bits always being 0. So the loops have constant length, and
+// 128-bit and 256-bit vectors are handled with single SSE4.1 or AVX2 instructions
+// when the compiler is allowed to use them (e.g. with -march=native). Wider vectors
+// use plain loops over the nWords words that are actually in use.
+//
+// Range and width checks are compiled in only if BOOL_ALGEBRA_CHECKS is defined.
+// Read, Write and SetBitWidth always check their arguments.
 
 #pragma once
 
@@ -8,6 +18,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <bit>
+#include <vector>
+
+#if defined (__AVX2__) || defined (__SSE4_1__)
+  #include <immintrin.h>
+#endif
 
 #if UINTPTR_MAX > 0xFFFFFFFF // If pointers are 64-bit
   // 64-bit bitmaps
@@ -29,11 +45,89 @@
   printf ("\nBoolAlgebra error at line %d in %s\n", \
   __LINE__, __FUNCTION__), exit (1)
 
+#ifdef BOOL_ALGEBRA_CHECKS
+  #define BOOL_ALGEBRA_CHECK(cond) if (!(cond)) BOOL_ALGEBRA_ERROR()
+#else
+  #define BOOL_ALGEBRA_CHECK(cond)
+#endif
+
+// Operations on fixed-width word arrays a and b of N words each
+
+template<int N> inline void WordsOr (bitmap_t* a, const bitmap_t* b) // a |= b
+  {
+#if defined (__AVX2__)
+  if constexpr (N * BITS_IN_WORD == 256)
+    {
+    __m256i x = _mm256_loadu_si256 ((const __m256i*)a) ;
+    __m256i y = _mm256_loadu_si256 ((const __m256i*)b) ;
+    _mm256_storeu_si256 ((__m256i*)a, _mm256_or_si256 (x, y)) ;
+    return ;
+    }
+#endif
+  for (int i = 0 ; i < N ; i++) a[i] |= b[i] ;
+  }
+
+template<int N> inline void WordsAndNot (bitmap_t* a, const bitmap_t* b) // a &= ~b
+  {
+#if defined (__AVX2__)
+  if constexpr (N * BITS_IN_WORD == 256)
+    {
+    __m256i x = _mm256_loadu_si256 ((const __m256i*)a) ;
+    __m256i y = _mm256_loadu_si256 ((const __m256i*)b) ;
+    _mm256_storeu_si256 ((__m256i*)a, _mm256_andnot_si256 (y, x)) ;
+    return ;
+    }
+#endif
+  for (int i = 0 ; i < N ; i++) a[i] &= ~b[i] ;
+  }
+
+template<int N> inline bool WordsMeet (const bitmap_t* a, const bitmap_t* b) // (a & b) != 0
+  {
+#if defined (__AVX2__)
+  if constexpr (N * BITS_IN_WORD == 256)
+    return !_mm256_testz_si256 (_mm256_loadu_si256 ((const __m256i*)a),
+                                _mm256_loadu_si256 ((const __m256i*)b)) ;
+#endif
+#if defined (__SSE4_1__)
+  if constexpr (N * BITS_IN_WORD == 128)
+    return !_mm_testz_si128 (_mm_loadu_si128 ((const __m128i*)a),
+                             _mm_loadu_si128 ((const __m128i*)b)) ;
+#endif
+  bitmap_t x = 0 ;
+  for (int i = 0 ; i < N ; i++) x |= a[i] & b[i] ;
+  return x != 0 ;
+  }
+
+template<int N> inline bool WordsSubset (const bitmap_t* a, const bitmap_t* b) // (a & ~b) == 0
+  {
+#if defined (__AVX2__)
+  if constexpr (N * BITS_IN_WORD == 256)
+    return _mm256_testc_si256 (_mm256_loadu_si256 ((const __m256i*)b),
+                               _mm256_loadu_si256 ((const __m256i*)a)) ;
+#endif
+#if defined (__SSE4_1__)
+  if constexpr (N * BITS_IN_WORD == 128)
+    return _mm_testc_si128 (_mm_loadu_si128 ((const __m128i*)b),
+                            _mm_loadu_si128 ((const __m128i*)a)) ;
+#endif
+  bitmap_t x = 0 ;
+  for (int i = 0 ; i < N ; i++) x |= a[i] & ~b[i] ;
+  return x == 0 ;
+  }
+
+template<int N> inline bool WordsZero (const bitmap_t* a)
+  {
+  bitmap_t x = 0 ;
+  for (int i = 0 ; i < N ; i++) x |= a[i] ;
+  return x == 0 ;
+  }
+
 template <int MaxBits> class BoolVector
   {
 public:
   static const int MaxBytes = (MaxBits + 7) >> 3 ;
   static const int MaxWords = (MaxBits + BIT_MASK) >> BIT_SHIFT ;
+  static const bool FixedWidth = MaxWords * BITS_IN_WORD <= 256 ;
 
   explicit BoolVector (uint32_t BitWidth = 0)
     {
@@ -41,7 +135,6 @@ public:
     }
   BoolVector (const BoolVector& v) : BoolVector (v.BitWidth)
     {
-if (MaxWords > 1) BOOL_ALGEBRA_ERROR() ;
     memcpy (d, v.d, sizeof (d)) ;
     }
   void SetBitWidth (uint32_t BitWidth)
@@ -54,16 +147,23 @@ if (MaxWords > 1) BOOL_ALGEBRA_ERROR() ;
     }
 
   void Read (FILE* fp, uint32_t BitWidth) ;
+  void Read (const uint8_t* Data, uint32_t BitWidth) ; // (BitWidth + 7) >> 3 bytes
   void Write (FILE* fp) ;
   bool BitSet (uint32_t bitnum) const ;
   bool SetBit (uint32_t bitnum) // Returns previous state
     {
-    if (bitnum >= BitWidth) BOOL_ALGEBRA_ERROR() ;
-    bool Prev = BitSet (bitnum) ;
-    d[bitnum >> BIT_SHIFT] |= ONE << (bitnum & BIT_MASK) ;
+    BOOL_ALGEBRA_CHECK (bitnum < BitWidth) ;
+    bitmap_t& Word = d[MaxWords == 1 ? 0 : bitnum >> BIT_SHIFT] ;
+    bitmap_t Mask = ONE << (bitnum & BIT_MASK) ;
+    bool Prev = (Word & Mask) != 0 ;
+    Word |= Mask ;
     return Prev ;
     }
-  bool IsZero() const { return !memcmp (d, Zero,sizeof (d)) ; }
+  bool IsZero() const
+    {
+    if constexpr (FixedWidth) return WordsZero<MaxWords> (d) ;
+    return !memcmp (d, Zero,sizeof (d)) ;
+    }
 
   BoolVector& operator= (const BoolVector& v) ;
   bool operator[] (std::size_t idx) const { return BitSet (idx) ; }
@@ -119,6 +219,7 @@ public:
     }
 
   void Read (FILE* fp, uint32_t BitWidth) ;
+  void Read (const uint8_t* Data, uint32_t BitWidth) ; // BitWidth rows
   void Write (FILE* fp) ;
   void SetBitWidth (uint32_t BitWidth)
     {
@@ -154,12 +255,42 @@ public:
   bool operator>= (const BoolMatrix& M) const ;
 
   static void Multiply (BoolMatrix& U, const BoolMatrix& V, const BoolMatrix& W) ;
+  static void MultiplyFourRussians (BoolMatrix& U, const BoolMatrix& V, const BoolMatrix& W) ;
 
   uint16_t BitWidth ;
 
   BoolVector<MaxBits> A[MaxBits] ;
   } ;
 
+// BoolMatrixTable: a BoolMatrix M preprocessed by the Method of Four Russians,
+// for computing many products v * M. The rows of M are taken 8 at a time, and for
+// each group of rows there is a table of the ORs of all 256 subsets of the group;
+// v * M is then the OR of one table entry for each byte of v, instead of one row
+// of M for each 1-bit of v. Building the tables costs 256 ORs per group, so this
+// only pays off if M is used for enough products.
+
+template <int MaxBits> class BoolMatrixTable
+  {
+public:
+  static const int MaxWords = BoolVector<MaxBits>::MaxWords ;
+
+  BoolMatrixTable() { }
+  explicit BoolMatrixTable (const BoolMatrix<MaxBits>& M)
+    {
+    Set (M) ;
+    }
+
+  void Set (const BoolMatrix<MaxBits>& M) ;
+  BoolVector<MaxBits> Multiply (const BoolVector<MaxBits>& v) const ; // Compute v M
+
+  uint16_t BitWidth = 0 ;
+  uint16_t nWords = 0 ;
+  uint16_t nGroups = 0 ;
+
+private:
+  std::vector<bitmap_t> Table ; // 256 entries of MaxWords words for each group
+  } ;
+
 // User-defined operators to post-/pre-multiply a BoolVector by a matrix
 template<int MaxBits> BoolVector<MaxBits> operator*
   (const BoolVector<MaxBits>& v, const BoolMatrix<MaxBits>& M) ; // Compute v M
@@ -170,6 +301,19 @@ template<int MaxBits> void BoolVector<MaxBits>::Read (FILE* fp, uint32_t BitWidt
   {
   SetBitWidth (BitWidth) ;
   if (fread (d, nBytes, 1, fp) != 1) BOOL_ALGEBRA_ERROR() ;
+
+  // Padding bits must be clear, since the fixed-width operations don't mask them off
+  if (BitWidth & BIT_MASK)
+    if (d[nWords - 1] >> (BitWidth & BIT_MASK)) BOOL_ALGEBRA_ERROR() ;
+  }
+
+template<int MaxBits> void BoolVector<MaxBits>::Read (const uint8_t* Data, uint32_t BitWidth)
+  {
+  SetBitWidth (BitWidth) ;
+  memcpy (d, Data, nBytes) ;
+
+  if (BitWidth & BIT_MASK)
+    if (d[nWords - 1] >> (BitWidth & BIT_MASK)) BOOL_ALGEBRA_ERROR() ;
   }
 
 template<int MaxBits> void BoolVector<MaxBits>::Write (FILE* fp)
@@ -177,15 +321,23 @@ template<int MaxBits> void BoolVector<MaxBits>::Write (FILE* fp)
   if (fwrite (d, nBytes, 1, fp) != 1) BOOL_ALGEBRA_ERROR() ;
   }
 
-template<int MaxBits> bool BoolVector<MaxBits>::BitSet (uint32_t n) const 
+template<int MaxBits> bool BoolVector<MaxBits>::BitSet (uint32_t n) const
   {
-  if (n >= BitWidth) BOOL_ALGEBRA_ERROR() ;
-  return (d[n >> BIT_SHIFT] & (ONE << (n & BIT_MASK))) != 0 ;
+  BOOL_ALGEBRA_CHECK (n < BitWidth) ;
+  return (d[MaxWords == 1 ? 0 : n >> BIT_SHIFT] & (ONE << (n & BIT_MASK))) != 0 ;
   }
 
 template<int MaxBits> BoolVector<MaxBits>& BoolVector<MaxBits>::operator= (const BoolVector<MaxBits>& v)
   {
   if (&v == this) return *this ;
+  if constexpr (FixedWidth)
+    {
+    BitWidth = v.BitWidth ;
+    nBytes = v.nBytes ;
+    nWords = v.nWords ;
+    memcpy (d, v.d, sizeof (d)) ;
+    return *this ;
+    }
   SetBitWidth (v.BitWidth) ;
   memcpy (d, v.d, nBytes) ;
   return *this ;
@@ -193,7 +345,12 @@ template<int MaxBits> BoolVector<MaxBits>& BoolVector<MaxBits>::operator= (const
 
 template<int MaxBits> BoolVector<MaxBits>& BoolVector<MaxBits>::operator+= (const BoolVector<MaxBits>& v)
   {
-  if (v.BitWidth != BitWidth) BOOL_ALGEBRA_ERROR() ;
+  BOOL_ALGEBRA_CHECK (v.BitWidth == BitWidth) ;
+  if constexpr (FixedWidth)
+    {
+    WordsOr<MaxWords> (d, v.d) ;
+    return *this ;
+    }
   for (uint32_t i = 0 ; i < nWords ; i++)
     d[i] |= v.d[i] ;
   return *this ;
@@ -201,7 +358,12 @@ template<int MaxBits> BoolVector<MaxBits>& BoolVector<MaxBits>::operator+= (cons
 
 template<int MaxBits> BoolVector<MaxBits>& BoolVector<MaxBits>::operator-= (const BoolVector<MaxBits>& v)
   {
-  if (v.BitWidth != BitWidth) BOOL_ALGEBRA_ERROR() ;
+  BOOL_ALGEBRA_CHECK (v.BitWidth == BitWidth) ;
+  if constexpr (FixedWidth)
+    {
+    WordsAndNot<MaxWords> (d, v.d) ;
+    return *this ;
+    }
   for (uint32_t i = 0 ; i < nWords ; i++)
     d[i] &= ~v.d[i] ;
   return *this ;
@@ -209,7 +371,9 @@ template<int MaxBits> BoolVector<MaxBits>& BoolVector<MaxBits>::operator-= (cons
 
 template<int MaxBits> bool BoolVector<MaxBits>::operator* (const BoolVector<MaxBits>& v) const
   {
-  if (v.BitWidth != BitWidth) BOOL_ALGEBRA_ERROR() ;
+  BOOL_ALGEBRA_CHECK (v.BitWidth == BitWidth) ;
+  if (nWords == 1) return (d[0] & v.d[0]) != 0 ;
+  if constexpr (FixedWidth) return WordsMeet<MaxWords> (d, v.d) ;
   for (uint32_t i = 0 ; i < nWords ; i++)
     if (d[i] & v.d[i]) return true ;
   return false ;
@@ -217,7 +381,8 @@ template<int MaxBits> bool BoolVector<MaxBits>::operator* (const BoolVector<MaxB
 
 template<int MaxBits> bool BoolVector<MaxBits>::operator<= (const BoolVector<MaxBits>& v) const
   {
-  if (v.BitWidth != BitWidth) BOOL_ALGEBRA_ERROR() ;
+  BOOL_ALGEBRA_CHECK (v.BitWidth == BitWidth) ;
+  if constexpr (FixedWidth) return WordsSubset<MaxWords> (d, v.d) ;
   for (uint32_t i = 0 ; i < nWords ; i++)
     if (d[i] & ~v.d[i]) return false ;
   return true ;
@@ -225,8 +390,9 @@ template<int MaxBits> bool BoolVector<MaxBits>::operator<= (const BoolVector<Max
 
 template<int MaxBits> bool BoolVector<MaxBits>::operator>= (const BoolVector<MaxBits>& v) const
   {
-  if (v.BitWidth != BitWidth)
-    BOOL_ALGEBRA_ERROR() ;
+  BOOL_ALGEBRA_CHECK (v.BitWidth == BitWidth) ;
+  if (nWords == 1) return (v.d[0] & ~d[0]) == 0 ;
+  if constexpr (FixedWidth) return WordsSubset<MaxWords> (v.d, d) ;
   for (uint32_t i = 0 ; i < nWords ; i++)
     if (~d[i] & v.d[i]) return false ;
   return true ;
@@ -235,7 +401,7 @@ template<int MaxBits> bool BoolVector<MaxBits>::operator>= (const BoolVector<Max
 template<int MaxBits> BoolMatrix<MaxBits>& BoolMatrix<MaxBits>::operator= (const BoolMatrix<MaxBits>& v)
   {
   if (&v == this) return *this ;
-  SetBitWidth (v.BitWidth) ;
+  BitWidth = v.BitWidth ; // Each row sets its own width
   for (uint32_t i = 0 ; i < BitWidth ; i++)
     A[i] = v[i] ;
   return *this ;
@@ -243,23 +409,45 @@ template<int MaxBits> BoolMatrix<MaxBits>& BoolMatrix<MaxBits>::operator= (const
 
 // BoolVector<MaxBits> operator* (const BoolVector<MaxBits>& v, const BoolMatrix<MaxBits>* M)
 //
-// Returns v * M
+// Returns v * M, the OR of the rows of M selected by the 1-bits of v
 
 template<int MaxBits> BoolVector<MaxBits> operator* (const BoolVector<MaxBits>& v, const BoolMatrix<MaxBits>& M)
   {
   BoolVector<MaxBits> result (v.BitWidth) ;
-  for (uint32_t i = 0 ; i < v.BitWidth ; i++)
-    if (v[i]) result += M[i] ;
+  BOOL_ALGEBRA_CHECK (M.BitWidth == v.BitWidth) ;
+  if (v.nWords == 1)
+    {
+    for (bitmap_t b = v.d[0] ; b ; b &= b - 1)
+      result.d[0] |= M.A[std::countr_zero (b)].d[0] ;
+    return result ;
+    }
+  uint32_t nWords = BoolVector<MaxBits>::FixedWidth ? BoolVector<MaxBits>::MaxWords : v.nWords ;
+  for (uint32_t w = 0 ; w < nWords ; w++)
+    for (bitmap_t b = v.d[w] ; b ; b &= b - 1)
+      result += M.A[(w << BIT_SHIFT) + std::countr_zero (b)] ;
   return result ;
   }
 
 // BoolVector<MaxBits> operator* (const BoolMatrix<MaxBits>& M, const BoolVector<MaxBits>& v)
 //
-// Returns M * v
+// Returns M * v: bit i of the result is set iff row i of M meets v
 
 template<int MaxBits> BoolVector<MaxBits> operator* (const BoolMatrix<MaxBits>& M, const BoolVector<MaxBits>& v)
   {
   BoolVector<MaxBits> result (v.BitWidth) ;
+  BOOL_ALGEBRA_CHECK (M.BitWidth == v.BitWidth) ;
+  if constexpr (BoolVector<MaxBits>::FixedWidth)
+    {
+    if (v.nWords == 1)
+      {
+      for (uint32_t i = 0 ; i < v.BitWidth ; i++)
+        result.d[0] |= bitmap_t ((M.A[i].d[0] & v.d[0]) != 0) << i ;
+      return result ;
+      }
+    for (uint32_t i = 0 ; i < v.BitWidth ; i++)
+      result.d[i >> BIT_SHIFT] |= bitmap_t (M.A[i] * v) << (i & BIT_MASK) ;
+    return result ;
+    }
   for (uint32_t i = 0 ; i < v.BitWidth ; i++)
     if (v * M[i]) result.SetBit (i) ;
   return result ;
@@ -272,15 +460,24 @@ template<int MaxBits> void BoolMatrix<MaxBits>::Read (FILE* fp, uint32_t BitWidt
     A[i].Read (fp, BitWidth) ;
   }
 
+template<int MaxBits> void BoolMatrix<MaxBits>::Read (const uint8_t* Data, uint32_t BitWidth)
+  {
+  SetBitWidth (BitWidth) ;
+  uint32_t nBytes = (BitWidth + 7) >> 3 ;
+  for (uint32_t i = 0 ; i < BitWidth ; i++)
+    A[i].Read (Data + i * nBytes, BitWidth) ;
+  }
+
 template<int MaxBits> void BoolMatrix<MaxBits>::Write (FILE* fp)
   {
   for (uint32_t i = 0 ; i < BitWidth ; i++)
     A[i].Write (fp) ;
   }
 
-// void BoolVector<MaxBits>::Multiply (BoolVector<MaxBits>* U, const BoolVector<MaxBits>* V, const BoolVector<MaxBits>* W)
+// void BoolMatrix<MaxBits>::Multiply (BoolMatrix<MaxBits>& U, const BoolMatrix<MaxBits>& V,
+//   const BoolMatrix<MaxBits>& W)
 //
-// Matrix multiplication: U = V * W
+// Matrix multiplication: U = V * W, one row of W for each 1-bit of V
 
 template<int MaxBits> void BoolMatrix<MaxBits>::Multiply (BoolMatrix<MaxBits>& U,
   const BoolMatrix<MaxBits>& V, const BoolMatrix<MaxBits>& W)
@@ -289,9 +486,73 @@ template<int MaxBits> void BoolMatrix<MaxBits>::Multiply (BoolMatrix<MaxBits>& U
     U[i] = V[i] * W ;
   }
 
+// void BoolMatrix<MaxBits>::MultiplyFourRussians (BoolMatrix<MaxBits>& U,
+//   const BoolMatrix<MaxBits>& V, const BoolMatrix<MaxBits>& W)
+//
+// Matrix multiplication: U = V * W, using a BoolMatrixTable for W
+
+template<int MaxBits> void BoolMatrix<MaxBits>::MultiplyFourRussians (BoolMatrix<MaxBits>& U,
+  const BoolMatrix<MaxBits>& V, const BoolMatrix<MaxBits>& W)
+  {
+  BOOL_ALGEBRA_CHECK (V.BitWidth == W.BitWidth) ;
+  BoolMatrixTable<MaxBits> Table (W) ;
+  U.BitWidth = V.BitWidth ;
+  for (uint32_t i = 0 ; i < V.BitWidth ; i++)
+    U[i] = Table.Multiply (V[i]) ;
+  }
+
+template<int MaxBits> void BoolMatrixTable<MaxBits>::Set (const BoolMatrix<MaxBits>& M)
+  {
+  BitWidth = M.BitWidth ;
+  nWords = (BitWidth + BIT_MASK) >> BIT_SHIFT ;
+  nGroups = (BitWidth + 7) >> 3 ;
+  Table.resize (nGroups * 256 * MaxWords) ;
+
+  static const bitmap_t Zero[MaxWords] = { } ;
+  for (uint32_t g = 0 ; g < nGroups ; g++)
+    {
+    bitmap_t* T = &Table[g * 256 * MaxWords] ;
+    memset (T, 0, MaxWords * sizeof (bitmap_t)) ;
+
+    // Each entry is an earlier entry plus one row (rows beyond BitWidth are
+    // never selected, since the padding bits of v are always 0)
+    const bitmap_t* Rows[8] ;
+    for (uint32_t r = 0 ; r < 8 ; r++)
+      Rows[r] = 8 * g + r < BitWidth ? M.A[8 * g + r].d : Zero ;
+    for (uint32_t s = 1 ; s < 256 ; s++)
+      {
+      bitmap_t* Entry = T + s * MaxWords ;
+      const bitmap_t* Prev = T + (s & (s - 1)) * MaxWords ;
+      const bitmap_t* Row = Rows[std::countr_zero (s)] ;
+      if constexpr (BoolVector<MaxBits>::FixedWidth)
+        for (uint32_t w = 0 ; w < MaxWords ; w++) Entry[w] = Prev[w] | Row[w] ;
+      else
+        {
+        memcpy (Entry, Prev, MaxWords * sizeof (bitmap_t)) ;
+        for (uint32_t w = 0 ; w < nWords ; w++) Entry[w] |= Row[w] ;
+        }
+      }
+    }
+  }
+
+template<int MaxBits> BoolVector<MaxBits> BoolMatrixTable<MaxBits>::Multiply (const BoolVector<MaxBits>& v) const
+  {
+  BoolVector<MaxBits> result (BitWidth) ;
+  BOOL_ALGEBRA_CHECK (v.BitWidth == BitWidth) ;
+  const uint8_t* Bytes = (const uint8_t*)v.d ; // Little-endian, like Read and Write
+  for (uint32_t g = 0 ; g < nGroups ; g++)
+    {
+    if (Bytes[g] == 0) continue ;
+    const bitmap_t* Entry = &Table[(g * 256 + Bytes[g]) * MaxWords] ;
+    if constexpr (BoolVector<MaxBits>::FixedWidth) WordsOr<MaxWords> (result.d, Entry) ;
+    else for (uint32_t w = 0 ; w < nWords ; w++) result.d[w] |= Entry[w] ;
+    }
+  return result ;
+  }
+
 template<int MaxBits> bool BoolMatrix<MaxBits>::operator<= (const BoolMatrix<MaxBits>& M) const
   {
-  if (M.BitWidth != BitWidth) BOOL_ALGEBRA_ERROR() ;
+  BOOL_ALGEBRA_CHECK (M.BitWidth == BitWidth) ;
   for (uint32_t i = 0 ; i < BitWidth ; i++)
     if (!(A[i] <= M[i])) return false ;
   return true ;
@@ -299,7 +560,7 @@ template<int MaxBits> bool BoolMatrix<MaxBits>::operator<= (const BoolMatrix<Max
 
 template<int MaxBits> bool BoolMatrix<MaxBits>::operator>= (const BoolMatrix<MaxBits>& M) const
   {
-  if (M.BitWidth != BitWidth) BOOL_ALGEBRA_ERROR() ;
+  BOOL_ALGEBRA_CHECK (M.BitWidth == BitWidth) ;
   for (uint32_t i = 0 ; i < BitWidth ; i++)
     if (!(A[i] >= M[i])) return false ;
   return true ;
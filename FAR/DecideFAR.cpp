@@ -4,45 +4,187 @@
 //            -V<verification file> Output file: verification data for decided machines
 //            -I<input file>        Input file: list of machines to be analysed (default=all machines)
 //            -U<undecided file>    Output file: remaining undecided machines
+//            -G                    Write a compressed umf and a compact dvf
+//            -XI                   Write a dvf index along with the dvf (see ../DvfIndex.h)
 //            -X<test machine>      Machine to test
 //            -M<machine spec>      Compact machine code (ASCII spec) to test
 //            -L<machine limit>     Max no. of machines to test
+//            -R<start>:<end>       Machines <start> to <end>-1 of the input file or database
 //            -H<threads>           Number of threads to use
 //            -O                    Print trace output
 //            -A<DFA states>        Number of DFA states
 //            -F                    Output NFA to dvf as well as DFA
+//            -P<extension limit>   Search machines needing more extensions in parallel
+//            -C<cache size>        Try the most successful DFAs so far first
+//            -E<initial DFA states> Try each DFA size from <initial DFA states> up to -A
+//            -B<extension budget>  NFA extensions per DFA size below -A (with -E)
+//            -S[<range size>]      Stream machines in ranges of <range size> (default 1000)
+//            -K                    Decide each canonical class of machines once
+//
+// If more than one thread is used, any machine that is still undecided after
+// <extension limit> NFA extensions (default 1000000) is put aside. When all the
+// other machines have been done, the DFA search tree of each of these machines is
+// split into subtrees (by Direction and the first few DFA transitions), which are
+// handed out to the threads one by one. As soon as a subtree succeeds, the threads
+// abandon any later subtrees of the same machine; earlier subtrees are searched to
+// the end, so the DFA found is the same as in a single-threaded search.
+//
+// With -C, the Decider keeps a cache of up to <cache size> DFAs that have decided
+// machines, ranked by the number of machines they have decided. Each machine is
+// tested against the cached DFAs (in both directions) before the full search. The
+// same machines are decided as without -C, but not necessarily by the same DFAs.
+//
+// With -E, each machine is tried with DFA sizes <initial DFA states>, <initial DFA
+// states> + 1, and so on up to -A, and output with the first DFA size that decides
+// it. If -B is also given, the search at each size below -A gives up after
+// <extension budget> NFA extensions and moves on to the next size.
+//
+// With -S, the machines are not all read into memory before the search starts.
+// Each thread reads a range of up to <range size> machines when it needs one, and
+// the results of each range are written as soon as it and all the ranges before
+// it are complete, so the output is in the same order as without -S. No more than
+// 4 * <threads> ranges are held in memory at once, whatever the number of
+// machines. -P is ignored, since a machine that was put aside would hold up all
+// the output after it.
+//
+// With -K, machines that are the same up to state renaming, unused transitions and
+// mirror images (see TuringMachineSpec::CanonicalKey) are only searched once: the
+// first machine of each class to be decided gives its verdict to the rest. The DFA
+// of a decided class is checked against each later machine, in the opposite
+// Direction if one machine is the mirror image of the other; if the check fails
+// (which is only possible for machines with unused transitions), the machine is
+// searched as usual. A failed search can't be shared so widely, because FAR uses
+// the unused transitions, and tries one Direction before the other within a single
+// extension limit; so a machine is only left undecided without a search if it is
+// the same up to state renaming alone as one that was searched and not decided.
+//
+// With -S, a checkpoint is saved every few minutes, when a range has been written,
+// so that if the run is interrupted, running it again with the same parameters
+// resumes from the last checkpoint (see ../Checkpoint.h). The DFA cache (-C) and the
+// canonical class cache (-K) are saved with it. Without -S, nothing is written until
+// all the machines have been searched, so there are no checkpoints.
 
 #include <ctype.h>
+#include <inttypes.h> // for PRIu64
 #include <string>
 #include <vector>
+#include <atomic>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "FAR.h"
 #include "../Params.h"
+#include "../Checkpoint.h"
 
 #if NEED_BOOST_THREADS
   #include <boost/thread.hpp>
   #include <boost/thread/mutex.hpp>
   #include <boost/thread/lock_guard.hpp>
+  #include <boost/thread/condition_variable.hpp>
   using boost::thread ;
   using boost::mutex ;
   using boost::lock_guard ;
+  using boost::unique_lock ;
+  using boost::condition_variable ;
 #else
   #include <thread>
   #include <mutex>
+  #include <condition_variable>
   using std::thread ;
   using std::mutex ;
   using std::lock_guard ;
+  using std::unique_lock ;
+  using std::condition_variable ;
 #endif
 
-mutex RangeMutex ;
-static uint32_t TotalAssigned = 0 ;
-static uint32_t TotalCompleted = 0 ;
-static uint32_t TotalDecided = 0 ;
+static mutex RangeMutex ;
+static uint64_t TotalAssigned = 0 ;
+static uint64_t TotalCompleted = 0 ;
+static uint64_t TotalDecided = 0 ;
 static uint32_t LastPercent = -1 ;
 
-static uint32_t* MachineIndexList ;
+static uint64_t* MachineIndexList ;
 static uint8_t* MachineSpecList ;
 static uint8_t* VerificationList ;
+static uint8_t* DFA_SizeList ; // DFA size of each decided machine
+
+// Machines whose results have been written (-S), for checkpoints
+static uint64_t nCommitted = 0 ;
+static uint64_t nDecidedCommitted = 0 ;
+
+#define DEFERRED 0xFE // VerificationList marker for machines left for SubtreeThreadFunction
+
+// Streaming (-S): instead of the lists above, each range of machines is read into
+// a slot when it is assigned, and its results are written as soon as it and all
+// the ranges before it are complete. A thread that wants a new range waits if
+// every slot is in use.
+struct StreamSlot
+  {
+  uint32_t nMachines ;
+  bool Done ;
+  std::vector<uint64_t> IndexList ;
+  std::vector<uint8_t> SpecList ;
+  std::vector<uint8_t> VerifList ;
+  std::vector<uint8_t> DFA_SizeList ;
+  } ;
+#define NO_SLOT 0xFFFFFFFF
+static std::vector<StreamSlot> SlotList ;
+static uint32_t NextSlot = 0 ;   // Slot for the next range
+static uint32_t OldestSlot = 0 ; // Slot of the oldest range not yet written
+static uint32_t nSlotsInUse = 0 ;
+static condition_variable SlotFree ;
+
+static std::vector<uint64_t> DeferredList ; // Machines that reached the extension limit
+static std::vector<uint8_t> PrefixList ;    // Subtree prefixes (see ListPrefixes)
+static uint32_t PrefixLength ;
+static uint32_t nPrefixes ;
+static std::atomic<uint32_t>* FirstSuccess ; // First subtree that succeeded, for each machine
+static uint32_t nJobs ;
+static uint32_t NextJob = 0 ;
+
+// DFA cache (-C): DFAs that have recently decided machines, most hits first
+struct CachedDFA
+  {
+  uint8_t DFA_States ;
+  uint8_t DFA[2 * FiniteAutomataReduction::MaxDFA_States] ;
+  uint32_t Hits ;
+  } ;
+static std::vector<CachedDFA> DFA_Cache ;
+static mutex CacheMutex ;
+
+// Canonical class cache (-K): the verdict of the first machine of each class to
+// be decided, by canonical key, and the keys (allowing for state renaming only) of
+// the machines that were searched and not decided
+struct ClassVerdict
+  {
+  bool Mirrored ;      // The key was the machine's mirror image's
+  uint8_t DFA_States ;
+  uint8_t VerificationEntry[1 + 2 * FiniteAutomataReduction::MaxDFA_States] ;
+  } ;
+static std::unordered_map<uint64_t, ClassVerdict> ClassCache ;
+static std::unordered_set<uint64_t> UndecidedClasses ;
+static mutex ClassMutex ;
+
+struct SearchStats
+  {
+  uint32_t nCacheHits ;
+  uint32_t nCacheMisses ;
+  uint32_t nSearchDecided ;           // Machines decided by a full search
+  uint64_t CacheExtensions ;          // NFA extensions spent trying cached DFAs
+  uint64_t SearchExtensions ;         // NFA extensions spent in full searches
+  uint64_t DecidingSearchExtensions ; // ...in full searches that succeeded
+  uint32_t nOverBudget[FiniteAutomataReduction::MaxDFA_States + 1] ; // -B
+  uint64_t nPruned[FiniteAutomataReduction::N_PRUNE_RULES] ; // Search pruning, by rule
+  uint64_t AllExtensions ;            // NFA extensions in all searches...
+  uint64_t LookaheadExtensions ;      // ...of which in lookahead
+  uint32_t nClassDecided ;            // -K: machines decided by the DFA of their class...
+  uint32_t nClassMirrored ;           // ...of which the mirror image of the first machine
+  uint32_t nClassUndecided ;          // Machines left undecided with their class
+  uint32_t nClassRetried ;            // Machines whose class DFA failed
+  uint64_t ClassExtensions ;          // NFA extensions spent checking class DFAs
+  } ;
+static SearchStats TotalStats ;
+static uint32_t MachineCount[FiniteAutomataReduction::MaxDFA_States + 1] ; // Decided, by DFA size
 
 class CommandLineParams : public DeciderParams
   {
@@ -50,25 +192,54 @@ public:
   uint32_t DFA_States ;
   bool DFA_StatesPresent = false ;
   bool OutputNFA ;
+  uint32_t ExtensionLimit = 1000000 ;
+  uint32_t CacheSize = 0 ;
+  uint32_t InitialDFA_States ;
+  bool InitialDFA_StatesPresent = false ;
+  uint32_t SizeBudget = 0 ;
+  uint32_t StreamRangeSize = 0 ;
+  bool CanonicalCache = false ;
   void Parse (int argc, char** argv) ;
   void PrintHelpAndExit [[noreturn]] (int status) ;
   } ;
 
 static CommandLineParams Params ;
 static TuringMachineReader Reader ;
+static Checkpoint* Check ;
 
 static void ThreadFunction() ;
 struct Range
   {
-  uint32_t First ;
-  uint32_t Last ; // not included in the range
+  uint64_t First ;
+  uint64_t Last ; // not included in the range
+  uint32_t Slot ; // -S
+  const uint8_t* SpecList ;
+  uint8_t* VerifList ;
+  uint8_t* DFA_SizeList ;
   } ;
 static bool GetNextRange (Range& R, uint32_t nCompleted, uint32_t nDecided) ;
+static void CommitRanges() ;
+static uint64_t WriteResults (const uint64_t* IndexList, const uint8_t* SpecList,
+  const uint8_t* VerifList, const uint8_t* DFA_SizeList, uint64_t nMachines) ;
+static void SaveCaches (FILE* fp) ;
+static void LoadCaches (FILE* fp) ;
+static void SubtreeThreadFunction() ;
+static bool GetNextJob (uint32_t& Job) ;
+static void RunThreads (void (*Function)()) ;
+static void UpdateCache (uint32_t DFA_States, const uint8_t* DFA) ;
+static void AddPruningStats (const FiniteAutomataReduction& Decider) ;
+static bool DecideMachine (FiniteAutomataReduction& Decider, const uint8_t* MachineSpec,
+  uint8_t* VerificationEntry, uint8_t& DFA_Size, const std::vector<CachedDFA>& CacheSnapshot,
+  SearchStats& Stats) ;
+static bool SearchMachine (FiniteAutomataReduction& Decider, const uint8_t* MachineSpec,
+  uint8_t* VerificationEntry, uint8_t& DFA_Size, const std::vector<CachedDFA>& CacheSnapshot,
+  SearchStats& Stats) ;
 
 int main (int argc, char** argv)
   {
   Params.Parse (argc, argv) ;
   Params.CheckParameters() ;
+  Check = new Checkpoint (Params, Reader, argc, argv, Params.StreamRangeSize != 0) ;
   Params.OpenFiles() ;
 
   Reader.SetParams (&Params) ;
@@ -88,157 +259,671 @@ int main (int argc, char** argv)
       printf ("nThreads = %d\n", Params.nThreads) ;
       }
     }
+  if (Params.nThreads == 1) Params.ExtensionLimit = 0 ; // Nothing to be gained
 
   clock_t Timer = clock() ;
 
-  // Read all the machines into memory
-  MachineIndexList = new uint32_t[Reader.nMachines] ;
-  MachineSpecList = new uint8_t[Reader.nMachines * Reader.MachineSpecSize] ;
-  VerificationList = new uint8_t[Reader.nMachines * (1 + 2 * Params.DFA_States)] ;
-  for (uint32_t i = 0 ; i < Reader.nMachines ; i++)
-    MachineIndexList[i] = Reader.Next (MachineSpecList + i * Reader.MachineSpecSize) ;
-
-  // Run inline if single thread (for ease of debugging)
-  if (Params.nThreads == 1) ThreadFunction() ;
-  else
+  if (Params.StreamRangeSize)
     {
-    std::vector<thread*> ThreadList (Params.nThreads) ;
-    for (uint32_t i = 0 ; i < Params.nThreads ; i++)
-      ThreadList[i] = new thread (ThreadFunction) ;
-    for (uint32_t i = 0 ; i < Params.nThreads ; i++)
+    // No machines are put aside for the subtree search, because they would
+    // hold up the output of all the ranges after them
+    Params.ExtensionLimit = 0 ;
+
+    SlotList.resize (4 * Params.nThreads) ;
+    for (StreamSlot& S : SlotList)
       {
-      ThreadList[i] -> join() ; // Wait for thread i to finish
-      delete ThreadList[i] ;
+      S.Done = false ;
+      S.IndexList.resize (Params.StreamRangeSize) ;
+      S.SpecList.resize (Params.StreamRangeSize * Reader.MachineSpecSize) ;
+      S.VerifList.resize (Params.StreamRangeSize * (1 + 2 * Params.DFA_States)) ;
+      S.DFA_SizeList.resize (Params.StreamRangeSize) ;
+      }
+
+    Check -> AddOutputFile (Params.fpUndecided, true) ;
+    Check -> AddOutputFile (Params.fpVerify) ;
+    Check -> AddOutputFile (Params.fpVerifyIndex) ;
+    Check -> AddCounter (nCommitted) ;
+    Check -> AddCounter (nDecidedCommitted) ;
+    if (Check -> Resume (LoadCaches))
+      {
+      TotalAssigned = TotalCompleted = nCommitted ;
+      TotalDecided = nDecidedCommitted ;
+      }
+    else
+      {
+      // Write umf header and dummy dvf header
+      Reader.WriteUndecidedHeader (Params.fpUndecided) ;
+      Reader.WriteVerificationHeader (Params.fpVerify, 0) ;
       }
     }
+  else
+    {
+    Reader.WriteUndecidedHeader (Params.fpUndecided) ;
+
+    // Read all the machines into memory
+    MachineIndexList = new uint64_t[Reader.nMachines] ;
+    MachineSpecList = new uint8_t[Reader.nMachines * Reader.MachineSpecSize] ;
+    VerificationList = new uint8_t[Reader.nMachines * (1 + 2 * Params.DFA_States)] ;
+    DFA_SizeList = new uint8_t[Reader.nMachines] ;
+    for (uint64_t i = 0 ; i < Reader.nMachines ; i++)
+      MachineIndexList[i] = Reader.Next (MachineSpecList + i * Reader.MachineSpecSize) ;
+    }
 
-  printf ("\r100%% %d %d\n", Reader.nMachines, TotalDecided) ;
+  clock_t SearchTimer = clock() ;
+  RunThreads (ThreadFunction) ;
+  SearchTimer = clock() - SearchTimer ;
+
+  printf ("\r100%% %" PRIu64 " %" PRIu64 "\n", Reader.nMachines, TotalDecided) ;
   fflush (stdout) ;
 
+  // Search the DFA space of the deferred machines in parallel
+  if (!Params.StreamRangeSize)
+    for (uint64_t i = 0 ; i < Reader.nMachines ; i++)
+      if (VerificationList[i * (1 + 2 * Params.DFA_States)] == DEFERRED)
+        DeferredList.push_back (i) ;
+  if (!DeferredList.empty())
+    {
+    clock_t SubtreeTimer = clock() ;
+
+    // Split the search tree finely enough to keep all the threads busy
+    for (PrefixLength = 0 ; ; PrefixLength++)
+      {
+      PrefixList.clear() ;
+      nPrefixes = FiniteAutomataReduction::ListPrefixes (Params.DFA_States, PrefixLength, PrefixList) ;
+      if (nPrefixes >= 4 * Params.nThreads || PrefixLength == 2 * Params.DFA_States - 1) break ;
+      }
+
+    // Jobs for each machine are numbered in search order: Direction, then prefix
+    nJobs = DeferredList.size() * 2 * nPrefixes ;
+    FirstSuccess = new std::atomic<uint32_t>[DeferredList.size()] ;
+    for (uint32_t d = 0 ; d < DeferredList.size() ; d++)
+      FirstSuccess[d] = 2 * nPrefixes ;
+    printf ("Searching %d machines in parallel (%d subtrees each)\n",
+      (int)DeferredList.size(), 2 * nPrefixes) ;
+    LastPercent = -1 ;
+
+    RunThreads (SubtreeThreadFunction) ;
+
+    uint32_t nSubtreeDecided = 0 ;
+    for (uint32_t d = 0 ; d < DeferredList.size() ; d++)
+      {
+      if (FirstSuccess[d] < 2 * nPrefixes) nSubtreeDecided++ ;
+      else VerificationList[DeferredList[d] * (1 + 2 * Params.DFA_States)] = 0xFF ;
+      }
+    TotalDecided += nSubtreeDecided ;
+    MachineCount[Params.DFA_States] += nSubtreeDecided ;
+    delete[] FirstSuccess ;
+
+    SubtreeTimer = clock() - SubtreeTimer ;
+    printf ("\rDecided %d out of %d in parallel, time %.3f\n", nSubtreeDecided,
+      (int)DeferredList.size(), (double)SubtreeTimer / CLOCKS_PER_SEC) ;
+    }
+
   if (Params.fpInput) fclose (Params.fpInput) ;
 
-  if (Params.fpVerify || Params.fpUndecided)
+  if (Params.StreamRangeSize == 0)
     {
-    Write32 (Params.fpVerify, TotalDecided) ;
+    Reader.WriteVerificationHeader (Params.fpVerify, TotalDecided) ;
+    WriteResults (MachineIndexList, MachineSpecList, VerificationList, DFA_SizeList, Reader.nMachines) ;
+    }
+
+  // Write the verification file header, and finish off the dvf index
+  if (Params.fpVerify) Reader.CloseVerification (Params.fpVerify, TotalDecided) ;
+  if (Params.fpUndecided) Reader.CloseUndecided (Params.fpUndecided) ;
+  Check -> Remove() ;
+
+  Timer = clock() - Timer ;
 
-    const uint32_t* IndexList = MachineIndexList ;
-    const uint8_t* SpecList = MachineSpecList ;
-    uint8_t* VerifList = VerificationList ;
-    for (uint32_t i = 0 ; i < Reader.nMachines ; i++)
+  printf ("\nDecided %" PRIu64 " out of %" PRIu64 "\n", TotalDecided, Reader.nMachines) ;
+  printf ("Elapsed time %.3f\n", (double)Timer / CLOCKS_PER_SEC) ;
+
+  if (Params.CacheSize)
+    {
+    const SearchStats& S = TotalStats ;
+    printf ("\nDFA cache: %d hits, %d misses\n", S.nCacheHits, S.nCacheMisses) ;
+    printf ("NFA extensions: %" PRIu64 " trying cached DFAs, %" PRIu64 " in full searches\n",
+      S.CacheExtensions, S.SearchExtensions) ;
+
+    // Estimate the time saved by assuming that each hit would otherwise have
+    // needed an average successful full search
+    uint64_t TotalExtensions = S.CacheExtensions + S.SearchExtensions ;
+    if (S.nSearchDecided && TotalExtensions)
       {
-      if (VerifList[0] == 0xFF) Write32 (Params.fpUndecided, *IndexList) ; // Undecided
-      else if (Params.fpVerify)
+      double Saved = S.nCacheHits * (double)S.DecidingSearchExtensions / S.nSearchDecided
+        - S.CacheExtensions ;
+      printf ("Estimated time saved %.3f (%.0f NFA extensions)\n",
+        Saved * SearchTimer / TotalExtensions / CLOCKS_PER_SEC, Saved) ;
+      }
+    }
+
+  const SearchStats& S = TotalStats ;
+  printf ("\nSearch: %" PRIu64 " NFA extensions, %" PRIu64 " of them in lookahead\n",
+    S.AllExtensions, S.LookaheadExtensions) ;
+  printf ("Pruning: %" PRIu64 " values ruled out, %" PRIu64 " transitions skipped, %" PRIu64 " nodes wiped out\n",
+    S.nPruned[FiniteAutomataReduction::PRUNE_DEAD_VALUE_FOUND],
+    S.nPruned[FiniteAutomataReduction::PRUNE_DEAD_VALUE],
+    S.nPruned[FiniteAutomataReduction::PRUNE_WIPEOUT]) ;
+
+  if (Params.CanonicalCache)
+    {
+    printf ("\nCanonical classes: %d decided, %d undecided\n", (int)ClassCache.size(),
+      (int)UndecidedClasses.size()) ;
+    printf ("Verdicts shared: %d decided (%d of them mirrored), %d undecided\n",
+      S.nClassDecided, S.nClassMirrored, S.nClassUndecided) ;
+    printf ("Class DFAs that failed: %d; NFA extensions spent checking class DFAs: %" PRIu64 "\n",
+      S.nClassRetried, S.ClassExtensions) ;
+    }
+
+  if (Params.InitialDFA_StatesPresent)
+    {
+    printf ("\nDecided machines by DFA size:\n") ;
+    for (uint32_t n = Params.InitialDFA_States ; n <= Params.DFA_States ; n++)
+      {
+      printf ("%d: %d", n, MachineCount[n]) ;
+      if (TotalStats.nOverBudget[n]) printf (" (%d over budget)", TotalStats.nOverBudget[n]) ;
+      printf ("\n") ;
+      }
+    }
+  }
+
+// static uint64_t WriteResults (const uint64_t* IndexList, const uint8_t* SpecList,
+//   const uint8_t* VerifList, const uint8_t* DFA_SizeList, uint64_t nMachines)
+//
+// Writes the dvf entries of the decided machines in the lists, and the indexes of
+// the undecided ones to the umf. Returns the number of decided machines.
+
+static uint64_t WriteResults (const uint64_t* IndexList, const uint8_t* SpecList,
+  const uint8_t* VerifList, const uint8_t* DFA_SizeList, uint64_t nMachines)
+  {
+  uint64_t nDecided = 0 ;
+  ustring Entry ;
+  for (uint64_t i = 0 ; i < nMachines ; i++)
+    {
+    uint32_t DFA_States = DFA_SizeList[i] ;
+    if (VerifList[0] != 0xFF) nDecided++ ;
+    if (VerifList[0] == 0xFF) Reader.WriteUndecided (Params.fpUndecided, *IndexList) ; // Undecided
+    else if (Params.fpVerify)
+      {
+      // Build the entry in memory, leaving room for SeedDatabaseIndex, DeciderTag
+      // and InfoLength, as WriteVerificationEntry expects
+      Entry.assign (12, 0) ;
+      if (Params.OutputNFA)
         {
-        Write32 (Params.fpVerify, *IndexList) ;
-        if (Params.OutputNFA)
-          {
-          Write32 (Params.fpVerify, (uint32_t)DeciderTag::FAR_DFA_NFA) ;
-
-          // Write DFA and NFA, with some header information
-          FiniteAutomataReduction Decider (Params.MachineStates, nullptr, true) ;
-          Decider.SetDFA_States (Params.DFA_States) ;
-          Decider.Direction = VerifList[0] ;
-          memcpy (Decider.DFA, VerifList + 1, 2 * Decider.DFA_States) ;
-
-          uint32_t nBytes = (Decider.NFA_States + 7) >> 3 ;
-          Write32 (Params.fpVerify, 5 + 2 * Decider.DFA_States + (2 * Decider.NFA_States + 1) * nBytes) ;
-          Write8 (Params.fpVerify, VerifList[0]) ; // Direction
-          Write16 (Params.fpVerify, Decider.DFA_States) ;
-          Write16 (Params.fpVerify, Decider.NFA_States) ;
-
-          // Write DFA
-          Write (Params.fpVerify, VerifList + 1, 2 * Decider.DFA_States) ;
-
-          // Reconstruct NFA from DFA
-          Decider.ReconstructNFA (SpecList) ;
-
-          // Write NFA
-          for (uint32_t r = 0 ; r <= 1 ; r++)
-            for (uint32_t i = 0 ; i < Decider.NFA_States ; i++)
-              Write (Params.fpVerify, Decider.R[r][i].d, nBytes) ;
-
-          // Write a
-          Write (Params.fpVerify, Decider.a.d, nBytes) ;
-          }
-        else
-          {
-          // Write DFA only
-          Write32 (Params.fpVerify, (uint32_t)DeciderTag::FAR_DFA_ONLY) ;
-          Write32 (Params.fpVerify, 1 + 2 * Params.DFA_States) ;
-          Write (Params.fpVerify, VerifList, 1 + 2 * Params.DFA_States) ;
-          }
+        Save32 (Entry.data() + 4, (uint32_t)DeciderTag::FAR_DFA_NFA) ;
+
+        // Write DFA and NFA, with some header information
+        FiniteAutomataReduction Decider (Params.MachineStates, true) ;
+        Decider.SetDFA_States (DFA_States) ;
+        Decider.Direction = VerifList[0] ;
+        memcpy (Decider.DFA, VerifList + 1, 2 * Decider.DFA_States) ;
+
+        uint32_t nBytes = (Decider.NFA_States + 7) >> 3 ;
+        uint8_t Header[5] ;
+        Header[0] = VerifList[0] ; // Direction
+        Save16 (Header + 1, Decider.DFA_States) ;
+        Save16 (Header + 3, Decider.NFA_States) ;
+        Entry.append (Header, 5) ;
+
+        // Write DFA
+        Entry.append (VerifList + 1, 2 * Decider.DFA_States) ;
+
+        // Reconstruct NFA from DFA
+        Decider.ReconstructNFA (SpecList) ;
+
+        // Write NFA
+        for (uint32_t r = 0 ; r <= 1 ; r++)
+          for (uint32_t i = 0 ; i < Decider.NFA_States ; i++)
+            Entry.append ((const uint8_t*)Decider.R[r][i].d, nBytes) ;
+
+        // Write a
+        Entry.append ((const uint8_t*)Decider.a.d, nBytes) ;
         }
-      IndexList++ ;
-      SpecList += Reader.MachineSpecSize ;
-      VerifList += 1 + 2 * Params.DFA_States ;
+      else
+        {
+        // Write DFA only
+        Save32 (Entry.data() + 4, (uint32_t)DeciderTag::FAR_DFA_ONLY) ;
+        Entry.append (VerifList, 1 + 2 * DFA_States) ;
+        }
+      Save32 (Entry.data() + 8, Entry.length() - 12) ;
+      Reader.WriteVerificationEntry (Params.fpVerify, *IndexList, Entry.data(), Entry.length()) ;
       }
-    if (Params.fpVerify) fclose (Params.fpVerify) ;
-    if (Params.fpUndecided) fclose (Params.fpUndecided) ;
+    IndexList++ ;
+    SpecList += Reader.MachineSpecSize ;
+    VerifList += 1 + 2 * Params.DFA_States ;
     }
+  return nDecided ;
+  }
 
-  Timer = clock() - Timer ;
-
-  printf ("\nDecided %d out of %d\n", TotalDecided, Reader.nMachines) ;
-  printf ("Elapsed time %.3f\n", (double)Timer / CLOCKS_PER_SEC) ;
+static void RunThreads (void (*Function)())
+  {
+  // Run inline if single thread (for ease of debugging)
+  if (Params.nThreads == 1) Function() ;
+  else
+    {
+    std::vector<thread*> ThreadList (Params.nThreads) ;
+    for (uint32_t i = 0 ; i < Params.nThreads ; i++)
+      ThreadList[i] = new thread (Function) ;
+    for (uint32_t i = 0 ; i < Params.nThreads ; i++)
+      {
+      ThreadList[i] -> join() ; // Wait for thread i to finish
+      delete ThreadList[i] ;
+      }
+    }
   }
 
 static void ThreadFunction()
   {
-  FiniteAutomataReduction Decider (Params.MachineStates, nullptr, false, Params.TraceOutput) ;
+  FiniteAutomataReduction Decider (Params.MachineStates, false, Params.TraceOutput) ;
+  std::vector<CachedDFA> CacheSnapshot ;
+  SearchStats Stats = { } ;
 
   uint32_t nDecided = 0 ;
   uint32_t nCompleted = 0 ;
+  Range R ;
+  R.Slot = NO_SLOT ;
   for ( ; ; )
     {
-    Range R ;
-    if (!GetNextRange (R, nCompleted, nDecided)) return ;
-    const uint32_t* IndexList = MachineIndexList + R.First ;
-    const uint8_t* SpecList = MachineSpecList + R.First * Reader.MachineSpecSize ;
-    uint8_t* VerifList = VerificationList + R.First * (1 + 2 * Params.DFA_States) ;
+    if (!GetNextRange (R, nCompleted, nDecided)) break ;
+    const uint8_t* SpecList = R.SpecList ;
+    uint8_t* VerifList = R.VerifList ;
     nDecided = nCompleted = 0 ;
-    for (uint32_t i = R.First ; i < R.Last ; i++, nCompleted++)
+
+    if (Params.CacheSize)
+      {
+      lock_guard<mutex> MutexLock { CacheMutex } ;
+      CacheSnapshot = DFA_Cache ;
+      }
+
+    for (uint32_t i = 0 ; i < R.Last - R.First ; i++, nCompleted++)
       {
-      if (Decider.RunDecider (Params.DFA_States, SpecList, VerifList)) nDecided++ ;
-      IndexList++ ;
+      if (DecideMachine (Decider, SpecList, VerifList, R.DFA_SizeList[i], CacheSnapshot, Stats))
+        nDecided++ ;
       SpecList += Reader.MachineSpecSize ;
       VerifList += 1 + 2 * Params.DFA_States ;
       }
     }
+
+  lock_guard<mutex> MutexLock { CacheMutex } ;
+  TotalStats.nCacheHits += Stats.nCacheHits ;
+  TotalStats.nCacheMisses += Stats.nCacheMisses ;
+  TotalStats.nSearchDecided += Stats.nSearchDecided ;
+  TotalStats.CacheExtensions += Stats.CacheExtensions ;
+  TotalStats.SearchExtensions += Stats.SearchExtensions ;
+  TotalStats.DecidingSearchExtensions += Stats.DecidingSearchExtensions ;
+  TotalStats.nClassDecided += Stats.nClassDecided ;
+  TotalStats.nClassMirrored += Stats.nClassMirrored ;
+  TotalStats.nClassUndecided += Stats.nClassUndecided ;
+  TotalStats.nClassRetried += Stats.nClassRetried ;
+  TotalStats.ClassExtensions += Stats.ClassExtensions ;
+  for (uint32_t n = 0 ; n <= FiniteAutomataReduction::MaxDFA_States ; n++)
+    {
+    TotalStats.nOverBudget[n] += Stats.nOverBudget[n] ;
+    MachineCount[n] += Decider.MachineCount[n] ;
+    }
+  AddPruningStats (Decider) ;
+  }
+
+// static bool DecideMachine (FiniteAutomataReduction& Decider, const uint8_t* MachineSpec,
+//   uint8_t* VerificationEntry, uint8_t& DFA_Size, const std::vector<CachedDFA>& CacheSnapshot,
+//   SearchStats& Stats)
+//
+// With -K, looks up the machine's canonical class, and uses its verdict if it has
+// one; otherwise calls SearchMachine, and records the result as the verdict of the
+// class (unless the machine was DEFERRED). Returns true and sets DFA_Size if the
+// machine was decided.
+//
+// An undecided verdict is kept under CanonicalKey (CANONICAL_RENAME): the search
+// doesn't depend on how the states are numbered, but it does depend on the unused
+// transitions, and on which Direction is tried first.
+
+static bool DecideMachine (FiniteAutomataReduction& Decider, const uint8_t* MachineSpec,
+  uint8_t* VerificationEntry, uint8_t& DFA_Size, const std::vector<CachedDFA>& CacheSnapshot,
+  SearchStats& Stats)
+  {
+  if (!Params.CanonicalCache)
+    return SearchMachine (Decider, MachineSpec, VerificationEntry, DFA_Size, CacheSnapshot, Stats) ;
+
+  TuringMachineSpec TM (Params.MachineStates) ;
+  TM.Initialise (0, MachineSpec) ;
+  bool Mirrored ;
+  uint64_t Key = TM.CanonicalKey (TuringMachineSpec::CANONICAL_ALL, &Mirrored) ;
+  uint64_t RenameKey = TM.CanonicalKey (TuringMachineSpec::CANONICAL_RENAME) ;
+
+  ClassVerdict V ;
+  bool Found, Undecided ;
+    {
+    lock_guard<mutex> MutexLock { ClassMutex } ;
+    Undecided = UndecidedClasses.contains (RenameKey) ;
+    auto Iter = ClassCache.find (Key) ;
+    Found = Iter != ClassCache.end() ;
+    if (Found) V = Iter -> second ;
+    }
+
+  if (Found)
+    {
+    // A DFA that reads the tape in one Direction works for the mirror image
+    // reading it in the other Direction
+    uint8_t Direction = V.VerificationEntry[0] ^ V.Mirrored ^ Mirrored ;
+    bool Decided = Decider.TryDFA (V.DFA_States, MachineSpec, V.VerificationEntry + 1,
+      VerificationEntry, Direction) ;
+    Stats.ClassExtensions += Decider.nExtensions ;
+    if (Decided)
+      {
+      Stats.nClassDecided++ ;
+      if (V.Mirrored != Mirrored) Stats.nClassMirrored++ ;
+      DFA_Size = V.DFA_States ;
+      return true ;
+      }
+    Stats.nClassRetried++ ;
+    }
+
+  if (Undecided)
+    {
+    DFA_Size = Params.DFA_States ;
+    Stats.nClassUndecided++ ;
+    *VerificationEntry = 0xFF ;
+    return false ;
+    }
+
+  bool Decided = SearchMachine (Decider, MachineSpec, VerificationEntry, DFA_Size, CacheSnapshot, Stats) ;
+  if (Decided && !Found)
+    {
+    V.Mirrored = Mirrored ;
+    V.DFA_States = DFA_Size ;
+    memcpy (V.VerificationEntry, VerificationEntry, 1 + 2 * DFA_Size) ;
+
+    lock_guard<mutex> MutexLock { ClassMutex } ;
+    ClassCache.emplace (Key, V) ; // Unless another thread got there first
+    }
+  else if (!Decided && *VerificationEntry != DEFERRED)
+    {
+    lock_guard<mutex> MutexLock { ClassMutex } ;
+    UndecidedClasses.insert (RenameKey) ;
+    }
+  return Decided ;
+  }
+
+// static bool SearchMachine (FiniteAutomataReduction& Decider, const uint8_t* MachineSpec,
+//   uint8_t* VerificationEntry, uint8_t& DFA_Size, const std::vector<CachedDFA>& CacheSnapshot,
+//   SearchStats& Stats)
+//
+// Tries the cached DFAs (-C), then searches each DFA size in turn (-E). Returns true
+// and sets DFA_Size if the machine was decided. If the search at the final size
+// reached the extension limit (-P), the machine is marked as DEFERRED.
+
+static bool SearchMachine (FiniteAutomataReduction& Decider, const uint8_t* MachineSpec,
+  uint8_t* VerificationEntry, uint8_t& DFA_Size, const std::vector<CachedDFA>& CacheSnapshot,
+  SearchStats& Stats)
+  {
+  DFA_Size = Params.DFA_States ;
+  if (Params.CacheSize)
+    {
+    for (const CachedDFA& C : CacheSnapshot)
+      {
+      bool Decided = Decider.TryDFA (C.DFA_States, MachineSpec, C.DFA, VerificationEntry) ;
+      Stats.CacheExtensions += Decider.nExtensions ;
+      if (Decided)
+        {
+        Stats.nCacheHits++ ;
+        DFA_Size = C.DFA_States ;
+        UpdateCache (C.DFA_States, C.DFA) ;
+        return true ;
+        }
+      }
+    Stats.nCacheMisses++ ;
+    }
+
+  uint32_t n = Params.InitialDFA_StatesPresent ? Params.InitialDFA_States : Params.DFA_States ;
+  for ( ; n <= Params.DFA_States ; n++)
+    {
+    Decider.ExtensionLimit = n < Params.DFA_States ? Params.SizeBudget : Params.ExtensionLimit ;
+    bool Decided = Decider.RunDecider (n, MachineSpec, VerificationEntry) ;
+    Stats.SearchExtensions += Decider.nExtensions ;
+    if (Decided)
+      {
+      Stats.nSearchDecided++ ;
+      Stats.DecidingSearchExtensions += Decider.nExtensions ;
+      DFA_Size = n ;
+      if (Params.CacheSize) UpdateCache (n, VerificationEntry + 1) ;
+      return true ;
+      }
+    if (Decider.LimitReached && n < Params.DFA_States) Stats.nOverBudget[n]++ ;
+    }
+
+  if (Decider.LimitReached) *VerificationEntry = DEFERRED ;
+  return false ;
+  }
+
+// static void UpdateCache (uint32_t DFA_States, const uint8_t* DFA)
+//
+// Called when DFA (with DFA_States states) has decided a machine: adds it to the cache if it isn't there
+// already (replacing the entry with fewest hits if the cache is full), and
+// increments its hit count
+
+static void UpdateCache (uint32_t DFA_States, const uint8_t* DFA)
+  {
+  lock_guard<mutex> MutexLock { CacheMutex } ;
+
+  uint32_t nBytes = 2 * DFA_States ;
+  uint32_t i ;
+  for (i = 0 ; i < DFA_Cache.size() ; i++)
+    if (DFA_Cache[i].DFA_States == DFA_States && memcmp (DFA_Cache[i].DFA, DFA, nBytes) == 0) break ;
+  if (i == DFA_Cache.size())
+    {
+    if (DFA_Cache.size() < Params.CacheSize) DFA_Cache.emplace_back() ;
+    i = DFA_Cache.size() - 1 ;
+    DFA_Cache[i].DFA_States = DFA_States ;
+    memcpy (DFA_Cache[i].DFA, DFA, nBytes) ;
+    DFA_Cache[i].Hits = 0 ;
+    }
+  DFA_Cache[i].Hits++ ;
+
+  // Keep the cache sorted by hit count, most recent first among equals
+  for ( ; i > 0 && DFA_Cache[i].Hits >= DFA_Cache[i - 1].Hits ; i--)
+    std::swap (DFA_Cache[i], DFA_Cache[i - 1]) ;
   }
 
 static bool GetNextRange (Range& R, uint32_t nCompleted, uint32_t nDecided)
   {
   // Get exclusive access to Range variables
-  lock_guard<mutex> MutexLock { RangeMutex } ;
+  unique_lock<mutex> MutexLock { RangeMutex } ;
 
   TotalDecided += nDecided ;
   TotalCompleted += nCompleted ;
-  uint32_t Percent = (TotalCompleted * 100LL) / Reader.nMachines ;
+  uint32_t Percent = Reader.nMachines ? (TotalCompleted * 100LL) / Reader.nMachines : 100 ;
   if (Percent != LastPercent)
     {
     LastPercent = Percent ;
-    printf ("\r%d%% %d %d", Percent, TotalCompleted, TotalDecided) ;
+    printf ("\r%d%% %" PRIu64 " %" PRIu64, Percent, TotalCompleted, TotalDecided) ;
     fflush (stdout) ;
     }
 
+  if (R.Slot != NO_SLOT)
+    {
+    SlotList[R.Slot].Done = true ;
+    CommitRanges() ;
+    }
+  if (Params.StreamRangeSize)
+    while (TotalAssigned < Reader.nMachines && nSlotsInUse == SlotList.size())
+      SlotFree.wait (MutexLock) ;
+
   if (TotalAssigned == Reader.nMachines) return false ;
-  uint32_t nRemaining = Reader.nMachines - TotalAssigned ;
+  uint64_t nRemaining = Reader.nMachines - TotalAssigned ;
 
   // Try to ensure that we are not left waiting for a single thread to complete
   // while everybody else has long since finished, by reducing the chunk size
   // as we near the end (this expression is plucked out of nowhere, but it's
   // not very important):
-  uint32_t ChunkSize = nRemaining / (5 * Params.nThreads) + 1 ;
+  uint64_t ChunkSize = nRemaining / (5 * Params.nThreads) + 1 ;
   if (ChunkSize * Params.nThreads * 50 > Reader.nMachines)
     {
     ChunkSize = Reader.nMachines / (Params.nThreads * 50) ;
     if (ChunkSize == 0) ChunkSize = 1 ;
     }
   if (TotalAssigned + ChunkSize > Reader.nMachines) ChunkSize = Reader.nMachines - TotalAssigned ;
+  if (Params.StreamRangeSize && ChunkSize > Params.StreamRangeSize) ChunkSize = Params.StreamRangeSize ;
 
   R.First = TotalAssigned ;
   R.Last = R.First + ChunkSize ;
   TotalAssigned += ChunkSize ;
+
+  if (Params.StreamRangeSize)
+    {
+    // Read the machines into the next slot
+    R.Slot = NextSlot ;
+    NextSlot = (NextSlot + 1) % SlotList.size() ;
+    nSlotsInUse++ ;
+    StreamSlot& S = SlotList[R.Slot] ;
+    S.nMachines = ChunkSize ;
+    for (uint32_t i = 0 ; i < ChunkSize ; i++)
+      S.IndexList[i] = Reader.Next (&S.SpecList[i * Reader.MachineSpecSize]) ;
+    R.SpecList = S.SpecList.data() ;
+    R.VerifList = S.VerifList.data() ;
+    R.DFA_SizeList = S.DFA_SizeList.data() ;
+    }
+  else
+    {
+    R.SpecList = MachineSpecList + R.First * Reader.MachineSpecSize ;
+    R.VerifList = VerificationList + R.First * (1 + 2 * Params.DFA_States) ;
+    R.DFA_SizeList = DFA_SizeList + R.First ;
+    }
+  return true ;
+  }
+
+// static void CommitRanges()
+//
+// -S: writes the results of the oldest ranges, for as long as they are complete,
+// and frees their slots. Called with RangeMutex locked.
+
+static void CommitRanges()
+  {
+  while (nSlotsInUse && SlotList[OldestSlot].Done)
+    {
+    StreamSlot& S = SlotList[OldestSlot] ;
+    nDecidedCommitted += WriteResults (S.IndexList.data(), S.SpecList.data(), S.VerifList.data(),
+      S.DFA_SizeList.data(), S.nMachines) ;
+    nCommitted += S.nMachines ;
+    S.Done = false ;
+    OldestSlot = (OldestSlot + 1) % SlotList.size() ;
+    nSlotsInUse-- ;
+    }
+  Check -> Save (nCommitted, SaveCaches) ;
+  SlotFree.notify_all() ;
+  }
+
+// static void SaveCaches (FILE* fp)
+// static void LoadCaches (FILE* fp)
+//
+// Save the DFA cache (-C) and the canonical class cache (-K) with a checkpoint, and
+// restore them when resuming from it. SaveCaches is called with RangeMutex locked,
+// while other threads may still be searching.
+
+static void SaveCaches (FILE* fp)
+  {
+    {
+    lock_guard<mutex> MutexLock { CacheMutex } ;
+    Write32 (fp, DFA_Cache.size()) ;
+    for (const CachedDFA& C : DFA_Cache)
+      {
+      Write8 (fp, C.DFA_States) ;
+      Write (fp, C.DFA, 2 * C.DFA_States) ;
+      Write32 (fp, C.Hits) ;
+      }
+    }
+
+  lock_guard<mutex> MutexLock { ClassMutex } ;
+  Write64 (fp, ClassCache.size()) ;
+  for (const auto& [Key, V] : ClassCache)
+    {
+    Write64 (fp, Key) ;
+    Write8 (fp, V.Mirrored) ;
+    Write8 (fp, V.DFA_States) ;
+    Write (fp, V.VerificationEntry, 1 + 2 * V.DFA_States) ;
+    }
+  Write64 (fp, UndecidedClasses.size()) ;
+  for (uint64_t Key : UndecidedClasses) Write64 (fp, Key) ;
+  }
+
+static void LoadCaches (FILE* fp)
+  {
+  DFA_Cache.resize (Read32 (fp)) ;
+  for (CachedDFA& C : DFA_Cache)
+    {
+    C.DFA_States = Read8u (fp) ;
+    Read (fp, C.DFA, 2 * C.DFA_States) ;
+    C.Hits = Read32 (fp) ;
+    }
+
+  for (uint64_t n = Read64 (fp) ; n ; n--)
+    {
+    uint64_t Key = Read64 (fp) ;
+    ClassVerdict V ;
+    V.Mirrored = Read8u (fp) ;
+    V.DFA_States = Read8u (fp) ;
+    Read (fp, V.VerificationEntry, 1 + 2 * V.DFA_States) ;
+    ClassCache.emplace (Key, V) ;
+    }
+  for (uint64_t n = Read64 (fp) ; n ; n--) UndecidedClasses.insert (Read64 (fp)) ;
+  }
+
+static void SubtreeThreadFunction()
+  {
+  FiniteAutomataReduction Decider (Params.MachineStates, false, Params.TraceOutput) ;
+  uint8_t VerificationEntry[1 + 2 * FiniteAutomataReduction::MaxDFA_States] ;
+  uint32_t VerifLength = 1 + 2 * Params.DFA_States ;
+
+  uint32_t Job ;
+  while (GetNextJob (Job))
+    {
+    uint32_t d = Job / (2 * nPrefixes) ;
+    uint32_t n = Job % (2 * nPrefixes) ;
+    if (FirstSuccess[d] < n) continue ; // An earlier subtree has already succeeded
+
+    uint64_t i = DeferredList[d] ;
+    if (Decider.SearchSubtree (Params.DFA_States, MachineSpecList + i * Reader.MachineSpecSize,
+      n / nPrefixes, PrefixList.data() + (n % nPrefixes) * PrefixLength, PrefixLength,
+      VerificationEntry, &FirstSuccess[d], n))
+      {
+      lock_guard<mutex> MutexLock { RangeMutex } ;
+      if (n < FirstSuccess[d])
+        {
+        FirstSuccess[d] = n ;
+        memcpy (VerificationList + i * VerifLength, VerificationEntry, VerifLength) ;
+        }
+      }
+    }
+
+  lock_guard<mutex> MutexLock { CacheMutex } ;
+  AddPruningStats (Decider) ;
+  }
+
+// static void AddPruningStats (const FiniteAutomataReduction& Decider)
+//
+// Adds the search statistics of a thread's Decider to the totals. Called with
+// CacheMutex locked.
+
+static void AddPruningStats (const FiniteAutomataReduction& Decider)
+  {
+  for (uint32_t n = 0 ; n < FiniteAutomataReduction::N_PRUNE_RULES ; n++)
+    TotalStats.nPruned[n] += Decider.nPruned[n] ;
+  TotalStats.AllExtensions += Decider.nAllExtensions ;
+  TotalStats.LookaheadExtensions += Decider.nLookaheadExtensions ;
+  }
+
+static bool GetNextJob (uint32_t& Job)
+  {
+  lock_guard<mutex> MutexLock { RangeMutex } ;
+
+  uint32_t Percent = (NextJob * 100LL) / nJobs ;
+  if (Percent != LastPercent)
+    {
+    LastPercent = Percent ;
+    printf ("\r%d%%", Percent) ;
+    fflush (stdout) ;
+    }
+
+  if (NextJob == nJobs) return false ;
+  Job = NextJob++ ;
   return true ;
   }
 
@@ -263,6 +948,32 @@ void CommandLineParams::Parse (int argc, char** argv)
         OutputNFA = true ;
         break ;
 
+      case 'P':
+        ExtensionLimit = atoi (&argv[0][2]) ;
+        break ;
+
+      case 'C':
+        CacheSize = atoi (&argv[0][2]) ;
+        break ;
+
+      case 'E':
+        InitialDFA_States = atoi (&argv[0][2]) ;
+        InitialDFA_StatesPresent = true ;
+        break ;
+
+      case 'B':
+        SizeBudget = atoi (&argv[0][2]) ;
+        break ;
+
+      case 'K':
+        CanonicalCache = true ;
+        break ;
+
+      case 'S':
+        StreamRangeSize = argv[0][2] ? atoi (&argv[0][2]) : 1000 ;
+        if (StreamRangeSize == 0) printf ("Invalid range size\n"), exit (1) ;
+        break ;
+
       default:
         printf ("Invalid parameter \"%s\"\n", argv[0]) ;
         PrintHelpAndExit (1) ;
@@ -270,6 +981,8 @@ void CommandLineParams::Parse (int argc, char** argv)
     }
 
   if (!DFA_StatesPresent) printf ("DFA states not specified\n"), PrintHelpAndExit (1) ;
+  if (InitialDFA_StatesPresent && (InitialDFA_States == 0 || InitialDFA_States > DFA_States))
+    printf ("Initial DFA states must be between 1 and %d\n", DFA_States), exit (1) ;
   }
 
 void CommandLineParams::PrintHelpAndExit (int status)
@@ -279,6 +992,13 @@ void CommandLineParams::PrintHelpAndExit (int status)
   printf (R"*RAW*(
            -A<DFA states>        Number of DFA states
            -F                    Output NFA to dvf as well as DFA
+           -P<extension limit>   Search machines needing more extensions in parallel
+                                   (default 1000000; 0 = never)
+           -C<cache size>        Try the most successful DFAs so far first
+           -E<initial DFA states> Try each DFA size from <initial DFA states> up to -A
+           -B<extension budget>  NFA extensions per DFA size below -A (with -E)
+           -S[<range size>]      Stream machines in ranges of <range size> (default 1000)
+           -K                    Decide each canonical class of machines once
 )*RAW*") ;
   exit (status) ;
   }
@@ -13,19 +13,22 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <inttypes.h> // for PRIX64
 #include <time.h>
+#include <atomic>
+#include <vector>
 
 #include "BoolAlgebra.h"
 #include "../TuringMachine.h"
 
 #define VERIFY_ERROR() \
-  printf ("\n#%d: Error at line %d in %s (fpos 0x%lX)\n", \
-  SeedDatabaseIndex, __LINE__, __FUNCTION__, ftell (fp)), exit (1)
+  printf ("\n#%d: Error at line %d in %s (fpos 0x%" PRIX64 ")\n", \
+  SeedDatabaseIndex, __LINE__, __FUNCTION__, Info.Offset()), exit (1)
 
 class FiniteAutomataReduction : public TuringMachineSpec
   {
 public:
-  static const uint32_t MaxDFA_States = 9 ;
+  static const uint32_t MaxDFA_States = 42 ;
   static const uint32_t MaxNFA_States = MAX_MACHINE_STATES * MaxDFA_States + 1 ;
   static const uint32_t MaxVerifEntryLen = 17 +
     2 * MaxDFA_States + (2 * MaxNFA_States + 1) * ((MaxNFA_States + 7) >> 3) ;
@@ -33,9 +36,8 @@ public:
   using Vector = BoolVector<MaxNFA_States> ;
   using Matrix = BoolMatrix<MaxNFA_States> ;
 
-  FiniteAutomataReduction (uint32_t MachineStates, FILE* fp, bool CheckNFA, bool TraceOutput = false)
+  FiniteAutomataReduction (uint32_t MachineStates, bool CheckNFA, bool TraceOutput = false)
   : TuringMachineSpec (MachineStates)
-  , fp (fp)
   , CheckNFA (CheckNFA)
   , TraceOutput (TraceOutput)
     {
@@ -43,10 +45,16 @@ public:
     }
 
   bool RunDecider (uint32_t DFA_States, const uint8_t* MachineSpec, uint8_t* VerificationEntry) ;
-  bool ExtendNFA (const uint8_t* MachineSpec, Matrix R[2], Vector& a, uint32_t k) ;
+  bool SearchSubtree (uint32_t DFA_States, const uint8_t* MachineSpec, uint8_t Direction,
+    const uint8_t* Prefix, uint32_t PrefixLength, uint8_t* VerificationEntry,
+    const std::atomic<uint32_t>* FirstSuccess, uint32_t JobNumber) ;
+  bool TryDFA (uint32_t DFA_States, const uint8_t* MachineSpec, const uint8_t* CandidateDFA,
+    uint8_t* VerificationEntry, uint8_t FirstDirection = 0) ;
+  static uint32_t ListPrefixes (uint32_t DFA_States, uint32_t PrefixLength, std::vector<uint8_t>& PrefixList) ;
+  bool ExtendNFA (Vector& a, uint32_t k, uint32_t x) ;
 
   void Verify (const uint8_t* MachineSpec) ;
-  void ReadVerificationInfo() ;
+  void ReadVerificationInfo (DeciderTag Tag, ByteReader Info) ;
 
   void SetDFA_States (uint32_t n)
     {
@@ -66,9 +74,70 @@ public:
   Matrix R[2] ; // Transition matrices
   Vector a ;
 
-  FILE* fp = nullptr ;
+  ByteReader Info ; // The VerificationInfo being verified (straight from the mapped dvf)
   bool CheckNFA ;
   bool TraceOutput ;
 
   uint32_t MachineCount[MaxDFA_States + 1] ; // for reporting statistics
+
+  uint32_t ExtensionLimit = 0 ; // RunDecider gives up after this many NFA extensions (0 = no limit)
+  bool LimitReached ;
+  uint32_t nExtensions ; // NFA extensions (including Lookahead) in the last RunDecider, SearchSubtree or TryDFA
+
+  // Search looks ahead LookaheadDepth transitions (see Lookahead), once it has
+  // spent LookaheadThreshold NFA extensions on a machine without deciding it
+  static const uint32_t LookaheadDepth = 2 ;
+  static const uint32_t LookaheadThreshold = 2000 ;
+
+  // Search pruning statistics, accumulated over all searches
+  enum PruneRule
+    {
+    PRUNE_DEAD_VALUE_FOUND, // Values of a transition ruled out by Lookahead
+    PRUNE_DEAD_VALUE,       // Transitions skipped because their value had been ruled out
+    PRUNE_WIPEOUT,          // Nodes abandoned because every value of a later transition fails
+    N_PRUNE_RULES
+    } ;
+  uint64_t nPruned[N_PRUNE_RULES] = { } ;
+  uint64_t nAllExtensions = 0 ;       // NFA extensions in all searches...
+  uint64_t nLookaheadExtensions = 0 ; // ...of which in Lookahead
+
+private:
+  // Decider work areas. RunDecider builds the NFA in R incrementally: ExtendNFA
+  // only re-applies (8') where an input row has changed since the last pass, and
+  // every change is recorded in UndoLog so that backtracking can restore R
+  // without copying it.
+  struct Rule
+    {
+    uint8_t f ; // Machine state (0-based)
+    uint8_t r ; // Symbol read
+    uint8_t w ; // Symbol written
+    uint8_t t ; // Next state (0-based)
+    } ;
+  Rule LeftRules[2 * MAX_MACHINE_STATES] ;
+  Rule RightRules[2 * MAX_MACHINE_STATES] ;
+  uint32_t nLeftRules ;
+  uint32_t nRightRules ;
+
+  struct UndoEntry
+    {
+    uint8_t r ;
+    uint16_t Row ;
+    Vector Prev ;
+    } ;
+  std::vector<UndoEntry> UndoLog ; // 2 * NFA_States^2 entries: each one adds a bit to R
+  uint32_t UndoLogSize ;
+
+  Vector Changed[2] ; // Rows of R[0] and R[1] changed in the current pass
+
+  const std::atomic<uint32_t>* FirstSuccess = nullptr ; // Cancels SearchSubtree
+  uint32_t JobNumber ;
+
+  bool Search (const uint8_t* MachineSpec, uint32_t PrefixLength, uint8_t* VerificationEntry) ;
+  bool Lookahead (const Vector& a, uint32_t k, uint32_t PrefixLength, uint32_t m,
+    const uint64_t* PrevDead, uint64_t* Dead) ;
+  void ApplyLeftRule (const Rule& L, uint32_t i, uint32_t b) ;
+  void AddToRow (uint32_t r, uint32_t Row, const Vector& v) ;
+  void AddToRow (uint32_t r, uint32_t Row, uint32_t Bit) ;
+  void SaveRow (uint32_t r, uint32_t Row) ;
+  void Undo (uint32_t Mark) ;
   } ;
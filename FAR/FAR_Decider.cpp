@@ -8,142 +8,390 @@ bool FiniteAutomataReduction::RunDecider (uint32_t DFA_States, const uint8_t* Ma
   *VerificationEntry = 0xFF ; // i.e. not decided
 
   SetDFA_States (DFA_States) ;
+  nExtensions = 0 ;
+  LimitReached = false ;
 
-  Matrix RStack[2 * MaxDFA_States + 1][2] ;
-  Vector aStack[2 * MaxDFA_States + 1] ;
+  for (Direction = 0 ; Direction <= 1 ; Direction++)
+    {
+    if (Search (MachineSpec, 0, VerificationEntry)) return true ;
+    if (LimitReached) break ;
+    }
+  return false ;
+  }
+
+// bool FiniteAutomataReduction::SearchSubtree (uint32_t DFA_States, const uint8_t* MachineSpec,
+//   uint8_t Direction, const uint8_t* Prefix, uint32_t PrefixLength, uint8_t* VerificationEntry,
+//   const std::atomic<uint32_t>* FirstSuccess, uint32_t JobNumber)
+//
+// Searches the DFAs in one Direction whose transitions 1 to PrefixLength are given
+// by Prefix (transition 0 is always 0). This lets several threads work on the same
+// machine: the search gives up as soon as *FirstSuccess drops below JobNumber, i.e.
+// as soon as some subtree that comes earlier in the full search has succeeded.
+
+bool FiniteAutomataReduction::SearchSubtree (uint32_t DFA_States, const uint8_t* MachineSpec,
+  uint8_t Direction, const uint8_t* Prefix, uint32_t PrefixLength, uint8_t* VerificationEntry,
+  const std::atomic<uint32_t>* FirstSuccess, uint32_t JobNumber)
+  {
+  *VerificationEntry = 0xFF ; // i.e. not decided
+
+  SetDFA_States (DFA_States) ;
+  nExtensions = 0 ;
+  LimitReached = false ;
 
-  for (uint32_t i = 0 ; i <= DFA_States ; i++)
+  this -> Direction = Direction ;
+  memcpy (DFA[0] + 1, Prefix, PrefixLength) ;
+  this -> FirstSuccess = FirstSuccess ;
+  this -> JobNumber = JobNumber ;
+  bool Decided = Search (MachineSpec, PrefixLength, VerificationEntry) ;
+  this -> FirstSuccess = nullptr ;
+  return Decided ;
+  }
+
+// bool FiniteAutomataReduction::TryDFA (uint32_t DFA_States, const uint8_t* MachineSpec,
+//   const uint8_t* CandidateDFA, uint8_t* VerificationEntry, uint8_t FirstDirection)
+//
+// Checks whether CandidateDFA (2 * DFA_States bytes) decides the machine, in either
+// Direction, starting with FirstDirection. This costs at most 2 * DFA_States NFA
+// extensions per Direction.
+
+bool FiniteAutomataReduction::TryDFA (uint32_t DFA_States, const uint8_t* MachineSpec,
+  const uint8_t* CandidateDFA, uint8_t* VerificationEntry, uint8_t FirstDirection)
+  {
+  *VerificationEntry = 0xFF ; // i.e. not decided
+  if (CandidateDFA[0] != 0) return false ;
+
+  SetDFA_States (DFA_States) ;
+  nExtensions = 0 ;
+  LimitReached = false ;
+
+  uint32_t Limit = ExtensionLimit ;
+  ExtensionLimit = 0 ;
+  bool Decided = false ;
+  for (uint32_t d = 0 ; d <= 1 ; d++)
     {
-    RStack[i][0].SetBitWidth (NFA_States) ;
-    RStack[i][1].SetBitWidth (NFA_States) ;
-    aStack[i].SetBitWidth (NFA_States) ;
+    Direction = FirstDirection ^ d ;
+    memcpy (DFA[0] + 1, CandidateDFA + 1, 2 * DFA_States - 1) ;
+    Decided = Search (MachineSpec, 2 * DFA_States - 1, VerificationEntry) ;
+    if (Decided) break ;
     }
+  ExtensionLimit = Limit ;
+  return Decided ;
+  }
 
-  for (Direction = 0 ; Direction <= 1 ; Direction++)
+// bool FiniteAutomataReduction::Search (const uint8_t* MachineSpec, uint32_t PrefixLength, uint8_t* VerificationEntry)
+//
+// Backtracking search through the DFAs in the current Direction, leaving the first
+// PrefixLength + 1 transitions as they are
+
+bool FiniteAutomataReduction::Search (const uint8_t* MachineSpec, uint32_t PrefixLength, uint8_t* VerificationEntry)
+  {
+  Vector aStack[2 * MaxDFA_States + 1] ;
+  uint32_t UndoMark[2 * MaxDFA_States + 1] ;
+
+  // Sort the transitions into left- and right-rules
+  TuringMachineSpec::Transition T ;
+  nLeftRules = nRightRules = 0 ;
+  const uint8_t* p = MachineSpec ;
+  for (uint8_t f = 0 ; f < MachineStates ; f++) // A-E or A-F
+    for (uint8_t r = 0 ; r <= 1 ; r++)
+      {
+      UnpackSpec (&T, p) ; p += 3 ;
+      if (T.Next == 0) continue ; // HALT transition
+      Rule Q = { f, r, T.Write, uint8_t (T.Next - 1) } ; // Convert state from 1-based to 0-based
+      if (T.Move == Direction) RightRules[nRightRules++] = Q ;
+      else LeftRules[nLeftRules++] = Q ;
+      }
+
+  R[0].SetBitWidth (NFA_States) ;
+  R[1].SetBitWidth (NFA_States) ;
+  aStack[0].SetBitWidth (NFA_States) ;
+  UndoLogSize = 0 ;
+  if (UndoLog.size() < 2 * NFA_States * NFA_States) UndoLog.resize (2 * NFA_States * NFA_States) ;
+
+  // 5'
+  R[0][HALT_State].SetBit (HALT_State) ;
+  R[1][HALT_State].SetBit (HALT_State) ;
+
+  // 7'
+  p = MachineSpec ;
+  for (uint8_t f = 0 ; f < MachineStates ; f++) // A-E
+    for (uint8_t r = 0 ; r <= 1 ; r++)
+      {
+      if (p[2] == 0) // HALT transition
+        for (uint32_t i = 0 ; i < DFA_States ; i++)
+          R[r][MachineStates*i + f].SetBit (HALT_State) ;
+      p += 3 ;
+      }
+
+  aStack[0].SetBit (HALT_State) ;
+
+  uint32_t k = 1 ;
+  uint8_t* t = DFA[0] ;
+  t[0] = 0 ;
+  memset (t + PrefixLength + 1, 0, 2 * DFA_States - PrefixLength - 1) ;
+  uint8_t m[2 * MaxDFA_States] ;
+  memset (m, 0, 2 * DFA_States) ;
+  // Dead[k][x]: values of t[x] ruled out by Lookahead, given transitions 0 to k - 1
+  uint64_t Dead[2 * MaxDFA_States + 1][2 * MaxDFA_States] ;
+  memset (Dead[0], 0, sizeof (Dead[0])) ;
+  for ( ; ; )
     {
-    // 5'
-    RStack[0][0][HALT_State].SetBit (HALT_State) ;
-    RStack[0][1][HALT_State].SetBit (HALT_State) ;
-  
-    // 7'
-    const uint8_t* p = MachineSpec ;
-    for (uint8_t f = 0 ; f < MachineStates ; f++) // A-E
-      for (uint8_t r = 0 ; r <= 1 ; r++)
+    // R holds the NFA for the first k - 1 DFA transitions
+    UndoMark[k] = UndoLogSize ;
+    bool Extended = false ;
+    if (Dead[k - 1][k - 1] & (uint64_t (1) << t[k - 1])) nPruned[PRUNE_DEAD_VALUE]++ ;
+    else
+      {
+      if (++nExtensions > ExtensionLimit && ExtensionLimit)
         {
-        if (p[2] == 0) // HALT transition
-          for (uint32_t i = 0 ; i < DFA_States ; i++)
-            RStack[0][r][MachineStates*i + f].SetBit (HALT_State) ;
-        p += 3 ;
+        LimitReached = true ;
+        return false ;
         }
-  
-    aStack[0].SetBit (HALT_State) ;
-  
-    uint32_t k = 1 ;
-    uint8_t* t = DFA[0] ;
-    memset (t, 0, 2 * DFA_States) ;
-    uint8_t m[2 * MaxDFA_States] ;
-    memset (m, 0, 2 * DFA_States) ;
-    for ( ; ; )
-      {
-      RStack[k][0] = RStack[k - 1][0] ;
-      RStack[k][1] = RStack[k - 1][1] ;
-      aStack[k] = aStack[k - 1] ;
+      if (FirstSuccess && *FirstSuccess < JobNumber) return false ;
 
-      if (ExtendNFA (MachineSpec, RStack[k], aStack[k], k))
+      nAllExtensions++ ;
+      aStack[k] = aStack[k - 1] ;
+      Extended = ExtendNFA (aStack[k], k - 1, k - 1) ;
+      if (Extended && k == 2 * DFA_States)
         {
-        if (k == 2 * DFA_States)
-          {
-          // Done
-          R[0] = RStack[k][0] ;
-          R[1] = RStack[k][1] ;
-          a = aStack[k] ;
+        // Done
+        a = aStack[k] ;
 
-          Verify (MachineSpec) ; // Should never fail
+        Verify (MachineSpec) ; // Should never fail
 
-          VerificationEntry[0] = Direction ;
-          memcpy (VerificationEntry + 1, DFA, 2 * DFA_States) ;
-          return true ;
+        VerificationEntry[0] = Direction ;
+        memcpy (VerificationEntry + 1, DFA, 2 * DFA_States) ;
+        return true ;
+        }
+      if (Extended && k < 2 * DFA_States
+        && !Lookahead (aStack[k], k, PrefixLength, m[k - 1], Dead[k - 1], Dead[k]))
+          {
+          nPruned[PRUNE_WIPEOUT]++ ;
+          Extended = false ;
           }
+      }
+
+    if (Extended)
+      {
+      if (k > PrefixLength)
+        {
         uint32_t q_new = m[k - 1] + 1 ;
         t[k] = (q_new < DFA_States && 2 * q_new - 1 == k) ? q_new : 0 ;
         }
-      else
+      }
+    else
+      {
+      do
         {
-        do
-          {
-          if (k <= 1) goto Failed ;
-          k-- ;
-          } while (t[k] > m[k - 1] || t[k] >= DFA_States - 1) ;
-        t[k]++ ;
-        }
-      m[k] = std::max (m[k - 1], t[k]) ;
-      k++ ;
+        if (k <= PrefixLength + 1) return false ;
+        k-- ;
+        } while (t[k] > m[k - 1] || t[k] >= DFA_States - 1) ;
+      t[k]++ ;
+      Undo (UndoMark[k + 1]) ;
       }
-Failed:
-    ;
+    m[k] = std::max (m[k - 1], t[k]) ;
+    k++ ;
     }
-  return false ;
   }
 
-bool FiniteAutomataReduction::ExtendNFA (const uint8_t* MachineSpec, Matrix R[2], Vector& a, uint32_t k)
-  {
-  TuringMachineSpec::Transition T ;
-  const uint8_t* p ; 
+// bool FiniteAutomataReduction::Lookahead (const Vector& a, uint32_t k, uint32_t PrefixLength,
+//   uint32_t m, const uint64_t* PrevDead, uint64_t* Dead)
+//
+// Called when R (with closure a) holds DFA transitions 0 to k - 1, the largest of
+// which is m. For each of the next few transitions x after transition k, tries
+// adding x on its own with each value it could take, and marks in Dead[x] the values
+// that make the NFA accept the initial state. Adding transitions only ever adds bits
+// to R and a, so these values will fail whatever the transitions in between turn out
+// to be, and Search can skip them. Values marked in PrevDead (by the parent node) are
+// already known to fail. Returns false if every value of some transition fails, in
+// which case no DFA extending transitions 0 to k - 1 can succeed.
 
-  // 9'
-  uint32_t i = (k - 1) / 2 ;
-  uint32_t w = (k - 1) & 1 ;
-  uint32_t d = DFA[i][w] ;
-  p = MachineSpec ;
-  for (uint8_t f = 0 ; f < MachineStates ; f++) // A-E or A-F
-    for (uint8_t r = 0 ; r <= 1 ; r++)
+bool FiniteAutomataReduction::Lookahead (const Vector& a, uint32_t k, uint32_t PrefixLength,
+  uint32_t m, const uint64_t* PrevDead, uint64_t* Dead)
+  {
+  memcpy (Dead, PrevDead, 2 * DFA_States * sizeof (uint64_t)) ;
+  if (nExtensions < LookaheadThreshold) return true ; // Not worth it for easy machines
+  uint8_t* t = DFA[0] ;
+  uint32_t Mark = UndoLogSize ;
+  for (uint32_t x = std::max (k + 1, PrefixLength + 1) ; x < 2 * DFA_States && x <= k + LookaheadDepth ; x++)
+    {
+    uint32_t MaxValue = std::min (m + x - k + 1, DFA_States - 1) ;
+    for (uint32_t v = 0 ; v <= MaxValue ; v++)
       {
-      UnpackSpec (&T, p) ; p += 3 ;
-      if (T.Next != 0 && T.Move == Direction && T.Write == w) // Right-rule
+      if (Dead[x] & (uint64_t (1) << v)) continue ;
+      nExtensions++ ;
+      nAllExtensions++ ;
+      nLookaheadExtensions++ ;
+      t[x] = v ;
+      Vector aCopy (a) ;
+      if (!ExtendNFA (aCopy, k, x))
         {
-        uint8_t t = T.Next - 1 ; // Convert state from 1-based to 0-based
-        R[r][MachineStates*i + f].SetBit (MachineStates*d + t) ;
+        Dead[x] |= uint64_t (1) << v ;
+        nPruned[PRUNE_DEAD_VALUE_FOUND]++ ;
         }
+      Undo (Mark) ;
       }
+    if (Dead[x] == (uint64_t (2) << MaxValue) - 1) return false ;
+    }
+  return true ;
+  }
 
-  // 8'
-  for ( ; ; )
+// static uint32_t FiniteAutomataReduction::ListPrefixes (uint32_t DFA_States, uint32_t PrefixLength,
+//   std::vector<uint8_t>& PrefixList)
+//
+// Appends to PrefixList every possible sequence of DFA transitions 1 to PrefixLength,
+// in the order in which Search would try them, and returns the number of sequences.
+// PrefixLength must be less than 2 * DFA_States.
+
+static uint32_t ListPrefixes (uint32_t DFA_States, uint32_t PrefixLength,
+  std::vector<uint8_t>& PrefixList, uint8_t* t, uint8_t* m, uint32_t k)
+  {
+  if (k > PrefixLength)
+    {
+    PrefixList.insert (PrefixList.end(), t + 1, t + k) ;
+    return 1 ;
+    }
+
+  // Same choices as in Search: t[k] runs from 0 to the next new state, unless
+  // this is the last chance to use the next new state, in which case it is forced
+  uint32_t q_new = m[k - 1] + 1 ;
+  uint32_t First = 0 ;
+  uint32_t Last = std::min (q_new, DFA_States - 1) ;
+  if (q_new < DFA_States && 2 * q_new - 1 == k) First = Last = q_new ;
+
+  uint32_t nPrefixes = 0 ;
+  for (uint32_t q = First ; q <= Last ; q++)
+    {
+    t[k] = q ;
+    m[k] = std::max<uint32_t> (m[k - 1], q) ;
+    nPrefixes += ListPrefixes (DFA_States, PrefixLength, PrefixList, t, m, k + 1) ;
+    }
+  return nPrefixes ;
+  }
+
+uint32_t FiniteAutomataReduction::ListPrefixes (uint32_t DFA_States, uint32_t PrefixLength,
+  std::vector<uint8_t>& PrefixList)
+  {
+  uint8_t t[2 * MaxDFA_States] ;
+  uint8_t m[2 * MaxDFA_States] ;
+  t[0] = m[0] = 0 ;
+  return ::ListPrefixes (DFA_States, PrefixLength, PrefixList, t, m, 1) ;
+  }
+
+// bool FiniteAutomataReduction::ExtendNFA (Vector& a, uint32_t k, uint32_t x)
+//
+// Adds DFA transition x (i.e. DFA[x / 2][x & 1]) to the NFA in R, which holds
+// transitions 0 to k - 1 (x >= k), and closes R and a again. Returns false if the
+// new NFA accepts the initial state.
+//
+// On entry, R already satisfies (8') for the first k transitions. So after
+// applying (9') and (8') for the new transition, (8') only needs to be re-applied
+// where R[b][MachineStates*i + t] has changed, or has a 1-bit in a row of R[w]
+// that has changed.
+
+bool FiniteAutomataReduction::ExtendNFA (Vector& a, uint32_t k, uint32_t x)
+  {
+  Changed[0].SetBitWidth (NFA_States) ;
+  Changed[1].SetBitWidth (NFA_States) ;
+  Vector PrevChanged[2] ;
+
+  // 9'
+  uint32_t i = x >> 1 ;
+  uint32_t b = x & 1 ;
+  uint32_t d = DFA[i][b] ;
+  for (uint32_t n = 0 ; n < nRightRules ; n++)
+    {
+    const Rule& Q = RightRules[n] ;
+    if (Q.w == b) AddToRow (Q.r, MachineStates*i + Q.f, MachineStates*d + Q.t) ;
+    }
+
+  // 8' for the new transition
+  for (uint32_t n = 0 ; n < nLeftRules ; n++)
+    ApplyLeftRule (LeftRules[n], i, b) ;
+
+  // a hasn't been closed under R[0] yet if k == 0
+  bool R0_Changed = k == 0 || !Changed[0].IsZero() ;
+
+  // 8' for the transitions whose inputs have changed
+  while (!Changed[0].IsZero() || !Changed[1].IsZero())
     {
-    bool Changed = false ;
-    p = MachineSpec ;
-    for (uint8_t f = 0 ; f < MachineStates ; f++) // A-E
-      for (uint8_t r = 0 ; r <= 1 ; r++)
+    PrevChanged[0] = Changed[0] ;
+    PrevChanged[1] = Changed[1] ;
+    Changed[0].SetBitWidth (NFA_States) ;
+    Changed[1].SetBitWidth (NFA_States) ;
+    for (uint32_t n = 0 ; n < nLeftRules ; n++)
+      {
+      const Rule& L = LeftRules[n] ;
+      for (uint32_t j = 0 ; j <= k ; j++)
         {
-        UnpackSpec (&T, p) ; p += 3 ;
-        if (T.Next != 0 && T.Move != Direction) // Left-rule
-          {
-          uint8_t t = T.Next - 1 ; // Convert state from 1-based to 0-based
-          w = T.Write ;
-          for (uint32_t j = 1 ; j <= k ; j++)
-            {
-            i = (j - 1) / 2 ;
-            uint32_t b = (j - 1) & 1 ;
-            uint32_t d = DFA[i][b] ;
-            Vector v = R[b][MachineStates*i + t] * R[w] ;
-            if (!(R[r][MachineStates*d + f] >= v))
-              {
-              R[r][MachineStates*d + f] += v ;
-              Changed = true ;
-              }
-            }
-          }
+        uint32_t y = j < k ? j : x ; // Transitions 0 to k - 1, then x
+        i = y >> 1 ;
+        b = y & 1 ;
+        uint32_t Row = MachineStates*i + L.t ;
+        if (PrevChanged[b][Row] || R[b][Row] * PrevChanged[L.w])
+          ApplyLeftRule (L, i, b) ;
         }
-
-    if (!Changed) break ;
+      }
+    if (!Changed[0].IsZero()) R0_Changed = true ;
     }
 
-  Vector aPrev (a) ;
-  for ( ; ; )
+  if (R0_Changed)
     {
-    a = R[0] * aPrev ;
-    if (a == aPrev) break ;
-    aPrev = a ;
+    Vector aPrev (a) ;
+    for ( ; ; )
+      {
+      a = R[0] * aPrev ;
+      if (a == aPrev) break ;
+      aPrev = a ;
+      }
     }
 
   return !(R[0][0] * a) ;
   }
+
+// void FiniteAutomataReduction::ApplyLeftRule (const Rule& L, uint32_t i, uint32_t b)
+//
+// (8') for left-rule L and DFA transition (i, b):
+//   R[r][MachineStates*d + f] >= R[b][MachineStates*i + t] * R[w], where d = DFA[i][b]
+
+void FiniteAutomataReduction::ApplyLeftRule (const Rule& L, uint32_t i, uint32_t b)
+  {
+  AddToRow (L.r, MachineStates*DFA[i][b] + L.f, R[b][MachineStates*i + L.t] * R[L.w]) ;
+  }
+
+void FiniteAutomataReduction::AddToRow (uint32_t r, uint32_t Row, const Vector& v)
+  {
+  if (R[r][Row] >= v) return ;
+  SaveRow (r, Row) ;
+  R[r][Row] += v ;
+  }
+
+void FiniteAutomataReduction::AddToRow (uint32_t r, uint32_t Row, uint32_t Bit)
+  {
+  if (R[r][Row][Bit]) return ;
+  SaveRow (r, Row) ;
+  R[r][Row].SetBit (Bit) ;
+  }
+
+// void FiniteAutomataReduction::SaveRow (uint32_t r, uint32_t Row)
+//
+// Called before R[r][Row] is changed: saves it in the undo log, and marks it as
+// changed
+
+void FiniteAutomataReduction::SaveRow (uint32_t r, uint32_t Row)
+  {
+  UndoEntry& U = UndoLog[UndoLogSize++] ;
+  U.r = r ;
+  U.Row = Row ;
+  U.Prev = R[r][Row] ;
+  Changed[r].SetBit (Row) ;
+  }
+
+void FiniteAutomataReduction::Undo (uint32_t Mark)
+  {
+  while (UndoLogSize > Mark)
+    {
+    const UndoEntry& U = UndoLog[--UndoLogSize] ;
+    R[U.r][U.Row] = U.Prev ;
+    }
+  }
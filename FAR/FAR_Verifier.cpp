@@ -3,11 +3,12 @@
 
 void FiniteAutomataReduction::Verify (const uint8_t* MachineSpec)
   {
-  if (Tag == DeciderTag::FAR_DFA_ONLY) ReconstructNFA (MachineSpec) ;
-
+  // Check the DFA before using it to index the NFA (BoolAlgebra doesn't range-check)
   for (uint32_t i = 0 ; i < DFA_States ; i++)
     if (DFA[i][0] >= DFA_States || DFA[i][1] >= DFA_States) VERIFY_ERROR() ;
 
+  if (Tag == DeciderTag::FAR_DFA_ONLY) ReconstructNFA (MachineSpec) ;
+
   // (1) q0 T[0] = q0
   if (DFA[0][0] != 0) VERIFY_ERROR() ;
 
@@ -94,42 +95,47 @@ void FiniteAutomataReduction::Verify (const uint8_t* MachineSpec)
   MachineCount[DFA_States]++ ;
   }
 
-void FiniteAutomataReduction::ReadVerificationInfo()
+void FiniteAutomataReduction::ReadVerificationInfo (DeciderTag Tag, ByteReader Info)
   {
-  Tag = DeciderTag (Read32 (fp)) ;
+  this -> Tag = Tag ;
   if (Tag != DeciderTag::FAR_DFA_ONLY && Tag != DeciderTag::FAR_DFA_NFA) VERIFY_ERROR() ;
-  uint32_t InfoLen = Read32 (fp) ;
+  uint32_t InfoLen = Info.Remaining() ;
 
   switch (Tag)
     {
     case DeciderTag::FAR_DFA_ONLY:
-      Direction = Read8u (fp) ;
+      Direction = Info.Read8u() ;
       DFA_States = (InfoLen - 1) / 2 ;
       if (DFA_States > MaxDFA_States) VERIFY_ERROR() ;
       NFA_States = MachineStates * DFA_States + 1 ;
       HALT_State = NFA_States - 1 ;
-      Read (fp, DFA, 2 * DFA_States) ;
+      memcpy (DFA, Info.Bytes (2 * DFA_States).data(), 2 * DFA_States) ;
       break ;
 
     case DeciderTag::FAR_DFA_NFA:
-      Direction = Read8u (fp) ;
-      DFA_States = Read16u (fp) ;
+      {
+      Direction = Info.Read8u() ;
+      DFA_States = Info.Read16u() ;
       if (DFA_States > MaxDFA_States) VERIFY_ERROR() ;
-      NFA_States = Read16u (fp) ;
+      NFA_States = Info.Read16u() ;
       if (NFA_States > MaxNFA_States) VERIFY_ERROR() ;
       if (NFA_States != MachineStates * DFA_States + 1) VERIFY_ERROR() ;
     
-      if (InfoLen != 5 + 2 * DFA_States + (2 * NFA_States + 1) * ((NFA_States + 7) >> 3))
+      uint32_t nBytes = (NFA_States + 7) >> 3 ;
+      if (InfoLen != 5 + 2 * DFA_States + (2 * NFA_States + 1) * nBytes)
         VERIFY_ERROR() ;
       HALT_State = NFA_States - 1 ;
     
-      Read (fp, DFA, 2 * DFA_States) ;
-      for (uint32_t r = 0 ; r <= 1 ; r++) R[r].Read (fp, NFA_States) ;
-      a.Read (fp, NFA_States) ;
+      memcpy (DFA, Info.Bytes (2 * DFA_States).data(), 2 * DFA_States) ;
+      for (uint32_t r = 0 ; r <= 1 ; r++) R[r].Read (Info.Bytes (NFA_States * nBytes).data(), NFA_States) ;
+      a.Read (Info.Bytes (nBytes).data(), NFA_States) ;
       break ;
+      }
 
     default: VERIFY_ERROR() ;
     }
+  if (!Info.AtEnd()) VERIFY_ERROR() ;
+  this -> Info = Info ; // For VERIFY_ERROR in Verify
   }
 
 void FiniteAutomataReduction::ReconstructNFA (const uint8_t* MachineSpec)
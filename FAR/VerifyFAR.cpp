@@ -2,9 +2,11 @@
 //   <param>: -N<states>            Machine states (2, 3, 4, 5, or 6)
 //            -D<database>          Seed database file (defaults to ../SeedDatabase.bin)
 //            -V<verification file> Input file: verification data to be checked
+//            -X<test machine>      Machine to verify (see ../DvfIndex.h)
 //            -F                    Reconstruct NFA and check it against NFA in dvf
 
 #include <time.h>
+#include <inttypes.h> // for PRIu64
 #include <string>
 
 #include "../bbchallenge.h"
@@ -34,14 +36,14 @@ int main (int argc, char** argv)
 
   Reader.SetParams (&Params) ;
 
-  FiniteAutomataReduction Verifier (Params.MachineStates, Params.fpVerify, Params.CheckNFA) ;
+  FiniteAutomataReduction Verifier (Params.MachineStates, Params.CheckNFA) ;
 
   uint8_t MachineSpec[MAX_MACHINE_SPEC_SIZE] ;
   int LastPercent = -1 ;
 
   clock_t Timer = clock() ;
 
-  for (uint32_t Entry = 0 ; Entry < Reader.nMachines ; Entry++)
+  for (uint64_t Entry = 0 ; Entry < Reader.nMachines ; Entry++)
     {
     int Percent = ((Entry + 1) * 100LL) / Reader.nMachines ;
     if (Percent != LastPercent)
@@ -52,13 +54,14 @@ int main (int argc, char** argv)
       }
 
     // Read SeedDatabaseIndex and Tag from dvf
-    Verifier.SeedDatabaseIndex = Read32 (Verifier.fp) ;
+    TuringMachineReader::DvfEntry VerifEntry = Reader.ReadVerificationEntry() ;
+    Verifier.SeedDatabaseIndex = VerifEntry.MachineIndex ;
 
     // Read the machine spec from the seed database file
-    Reader.Read (Verifier.SeedDatabaseIndex, MachineSpec) ;
+    Reader.Read (VerifEntry.MachineIndex, MachineSpec) ;
 
     // Read the verification info from the file
-    Verifier.ReadVerificationInfo() ;
+    Verifier.ReadVerificationInfo (VerifEntry.Tag, VerifEntry.Info) ;
 
     // Verify it
     Verifier.Verify (MachineSpec) ;
@@ -66,10 +69,10 @@ int main (int argc, char** argv)
 
   Timer = clock() - Timer ;
 
-  if (!CheckEndOfFile (Verifier.fp)) printf ("File too long!\n"), exit (1) ;
-  fclose (Verifier.fp) ;
+  if (!Reader.SingleEntry && !Reader.VerificationAtEnd()) printf ("File too long!\n"), exit (1) ;
+  fclose (Params.fpVerify) ;
 
-  printf ("\n%d machines verified\n", Reader.nMachines) ;
+  printf ("\n%" PRIu64 " machines verified\n", Reader.nMachines) ;
   printf ("Elapsed time %.3f\n", (double)Timer / CLOCKS_PER_SEC) ;
 
   for (uint32_t i = 0 ; i <= FiniteAutomataReduction::MaxDFA_States ; i++)
@@ -102,7 +105,7 @@ void CommandLineParams::Parse (int argc, char** argv)
 void CommandLineParams::PrintHelpAndExit (int status)
   {
   printf ("VerifyFAR <param> <param>...\n") ;
-  CommonParams::PrintHelp() ;
+  PrintHelp() ;
   printf (R"*RAW*(
            -F                    Reconstruct NFA and check it against NFA in dvf
 )*RAW*") ;
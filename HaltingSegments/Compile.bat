@@ -1 +1 @@
-g++ -std=c++20 -Wall -O3 -oHaltingSegments HaltingSegments.cpp ../Params.obj ../Reader.obj ../TuringMachine.obj
+g++ -std=c++20 -Wall -O3 -oHaltingSegments HaltingSegments.cpp HaltingSegment.cpp ../Params.obj ../Reader.obj ../CompressedUmf.obj ../Enumerator.obj ../DvfIndex.obj ../MappedFile.obj ../CompactDvf.obj ../TuringMachine.obj ../ResultCache.obj ../CostHints.obj
@@ -0,0 +1,447 @@
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+#include "HaltingSegment.h"
+
+// We need a special value to indicate that the contents of a cell on the tape
+// are so far undetermined:
+#define TAPE_ANY 3
+
+// We have two different tape sentinels:
+#define TAPE_SENTINEL_LEFT  4
+#define TAPE_SENTINEL_RIGHT 5
+
+void HaltingSegment::ThreadFunction (int nItems, const WorkItem* ItemList, const uint64_t* MachineIndexList,
+  const uint8_t* MachineSpecList, uint8_t* VerificationEntryList)
+  {
+  for ( ; nItems-- ; ItemList++)
+    {
+    auto StartTime = std::chrono::steady_clock::now() ;
+    SeedDatabaseIndex = MachineIndexList[ItemList -> Entry] ;
+    RunDecider (MachineSpecList + ItemList -> Entry * MachineSpecSize,
+      VerificationEntryList + ItemList -> Entry * VERIF_ENTRY_LENGTH,
+      ItemList -> FirstHalfWidth, ItemList -> LastHalfWidth) ;
+    if (CostList)
+      {
+      MachineCost& Cost = CostList[ItemList -> Entry] ;
+      Cost.Steps += TotalNodes ;
+      Cost.Microseconds += std::chrono::duration_cast<std::chrono::microseconds>
+        (std::chrono::steady_clock::now() - StartTime).count() ;
+      }
+    }
+  }
+
+bool HaltingSegment::RunDecider (const uint8_t* MachineSpec, uint8_t* VerificationEntry,
+  int FirstHalfWidth, int LastHalfWidth)
+  {
+  if (!RunDecider (MachineSpec, FirstHalfWidth, LastHalfWidth))
+    {
+    Save32 (VerificationEntry + 4, uint32_t (DeciderTag::NONE)) ;
+    return false ;
+    }
+  Save32 (VerificationEntry, SeedDatabaseIndex) ;
+  Save32 (VerificationEntry + 4, uint32_t (DeciderTag::HALTING_SEGMENT)) ;
+  Save32 (VerificationEntry + 8, VERIF_INFO_LENGTH) ;
+  Save32 (VerificationEntry + 12, Leftmost) ;
+  Save32 (VerificationEntry + 16, Rightmost) ;
+  Save32 (VerificationEntry + 20, MaxDepth) ;
+  Save32 (VerificationEntry + 24, nNodes) ;
+  Save32 (VerificationEntry + 28, 2 * HalfWidth + 1) ;
+  return true ;
+  }
+
+bool HaltingSegment::RunDecider (const uint8_t* MachineSpec, int FirstHalfWidth, int LastHalfWidth)
+  {
+  for (uint32_t i = 0 ; i <= MachineStates ; i++) TransitionTable[i].clear() ;
+
+  for (int i = 0 ; i <= 1 ; i++)
+    {
+    LeftOfSegment[i].clear() ;
+    RightOfSegment[i].clear() ;
+    }
+
+  // Build the backward transition table from the MachineSpec
+  for (uint8_t State = 1 ; State <= MachineStates ; State++)
+    {
+    for (uint8_t Cell = 0 ; Cell <= 1 ; Cell++)
+      {
+      Predecessor T ;
+      UnpackSpec (&T, MachineSpec) ;
+      MachineSpec += 3 ;
+      T.State = State ;
+      T.Read = Cell ;
+      TransitionTable[T.Next].push_back (T) ;
+
+      if (T.Next != 0)
+        {
+        if (T.Move) LeftOfSegment[T.Write].push_back (T) ;
+        else RightOfSegment[T.Write].push_back (T) ;
+        }
+      }
+    }
+
+  TotalNodes = 0 ;
+  for (HalfWidth = FirstHalfWidth ; HalfWidth <= LastHalfWidth ; HalfWidth++)
+    {
+    // Start in state 0 with unspecified tape
+    memset (Tape - HalfWidth, TAPE_ANY, 2 * HalfWidth + 1) ;
+    Tape[-HalfWidth - 1] = TAPE_SENTINEL_LEFT ;
+    Tape[HalfWidth + 1] = TAPE_SENTINEL_RIGHT ;
+    Configuration StartConfig ;
+    StartConfig.State = 0 ;
+    StartConfig.TapeHead = 0 ;
+
+    CompoundTreePool.Clear() ;
+    SimpleTreePool.Clear() ;
+    memset (AlreadySeen, 0, sizeof (AlreadySeen)) ;
+    ExitedLeft = 0 ;
+    ExitedRight = 0 ;
+
+    MaxDepth = nNodes = 0 ;
+    Leftmost = Rightmost = 0 ;
+
+    bool Decided = Recurse (0, StartConfig) ;
+    TotalNodes += nNodes ;
+    if (Decided)
+      {
+      if (MaxDepth > MaxDecidingDepth[HalfWidth])
+        {
+        MaxDecidingDepth[HalfWidth] = MaxDepth ;
+        MaxDecidingDepthMachine[HalfWidth] = SeedDatabaseIndex ;
+        }
+      return true ;
+      }
+    }
+
+  return false ;
+  }
+
+bool HaltingSegment::Recurse (uint32_t Depth, const Configuration& Config)
+  {
+  // Check for possible match with starting configuration
+  if (Config.State == 1)
+    {
+    int i ; for (i = -HalfWidth ; i <= int(HalfWidth) ; i++)
+      if (Tape[i] != 0 && Tape[i] != TAPE_ANY) break ;
+    if (i > (int)HalfWidth)
+      return false ;
+    }
+
+  if (Depth != 0)
+    {
+    nNodes++ ;
+    if (TraceOutput)
+      {
+      printf ("State: %c ; ", Config.State + '@') ;
+      for (int i = -HalfWidth - 1 ; i <= (int)HalfWidth + 1 ; i++)
+        {
+        printf (i == Config.TapeHead ? "[" : i == Config.TapeHead + 1 ? "]" : " ") ;
+        printf ("%c", "01*.__"[Tape[i]]) ;
+        }
+      printf (Config.TapeHead == (int)HalfWidth + 1 ? "]" : " ") ;
+      printf (" ; Node: %d ; Depth: %d\n", nNodes, Depth) ;
+      }
+    }
+
+  if (++Depth > MaxDepth) 
+   {
+   if (Depth > MaxStackDepth) return false ;
+   MaxDepth = Depth ;
+   }
+
+  // If we've seen this already, return true
+  if (Tape[Config.TapeHead] <= 1)
+    {
+    CompoundTree*& Tree = AlreadySeen[Config.State][Tape[Config.TapeHead]] ;
+    if (FindShorterOrEqual (Tree, Tape + Config.TapeHead)) return true ;
+    Tree = Insert (Tree, Tape + Config.TapeHead, nNodes) ;
+    }
+
+  Configuration PrevConfig ;
+
+  // Go through the transitions in reverse order, to match Iijil's Go implementation
+  bool ExitedLeft = false, ExitedRight = false ;
+  for (int i = TransitionTable[Config.State].size() - 1 ; i >= 0 ; i--)
+    {
+    const auto& T = TransitionTable[Config.State][i] ;
+
+    // Update the tape head
+    if (Depth == 1) PrevConfig.TapeHead = Config.TapeHead ;
+    else if (T.Move)
+      {
+      PrevConfig.TapeHead = Config.TapeHead + 1 ;
+      if (PrevConfig.TapeHead > Rightmost) Rightmost = PrevConfig.TapeHead ;
+      }
+    else
+      {
+      PrevConfig.TapeHead = Config.TapeHead - 1 ;
+      if (PrevConfig.TapeHead < Leftmost) Leftmost = PrevConfig.TapeHead ;
+      }
+
+    uint8_t Cell = Tape[PrevConfig.TapeHead] ;
+    switch (Cell)
+      {
+      case TAPE_SENTINEL_LEFT: // Exiting tape segment to the left
+        if (!ExitedLeft)
+          {
+          if (!ExitSegmentLeft (Depth, Config.State)) return false ;
+          ExitedLeft = true ;
+          }
+        continue ;
+
+      case TAPE_SENTINEL_RIGHT: // Exiting tape segment to the right
+        if (!ExitedRight)
+          {
+          if (!ExitSegmentRight (Depth, Config.State)) return false ;
+          ExitedRight = true ;
+          }
+        continue ;
+
+      case TAPE_ANY: // New tape cell reached, so just write the expected value
+        Tape[PrevConfig.TapeHead] = T.Read ;
+        break ;
+
+      default:
+        if (Tape[PrevConfig.TapeHead] != T.Write)
+          {
+          // Clash with required tape cell value, so this is an impossible path
+          Tape[PrevConfig.TapeHead] = Cell ; // Restore the previous value
+          continue ;
+          }
+
+        // Update the tape with the value that it had to contain to reach this state
+        Tape[PrevConfig.TapeHead] = T.Read ;
+        break ;
+      }
+
+    // Perform a backwards step and search deeper
+    PrevConfig.State = T.State ;
+
+    if (!Recurse (Depth, PrevConfig)) return false ;
+
+    Tape[PrevConfig.TapeHead] = Cell ;
+    }
+
+  // No search returned false, i.e. all searches terminated at a finite depth.
+  // So we can't reach this state from the starting position:
+  return true ;
+  }
+
+bool HaltingSegment::ExitSegmentLeft (uint32_t Depth, uint8_t State)
+  {
+  // Check for all zeroes or unset
+  int i ; for (i = -HalfWidth ; i <= int(HalfWidth) ; i++)
+    if (Tape[i] != 0 && Tape[i] != TAPE_ANY) break ;
+  if (i > (int)HalfWidth)
+    return false ;
+
+  // If we've seen this already, return true
+  if (FindShorterOrEqual (ExitedLeft, Tape - HalfWidth)) return true ;
+
+  nNodes++ ;
+
+  if (TraceOutput)
+    {
+    printf ("State: * ; [_]") ;
+    for (int i = -HalfWidth ; i <= (int)HalfWidth ; i++)
+      printf ("%c ", "01*.__"[Tape[i]]) ;
+    printf ("_  ; Node: %d ; Depth: %d\n", nNodes, Depth) ;
+    }
+
+  if (++Depth > MaxDepth) MaxDepth = Depth ;
+
+  ExitedLeft = Insert (ExitedLeft, Tape - HalfWidth, nNodes) ;
+
+  Configuration PrevConfig ;
+  PrevConfig.TapeHead = -HalfWidth ;
+  uint8_t Cell = Tape[-HalfWidth] ;
+
+  // Go through the transitions in reverse order, to match Iijil's Go implementation
+  for (int i = LeftOfSegment[Cell].size() - 1 ; i >= 0 ; i--)
+    {
+    const auto& T = LeftOfSegment[Cell][i] ;
+    PrevConfig.State = T.State ;
+    Tape[-HalfWidth] = T.Read ;
+    if (!Recurse (Depth, PrevConfig)) return false ;
+    Tape[-HalfWidth] = Cell ;
+    }
+
+  return true ;
+  }
+
+bool HaltingSegment::ExitSegmentRight (uint32_t Depth, uint8_t State)
+  {
+  // Check for all zeroes or unset
+  int i ; for (i = -HalfWidth ; i <= int(HalfWidth) ; i++)
+    if (Tape[i] != 0 && Tape[i] != TAPE_ANY) break ;
+  if (i > (int)HalfWidth)
+    return false ;
+
+  // If we've seen this already, return true
+  if (FindShorterOrEqual (ExitedRight, Tape + HalfWidth)) return true ;
+
+  nNodes++ ;
+
+  if (TraceOutput)
+    {
+    printf ("State: * ;  _") ;
+    for (int i = -HalfWidth ; i <= (int)HalfWidth ; i++)
+      printf (" %c", "01*.__"[Tape[i]]) ;
+    printf ("[_] ; Node: %d ; Depth: %d\n", nNodes, Depth) ;
+    }
+
+  if (++Depth > MaxDepth) MaxDepth = Depth ;
+
+  ExitedRight = Insert (ExitedRight, Tape + HalfWidth, nNodes) ;
+
+  Configuration PrevConfig ;
+  PrevConfig.TapeHead = HalfWidth ;
+  uint8_t Cell = Tape[HalfWidth] ;
+
+  // Go through the transitions in reverse order, to match Iijil's Go implementation
+  for (int i = RightOfSegment[Cell].size() - 1 ; i >= 0 ; i--)
+    {
+    const auto& T = RightOfSegment[Cell][i] ;
+    PrevConfig.State = T.State ;
+    Tape[HalfWidth] = T.Read ;
+    if (!Recurse (Depth, PrevConfig)) return false ;
+    Tape[HalfWidth] = Cell ;
+    }
+
+  return true ;
+  }
+
+size_t HaltingSegment::FindShorterOrEqual (const CompoundTree* Tree, const uint8_t* TapeHead)
+  {
+  if (Tree == nullptr) return 0 ;
+  for (const uint8_t* p = TapeHead - 1 ; Tree ; p--)
+    {
+    size_t NodeIndex = FindShorterOrEqual (Tree -> SubTree, TapeHead + 1) ;
+    if (NodeIndex) return NodeIndex ;
+    if (*p > 1) return 0 ;
+    Tree = Tree -> Next[*p] ;
+    }
+  return 0 ;
+  }
+
+HaltingSegment::CompoundTree* HaltingSegment::Insert (CompoundTree* Tree, const uint8_t* TapeHead, size_t NodeIndex)
+  {
+  if (Tree == 0)
+    {
+    Tree = CompoundTreePool.Allocate() ;
+    Tree -> Next[0] = Tree -> Next[1] = 0 ;
+    Tree -> SubTree = 0 ;
+    }
+  CompoundTree* TreeNode = Tree ;
+  for (const uint8_t* p = TapeHead - 1 ; *p <= 1 ; p--)
+    {
+    if (TreeNode -> Next[*p] == 0)
+      {
+      TreeNode -> Next[*p] = CompoundTreePool.Allocate() ;
+      TreeNode -> Next[*p] -> Next[0] = TreeNode -> Next[*p] -> Next[1] = 0 ;
+      TreeNode -> Next[*p] -> SubTree = 0 ;
+      }
+    TreeNode = TreeNode -> Next[*p] ;
+    }
+  TreeNode -> SubTree = Insert (TreeNode -> SubTree, TapeHead + 1, NodeIndex) ;
+  return Tree ;
+  }
+
+size_t HaltingSegment::FindShorterOrEqual (const ForwardTree* Tree, const uint8_t* TapeHead)
+  {
+  // Tree = 0 means no entries here:
+  if (Tree == 0) return 0 ;
+  if (IsLeafNode (Tree)) return TreeAsLeafNode (Tree) ;
+
+  for ( ; ; TapeHead++)
+    {
+    if (*TapeHead > 1) return 0 ;
+    Tree = Tree -> Next[*TapeHead] ;
+    if (Tree == 0) return 0 ;
+    if (IsLeafNode (Tree)) return TreeAsLeafNode (Tree) ;
+    if (Tree -> Next[0] == 0 && Tree -> Next[1] == 0)
+      printf ("Error 2 in FindShorterOrEqual (ForwardTree)\n"), exit (1) ;
+    }
+  }
+
+HaltingSegment::ForwardTree* HaltingSegment::Insert (ForwardTree* Tree, const uint8_t* TapeHead, size_t NodeIndex)
+  {
+  if (*TapeHead > 1) return LeafNodeAsTree<ForwardTree> (NodeIndex) ; // Empty string
+
+  if (Tree == 0)
+    {
+    Tree = (ForwardTree*)SimpleTreePool.Allocate() ;
+    Tree -> Next[0] = Tree -> Next[1] = 0 ;
+    }
+  else if (Tree -> Next[0] == 0 && Tree -> Next[1] == 0)
+    printf ("Error 2 in Insert (ForwardTree)\n"), exit (1) ;
+
+  ForwardTree* TreeNode = Tree ;
+  for ( ; ; )
+    {
+    if (TapeHead[1] > 1)
+      {
+      TreeNode -> Next[*TapeHead] = LeafNodeAsTree<ForwardTree> (NodeIndex) ;
+      return Tree ;
+      }
+    if (TreeNode -> Next[*TapeHead] == 0)
+      {
+      TreeNode -> Next[*TapeHead] = (ForwardTree*)SimpleTreePool.Allocate() ;
+      TreeNode -> Next[*TapeHead] -> Next[0] = TreeNode -> Next[*TapeHead] -> Next[1] = 0 ;
+      }
+    else if (IsLeafNode (TreeNode -> Next[*TapeHead]))
+      printf ("Error 1 in Insert (ForwardTree)\n"), exit (1) ;
+
+    TreeNode = TreeNode -> Next[*TapeHead++] ;
+    }
+  }
+
+size_t HaltingSegment::FindShorterOrEqual (const BackwardTree* Tree, const uint8_t* TapeHead)
+  {
+  // Tree = 0 means no entries here:
+  if (Tree == 0) return 0 ;
+  if (IsLeafNode (Tree)) return TreeAsLeafNode (Tree) ;
+
+  for ( ; ; TapeHead--)
+    {
+    if (*TapeHead > 1) return 0 ;
+    Tree = Tree -> Next[*TapeHead] ;
+    if (Tree == 0) return 0 ;
+    if (IsLeafNode (Tree)) return TreeAsLeafNode (Tree) ;
+    if (Tree -> Next[0] == 0 && Tree -> Next[1] == 0)
+      printf ("Error 2 in FindShorterOrEqual (BackwardTree)\n"), exit (1) ;
+    }
+  }
+
+HaltingSegment::BackwardTree* HaltingSegment::Insert (BackwardTree* Tree, const uint8_t* TapeHead, size_t NodeIndex)
+  {
+  if (*TapeHead > 1) return LeafNodeAsTree<BackwardTree> (NodeIndex) ; // Empty string
+
+  if (Tree == 0)
+    {
+    Tree = (BackwardTree*)SimpleTreePool.Allocate() ;
+    Tree -> Next[0] = Tree -> Next[1] = 0 ;
+    }
+  else if (Tree -> Next[0] == 0 && Tree -> Next[1] == 0)
+    printf ("Error 2 in Insert (BackwardTree)\n"), exit (1) ;
+
+  BackwardTree* TreeNode = Tree ;
+  for ( ; ; )
+    {
+    if (TapeHead[-1] > 1)
+      {
+      TreeNode -> Next[*TapeHead] = LeafNodeAsTree<BackwardTree> (NodeIndex) ;
+      return Tree ;
+      }
+    if (TreeNode -> Next[*TapeHead] == 0)
+      {
+      TreeNode -> Next[*TapeHead] = (BackwardTree*)SimpleTreePool.Allocate() ;
+      TreeNode -> Next[*TapeHead] -> Next[0] = TreeNode -> Next[*TapeHead] -> Next[1] = 0 ;
+      }
+    else if (IsLeafNode (TreeNode -> Next[*TapeHead]))
+      printf ("Error 1 in Insert (BackwardTree)\n"), exit (1) ;
+
+    TreeNode = TreeNode -> Next[*TapeHead--] ;
+    }
+  }
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <limits.h>
+#include <vector>
+
+#include "../TuringMachine.h"
+#include "../CostHints.h"
+
+// Decider-specific Verification Data:
+#define VERIF_INFO_LENGTH 20
+
+class HaltingSegment : public TuringMachineSpec
+  {
+public:
+  HaltingSegment (uint32_t MachineStates, int WidthLimit, uint32_t MaxStackDepth, bool TraceOutput)
+  : TuringMachineSpec (MachineStates)
+  , WidthLimit (WidthLimit)
+  , MaxStackDepth (MaxStackDepth)
+  , TraceOutput (TraceOutput)
+    {
+    WidthLimit |= 1 ; // Should be odd, but no harm in making sure
+
+    // Allocate the tape workspace
+    Tape = new uint8_t[WidthLimit + 2] ;
+    Tape += (WidthLimit + 1) >> 1 ; // so Tape[0] is in the middle
+
+    // Reserve maximum possible lengths for the predecessor vectors,
+    // to avoid having to re-allocate them between searches (a mini-
+    // optimisation)
+    for (uint32_t i = 0 ; i <= MachineStates ; i++)
+      TransitionTable[i].reserve (2 * MachineStates) ;
+
+    // Statistics
+    MaxDecidingDepth = new uint32_t[WidthLimit + 1] ;
+    memset (MaxDecidingDepth, 0, (WidthLimit + 1) * sizeof (uint32_t)) ;
+    MaxDecidingDepthMachine = new uint32_t[WidthLimit + 1] ;
+
+    MinStat = INT_MAX ;
+    MaxStat = INT_MIN ;
+    }
+
+  // Call RunDecider to analyse a single machine at half-widths FirstHalfWidth
+  // to LastHalfWidth inclusive. MachineSpec is in the 30-byte Seed Database format:
+  bool RunDecider (const uint8_t* MachineSpec, int FirstHalfWidth, int LastHalfWidth) ;
+
+  // Call RunDecider with a VerificationEntry to fill it in as well (if the machine
+  // is undecided, the DeciderType is NONE). SeedDatabaseIndex must be set first:
+  bool RunDecider (const uint8_t* MachineSpec, uint8_t* VerificationEntry,
+    int FirstHalfWidth, int LastHalfWidth) ;
+
+  uint8_t* Tape ;
+
+  // Predecessor struct contains the parameters of a possible predecessor state
+  struct Predecessor : public Transition
+    {
+    uint8_t State ;
+    uint8_t Read ;
+    } ;
+
+  // Each undecided machine in the current batch carries the range of segment
+  // half-widths that it has still to try:
+  struct WorkItem
+    {
+    uint32_t Entry ; // Index into the batch
+    int FirstHalfWidth ;
+    int LastHalfWidth ;
+    } ;
+
+  void ThreadFunction (int nItems, const WorkItem* ItemList, const uint64_t* MachineIndexList,
+    const uint8_t* MachineSpecList, uint8_t* VerificationEntryList) ;
+
+  MachineCost* CostList = nullptr ; // -Y: ThreadFunction adds the cost of each item here (indexed by Entry)
+
+  // Each state can be reached from a number of predecessor states:
+  std::vector<Predecessor> TransitionTable[MAX_MACHINE_STATES + 1] ;
+
+  // Possible previous configurations when leaving the segment, depending on tape contents
+  std::vector<Predecessor> LeftOfSegment[2] ;
+  std::vector<Predecessor> RightOfSegment[2] ;
+
+  // The Configuration struct doesn't need to contain the tape contents,
+  // because we update the tape dynamically as we recurse
+  struct Configuration
+    {
+    uint8_t State ;
+    int16_t TapeHead ;
+    } ;
+
+  // Call Recurse with Depth = 0 to start the search
+  bool Recurse (uint32_t Depth, const Configuration& Config) ;
+
+  // If we exit the halting segment to the left or right:
+  bool ExitSegmentLeft (uint32_t Depth, uint8_t State) ;
+  bool ExitSegmentRight (uint32_t Depth, uint8_t State) ;
+
+  //
+  // SEGMENT TREES
+  //
+
+  struct SimpleTree { SimpleTree* Next[2] ; } ;
+  struct ForwardTree { ForwardTree* Next[2] ; } ;
+  struct BackwardTree { BackwardTree* Next[2] ; } ;
+  struct CompoundTree
+    {
+    CompoundTree* Next[2] ;
+    ForwardTree* SubTree ;
+    } ;
+
+  size_t FindShorterOrEqual (const CompoundTree* Tree, const uint8_t* TapeHead) ;
+  CompoundTree* Insert (CompoundTree* Tree, const uint8_t* TapeHead, size_t NodeIndex) ;
+
+  size_t FindShorterOrEqual (const ForwardTree* subTree, const uint8_t* TapeHead) ;
+  ForwardTree* Insert (ForwardTree* Tree, const uint8_t* TapeHead, size_t NodeIndex) ;
+
+  size_t FindShorterOrEqual (const BackwardTree* subTree, const uint8_t* TapeHead) ;
+  BackwardTree* Insert (BackwardTree* Tree, const uint8_t* TapeHead, size_t NodeIndex) ;
+
+  template<class T> bool IsLeafNode (T* Tree)
+    {
+    return ((size_t)Tree & 1) != 0 ;
+    }
+
+  template<class T> uint32_t TreeAsLeafNode (T* Tree)
+    {
+    return (size_t)Tree >> 1 ;
+    }
+
+  template<class T> T* LeafNodeAsTree (size_t NodeIndex)
+    {
+    return (T*)(2 * NodeIndex + 1) ;
+    }
+
+  template<class TreeType> class TreePool
+    {
+    #define BLOCK_SIZE 100000
+  public:
+    TreePool()
+      {
+      FirstBlock = new Block ;
+      CurrentBlock = FirstBlock ;
+      TreeIndex = 0 ;
+      }
+    struct Block
+      {
+      Block* Next = 0 ;
+      TreeType Tree[BLOCK_SIZE] ;
+      } ;
+    Block* FirstBlock ;
+    Block* CurrentBlock ;
+    uint32_t TreeIndex ;
+
+    void Clear()
+      {
+      CurrentBlock = FirstBlock ;
+      TreeIndex = 0 ;
+      }
+
+    TreeType* Allocate()
+      {
+      if (TreeIndex == BLOCK_SIZE)
+        {
+        if (CurrentBlock -> Next == 0) CurrentBlock -> Next = new Block ;
+        CurrentBlock = CurrentBlock -> Next ;
+        TreeIndex = 0 ;
+        }
+      return &CurrentBlock -> Tree[TreeIndex++] ;
+      }
+    } ;
+
+  CompoundTree* AlreadySeen[MAX_MACHINE_STATES + 1][2] ;
+  ForwardTree* ExitedLeft ;
+  BackwardTree* ExitedRight ;
+
+  TreePool<CompoundTree> CompoundTreePool ;
+  TreePool<SimpleTree> SimpleTreePool ;
+
+  uint32_t WidthLimit ; // Must be odd
+  int HalfWidth ;  // Max absolute value of TapeHead = WidthLimit >> 1
+  uint32_t MaxStackDepth ;
+  bool TraceOutput ;
+
+  //
+  // STATISTICS
+  //
+
+  int Leftmost, Rightmost ;
+  uint32_t MaxDepth ;
+  uint32_t nNodes ;
+  uint32_t TotalNodes ; // Over all the widths tried by the last RunDecider
+  uint32_t* MaxDecidingDepth ;
+  uint32_t* MaxDecidingDepthMachine ;
+
+  // Whatever we may want to know from time to time:
+  int MaxStat ; uint32_t MaxStatMachine ;
+  int MinStat ; uint32_t MinStatMachine ;
+  } ;
@@ -5,13 +5,20 @@
 //            -V<verification file> Output file: verification data for decided machines
 //            -I<input file>        Input file: list of machines to be analysed (default=all machines)
 //            -U<undecided file>    Output file: remaining undecided machines
+//            -G                    Write a compressed umf and a compact dvf
+//            -XI                   Write a dvf index along with the dvf (see ../DvfIndex.h)
 //            -X<test machine>      Machine to test
 //            -M<machine spec>      Compact machine code (ASCII spec) to test
 //            -L<machine limit>     Max no. of machines to test
+//            -R<start>:<end>       Machines <start> to <end>-1 of the input file or database
 //            -H<threads>           Number of threads to use
 //            -O                    Print trace output
 //            -W<width limit>       Max segment width (must be odd)
 //            -S<stack depth>       Max stack depth (default 10000)
+//            -E<initial width>     Escalate segment width from <initial width> up to <width limit>
+//            -C<cache file>        Result cache: skip machines whose result is known
+//            -Q<cost hint file>    Give the most expensive machines of each round out first (see ../CostHints.h)
+//            -Y<cost hint file>    Output file: nodes and time for each machine
 //
 // The HaltingSegments Decider starts from the HALT state and recursively generates 
 // all possible predecessor states within a given tape window, plus all possible
@@ -19,18 +26,41 @@
 // entering it again. If it can determine that none of the possible states is the
 // starting state, then there is no way to reach the HALT state from the starting
 // state, and the machine can be flagged as non-halting.
+//
+// Each machine is tried at segment widths 3, 5, 7... up to the width limit, stopping
+// at the first width that decides it. With -E<initial width>, this is done in rounds:
+// every machine is first tried up to the initial width W; the remainder are tried at
+// widths up to 2W+1, and so on up to the width limit. Each machine in the work queue
+// carries the range of widths that it has still to try, so no width is tried twice,
+// and the output files are identical to those of a single round.
+//
+// With -C, each machine is first looked up in the result cache (see ../ResultCache.h).
+// A machine that was decided at width w is decided in the same way with any width
+// limit of w or more, and any stack depth between its search depth and the stack
+// depth of the run that decided it (at which the smaller widths failed). A machine
+// that was undecided is still undecided with any smaller width limit and stack depth;
+// with a larger width limit, only the new widths are tried. The results of all the
+// machines that are run are added to the cache, which is saved at the end.
+//
+// In each round, the work queue is shared out between the threads in equal slices.
+// With -Q, it is shared out longest first instead, each machine going to the thread
+// with the least work so far. The output files are written in input order either way.
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
 #include <time.h>
+#include <inttypes.h> // for PRIu64
 #include <string>
 #include <vector>
 #include <set>
+#include <algorithm>
 
-#include "../TuringMachine.h"
+#include "HaltingSegment.h"
 #include "../Params.h"
+#include "../ResultCache.h"
+#include "../CostHints.h"
 
 #if NEED_BOOST_THREADS
   #include <boost/thread.hpp>
@@ -44,16 +74,8 @@
 #define DEFAULT_CHUNK_SIZE 256
 static uint32_t ChunkSize = DEFAULT_CHUNK_SIZE ;
 
-// Decider-specific Verification Data:
-#define VERIF_INFO_LENGTH 20
-
-// We need a special value to indicate that the contents of a cell on the tape
-// are so far undetermined:
-#define TAPE_ANY 3
-
-// We have two different tape sentinels:
-#define TAPE_SENTINEL_LEFT  4
-#define TAPE_SENTINEL_RIGHT 5
+// Number of chunks per thread to read into memory for each batch of rounds
+#define CHUNKS_PER_BATCH 16
 
 //
 // Command-line parameters
@@ -64,192 +86,37 @@ class CommandLineParams : public DeciderParams
 public:
   int WidthLimit ; bool WidthLimitPresent = false ;
   uint32_t MaxStackDepth = 10000 ;
+  int InitialWidth ; bool InitialWidthPresent = false ;
+  std::vector<int> WidthSchedule ; // Max segment width for each round
+  std::string CacheFilename ;
+  std::string CostHintFilename ;
+  std::string CostOutputFilename ;
+  FILE* fpCostOutput = 0 ;
   void Parse (int argc, char** argv) ;
   void PrintHelpAndExit [[noreturn]] (int status) ;
-  } ;
-
-static CommandLineParams Params ;
-
-//
-// HaltingSegment class
-//
-
-class HaltingSegment : public TuringMachineSpec
-  {
-public:
-  HaltingSegment (uint32_t MachineStates, int WidthLimit)
-  : TuringMachineSpec (MachineStates)
-  , WidthLimit (WidthLimit)
-    {
-    WidthLimit |= 1 ; // Should be odd, but no harm in making sure
-
-    // Allocate the tape workspace
-    Tape = new uint8_t[WidthLimit + 2] ;
-    Tape += (WidthLimit + 1) >> 1 ; // so Tape[0] is in the middle
-
-    // Reserve maximum possible lengths for the predecessor vectors,
-    // to avoid having to re-allocate them between searches (a mini-
-    // optimisation)
-    for (uint32_t i = 0 ; i <= MachineStates ; i++)
-      TransitionTable[i].reserve (2 * MachineStates) ;
-
-    // Statistics
-    MaxDecidingDepth = new uint32_t[WidthLimit + 1] ;
-    memset (MaxDecidingDepth, 0, (WidthLimit + 1) * sizeof (uint32_t)) ;
-    MaxDecidingDepthMachine = new uint32_t[WidthLimit + 1] ;
-
-    MinStat = INT_MAX ;
-    MaxStat = INT_MIN ;
-    }
-
-  // Call RunDecider to analyse a single machine. MachineSpec is in the 30-byte
-  // Seed Database format:
-  bool RunDecider (const uint8_t* MachineSpec) ;
-
-  uint8_t* Tape ;
-
-  // Predecessor struct contains the parameters of a possible predecessor state
-  struct Predecessor : public Transition
-    {
-    uint8_t State ;
-    uint8_t Read ;
-    } ;
-
-  void ThreadFunction (int nMachines, const uint32_t* MachineIndexList,
-    const uint8_t* MachineSpecList, uint8_t* VerificationEntryList) ;
-
-  // Each state can be reached from a number of predecessor states:
-  std::vector<Predecessor> TransitionTable[MAX_MACHINE_STATES + 1] ;
-
-  // Possible previous configurations when leaving the segment, depending on tape contents
-  std::vector<Predecessor> LeftOfSegment[2] ;
-  std::vector<Predecessor> RightOfSegment[2] ;
-
-  // The Configuration struct doesn't need to contain the tape contents,
-  // because we update the tape dynamically as we recurse
-  struct Configuration
-    {
-    uint8_t State ;
-    int16_t TapeHead ;
-    } ;
-
-  // Call Recurse with Depth = 0 to start the search
-  bool Recurse (uint32_t Depth, const Configuration& Config) ;
-
-  // If we exit the halting segment to the left or right:
-  bool ExitSegmentLeft (uint32_t Depth, uint8_t State) ;
-  bool ExitSegmentRight (uint32_t Depth, uint8_t State) ;
-
-  //
-  // SEGMENT TREES
-  //
-
-  struct SimpleTree { SimpleTree* Next[2] ; } ;
-  struct ForwardTree { ForwardTree* Next[2] ; } ;
-  struct BackwardTree { BackwardTree* Next[2] ; } ;
-  struct CompoundTree
-    {
-    CompoundTree* Next[2] ;
-    ForwardTree* SubTree ;
-    } ;
 
-  size_t FindShorterOrEqual (const CompoundTree* Tree, const uint8_t* TapeHead) ;
-  CompoundTree* Insert (CompoundTree* Tree, const uint8_t* TapeHead, size_t NodeIndex) ;
-
-  size_t FindShorterOrEqual (const ForwardTree* subTree, const uint8_t* TapeHead) ;
-  ForwardTree* Insert (ForwardTree* Tree, const uint8_t* TapeHead, size_t NodeIndex) ;
-
-  size_t FindShorterOrEqual (const BackwardTree* subTree, const uint8_t* TapeHead) ;
-  BackwardTree* Insert (BackwardTree* Tree, const uint8_t* TapeHead, size_t NodeIndex) ;
-
-  template<class T> bool IsLeafNode (T* Tree)
-    {
-    return ((size_t)Tree & 1) != 0 ;
-    }
-
-  template<class T> uint32_t TreeAsLeafNode (T* Tree)
-    {
-    return (size_t)Tree >> 1 ;
-    }
-
-  template<class T> T* LeafNodeAsTree (size_t NodeIndex)
+  virtual void OpenFiles() override
     {
-    return (T*)(2 * NodeIndex + 1) ;
+    DeciderParams::OpenFiles() ;
+    fpCostOutput = OpenFile (CostOutputFilename, "wb") ;
     }
-
-  template<class TreeType> class TreePool
-    {
-    #define BLOCK_SIZE 100000
-  public:
-    TreePool()
-      {
-      FirstBlock = new Block ;
-      CurrentBlock = FirstBlock ;
-      TreeIndex = 0 ;
-      }
-    struct Block
-      {
-      Block* Next = 0 ;
-      TreeType Tree[BLOCK_SIZE] ;
-      } ;
-    Block* FirstBlock ;
-    Block* CurrentBlock ;
-    uint32_t TreeIndex ;
-
-    void Clear()
-      {
-      CurrentBlock = FirstBlock ;
-      TreeIndex = 0 ;
-      }
-
-    TreeType* Allocate()
-      {
-      if (TreeIndex == BLOCK_SIZE)
-        {
-        if (CurrentBlock -> Next == 0) CurrentBlock -> Next = new Block ;
-        CurrentBlock = CurrentBlock -> Next ;
-        TreeIndex = 0 ;
-        }
-      return &CurrentBlock -> Tree[TreeIndex++] ;
-      }
-    } ;
-
-  CompoundTree* AlreadySeen[MAX_MACHINE_STATES + 1][2] ;
-  ForwardTree* ExitedLeft ;
-  BackwardTree* ExitedRight ;
-
-  TreePool<CompoundTree> CompoundTreePool ;
-  TreePool<SimpleTree> SimpleTreePool ;
-
-  uint32_t WidthLimit ; // Must be odd
-  int HalfWidth ;  // Max absolute value of TapeHead = WidthLimit >> 1
-
-  //
-  // STATISTICS
-  //
-
-  int Leftmost, Rightmost ;
-  uint32_t MaxDepth ;
-  uint32_t nNodes ;
-  uint32_t* MaxDecidingDepth ;
-  uint32_t* MaxDecidingDepthMachine ;
-
-  // Whatever we may want to know from time to time:
-  int MaxStat ; uint32_t MaxStatMachine ;
-  int MinStat ; uint32_t MinStatMachine ;
   } ;
 
+static CommandLineParams Params ;
+
 int main (int argc, char** argv)
   {
   Params.Parse (argc, argv) ;
 
   Params.CheckParameters() ;
+  if (!Params.CostOutputFilename.empty()) TuringMachineReader::CheckIndex32 (Params, "-Y") ;
   Params.OpenFiles() ;
 
   TuringMachineReader Reader (&Params) ;
 
-  // Write dummy dvf header
-  Write32 (Params.fpVerify, 0) ;
+  // Write umf header and dummy dvf header
+  Reader.WriteUndecidedHeader (Params.fpUndecided) ;
+  Reader.WriteVerificationHeader (Params.fpVerify, 0) ;
 
   if (!Params.nThreadsPresent)
     {
@@ -270,120 +137,209 @@ int main (int argc, char** argv)
 
   clock_t Timer = clock() ;
 
+  uint32_t nRounds = Params.WidthSchedule.size() ;
+  std::vector<uint64_t> RoundTried (nRounds), RoundDecided (nRounds) ;
+  std::vector<clock_t> RoundTime (nRounds) ;
+
+  uint32_t BatchSize = Params.nThreads * ChunkSize * CHUNKS_PER_BATCH ;
+  if (BatchSize > Reader.nMachines) BatchSize = Reader.nMachines ;
   HaltingSegment** DeciderArray = new HaltingSegment*[Params.nThreads] ;
-  uint32_t** MachineIndexList = new uint32_t*[Params.nThreads] ;
-  uint8_t** MachineSpecList = new uint8_t*[Params.nThreads] ;
-  uint8_t** VerificationEntryList = new uint8_t*[Params.nThreads] ;
-  uint32_t* ChunkSizeArray = new uint32_t[Params.nThreads] ;
   for (uint32_t i = 0 ; i < Params.nThreads ; i++)
-    {
-    DeciderArray[i] = new HaltingSegment (Params.MachineStates, Params.WidthLimit) ;
-    MachineIndexList[i] = new uint32_t[ChunkSize] ;
-    MachineSpecList[i] = new uint8_t[Reader.MachineSpecSize * ChunkSize] ;
-    VerificationEntryList[i] = new uint8_t[VERIF_ENTRY_LENGTH * ChunkSize] ;
-    }
-
-  uint32_t nDecided = 0 ;
-  uint32_t nTimeLimitedDecided = 0 ;
-  uint32_t nSpaceLimitedDecided = 0 ;
-  uint32_t nCompleted = 0 ;
+    DeciderArray[i] = new HaltingSegment (Params.MachineStates, Params.WidthLimit,
+      Params.MaxStackDepth, Params.TraceOutput) ;
+  uint64_t* MachineIndexList = new uint64_t[BatchSize] ;
+  uint8_t* MachineSpecList = new uint8_t[Reader.MachineSpecSize * BatchSize] ;
+  uint8_t* VerificationEntryList = new uint8_t[VERIF_ENTRY_LENGTH * BatchSize] ;
+  std::vector<HaltingSegment::WorkItem> Queue, NextQueue ;
+
+  CostHints* Hints = nullptr ;
+  if (!Params.CostHintFilename.empty())
+    {
+    Hints = new CostHints (Params.CostHintFilename) ;
+    printf ("%d cost hints\n", Hints -> nHints) ;
+    }
+  std::vector<uint64_t> QueueIndexList ;
+  std::vector<uint32_t> Order, nAssigned (Params.nThreads) ;
+  MachineCost* CostList = nullptr ;
+  if (Params.fpCostOutput)
+    {
+    CostList = new MachineCost[BatchSize] ;
+    for (uint32_t i = 0 ; i < Params.nThreads ; i++) DeciderArray[i] -> CostList = CostList ;
+    }
+
+  ResultCache* Cache = nullptr ;
+  if (!Params.CacheFilename.empty())
+    Cache = new ResultCache (Params.CacheFilename, DeciderTag::HALTING_SEGMENT, Params.MachineStates, 2) ;
+  uint32_t Limits[2] = { (uint32_t)Params.WidthLimit, Params.MaxStackDepth } ;
+  const ResultCache::Range UndecidedRange[2] = { { 0, Limits[0] }, { 0, Limits[1] } } ;
+
+  uint64_t nDecided = 0 ;
+  uint64_t nTimeLimitedDecided = 0 ;
+  uint64_t nSpaceLimitedDecided = 0 ;
+  uint64_t nCompleted = 0 ;
   int LastPercent = -1 ;
 
   while (nCompleted < Reader.nMachines)
     {
-    uint32_t nRemaining = Reader.nMachines - nCompleted ;
-    if (nRemaining >= Params.nThreads * ChunkSize)
-      {
-      for (uint32_t i = 0 ; i < Params.nThreads ; i++) ChunkSizeArray[i] = ChunkSize ;
-      }
-    else
+    uint32_t nBatch = std::min (Reader.nMachines - nCompleted, (uint64_t)BatchSize) ;
+    Queue.clear() ;
+    if (CostList) std::fill (CostList, CostList + nBatch, MachineCost()) ;
+    for (uint32_t Entry = 0 ; Entry < nBatch ; Entry++)
       {
-      for (uint32_t i = 0 ; i < Params.nThreads ; i++)
+      const uint8_t* MachineSpec = MachineSpecList + Entry * Reader.MachineSpecSize ;
+      MachineIndexList[Entry] = Reader.Next (MachineSpecList + Entry * Reader.MachineSpecSize) ;
+      int FirstHalfWidth = 1 ;
+      if (Cache)
         {
-        ChunkSizeArray[i] = nRemaining / (Params.nThreads - i) ;
-        nRemaining -= ChunkSizeArray[i] ;
+        uint8_t* VerificationEntry = VerificationEntryList + Entry * VERIF_ENTRY_LENGTH ;
+        uint32_t Result, MaxWidth ;
+        if (Cache -> Lookup (MachineSpec, MachineIndexList[Entry], Limits, VerificationEntry, Result))
+          {
+          if (Result != ResultCache::DECIDED) Save32 (VerificationEntry + 4, uint32_t (DeciderTag::NONE)) ;
+          continue ;
+          }
+        if (Cache -> UndecidedUpTo (MachineSpec, Limits, 0, MaxWidth))
+          FirstHalfWidth = (MaxWidth >> 1) + 1 ;
         }
-      }
 
-    for (uint32_t i = 0 ; i < Params.nThreads ; i++)
-      {
-      for (uint32_t j = 0 ; j < ChunkSizeArray[i] ; j++)
-        MachineIndexList[i][j] = Reader.Next (MachineSpecList[i] + j * Reader.MachineSpecSize) ;
-
-      // Run inline if single thread (for ease of debugging)
-      if (Params.nThreads == 1) DeciderArray[i] -> ThreadFunction (ChunkSizeArray[i],
-        MachineIndexList[i], MachineSpecList[i], VerificationEntryList[i]) ;
-      else ThreadList[i] = new thread (&HaltingSegment::ThreadFunction, DeciderArray[i],
-        ChunkSizeArray[i], MachineIndexList[i], MachineSpecList[i], VerificationEntryList[i]) ;
+      // If the widths of the first round have already been tried, the machine
+      // skips it
+      Queue.push_back ({ Entry, FirstHalfWidth,
+        std::max (FirstHalfWidth - 1, Params.WidthSchedule[0] >> 1) }) ;
       }
 
-    for (uint32_t i = 0 ; i < Params.nThreads ; i++)
+    for (uint32_t Round = 0 ; Round < nRounds && !Queue.empty() ; Round++)
       {
-      if (Params.nThreads != 1)
+      clock_t RoundTimer = clock() ;
+
+      // Share the work queue out between the threads
+      if (Hints)
+        {
+        QueueIndexList.resize (Queue.size()) ;
+        Order.resize (Queue.size()) ;
+        for (uint32_t i = 0 ; i < Queue.size() ; i++)
+          QueueIndexList[i] = MachineIndexList[Queue[i].Entry] ;
+        Hints -> Schedule (QueueIndexList.data(), Queue.size(), Params.nThreads,
+          Queue.size(), Order.data(), nAssigned.data()) ;
+        NextQueue.clear() ;
+        for (uint32_t i : Order) NextQueue.push_back (Queue[i]) ;
+        std::swap (Queue, NextQueue) ;
+        }
+      uint32_t nRemaining = Queue.size() ;
+      const HaltingSegment::WorkItem* Item = Queue.data() ;
+      for (uint32_t i = 0 ; i < Params.nThreads ; i++)
+        {
+        uint32_t nItems = Hints ? nAssigned[i] : nRemaining / (Params.nThreads - i) ;
+        nRemaining -= nItems ;
+
+        // Run inline if single thread (for ease of debugging)
+        if (Params.nThreads == 1) DeciderArray[i] -> ThreadFunction (nItems, Item,
+          MachineIndexList, MachineSpecList, VerificationEntryList) ;
+        else ThreadList[i] = new thread (&HaltingSegment::ThreadFunction, DeciderArray[i],
+          nItems, Item, MachineIndexList, MachineSpecList, VerificationEntryList) ;
+        Item += nItems ;
+        }
+
+      if (Params.nThreads != 1) for (uint32_t i = 0 ; i < Params.nThreads ; i++)
         {
         // Wait for thread i to finish
         ThreadList[i] -> join() ;
         delete ThreadList[i] ;
         }
 
-      const uint8_t* MachineSpec = MachineSpecList[i] ;
-      const uint8_t* VerificationEntry = VerificationEntryList[i] ;
-      for (uint32_t j = 0 ; j < ChunkSizeArray[i] ; j++)
+      // Undecided machines go on to the next round with the next range of widths
+      NextQueue.clear() ;
+      for (const HaltingSegment::WorkItem& Item : Queue)
+        {
+        RoundTried[Round]++ ;
+        if (Load32 (VerificationEntryList + Item.Entry * VERIF_ENTRY_LENGTH + 4))
+          RoundDecided[Round]++ ;
+        else if (Round + 1 < nRounds) NextQueue.push_back ({ Item.Entry,
+          Item.LastHalfWidth + 1, std::max (Item.LastHalfWidth, Params.WidthSchedule[Round + 1] >> 1) }) ;
+        }
+      std::swap (Queue, NextQueue) ;
+      RoundTime[Round] += clock() - RoundTimer ;
+      }
+
+    // Write the output files in input order
+    const uint8_t* VerificationEntry = VerificationEntryList ;
+    for (uint32_t Entry = 0 ; Entry < nBatch ; Entry++)
+      {
+      const uint8_t* MachineSpec = MachineSpecList + Entry * Reader.MachineSpecSize ;
+      if (Load32 (VerificationEntry + 4))
         {
-        if (Load32 (VerificationEntry + 4))
+        Reader.WriteVerificationEntry (Params.fpVerify, MachineIndexList[Entry],
+          VerificationEntry, VERIF_ENTRY_LENGTH) ;
+        if (Cache)
           {
-          if (Params.fpVerify && fwrite (VerificationEntry, VERIF_ENTRY_LENGTH, 1, Params.fpVerify) != 1)
-            printf ("Error writing file\n"), exit (1) ;
-          nDecided++ ;
-          if (MachineIndexList[i][j] < Reader.nTimeLimited) nTimeLimitedDecided++ ;
-          else nSpaceLimitedDecided++ ;
+          // Decided at this width, given enough stack depth for its search
+          // (MaxDepth can exceed the stack depth when the search leaves the segment)
+          uint32_t MinStackDepth = std::min (Load32 (VerificationEntry + 20), Limits[1]) ;
+          const ResultCache::Range DecidedRange[2] =
+            { { Load32 (VerificationEntry + 28), UINT32_MAX }, { MinStackDepth, Limits[1] } } ;
+          Cache -> Add (MachineSpec, DecidedRange, ResultCache::DECIDED, VerificationEntry) ;
           }
-        else Write32 (Params.fpUndecided, MachineIndexList[i][j]) ;
-        MachineSpec += Reader.MachineSpecSize ;
-        VerificationEntry += VERIF_ENTRY_LENGTH ;
-        nCompleted++ ;
+        nDecided++ ;
+        if (MachineIndexList[Entry] < Reader.nTimeLimited) nTimeLimitedDecided++ ;
+        else nSpaceLimitedDecided++ ;
+        }
+      else
+        {
+        Reader.WriteUndecided (Params.fpUndecided, MachineIndexList[Entry]) ;
+        if (Cache) Cache -> Add (MachineSpec, UndecidedRange, 1) ;
         }
+      if (CostList) CostHints::Write (Params.fpCostOutput, MachineIndexList[Entry], CostList[Entry]) ;
+      VerificationEntry += VERIF_ENTRY_LENGTH ;
       }
+    nCompleted += nBatch ;
 
     int Percent = (nCompleted * 100LL) / Reader.nMachines ;
     if (Percent != LastPercent)
       {
       LastPercent = Percent ;
-      printf ("\r%d%% %d %d", Percent, nCompleted, nDecided) ;
+      printf ("\r%d%% %" PRIu64 " %" PRIu64, Percent, nCompleted, nDecided) ;
       fflush (stdout) ;
       }
     }
   printf ("\n") ;
 
-  if (Params.fpUndecided) fclose (Params.fpUndecided) ;
+  if (Params.fpUndecided) Reader.CloseUndecided (Params.fpUndecided) ;
   if (Params.fpInput) fclose (Params.fpInput) ;
+  if (Params.fpCostOutput) fclose (Params.fpCostOutput) ;
 
-  if (Params.fpVerify)
-    {
-    // Write the verification file header
-    if (fseek (Params.fpVerify, 0 , SEEK_SET))
-      printf ("\nfseek failed\n"), exit (1) ;
-    Write32 (Params.fpVerify, nDecided) ;
-    fclose (Params.fpVerify) ;
-    }
+  // Write the verification file header, and finish off the dvf index
+  if (Params.fpVerify) Reader.CloseVerification (Params.fpVerify, nDecided) ;
 
   Timer = clock() - Timer ;
 
-  printf ("\nDecided %d out of %d\n", nDecided, Reader.nMachines) ;
+  printf ("\nDecided %" PRIu64 " out of %" PRIu64 "\n", nDecided, Reader.nMachines) ;
   printf ("Elapsed time %.3f\n", (double)Timer / CLOCKS_PER_SEC) ;
 
+  if (Cache)
+    {
+    Cache -> PrintStats() ;
+    Cache -> Save() ;
+    }
+
   printf ("\nMax search depth for decided machines by segment width:\n") ;
-  for (int HalfWidth = 1 ; 2 * HalfWidth + 1 <= Params.WidthLimit ; HalfWidth++)
+  int HalfWidth = 1 ;
+  for (uint32_t Round = 0 ; Round < nRounds ; Round++)
     {
-    uint32_t Max = 0 ;
-    uint32_t MaxMachineIndex ;
-    for (uint32_t i = 0 ; i < Params.nThreads ; i++)
-      if (DeciderArray[i] -> MaxDecidingDepth[HalfWidth] > Max)
-        {
-        Max = DeciderArray[i] -> MaxDecidingDepth[HalfWidth] ;
-        MaxMachineIndex = DeciderArray[i] -> MaxDecidingDepthMachine[HalfWidth] ;
-        }
-    if (Max) printf ("%d: %d (#%d)\n", 2 * HalfWidth + 1, Max, MaxMachineIndex) ;
+    if (nRounds > 1) printf ("Round %d (width %d to %d): %" PRIu64 " out of %" PRIu64 ", time %.3f\n",
+      Round + 1, 2 * HalfWidth + 1, Params.WidthSchedule[Round], RoundDecided[Round],
+      RoundTried[Round], (double)RoundTime[Round] / CLOCKS_PER_SEC) ;
+    for ( ; 2 * HalfWidth + 1 <= Params.WidthSchedule[Round] ; HalfWidth++)
+      {
+      uint32_t Max = 0 ;
+      uint32_t MaxMachineIndex ;
+      for (uint32_t i = 0 ; i < Params.nThreads ; i++)
+        if (DeciderArray[i] -> MaxDecidingDepth[HalfWidth] > Max)
+          {
+          Max = DeciderArray[i] -> MaxDecidingDepth[HalfWidth] ;
+          MaxMachineIndex = DeciderArray[i] -> MaxDecidingDepthMachine[HalfWidth] ;
+          }
+      if (Max) printf ("%d: %d (#%d)\n", 2 * HalfWidth + 1, Max, MaxMachineIndex) ;
+      }
     }
 
   int MinStat = INT_MAX ;
@@ -407,422 +363,6 @@ int main (int argc, char** argv)
   if (MaxStat != INT_MIN) printf ("\n%d: MaxStat = %d\n", MaxStatMachine, MaxStat) ;
   }
 
-void HaltingSegment::ThreadFunction (int nMachines, const uint32_t* MachineIndexList,
-  const uint8_t* MachineSpecList, uint8_t* VerificationEntryList)
-  {
-  while (nMachines--)
-    {
-    SeedDatabaseIndex = *MachineIndexList++ ;
-    if (RunDecider (MachineSpecList))
-      {
-      Save32 (VerificationEntryList, SeedDatabaseIndex) ;
-      Save32 (VerificationEntryList + 4, uint32_t (DeciderTag::HALTING_SEGMENT)) ;
-      Save32 (VerificationEntryList + 8, VERIF_INFO_LENGTH) ;
-      Save32 (VerificationEntryList + 12, Leftmost) ;
-      Save32 (VerificationEntryList + 16, Rightmost) ;
-      Save32 (VerificationEntryList + 20, MaxDepth) ;
-      Save32 (VerificationEntryList + 24, nNodes) ;
-      Save32 (VerificationEntryList + 28, 2 * HalfWidth + 1) ;
-      }
-    else Save32 (VerificationEntryList + 4, uint32_t (DeciderTag::NONE)) ;
-
-    MachineSpecList += MachineSpecSize ;
-    VerificationEntryList += VERIF_ENTRY_LENGTH ;
-    }
-  }
-
-bool HaltingSegment::RunDecider (const uint8_t* MachineSpec)
-  {
-  for (uint32_t i = 0 ; i <= MachineStates ; i++) TransitionTable[i].clear() ;
-
-  for (int i = 0 ; i <= 1 ; i++)
-    {
-    LeftOfSegment[i].clear() ;
-    RightOfSegment[i].clear() ;
-    }
-
-  // Build the backward transition table from the MachineSpec
-  for (uint8_t State = 1 ; State <= MachineStates ; State++)
-    {
-    for (uint8_t Cell = 0 ; Cell <= 1 ; Cell++)
-      {
-      Predecessor T ;
-      UnpackSpec (&T, MachineSpec) ;
-      MachineSpec += 3 ;
-      T.State = State ;
-      T.Read = Cell ;
-      TransitionTable[T.Next].push_back (T) ;
-
-      if (T.Next != 0)
-        {
-        if (T.Move) LeftOfSegment[T.Write].push_back (T) ;
-        else RightOfSegment[T.Write].push_back (T) ;
-        }
-      }
-    }
-
-  for (HalfWidth = 1 ; 2 * HalfWidth + 1 <= Params.WidthLimit ; HalfWidth++)
-    {
-    // Start in state 0 with unspecified tape
-    memset (Tape - HalfWidth, TAPE_ANY, 2 * HalfWidth + 1) ;
-    Tape[-HalfWidth - 1] = TAPE_SENTINEL_LEFT ;
-    Tape[HalfWidth + 1] = TAPE_SENTINEL_RIGHT ;
-    Configuration StartConfig ;
-    StartConfig.State = 0 ;
-    StartConfig.TapeHead = 0 ;
-
-    CompoundTreePool.Clear() ;
-    SimpleTreePool.Clear() ;
-    memset (AlreadySeen, 0, sizeof (AlreadySeen)) ;
-    ExitedLeft = 0 ;
-    ExitedRight = 0 ;
-
-    MaxDepth = nNodes = 0 ;
-    Leftmost = Rightmost = 0 ;
-
-    if (Recurse (0, StartConfig))
-      {
-      if (MaxDepth > MaxDecidingDepth[HalfWidth])
-        {
-        MaxDecidingDepth[HalfWidth] = MaxDepth ;
-        MaxDecidingDepthMachine[HalfWidth] = SeedDatabaseIndex ;
-        }
-      return true ;
-      }
-    }
-
-  return false ;
-  }
-
-bool HaltingSegment::Recurse (uint32_t Depth, const Configuration& Config)
-  {
-  // Check for possible match with starting configuration
-  if (Config.State == 1)
-    {
-    int i ; for (i = -HalfWidth ; i <= int(HalfWidth) ; i++)
-      if (Tape[i] != 0 && Tape[i] != TAPE_ANY) break ;
-    if (i > (int)HalfWidth)
-      return false ;
-    }
-
-  if (Depth != 0)
-    {
-    nNodes++ ;
-    if (Params.TraceOutput)
-      {
-      printf ("State: %c ; ", Config.State + '@') ;
-      for (int i = -HalfWidth - 1 ; i <= (int)HalfWidth + 1 ; i++)
-        {
-        printf (i == Config.TapeHead ? "[" : i == Config.TapeHead + 1 ? "]" : " ") ;
-        printf ("%c", "01*.__"[Tape[i]]) ;
-        }
-      printf (Config.TapeHead == (int)HalfWidth + 1 ? "]" : " ") ;
-      printf (" ; Node: %d ; Depth: %d\n", nNodes, Depth) ;
-      }
-    }
-
-  if (++Depth > MaxDepth) 
-   {
-   if (Depth > Params.MaxStackDepth) return false ;
-   MaxDepth = Depth ;
-   }
-
-  // If we've seen this already, return true
-  if (Tape[Config.TapeHead] <= 1)
-    {
-    CompoundTree*& Tree = AlreadySeen[Config.State][Tape[Config.TapeHead]] ;
-    if (FindShorterOrEqual (Tree, Tape + Config.TapeHead)) return true ;
-    Tree = Insert (Tree, Tape + Config.TapeHead, nNodes) ;
-    }
-
-  Configuration PrevConfig ;
-
-  // Go through the transitions in reverse order, to match Iijil's Go implementation
-  bool ExitedLeft = false, ExitedRight = false ;
-  for (int i = TransitionTable[Config.State].size() - 1 ; i >= 0 ; i--)
-    {
-    const auto& T = TransitionTable[Config.State][i] ;
-
-    // Update the tape head
-    if (Depth == 1) PrevConfig.TapeHead = Config.TapeHead ;
-    else if (T.Move)
-      {
-      PrevConfig.TapeHead = Config.TapeHead + 1 ;
-      if (PrevConfig.TapeHead > Rightmost) Rightmost = PrevConfig.TapeHead ;
-      }
-    else
-      {
-      PrevConfig.TapeHead = Config.TapeHead - 1 ;
-      if (PrevConfig.TapeHead < Leftmost) Leftmost = PrevConfig.TapeHead ;
-      }
-
-    uint8_t Cell = Tape[PrevConfig.TapeHead] ;
-    switch (Cell)
-      {
-      case TAPE_SENTINEL_LEFT: // Exiting tape segment to the left
-        if (!ExitedLeft)
-          {
-          if (!ExitSegmentLeft (Depth, Config.State)) return false ;
-          ExitedLeft = true ;
-          }
-        continue ;
-
-      case TAPE_SENTINEL_RIGHT: // Exiting tape segment to the right
-        if (!ExitedRight)
-          {
-          if (!ExitSegmentRight (Depth, Config.State)) return false ;
-          ExitedRight = true ;
-          }
-        continue ;
-
-      case TAPE_ANY: // New tape cell reached, so just write the expected value
-        Tape[PrevConfig.TapeHead] = T.Read ;
-        break ;
-
-      default:
-        if (Tape[PrevConfig.TapeHead] != T.Write)
-          {
-          // Clash with required tape cell value, so this is an impossible path
-          Tape[PrevConfig.TapeHead] = Cell ; // Restore the previous value
-          continue ;
-          }
-
-        // Update the tape with the value that it had to contain to reach this state
-        Tape[PrevConfig.TapeHead] = T.Read ;
-        break ;
-      }
-
-    // Perform a backwards step and search deeper
-    PrevConfig.State = T.State ;
-
-    if (!Recurse (Depth, PrevConfig)) return false ;
-
-    Tape[PrevConfig.TapeHead] = Cell ;
-    }
-
-  // No search returned false, i.e. all searches terminated at a finite depth.
-  // So we can't reach this state from the starting position:
-  return true ;
-  }
-
-bool HaltingSegment::ExitSegmentLeft (uint32_t Depth, uint8_t State)
-  {
-  // Check for all zeroes or unset
-  int i ; for (i = -HalfWidth ; i <= int(HalfWidth) ; i++)
-    if (Tape[i] != 0 && Tape[i] != TAPE_ANY) break ;
-  if (i > (int)HalfWidth)
-    return false ;
-
-  // If we've seen this already, return true
-  if (FindShorterOrEqual (ExitedLeft, Tape - HalfWidth)) return true ;
-
-  nNodes++ ;
-
-  if (Params.TraceOutput)
-    {
-    printf ("State: * ; [_]") ;
-    for (int i = -HalfWidth ; i <= (int)HalfWidth ; i++)
-      printf ("%c ", "01*.__"[Tape[i]]) ;
-    printf ("_  ; Node: %d ; Depth: %d\n", nNodes, Depth) ;
-    }
-
-  if (++Depth > MaxDepth) MaxDepth = Depth ;
-
-  ExitedLeft = Insert (ExitedLeft, Tape - HalfWidth, nNodes) ;
-
-  Configuration PrevConfig ;
-  PrevConfig.TapeHead = -HalfWidth ;
-  uint8_t Cell = Tape[-HalfWidth] ;
-
-  // Go through the transitions in reverse order, to match Iijil's Go implementation
-  for (int i = LeftOfSegment[Cell].size() - 1 ; i >= 0 ; i--)
-    {
-    const auto& T = LeftOfSegment[Cell][i] ;
-    PrevConfig.State = T.State ;
-    Tape[-HalfWidth] = T.Read ;
-    if (!Recurse (Depth, PrevConfig)) return false ;
-    Tape[-HalfWidth] = Cell ;
-    }
-
-  return true ;
-  }
-
-bool HaltingSegment::ExitSegmentRight (uint32_t Depth, uint8_t State)
-  {
-  // Check for all zeroes or unset
-  int i ; for (i = -HalfWidth ; i <= int(HalfWidth) ; i++)
-    if (Tape[i] != 0 && Tape[i] != TAPE_ANY) break ;
-  if (i > (int)HalfWidth)
-    return false ;
-
-  // If we've seen this already, return true
-  if (FindShorterOrEqual (ExitedRight, Tape + HalfWidth)) return true ;
-
-  nNodes++ ;
-
-  if (Params.TraceOutput)
-    {
-    printf ("State: * ;  _") ;
-    for (int i = -HalfWidth ; i <= (int)HalfWidth ; i++)
-      printf (" %c", "01*.__"[Tape[i]]) ;
-    printf ("[_] ; Node: %d ; Depth: %d\n", nNodes, Depth) ;
-    }
-
-  if (++Depth > MaxDepth) MaxDepth = Depth ;
-
-  ExitedRight = Insert (ExitedRight, Tape + HalfWidth, nNodes) ;
-
-  Configuration PrevConfig ;
-  PrevConfig.TapeHead = HalfWidth ;
-  uint8_t Cell = Tape[HalfWidth] ;
-
-  // Go through the transitions in reverse order, to match Iijil's Go implementation
-  for (int i = RightOfSegment[Cell].size() - 1 ; i >= 0 ; i--)
-    {
-    const auto& T = RightOfSegment[Cell][i] ;
-    PrevConfig.State = T.State ;
-    Tape[HalfWidth] = T.Read ;
-    if (!Recurse (Depth, PrevConfig)) return false ;
-    Tape[HalfWidth] = Cell ;
-    }
-
-  return true ;
-  }
-
-size_t HaltingSegment::FindShorterOrEqual (const CompoundTree* Tree, const uint8_t* TapeHead)
-  {
-  if (Tree == nullptr) return 0 ;
-  for (const uint8_t* p = TapeHead - 1 ; Tree ; p--)
-    {
-    size_t NodeIndex = FindShorterOrEqual (Tree -> SubTree, TapeHead + 1) ;
-    if (NodeIndex) return NodeIndex ;
-    if (*p > 1) return 0 ;
-    Tree = Tree -> Next[*p] ;
-    }
-  return 0 ;
-  }
-
-HaltingSegment::CompoundTree* HaltingSegment::Insert (CompoundTree* Tree, const uint8_t* TapeHead, size_t NodeIndex)
-  {
-  if (Tree == 0)
-    {
-    Tree = CompoundTreePool.Allocate() ;
-    Tree -> Next[0] = Tree -> Next[1] = 0 ;
-    Tree -> SubTree = 0 ;
-    }
-  CompoundTree* TreeNode = Tree ;
-  for (const uint8_t* p = TapeHead - 1 ; *p <= 1 ; p--)
-    {
-    if (TreeNode -> Next[*p] == 0)
-      {
-      TreeNode -> Next[*p] = CompoundTreePool.Allocate() ;
-      TreeNode -> Next[*p] -> Next[0] = TreeNode -> Next[*p] -> Next[1] = 0 ;
-      TreeNode -> Next[*p] -> SubTree = 0 ;
-      }
-    TreeNode = TreeNode -> Next[*p] ;
-    }
-  TreeNode -> SubTree = Insert (TreeNode -> SubTree, TapeHead + 1, NodeIndex) ;
-  return Tree ;
-  }
-
-size_t HaltingSegment::FindShorterOrEqual (const ForwardTree* Tree, const uint8_t* TapeHead)
-  {
-  // Tree = 0 means no entries here:
-  if (Tree == 0) return 0 ;
-  if (IsLeafNode (Tree)) return TreeAsLeafNode (Tree) ;
-
-  for ( ; ; TapeHead++)
-    {
-    if (*TapeHead > 1) return 0 ;
-    Tree = Tree -> Next[*TapeHead] ;
-    if (Tree == 0) return 0 ;
-    if (IsLeafNode (Tree)) return TreeAsLeafNode (Tree) ;
-    if (Tree -> Next[0] == 0 && Tree -> Next[1] == 0)
-      printf ("Error 2 in FindShorterOrEqual (ForwardTree)\n"), exit (1) ;
-    }
-  }
-
-HaltingSegment::ForwardTree* HaltingSegment::Insert (ForwardTree* Tree, const uint8_t* TapeHead, size_t NodeIndex)
-  {
-  if (*TapeHead > 1) return LeafNodeAsTree<ForwardTree> (NodeIndex) ; // Empty string
-
-  if (Tree == 0)
-    {
-    Tree = (ForwardTree*)SimpleTreePool.Allocate() ;
-    Tree -> Next[0] = Tree -> Next[1] = 0 ;
-    }
-  else if (Tree -> Next[0] == 0 && Tree -> Next[1] == 0)
-    printf ("Error 2 in Insert (ForwardTree)\n"), exit (1) ;
-
-  ForwardTree* TreeNode = Tree ;
-  for ( ; ; )
-    {
-    if (TapeHead[1] > 1)
-      {
-      TreeNode -> Next[*TapeHead] = LeafNodeAsTree<ForwardTree> (NodeIndex) ;
-      return Tree ;
-      }
-    if (TreeNode -> Next[*TapeHead] == 0)
-      {
-      TreeNode -> Next[*TapeHead] = (ForwardTree*)SimpleTreePool.Allocate() ;
-      TreeNode -> Next[*TapeHead] -> Next[0] = TreeNode -> Next[*TapeHead] -> Next[1] = 0 ;
-      }
-    else if (IsLeafNode (TreeNode -> Next[*TapeHead]))
-      printf ("Error 1 in Insert (ForwardTree)\n"), exit (1) ;
-
-    TreeNode = TreeNode -> Next[*TapeHead++] ;
-    }
-  }
-
-size_t HaltingSegment::FindShorterOrEqual (const BackwardTree* Tree, const uint8_t* TapeHead)
-  {
-  // Tree = 0 means no entries here:
-  if (Tree == 0) return 0 ;
-  if (IsLeafNode (Tree)) return TreeAsLeafNode (Tree) ;
-
-  for ( ; ; TapeHead--)
-    {
-    if (*TapeHead > 1) return 0 ;
-    Tree = Tree -> Next[*TapeHead] ;
-    if (Tree == 0) return 0 ;
-    if (IsLeafNode (Tree)) return TreeAsLeafNode (Tree) ;
-    if (Tree -> Next[0] == 0 && Tree -> Next[1] == 0)
-      printf ("Error 2 in FindShorterOrEqual (BackwardTree)\n"), exit (1) ;
-    }
-  }
-
-HaltingSegment::BackwardTree* HaltingSegment::Insert (BackwardTree* Tree, const uint8_t* TapeHead, size_t NodeIndex)
-  {
-  if (*TapeHead > 1) return LeafNodeAsTree<BackwardTree> (NodeIndex) ; // Empty string
-
-  if (Tree == 0)
-    {
-    Tree = (BackwardTree*)SimpleTreePool.Allocate() ;
-    Tree -> Next[0] = Tree -> Next[1] = 0 ;
-    }
-  else if (Tree -> Next[0] == 0 && Tree -> Next[1] == 0)
-    printf ("Error 2 in Insert (BackwardTree)\n"), exit (1) ;
-
-  BackwardTree* TreeNode = Tree ;
-  for ( ; ; )
-    {
-    if (TapeHead[-1] > 1)
-      {
-      TreeNode -> Next[*TapeHead] = LeafNodeAsTree<BackwardTree> (NodeIndex) ;
-      return Tree ;
-      }
-    if (TreeNode -> Next[*TapeHead] == 0)
-      {
-      TreeNode -> Next[*TapeHead] = (BackwardTree*)SimpleTreePool.Allocate() ;
-      TreeNode -> Next[*TapeHead] -> Next[0] = TreeNode -> Next[*TapeHead] -> Next[1] = 0 ;
-      }
-    else if (IsLeafNode (TreeNode -> Next[*TapeHead]))
-      printf ("Error 1 in Insert (BackwardTree)\n"), exit (1) ;
-
-    TreeNode = TreeNode -> Next[*TapeHead--] ;
-    }
-  }
-
 void CommandLineParams::Parse (int argc, char** argv)
   {
   if (argc == 1) PrintHelpAndExit (0) ;
@@ -843,6 +383,27 @@ void CommandLineParams::Parse (int argc, char** argv)
         MaxStackDepth = atoi (&argv[0][2]) ;
         break ;
 
+      case 'E':
+        InitialWidth = atoi (&argv[0][2]) ;
+        if (!(InitialWidth & 1)) printf ("Initial segment width must be odd\n"), exit (1) ;
+        InitialWidthPresent = true ;
+        break ;
+
+      case 'C':
+        if (argv[0][2] == 0) printf ("%s: filename expected\n", argv[0]), PrintHelpAndExit (1) ;
+        CacheFilename = std::string (&argv[0][2]) ;
+        break ;
+
+      case 'Q':
+        if (argv[0][2] == 0) printf ("%s: filename expected\n", argv[0]), PrintHelpAndExit (1) ;
+        CostHintFilename = std::string (&argv[0][2]) ;
+        break ;
+
+      case 'Y':
+        if (argv[0][2] == 0) printf ("%s: filename expected\n", argv[0]), PrintHelpAndExit (1) ;
+        CostOutputFilename = std::string (&argv[0][2]) ;
+        break ;
+
       default:
         printf ("Invalid parameter \"%s\"\n", argv[0]) ;
         PrintHelpAndExit (1) ;
@@ -850,6 +411,12 @@ void CommandLineParams::Parse (int argc, char** argv)
     }
 
   if (!WidthLimitPresent) printf ("Width limit not specified\n"), PrintHelpAndExit (1) ;
+
+  // Build the width escalation schedule: W, 2W+1, 4W+3, ..., WidthLimit
+  if (InitialWidthPresent)
+    for (int Width = InitialWidth ; Width < WidthLimit ; Width = 2 * Width + 1)
+      WidthSchedule.push_back (Width) ;
+  WidthSchedule.push_back (WidthLimit) ;
   }
 
 void CommandLineParams::PrintHelpAndExit (int status)
@@ -859,6 +426,10 @@ void CommandLineParams::PrintHelpAndExit (int status)
   printf (R"*RAW*(
            -W<width limit>       Max segment width (must be odd)
            -S<stack depth>       Max stack depth
+           -E<initial width>     Escalate segment width from <initial width> up to <width limit>
+           -C<cache file>        Result cache: skip machines whose result is known
+           -Q<cost hint file>    Give the most expensive machines of each round out first
+           -Y<cost hint file>    Output file: nodes and time for each machine
 )*RAW*") ;
   exit (status) ;
   }
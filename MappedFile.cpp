@@ -0,0 +1,65 @@
+#ifdef _WIN32
+  #include <windows.h>
+  #include <io.h>
+#else
+  #include <sys/mman.h>
+#endif
+
+#include "MappedFile.h"
+
+void MappedFile::Map (FILE* fp)
+  {
+  Unmap() ;
+
+  // The file size can exceed 2^32, so we need to use ftello64:
+  off64_t Pos = ftello64 (fp) ;
+  if (fseeko64 (fp, 0, SEEK_END)) printf ("fseek failed\n"), exit (1) ;
+  Length = ftello64 (fp) ;
+  if (fseeko64 (fp, Pos, SEEK_SET)) printf ("fseek failed\n"), exit (1) ;
+  if (Length == 0) return ;
+
+#ifdef _WIN32
+  HANDLE hFile = (HANDLE)_get_osfhandle (fileno (fp)) ;
+  hMapping = CreateFileMapping (hFile, nullptr, PAGE_READONLY, 0, 0, nullptr) ;
+  if (hMapping)
+    {
+    Base = (const uint8_t*)MapViewOfFile (hMapping, FILE_MAP_READ, 0, 0, 0) ;
+    if (Base == nullptr) CloseHandle (hMapping), hMapping = nullptr ;
+    }
+#else
+  void* p = mmap (nullptr, Length, PROT_READ, MAP_PRIVATE, fileno (fp), 0) ;
+  if (p != MAP_FAILED)
+    {
+    Base = (const uint8_t*)p ;
+    madvise (p, Length, MADV_SEQUENTIAL) ;
+    }
+#endif
+  Mapped = Base != nullptr ;
+  if (Mapped) return ;
+
+  // Read the file into memory instead
+  Copy.resize (Length) ;
+  if (fseeko64 (fp, 0, SEEK_SET)) printf ("fseek failed\n"), exit (1) ;
+  Read (fp, Copy.data(), Length) ;
+  if (fseeko64 (fp, Pos, SEEK_SET)) printf ("fseek failed\n"), exit (1) ;
+  Base = Copy.data() ;
+  }
+
+void MappedFile::Unmap()
+  {
+  if (Mapped)
+    {
+#ifdef _WIN32
+    UnmapViewOfFile (Base) ;
+    CloseHandle (hMapping) ;
+    hMapping = nullptr ;
+#else
+    munmap ((void*)Base, Length) ;
+#endif
+    }
+  Copy.clear() ;
+  Copy.shrink_to_fit() ;
+  Base = nullptr ;
+  Length = 0 ;
+  Mapped = false ;
+  }
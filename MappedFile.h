@@ -0,0 +1,39 @@
+// MappedFile.h
+//
+// MappedFile class
+
+#pragma once
+
+// class MappedFile
+//
+// Maps the whole of an open file into memory, read-only, so that it can be read
+// with a ByteReader (see bbchallenge.h) instead of a call to fread for every
+// field. The Verifiers read their verification files this way (see
+// TuringMachineReader::ReadVerificationEntry), so there are no stdio calls and no
+// heap allocations per dvf entry: each VerificationInfo is parsed straight from
+// the mapping.
+//
+// If the file can't be mapped, Map reads it into memory instead.
+// The FILE* must stay open until the file is unmapped.
+
+#include "bbchallenge.h"
+
+class MappedFile
+  {
+public:
+  ~MappedFile() { Unmap() ; }
+
+  void Map (FILE* fp) ;
+  void Unmap() ;
+
+  ustring_view Data() const { return ustring_view (Base, Length) ; }
+
+private:
+  const uint8_t* Base = nullptr ;
+  uint64_t Length = 0 ;
+  bool Mapped = false ;
+  ustring Copy ; // If the file couldn't be mapped
+#ifdef _WIN32
+  void* hMapping = nullptr ;
+#endif
+  } ;
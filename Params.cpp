@@ -21,6 +21,11 @@ bool CommonParams::ParseParam (const char* arg)
       VerificationFilename = std::string (&arg[2]) ;
       return true ;
 
+    case 'X':
+      TestMachine = ParseInt64 (arg, arg + 2) ;
+      TestMachinePresent = true ;
+      return true ;
+
     default: return false ;
     }
   }
@@ -48,11 +53,6 @@ bool DeciderParams::ParseParam (const char* arg)
       UndecidedFilename = std::string (&arg[2]) ;
       return true ;
 
-    case 'X':
-      TestMachine = ParseInt (arg, arg + 2) ;
-      TestMachinePresent = true ;
-      return true ;
-
     case 'M':
       if (arg[2] == 0) printf ("Invalid parameter \"%s\"\n", arg), PrintHelpAndExit (1) ;
       MachineSpec = std::string (&arg[2]) ;
@@ -60,10 +60,24 @@ bool DeciderParams::ParseParam (const char* arg)
       return true ;
 
     case 'L':
-      MachineLimit = ParseInt (arg, arg + 2) ;
+      MachineLimit = ParseInt64 (arg, arg + 2) ;
       MachineLimitPresent = true ;
       return true ;
 
+    case 'R':
+      {
+      // -R<start>:<end>, where <end> can be omitted
+      std::string Range (arg + 2) ;
+      size_t Colon = Range.find (':') ;
+      if (Colon == std::string::npos) printf ("%s: <start>:<end> expected\n", arg), exit (1) ;
+      RangeStart = ParseInt64 (arg, Range.substr (0, Colon).c_str()) ;
+      if (Colon + 1 < Range.length())
+        RangeEnd = ParseInt64 (arg, Range.c_str() + Colon + 1) ;
+      if (RangeStart > RangeEnd) printf ("%s: invalid range\n", arg), exit (1) ;
+      RangePresent = true ;
+      }
+      return true ;
+
     case 'H':
       nThreads = ParseInt (arg, arg + 2) ;
       nThreadsPresent = true ;
@@ -72,6 +86,20 @@ bool DeciderParams::ParseParam (const char* arg)
     case 'O':
       TraceOutput = true ;
       return true ;
+
+    case 'G':
+      CompressUndecided = true ;
+      return true ;
+
+    case 'X':
+      // -XI (write a dvf index) isn't a test machine; no single letter is free in
+      // every Decider
+      if (toupper (arg[2]) == 'I' && arg[3] == 0)
+        {
+        WriteDvfIndex = true ;
+        return true ;
+        }
+      break ;
     }
 
   return CommonParams::ParseParam (arg) ;
@@ -92,6 +120,11 @@ void DeciderParams::CheckParameters()
       printf ("-L parameter ignored\n") ;
       MachineLimitPresent = false ;
       }
+    if (RangePresent)
+      {
+      printf ("-R parameter ignored\n") ;
+      RangePresent = false ;
+      }
     }
   if (!MachineSpec.empty())
     {
@@ -113,6 +146,13 @@ void DeciderParams::CheckParameters()
         exit (1) ;
       }
     }
+
+  // The machine indices of an enumeration are in the order of the TNF walk, and so
+  // are those of a umf written from it, but a compressed umf must be in increasing
+  // order (see CompressedUmf.h). Checked here, before any output file is opened
+  if (CompressUndecided && TNFEnumerator::IsEnumeration (DatabaseFilename)
+    && MachineSpec.empty() && !TestMachinePresent)
+      printf ("-G can't be used with an enumeration (-DTNF)\n"), exit (1) ;
   }
 
 void VerifierParams::CheckParameters()
@@ -139,6 +179,25 @@ uint32_t CommonParams::ParseInt (const char* arg, const char* s)
     }
   }
 
+uint64_t CommonParams::ParseInt64 (const char* arg, const char* s)
+  {
+  if (*s == 0) printf ("%s: integer expected\n", arg), exit (1) ;
+  if (s[0] == '0' && toupper (s[1]) == 'X')
+    {
+    // Hex
+    if (s[2] == 0) printf ("%s: integer expected\n", arg), exit (1) ;
+    for (int i = 2 ; s[i] ; i++) if (!isxdigit (s[i]))
+      printf ("%s: invalid integer\n", arg), exit (1) ;
+    return strtoull (s + 2, nullptr, 16) ;
+    }
+  else
+    {
+    for (int i = 0 ; s[i] ; i++) if (!isdigit (s[i]))
+      printf ("%s: invalid integer\n", arg), exit (1) ;
+    return strtoull (s, nullptr, 10) ;
+    }
+  }
+
 void CommonParams::PrintHelp() const
   {
   printf (R"*RAW*(
@@ -154,8 +213,11 @@ void DeciderParams::PrintHelp() const
            -X<test machine>      Machine to test
            -M<machine spec>      Compact machine code (ASCII spec) to test
            -L<machine limit>     Max no. of machines to test
+           -R<start>:<end>       Machines <start> to <end>-1 of the input file or database
            -V<verification file> Output file: verification data for decided machines
            -U<undecided file>    Output file: remaining undecided machines
+           -G                    Write a compressed umf and a compact dvf
+           -XI                   Write a dvf index along with the dvf (see ../DvfIndex.h)
            -H<threads>           Number of threads to use
            -O                    Print trace output)*RAW*") ;
   }
@@ -164,5 +226,6 @@ void VerifierParams::PrintHelp() const
   {
   CommonParams::PrintHelp() ;
   printf (R"*RAW*(
-           -V<verification file> Input file: verification data to be checked)*RAW*") ;
+           -V<verification file> Input file: verification data to be checked
+           -X<test machine>      Machine to verify (see ../DvfIndex.h))*RAW*") ;
   }
@@ -7,10 +7,13 @@
 //   -I<input file>        Input file: list of machines to be analysed (default=all machines)
 //   -V<verification file> Output file: verification data for decided machines
 //   -U<undecided file>    Output file: remaining undecided machines
+//   -G                    Write a compressed umf and a compact dvf
+//   -XI                   Write a dvf index along with the dvf (see DvfIndex.h)
 //   -X<test machine>      Machine to test
 //   -M<machine spec>      Compact machine code (ASCII spec) to test
 //   -H<threads>           Number of threads to use
 //   -L<machine limit>     Max no. of machines to test
+//   -R<start>:<end>       Machines <start> to <end>-1 of the input file or database
 //   -O                    Print trace output
 
 #pragma once
@@ -24,16 +27,18 @@ public:
   uint32_t MachineStates = 5 ;
   std::string DatabaseFilename ;
   std::string VerificationFilename ;
-  uint32_t TestMachine ; bool TestMachinePresent = false ;
+  uint64_t TestMachine ; bool TestMachinePresent = false ;
   std::string MachineSpec ;
   bool BinaryMachineSpecs = true ;
 
   virtual bool ParseParam (const char* arg) ;
   static uint32_t ParseInt (const char* arg, const char* s) ;
+  static uint64_t ParseInt64 (const char* arg, const char* s) ;
   virtual void CheckParameters() ;
   virtual void OpenFiles()
     {
-    fpDatabase = OpenFile (DatabaseFilename, "rb") ;
+    if (TNFEnumerator::IsEnumeration (DatabaseFilename)) fpDatabase = nullptr ; // See Enumerator.h
+    else fpDatabase = OpenFile (DatabaseFilename, "rb") ;
     }
 
   virtual void PrintHelp() const ;
@@ -61,8 +66,12 @@ public:
   std::string InputFilename ;
   std::string UndecidedFilename ;
   uint32_t nThreads ;      bool nThreadsPresent ;
-  uint32_t MachineLimit ;  bool MachineLimitPresent ;
+  uint64_t MachineLimit ;  bool MachineLimitPresent ;
+  uint64_t RangeStart = 0 ; uint64_t RangeEnd = UINT64_MAX ; bool RangePresent = false ;
   bool TraceOutput = false ;
+  bool CompressUndecided = false ;
+  bool WriteDvfIndex = false ;
+  bool Resuming = false ; // From a checkpoint (see Checkpoint.h)
 
   virtual bool ParseParam (const char* arg) ;
   virtual void CheckParameters() override ;
@@ -73,13 +82,30 @@ public:
     {
     CommonParams::OpenFiles() ;
     fpInput = OpenFile (InputFilename, "rb") ;
-    fpVerify = OpenFile (VerificationFilename, "wb") ;
-    fpUndecided = OpenFile (UndecidedFilename, "wb") ;
+    fpVerify = OpenOutputFile (VerificationFilename) ;
+    if (WriteDvfIndex && !VerificationFilename.empty())
+      fpVerifyIndex = OpenOutputFile (DvfIndex::IndexFilename (VerificationFilename)) ;
+    fpUndecided = OpenOutputFile (UndecidedFilename) ;
+    }
+
+  // When resuming from a checkpoint, output files are opened for update, so that the
+  // Checkpoint can truncate them to the length they had when it was saved. Binary
+  // files are always opened for update, so that they can be read back before they
+  // are closed (see DvfIndexWriter::Close)
+  FILE* OpenOutputFile (const std::string& Filename, bool Text = false) const
+    {
+    if (!Resuming) return OpenFile (Filename, Text ? "wt" : "w+b") ;
+    if (Filename.empty()) return nullptr ;
+    FILE* fp = fopen (Filename.c_str(), Text ? "r+t" : "r+b") ;
+    if (fp == nullptr)
+      printf ("Can't open file \"%s\" to resume from the checkpoint\n", Filename.c_str()), exit (1) ;
+    return fp ;
     }
 
   virtual bool Verifying() const override { return false ; }
 
   FILE* fpUndecided ;
+  FILE* fpVerifyIndex = nullptr ; // See DvfIndex.h
   } ;
 
 class VerifierParams : public CommonParams
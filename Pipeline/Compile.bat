@@ -0,0 +1 @@
+g++ -std=c++20 -Wall -O3 -march=native -oDecidePipeline DecidePipeline.cpp PipelineStage.cpp ../Cyclers/Cycler.cpp ../BackwardReasoning/BackwardReasoningDecider.cpp ../TranslatedCyclers/TranslatedCycler.cpp ../Bouncers/BouncerDecider.cpp ../Bouncers/Bouncer.cpp ../HaltingSegments/HaltingSegment.cpp ../FAR/FAR_Decider.cpp ../FAR/FAR_Verifier.cpp ../Params.obj ../Reader.obj ../CompressedUmf.obj ../Enumerator.obj ../DvfIndex.obj ../MappedFile.obj ../CompactDvf.obj ../TuringMachine.obj ../ResultCache.obj ../CostHints.obj
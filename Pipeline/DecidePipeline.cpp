@@ -0,0 +1,338 @@
+// DecidePipeline <param> <param>...
+//   <param>: -N<states>            Machine states (2, 3, 4, 5, or 6)
+//            -D<database>          Seed database file (defaults to ../SeedDatabase.bin)
+//            -V<verification file> Output file: verification data for decided machines
+//            -I<input file>        Input file: list of machines to be analysed (default=all machines)
+//            -U<undecided file>    Output file: remaining undecided machines
+//            -G                    Write a compressed umf and a compact dvf
+//            -XI                   Write a dvf index along with the dvf (see ../DvfIndex.h)
+//            -X<test machine>      Machine to test
+//            -M<machine spec>      Compact machine code (ASCII spec) to test
+//            -L<machine limit>     Max no. of machines to test
+//            -R<start>:<end>       Machines <start> to <end>-1 of the input file or database
+//            -H<threads>           Number of threads to use
+//            -O                    Print trace output
+//            -P<stage>             Add a Decider stage (see PipelineStage.h)
+//            -Q<cost hint file>    Run the most expensive machines of each batch first (see ../CostHints.h)
+//            -Y<cost hint file>    Output file: steps and time for each machine
+//
+// DecidePipeline runs several Deciders in a single process. Each machine is read
+// once, and passed to each stage in turn (in the order of the -P parameters) until
+// one of them decides it. The Verification Entries of the decided machines are
+// written to a single dvf, in input order, and the machines that no stage decides
+// are written to the umf. So the output is the same as running each Decider on the
+// umf of the one before, and merging their dvfs, but without the intermediate files.
+//
+// The threads take machines one at a time from a batch that has been read into
+// memory, so a machine that takes a long time in a late stage doesn't hold the
+// other threads up. With -Q, they take them in order of decreasing cost, so that
+// the slowest machines of a batch are not left until the end.
+//
+// With -Y, the total steps (or nodes) and thread time over all the stages that
+// were run are recorded for each machine, in input order.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <inttypes.h> // for PRIu64
+#include <ctype.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+#include "PipelineStage.h"
+#include "../Params.h"
+#include "../CostHints.h"
+
+#if NEED_BOOST_THREADS
+  #include <boost/thread.hpp>
+  using boost::thread ;
+#else
+  #include <thread>
+  using std::thread ;
+#endif
+
+#define CHUNK_SIZE 256 // Number of machines per thread to read into memory for each batch
+
+#define UNDECIDED 0xFF // DecidingStage of an undecided machine
+
+class CommandLineParams : public DeciderParams
+  {
+public:
+  std::vector<StageParams> StageList ;
+  std::string CostHintFilename ;
+  std::string CostOutputFilename ;
+  FILE* fpCostOutput = nullptr ;
+  void Parse (int argc, char** argv) ;
+  void PrintHelpAndExit [[noreturn]] (int status) ;
+
+  virtual void OpenFiles() override
+    {
+    DeciderParams::OpenFiles() ;
+    fpCostOutput = OpenFile (CostOutputFilename, "wb") ;
+    }
+  } ;
+
+static CommandLineParams Params ;
+static TuringMachineReader Reader ;
+
+// Per-thread, per-stage statistics
+struct StageStats
+  {
+  uint64_t nTried = 0 ;
+  uint64_t nDecided = 0 ;
+  double Time = 0 ; // Thread time, in seconds
+  } ;
+
+// The current batch
+static uint32_t nBatch ;
+static std::atomic<uint32_t> NextEntry ;
+static uint64_t* MachineIndexList ;
+static uint8_t* MachineSpecList ;
+static uint8_t* DecidingStage ;
+static ustring* VerificationEntryList ;
+static uint32_t* Order ;        // Entries in the order in which the threads take them
+static MachineCost* CostList ;  // -Y
+
+static void ThreadFunction (std::vector<PipelineStage*>* StageList,
+  std::vector<StageStats>* Stats, uint8_t* Workspace) ;
+
+int main (int argc, char** argv)
+  {
+  Params.Parse (argc, argv) ;
+  Params.CheckParameters() ;
+  if (!Params.CostOutputFilename.empty()) TuringMachineReader::CheckIndex32 (Params, "-Y") ;
+  Params.OpenFiles() ;
+
+  Reader.SetParams (&Params) ;
+
+  CostHints* Hints = nullptr ;
+  if (!Params.CostHintFilename.empty())
+    {
+    Hints = new CostHints (Params.CostHintFilename) ;
+    printf ("%d cost hints\n", Hints -> nHints) ;
+    }
+
+  if (!Params.nThreadsPresent)
+    {
+    if (Reader.SingleEntry) Params.nThreads = 1 ;
+    else
+      {
+      Params.nThreads = 4 ;
+      char* env = getenv ("NUMBER_OF_PROCESSORS") ;
+      if (env)
+        {
+        Params.nThreads = atoi (env) ;
+        if (Params.nThreads == 0) Params.nThreads = 4 ;
+        }
+      printf ("nThreads = %d\n", Params.nThreads) ;
+      }
+    }
+
+  // Each thread has its own set of stages
+  uint32_t nStages = Params.StageList.size() ;
+  bool OrigSeedDatabase = Reader.OrigSeedDatabase && !Reader.SingleEntry ;
+  std::vector<std::vector<PipelineStage*>> StageArray (Params.nThreads) ;
+  std::vector<std::vector<StageStats>> StatsArray (Params.nThreads) ;
+  uint8_t** WorkspaceArray = new uint8_t*[Params.nThreads] ;
+  for (uint32_t i = 0 ; i < Params.nThreads ; i++)
+    {
+    uint32_t MaxEntryLength = 0 ;
+    for (const StageParams& S : Params.StageList)
+      {
+      StageArray[i].push_back (NewPipelineStage (S, Params.MachineStates,
+        OrigSeedDatabase, Reader.nTimeLimited, Params.TraceOutput)) ;
+      MaxEntryLength = std::max (MaxEntryLength, StageArray[i].back() -> MaxEntryLength) ;
+      }
+    StatsArray[i].resize (nStages) ;
+    WorkspaceArray[i] = new uint8_t[MaxEntryLength] ;
+    }
+
+  // Write umf header and dummy dvf header
+  Reader.WriteUndecidedHeader (Params.fpUndecided) ;
+  Reader.WriteVerificationHeader (Params.fpVerify, 0) ;
+
+  clock_t Timer = clock() ;
+
+  uint32_t BatchSize = std::min (Reader.nMachines, (uint64_t)Params.nThreads * CHUNK_SIZE) ;
+  MachineIndexList = new uint64_t[BatchSize] ;
+  MachineSpecList = new uint8_t[BatchSize * Reader.MachineSpecSize] ;
+  DecidingStage = new uint8_t[BatchSize] ;
+  VerificationEntryList = new ustring[BatchSize] ;
+  Order = new uint32_t[BatchSize] ;
+  CostList = Params.fpCostOutput ? new MachineCost[BatchSize] : nullptr ;
+  std::vector<thread*> ThreadList (Params.nThreads) ;
+
+  uint64_t nDecided = 0 ;
+  uint64_t nCompleted = 0 ;
+  int LastPercent = -1 ;
+
+  while (nCompleted < Reader.nMachines)
+    {
+    nBatch = std::min (Reader.nMachines - nCompleted, (uint64_t)BatchSize) ;
+    for (uint32_t Entry = 0 ; Entry < nBatch ; Entry++)
+      MachineIndexList[Entry] = Reader.Next (MachineSpecList + Entry * Reader.MachineSpecSize) ;
+    if (Hints) Hints -> Sort (MachineIndexList, nBatch, Order) ;
+    else for (uint32_t Entry = 0 ; Entry < nBatch ; Entry++) Order[Entry] = Entry ;
+    NextEntry = 0 ;
+
+    // Run inline if single thread (for ease of debugging)
+    if (Params.nThreads == 1) ThreadFunction (&StageArray[0], &StatsArray[0], WorkspaceArray[0]) ;
+    else
+      {
+      for (uint32_t i = 0 ; i < Params.nThreads ; i++)
+        ThreadList[i] = new thread (ThreadFunction, &StageArray[i], &StatsArray[i], WorkspaceArray[i]) ;
+      for (uint32_t i = 0 ; i < Params.nThreads ; i++)
+        {
+        ThreadList[i] -> join() ; // Wait for thread i to finish
+        delete ThreadList[i] ;
+        }
+      }
+
+    // Write the output files in input order
+    for (uint32_t Entry = 0 ; Entry < nBatch ; Entry++)
+      {
+      if (DecidingStage[Entry] != UNDECIDED)
+        {
+        Reader.WriteVerificationEntry (Params.fpVerify, MachineIndexList[Entry],
+          VerificationEntryList[Entry].data(), VerificationEntryList[Entry].size()) ;
+        nDecided++ ;
+        }
+      else Reader.WriteUndecided (Params.fpUndecided, MachineIndexList[Entry]) ;
+      if (CostList) CostHints::Write (Params.fpCostOutput, MachineIndexList[Entry], CostList[Entry]) ;
+      }
+    nCompleted += nBatch ;
+
+    int Percent = (nCompleted * 100LL) / Reader.nMachines ;
+    if (Percent != LastPercent)
+      {
+      LastPercent = Percent ;
+      printf ("\r%d%% %" PRIu64 " %" PRIu64, Percent, nCompleted, nDecided) ;
+      fflush (stdout) ;
+      }
+    }
+  printf ("\n") ;
+
+  if (Params.fpUndecided) Reader.CloseUndecided (Params.fpUndecided) ;
+  if (Params.fpInput) fclose (Params.fpInput) ;
+  if (Params.fpCostOutput) fclose (Params.fpCostOutput) ;
+
+  // Write the verification file header, and finish off the dvf index
+  if (Params.fpVerify) Reader.CloseVerification (Params.fpVerify, nDecided) ;
+
+  Timer = clock() - Timer ;
+
+  printf ("\nDecided %" PRIu64 " out of %" PRIu64 "\n", nDecided, Reader.nMachines) ;
+  printf ("Elapsed time %.3f\n", (double)Timer / CLOCKS_PER_SEC) ;
+
+  printf ("\nDecided machines by stage:\n") ;
+  for (uint32_t s = 0 ; s < nStages ; s++)
+    {
+    StageStats Total ;
+    for (uint32_t i = 0 ; i < Params.nThreads ; i++)
+      {
+      Total.nTried += StatsArray[i][s].nTried ;
+      Total.nDecided += StatsArray[i][s].nDecided ;
+      Total.Time += StatsArray[i][s].Time ;
+      }
+    printf ("%s: %" PRIu64 " out of %" PRIu64 ", time %.3f\n", StageArray[0][s] -> Description.c_str(),
+      Total.nDecided, Total.nTried, Total.Time) ;
+    }
+  }
+
+// static void ThreadFunction (std::vector<PipelineStage*>* StageList,
+//   std::vector<StageStats>* Stats, uint8_t* Workspace)
+//
+// Takes machines from the current batch until there are none left, and runs each
+// one through the stages until one of them decides it
+
+static void ThreadFunction (std::vector<PipelineStage*>* StageList,
+  std::vector<StageStats>* Stats, uint8_t* Workspace)
+  {
+  for (uint32_t Next ; (Next = NextEntry++) < nBatch ; )
+    {
+    uint32_t Entry = Order[Next] ;
+    MachineCost Cost ;
+    const uint8_t* MachineSpec = MachineSpecList + Entry * Reader.MachineSpecSize ;
+    DecidingStage[Entry] = UNDECIDED ;
+    for (uint32_t s = 0 ; s < StageList -> size() ; s++)
+      {
+      PipelineStage* Stage = (*StageList)[s] ;
+      auto StartTime = std::chrono::steady_clock::now() ;
+      bool Decided = Stage -> RunDecider (MachineIndexList[Entry], MachineSpec, Workspace) ;
+      std::chrono::duration<double> Time = std::chrono::steady_clock::now() - StartTime ;
+      (*Stats)[s].Time += Time.count() ;
+      (*Stats)[s].nTried++ ;
+      Cost.Steps += Stage -> Steps ;
+      Cost.Microseconds += std::chrono::duration_cast<std::chrono::microseconds> (Time).count() ;
+      if (Decided)
+        {
+        uint32_t EntryLength = VERIF_HEADER_LENGTH + Load32 (Workspace + 8) ;
+        if (EntryLength > Stage -> MaxEntryLength)
+          printf ("\nVerification entry too long (%s)\n", Stage -> Description.c_str()), exit (1) ;
+        VerificationEntryList[Entry].assign (Workspace, EntryLength) ;
+        DecidingStage[Entry] = s ;
+        (*Stats)[s].nDecided++ ;
+        break ;
+        }
+      }
+    if (CostList) CostList[Entry] = Cost ;
+    }
+  }
+
+void CommandLineParams::Parse (int argc, char** argv)
+  {
+  if (argc == 1) PrintHelpAndExit (0) ;
+
+  for (argc--, argv++ ; argc ; argc--, argv++)
+    {
+    if (DeciderParams::ParseParam (argv[0])) continue ;
+    if (argv[0][0] != '-') printf ("Invalid parameter \"%s\"\n", argv[0]), PrintHelpAndExit (1) ;
+    switch (toupper (argv[0][1]))
+      {
+      case 'P':
+        StageList.emplace_back() ;
+        StageList.back().Parse (&argv[0][2]) ;
+        if (StageList.size() == UNDECIDED) printf ("Too many stages\n"), exit (1) ;
+        break ;
+
+      case 'Q':
+        if (argv[0][2] == 0) printf ("%s: filename expected\n", argv[0]), PrintHelpAndExit (1) ;
+        CostHintFilename = std::string (&argv[0][2]) ;
+        break ;
+
+      case 'Y':
+        if (argv[0][2] == 0) printf ("%s: filename expected\n", argv[0]), PrintHelpAndExit (1) ;
+        CostOutputFilename = std::string (&argv[0][2]) ;
+        break ;
+
+      default:
+        printf ("Invalid parameter \"%s\"\n", argv[0]) ;
+        PrintHelpAndExit (1) ;
+      }
+    }
+
+  if (StageList.empty()) printf ("No stages specified\n"), PrintHelpAndExit (1) ;
+  }
+
+void CommandLineParams::PrintHelpAndExit (int status)
+  {
+  printf ("DecidePipeline <param> <param>...") ;
+  DeciderParams::PrintHelp() ;
+  printf (R"*RAW*(
+           -P<stage>             Add a Decider stage (stages are run in the order given)
+           -Q<cost hint file>    Run the most expensive machines of each batch first
+           -Y<cost hint file>    Output file: steps and time for each machine
+
+  <stage>: Cyclers,T<time limit>,S<space limit>
+           BackwardReasoning,S<depth limit>
+           TranslatedCyclers,T<time limit>[,S<space limit>]
+           Bouncers,T<time limit>,S<space limit>
+           HaltingSegments,W<width limit>[,S<stack depth>]
+           FAR,A<DFA states>[,E<initial DFA states>]
+)*RAW*") ;
+  exit (status) ;
+  }
@@ -0,0 +1,279 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "PipelineStage.h"
+
+// Each Decider header defines its own VERIF_INFO_LENGTH, so we note each entry
+// length as we go:
+
+#include "../Cyclers/Cycler.h"
+static const uint32_t CyclerEntryLength = VERIF_ENTRY_LENGTH ;
+#undef VERIF_INFO_LENGTH
+
+#include "../BackwardReasoning/BackwardReasoningDecider.h"
+static const uint32_t BackwardReasoningEntryLength = VERIF_ENTRY_LENGTH ;
+#undef VERIF_INFO_LENGTH
+
+#include "../TranslatedCyclers/TranslatedCycler.h"
+static const uint32_t TranslatedCyclerEntryLength = VERIF_ENTRY_LENGTH ;
+#undef VERIF_INFO_LENGTH
+
+#include "../HaltingSegments/HaltingSegment.h"
+static const uint32_t HaltingSegmentEntryLength = VERIF_ENTRY_LENGTH ;
+#undef VERIF_INFO_LENGTH
+
+#include "../Bouncers/BouncerDecider.h"
+#include "../FAR/FAR.h"
+
+//
+// Stages
+//
+
+class CyclerStage : public PipelineStage
+  {
+public:
+  CyclerStage (uint32_t MachineStates, uint32_t TimeLimit, uint32_t SpaceLimit, uint64_t nTimeLimited)
+  : Decider (MachineStates, TimeLimit, SpaceLimit)
+  , nTimeLimited (nTimeLimited)
+    {
+    MaxEntryLength = CyclerEntryLength ;
+    }
+
+  virtual bool RunDecider (uint64_t SeedDatabaseIndex, const uint8_t* MachineSpec,
+    uint8_t* VerificationEntry)
+    {
+    Steps = 0 ;
+    if (SeedDatabaseIndex >= nTimeLimited) return false ;
+    Decider.Run (SeedDatabaseIndex, MachineSpec, VerificationEntry) ;
+    Steps = Decider.StepCount ;
+    return Load32 (VerificationEntry + 4) != uint32_t (DeciderTag::NONE) ;
+    }
+
+  Cycler Decider ;
+  uint64_t nTimeLimited ;
+  } ;
+
+class BackwardReasoningStage : public PipelineStage
+  {
+public:
+  BackwardReasoningStage (uint32_t MachineStates, uint32_t DepthLimit)
+  : Decider (MachineStates, MAX_SPACE)
+  , DepthLimit (DepthLimit)
+    {
+    MaxEntryLength = BackwardReasoningEntryLength ;
+    }
+
+  virtual bool RunDecider (uint64_t SeedDatabaseIndex, const uint8_t* MachineSpec,
+    uint8_t* VerificationEntry)
+    {
+    bool Decided = Decider.RunDecider (SeedDatabaseIndex, MachineSpec, DepthLimit, VerificationEntry) ;
+    Steps = Decider.nNodes ;
+    return Decided ;
+    }
+
+  BackwardReasoning Decider ;
+  uint32_t DepthLimit ;
+  } ;
+
+class TranslatedCyclerStage : public PipelineStage
+  {
+public:
+  TranslatedCyclerStage (uint32_t MachineStates, uint32_t TimeLimit, uint32_t SpaceLimit,
+    uint64_t nTimeLimited, bool TraceOutput)
+  : Decider (MachineStates, TimeLimit, SpaceLimit, TraceOutput)
+  , nTimeLimited (nTimeLimited)
+    {
+    MaxEntryLength = TranslatedCyclerEntryLength ;
+    }
+
+  virtual bool RunDecider (uint64_t SeedDatabaseIndex, const uint8_t* MachineSpec,
+    uint8_t* VerificationEntry)
+    {
+    Steps = 0 ;
+    if (SeedDatabaseIndex < nTimeLimited) return false ;
+    Decider.SeedDatabaseIndex = SeedDatabaseIndex ;
+    bool Decided = Decider.Run (MachineSpec, VerificationEntry) ;
+    Steps = Decider.StepCount ;
+    return Decided ;
+    }
+
+  TranslatedCycler Decider ;
+  uint64_t nTimeLimited ;
+  } ;
+
+class BouncerStage : public PipelineStage
+  {
+public:
+  BouncerStage (uint32_t MachineStates, uint32_t TimeLimit, uint32_t SpaceLimit, bool TraceOutput)
+  : Decider (MachineStates, TimeLimit, SpaceLimit, TraceOutput)
+    {
+    Decider.Clone = new BouncerDecider (MachineStates, TimeLimit, SpaceLimit, TraceOutput) ;
+    MaxEntryLength = VERIF_HEADER_LENGTH + VERIF_INFO_MAX_LENGTH ;
+    }
+
+  virtual bool RunDecider (uint64_t SeedDatabaseIndex, const uint8_t* MachineSpec,
+    uint8_t* VerificationEntry)
+    {
+    Decider.SeedDatabaseIndex = SeedDatabaseIndex ;
+    Save32 (VerificationEntry, SeedDatabaseIndex) ;
+    Save32 (VerificationEntry + 4, uint32_t (DeciderTag::NEW_BOUNCER)) ;
+    bool Decided = Decider.RunDecider (MachineSpec, VerificationEntry) ;
+    Steps = Decider.StepCount ;
+    return Decided ;
+    }
+
+  BouncerDecider Decider ;
+  } ;
+
+class HaltingSegmentStage : public PipelineStage
+  {
+public:
+  HaltingSegmentStage (uint32_t MachineStates, int WidthLimit, uint32_t MaxStackDepth, bool TraceOutput)
+  : Decider (MachineStates, WidthLimit, MaxStackDepth, TraceOutput)
+  , WidthLimit (WidthLimit)
+    {
+    MaxEntryLength = HaltingSegmentEntryLength ;
+    }
+
+  virtual bool RunDecider (uint64_t SeedDatabaseIndex, const uint8_t* MachineSpec,
+    uint8_t* VerificationEntry)
+    {
+    Decider.SeedDatabaseIndex = SeedDatabaseIndex ;
+    bool Decided = Decider.RunDecider (MachineSpec, VerificationEntry, 1, WidthLimit >> 1) ;
+    Steps = Decider.TotalNodes ;
+    return Decided ;
+    }
+
+  HaltingSegment Decider ;
+  int WidthLimit ;
+  } ;
+
+class FAR_Stage : public PipelineStage
+  {
+public:
+  FAR_Stage (uint32_t MachineStates, uint32_t DFA_States, uint32_t InitialDFA_States, bool TraceOutput)
+  : Decider (MachineStates, false, TraceOutput)
+  , DFA_States (DFA_States)
+  , InitialDFA_States (InitialDFA_States)
+    {
+    MaxEntryLength = VERIF_HEADER_LENGTH + 1 + 2 * DFA_States ;
+    }
+
+  // The DFA-only Verification Entry is the Direction followed by the DFA (see ../FAR/ReadMe.md)
+  virtual bool RunDecider (uint64_t SeedDatabaseIndex, const uint8_t* MachineSpec,
+    uint8_t* VerificationEntry)
+    {
+    Steps = 0 ;
+    for (uint32_t n = InitialDFA_States ; n <= DFA_States ; n++)
+      {
+      bool Decided = Decider.RunDecider (n, MachineSpec, VerificationEntry + VERIF_HEADER_LENGTH) ;
+      Steps += Decider.nExtensions ;
+      if (Decided)
+        {
+        Save32 (VerificationEntry, SeedDatabaseIndex) ;
+        Save32 (VerificationEntry + 4, uint32_t (DeciderTag::FAR_DFA_ONLY)) ;
+        Save32 (VerificationEntry + 8, 1 + 2 * n) ;
+        return true ;
+        }
+      }
+    return false ;
+    }
+
+  FiniteAutomataReduction Decider ;
+  uint32_t DFA_States ;
+  uint32_t InitialDFA_States ;
+  } ;
+
+PipelineStage* NewPipelineStage (const StageParams& Params, uint32_t MachineStates,
+  bool OrigSeedDatabase, uint64_t nTimeLimited, bool TraceOutput)
+  {
+  PipelineStage* Stage ;
+  if (Params.Name == "Cyclers")
+    {
+    Params.CheckLetters ("TS") ;
+    Stage = new CyclerStage (MachineStates, Params.Get ('T'), Params.Get ('S'),
+      OrigSeedDatabase ? nTimeLimited : UINT64_MAX) ;
+    }
+  else if (Params.Name == "BackwardReasoning")
+    {
+    Params.CheckLetters ("S") ;
+    Stage = new BackwardReasoningStage (MachineStates, Params.Get ('S')) ;
+    }
+  else if (Params.Name == "TranslatedCyclers")
+    {
+    Params.CheckLetters ("TS") ;
+    Stage = new TranslatedCyclerStage (MachineStates, Params.Get ('T'), Params.Get ('S', 100000),
+      OrigSeedDatabase ? nTimeLimited : 0, TraceOutput) ;
+    }
+  else if (Params.Name == "Bouncers")
+    {
+    Params.CheckLetters ("TS") ;
+    Stage = new BouncerStage (MachineStates, Params.Get ('T'), Params.Get ('S'), TraceOutput) ;
+    }
+  else if (Params.Name == "HaltingSegments")
+    {
+    Params.CheckLetters ("WS") ;
+    uint32_t WidthLimit = Params.Get ('W') ;
+    if (!(WidthLimit & 1)) printf ("Segment width limit must be odd\n"), exit (1) ;
+    Stage = new HaltingSegmentStage (MachineStates, WidthLimit, Params.Get ('S', 10000), TraceOutput) ;
+    }
+  else if (Params.Name == "FAR")
+    {
+    Params.CheckLetters ("AE") ;
+    uint32_t DFA_States = Params.Get ('A') ;
+    uint32_t InitialDFA_States = Params.Get ('E', DFA_States) ;
+    if (DFA_States == 0 || DFA_States > FiniteAutomataReduction::MaxDFA_States)
+      printf ("DFA states must be between 1 and %d\n", FiniteAutomataReduction::MaxDFA_States), exit (1) ;
+    if (InitialDFA_States == 0 || InitialDFA_States > DFA_States)
+      printf ("Initial DFA states must be between 1 and %d\n", DFA_States), exit (1) ;
+    Stage = new FAR_Stage (MachineStates, DFA_States, InitialDFA_States, TraceOutput) ;
+    }
+  else printf ("Unrecognised Decider \"%s\"\n", Params.Name.c_str()), exit (1) ;
+
+  Stage -> Description = Params.Name ;
+  for (int i = 0 ; i < 26 ; i++)
+    if (Params.Present[i]) Stage -> Description += " -" + std::string (1, 'A' + i) + std::to_string (Params.Value[i]) ;
+  return Stage ;
+  }
+
+//
+// StageParams
+//
+
+void StageParams::Parse (const char* Spec)
+  {
+  const char* Comma = strchr (Spec, ',') ;
+  Name = Comma ? std::string (Spec, Comma - Spec) : std::string (Spec) ;
+  if (Name.empty()) printf ("Decider name expected\n"), exit (1) ;
+  while (Comma)
+    {
+    Spec = Comma + 1 ;
+    Comma = strchr (Spec, ',') ;
+    if (!isalpha (Spec[0]) || !isdigit (Spec[1]))
+      printf ("Invalid parameter \"%s\" for %s\n", Spec, Name.c_str()), exit (1) ;
+    int i = toupper (Spec[0]) - 'A' ;
+    Value[i] = atoi (Spec + 1) ;
+    Present[i] = true ;
+    }
+  }
+
+uint32_t StageParams::Get (char Letter, uint32_t Default) const
+  {
+  return Present[Letter - 'A'] ? Value[Letter - 'A'] : Default ;
+  }
+
+uint32_t StageParams::Get (char Letter) const
+  {
+  if (!Present[Letter - 'A'])
+    printf ("Parameter -%c not specified for %s\n", Letter, Name.c_str()), exit (1) ;
+  return Value[Letter - 'A'] ;
+  }
+
+void StageParams::CheckLetters (const char* Letters) const
+  {
+  for (int i = 0 ; i < 26 ; i++)
+    if (Present[i] && !strchr (Letters, 'A' + i))
+      printf ("Invalid parameter -%c for %s\n", 'A' + i, Name.c_str()), exit (1) ;
+  }
@@ -0,0 +1,67 @@
+#pragma once
+
+// class PipelineStage
+//
+// A PipelineStage wraps one of the Deciders in the other sub-directories, so that
+// DecidePipeline can run a machine through a sequence of Deciders in memory. Each
+// thread has its own set of stages.
+//
+// A stage is specified on the command line by the name of its Decider, followed by
+// the Decider's own parameters, separated by commas:
+//
+//   Cyclers,T<time limit>,S<space limit>
+//   BackwardReasoning,S<depth limit>
+//   TranslatedCyclers,T<time limit>[,S<space limit>]
+//   Bouncers,T<time limit>,S<space limit>
+//   HaltingSegments,W<width limit>[,S<stack depth>]
+//   FAR,A<DFA states>[,E<initial DFA states>]
+//
+// The parameters have the same meanings (and defaults) as for the Decider's own
+// executable.
+
+#include <string>
+
+#include "../bbchallenge.h"
+
+struct StageParams
+  {
+  std::string Name ;
+  uint32_t Value[26] ; // Indexed by parameter letter
+  bool Present[26] = { } ;
+
+  // Parses "<name>[,<letter><value>...]"
+  void Parse (const char* Spec) ;
+
+  // Returns the value of parameter Letter, or Default if it wasn't given
+  uint32_t Get (char Letter, uint32_t Default) const ;
+
+  // Returns the value of parameter Letter, which must have been given
+  uint32_t Get (char Letter) const ;
+
+  // Checks that no parameters were given apart from those in Letters
+  void CheckLetters (const char* Letters) const ;
+  } ;
+
+class PipelineStage
+  {
+public:
+  virtual ~PipelineStage() { }
+
+  // Call RunDecider to analyse a single machine. If it returns true, the machine
+  // has been decided, and VerificationEntry holds its complete Verification Entry
+  // (of at most MaxEntryLength bytes):
+  virtual bool RunDecider (uint64_t SeedDatabaseIndex, const uint8_t* MachineSpec,
+    uint8_t* VerificationEntry) = 0 ;
+
+  std::string Description ; // Decider name and parameters, for the report
+  uint32_t MaxEntryLength ;
+  uint32_t Steps = 0 ; // Steps simulated (or nodes searched) by the last RunDecider, for -Y
+  } ;
+
+// NewPipelineStage creates the stage specified by Params (exiting with an error
+// message if Params are invalid). If OrigSeedDatabase is true, the Cyclers stage
+// only runs time-limited machines and the TranslatedCyclers stage only runs
+// space-limited machines, as their executables do:
+
+PipelineStage* NewPipelineStage (const StageParams& Params, uint32_t MachineStates,
+  bool OrigSeedDatabase, uint64_t nTimeLimited, bool TraceOutput) ;
@@ -0,0 +1 @@
+DecidePipeline -PCyclers,T1000,S200 -PBackwardReasoning,S75 -PTranslatedCyclers,T20000000,S100000 -PBouncers,T1000000,S20000 -PHaltingSegments,W21 -PFAR,A7 -UPipeline.umf -VPipeline.dvf -h4
@@ -1,4 +1,8 @@
+#include <inttypes.h> // for PRIu64
+#include <algorithm>
+
 #include "Params.h"
+#include "TuringMachine.h"
 
 TuringMachineReader::TuringMachineReader (const CommonParams* Params)
   {
@@ -21,7 +25,8 @@ void TuringMachineReader::SetParams (const CommonParams* Params)
 
   fpDatabase = Params -> fpDatabase ;
   fpInput = Params -> fpInput ;
-  if (fpDatabase == 0 && Params -> MachineSpec.empty())
+  EnumeratedDatabase = TNFEnumerator::IsEnumeration (Params -> DatabaseFilename) ;
+  if (fpDatabase == 0 && Params -> MachineSpec.empty() && !EnumeratedDatabase)
     {
     if (Params -> MachineStates != 5 || !Params -> BinaryMachineSpecs)
       printf ("Invalid parameters for SeedDatabase.bin\n"), exit (1) ;
@@ -34,8 +39,18 @@ void TuringMachineReader::SetParams (const CommonParams* Params)
   if (!Params -> BinaryMachineSpecs)
     SpecSizeInFile += Params -> MachineStates ; // Allow for underscores and trailing newline
 
+  PackedDatabase = false ;
   if (!Params -> MachineSpec.empty())
     MachinesInDatabase = 0 ;
+  else if (EnumeratedDatabase)
+    {
+    Enumerator.Initialise (Params -> DatabaseFilename, Params -> MachineStates) ;
+    MachinesInDatabase = TNFEnumerator::MachineIndexLimit (Params -> MachineStates) ;
+    OrigSeedDatabase = false ;
+    nTimeLimited = nSpaceLimited = 0 ;
+    }
+  else if (ReadPackedHeader())
+    ; // Packed database (see Reader.h)
   else if (OrigSeedDatabase)
     {
     nTimeLimited = Read32 (fpDatabase) ;
@@ -52,9 +67,10 @@ void TuringMachineReader::SetParams (const CommonParams* Params)
     {
     nTimeLimited = nSpaceLimited = 0 ; // Unknown
 
-    if (fseek (fpDatabase, 0, SEEK_END)) printf ("fseek failed\n"), exit (1) ;
-    uint32_t InputFileSize = ftell (fpDatabase) ;
-    if (fseek (fpDatabase, 0, SEEK_SET)) printf ("fseek failed\n"), exit (1) ;
+    // The file size can exceed 2^32, so we need to use ftello64:
+    if (fseeko64 (fpDatabase, 0, SEEK_END)) printf ("fseek failed\n"), exit (1) ;
+    uint64_t InputFileSize = ftello64 (fpDatabase) ;
+    if (fseeko64 (fpDatabase, 0, SEEK_SET)) printf ("fseek failed\n"), exit (1) ;
 
     if (InputFileSize % SpecSizeInFile == SpecSizeInFile - 1)
       InputFileSize++ ; // Allow for missing newline at end of file
@@ -63,14 +79,36 @@ void TuringMachineReader::SetParams (const CommonParams* Params)
     MachinesInDatabase = InputFileSize / SpecSizeInFile ;
     }
 
-  if (Params -> Verifying()) nMachines = Read32 (Params -> fpVerify) ;
+  FileVersion = MachinesInDatabase >= FILE_VERSION_MARK ? 2 : 1 ;
+  if (Params -> Verifying())
+    {
+    FileVersion = ReadFileVersion (Params -> fpVerify) ;
+    if (FileVersion == COMPRESSED_UMF_VERSION)
+      printf ("Verification file is a compressed umf\n"), exit (1) ;
+    CompactVerification = FileVersion == COMPACT_DVF_VERSION ;
+    nMachines = FileVersion == 1 ? Read32 (Params -> fpVerify) : Read64 (Params -> fpVerify) ;
 
-  MachinesRead = 0 ;
+    // The entries are read from the mapped file, starting where we are now
+    VerificationFile.Map (Params -> fpVerify) ;
+    Verification = ByteReader (VerificationFile.Data()) ;
+    Verification.Seek (ftello64 (Params -> fpVerify)) ;
+    if (Params -> TestMachinePresent)
+      {
+      SeekVerificationEntry (Params -> TestMachine) ;
+      SingleEntry = true ;
+      nMachines = 1 ;
+      }
+    }
+
+  MachinesRead = IndicesRead = 0 ;
+  RangeStart = 0 ;
+  RangeEnd = MachinesInDatabase ;
   }
 
 void TuringMachineReader::SetParams (const DeciderParams* Params)
   {
   SetParams (static_cast<const CommonParams*> (Params)) ;
+  fpVerifyIndex = Params -> fpVerifyIndex ;
 
   if (Params -> TestMachinePresent || !Params -> MachineSpec.empty())
     {
@@ -79,44 +117,129 @@ void TuringMachineReader::SetParams (const DeciderParams* Params)
     }
   else if (fpInput)
     {
-    if (fseek (fpInput, 0, SEEK_END)) printf ("fseek failed\n"), exit (1) ;
-    uint32_t InputFileSize = ftell (fpInput) ;
-    if (fseek (fpInput, 0, SEEK_SET)) printf ("fseek failed\n"), exit (1) ;
-    if (InputFileSize & 3) printf ("Invalid input file size\n"), exit (1) ;
-    nMachines = InputFileSize >> 2 ;
+    if (fseeko64 (fpInput, 0, SEEK_END)) printf ("fseek failed\n"), exit (1) ;
+    uint64_t InputFileSize = ftello64 (fpInput) ;
+    if (fseeko64 (fpInput, 0, SEEK_SET)) printf ("fseek failed\n"), exit (1) ;
+    uint32_t InputVersion = InputFileSize ? ReadFileVersion (fpInput) : 1 ;
+    if (InputVersion == COMPACT_DVF_VERSION) printf ("Input file is a compact dvf\n"), exit (1) ;
+    if (InputVersion == COMPRESSED_UMF_VERSION)
+      {
+      CompressedInput = true ;
+      InputReader.Open (fpInput, InputVersion) ;
+      nMachines = InputReader.nIndices ;
+      }
+    else
+      {
+      FileVersion = InputVersion ;
+      InputFileSize -= FileHeaderSize (FileVersion) ;
+      if (InputFileSize % IndexSize (FileVersion)) printf ("Invalid input file size\n"), exit (1) ;
+      nMachines = InputFileSize / IndexSize (FileVersion) ;
+      }
+    }
+  else if (EnumeratedDatabase)
+    {
+    // Count no further than we need to
+    uint64_t Limit = Params -> RangePresent ? Params -> RangeEnd : UINT64_MAX ;
+    if (Params -> MachineLimitPresent && Params -> MachineLimit < Limit - Params -> RangeStart)
+      Limit = Params -> RangeStart + Params -> MachineLimit ;
+    nMachines = Enumerator.Count (Limit) ;
     }
   else nMachines = MachinesInDatabase ;
 
+  RangeEnd = nMachines ;
+  if (Params -> RangePresent) SelectRange (Params -> RangeStart, Params -> RangeEnd) ;
+
+  CompressedOutput = CompressedInput || Params -> CompressUndecided ;
+  CompactVerification = CompressedOutput ;
+
   if (Params -> MachineLimitPresent && nMachines > Params -> MachineLimit)
     nMachines = Params -> MachineLimit ;
   }
 
-uint32_t TuringMachineReader::Next (uint8_t* MachineSpec)
+uint64_t TuringMachineReader::Next (uint8_t* MachineSpec)
   {
   if (MachinesRead >= nMachines) printf ("Invalid read of machine spec\n"), exit (1) ;
-  uint32_t MachineIndex = 0 ;
+  uint64_t MachineIndex = 0 ;
 
   if (!Params -> MachineSpec.empty())
+    {
     ConvertToBinary (MachineSpec, (const uint8_t*)Params -> MachineSpec.c_str()) ;
+    CheckMachineSpec (MachineSpec) ;
+    }
   else
     {
     if (Params -> TestMachinePresent) MachineIndex = Params -> TestMachine ;
-    else if (fpInput) MachineIndex = Read32 (fpInput) ;
-    else MachineIndex = MachinesRead ;
+    else MachineIndex = NextIndex() ;
 
-    Read (MachineIndex, MachineSpec) ;
+    Read (MachineIndex, MachineSpec) ; // Checks the spec if need be
     }
-  CheckMachineSpec (MachineSpec) ;
 
   MachinesRead++ ;
   return MachineIndex ;
   }
 
-void TuringMachineReader::Read (uint32_t MachineIndex, uint8_t* MachineSpec, uint32_t n)
+uint64_t TuringMachineReader::NextIndex()
+  {
+  if (fpInput) return ReadInputIndex() ;
+  if (!EnumeratedDatabase) return IndicesRead++ ;
+
+  uint64_t MachineIndex ;
+  if (!Enumerator.Next (MachineIndex)) printf ("\nEnumeration ended early\n"), exit (1) ;
+  IndicesRead++ ;
+  return MachineIndex ;
+  }
+
+void TuringMachineReader::SetSnapshotFile (FILE* fp)
+  {
+  if (fp && (SingleEntry || fpInput == nullptr))
+    printf ("A snapshot file needs an input file\n"), exit (1) ;
+  fpSnapshot = fp ;
+  }
+
+uint64_t TuringMachineReader::Next (uint8_t* MachineSpec, MachineSnapshot& Snapshot)
+  {
+  uint64_t MachineIndex = Next (MachineSpec) ;
+  if (fpSnapshot)
+    {
+    Snapshot.Read (fpSnapshot) ;
+    if (Snapshot.SeedDatabaseIndex != MachineIndex)
+      printf ("\nSnapshot file doesn't match input file at machine %" PRIu64 "\n", MachineIndex), exit (1) ;
+    }
+  else
+    {
+    Snapshot = MachineSnapshot() ;
+    Snapshot.SeedDatabaseIndex = MachineIndex ;
+    }
+  return MachineIndex ;
+  }
+
+void TuringMachineReader::Read (uint64_t MachineIndex, uint8_t* MachineSpec, uint32_t n)
   {
   if (MachineIndex + n > MachinesInDatabase)
-    printf ("Invalid machine index %d\n", MachineIndex + n - 1), exit (1) ;
+    printf ("Invalid machine index %" PRIu64 "\n", MachineIndex + n - 1), exit (1) ;
+  if (EnumeratedDatabase)
+    {
+    // The machine index is the spec
+    TuringMachineSpec TM (Params -> MachineStates) ;
+    for (uint32_t i = 0 ; i < n ; i++, MachineSpec += MachineSpecSize)
+      {
+      TM.KeyToSpec (MachineIndex + i, MachineSpec) ;
+      CheckMachineSpec (MachineSpec) ;
+      }
+    return ;
+    }
+
   uint8_t SpecFromFile[MAX_MACHINE_SPEC_SIZE] ;
+  if (PackedDatabase)
+    {
+    if (fseeko64 (fpDatabase, PACKED_DATABASE_HEADER_LENGTH + MachineIndex * SpecSizeInFile, SEEK_SET))
+      printf ("Seek error for machine %" PRIu64 "\n", MachineIndex), exit (1) ;
+    ::Read (fpDatabase, SpecFromFile, SpecSizeInFile) ;
+    UnpackMachineSpec (MachineSpec, SpecFromFile, Params -> MachineStates) ;
+    if (!(PackedFlags & PACKED_DATABASE_VALIDATED)) CheckMachineSpec (MachineSpec) ;
+    return ;
+    }
+
   off64_t FileOffset = MachineIndex ;
   FileOffset *= SpecSizeInFile ;
   if (Params -> BinaryMachineSpecs)
@@ -124,7 +247,7 @@ void TuringMachineReader::Read (uint32_t MachineIndex, uint8_t* MachineSpec, uin
 
   // File offset can exceed 2^31, so we need to use fseek064:
   if (fseeko64 (fpDatabase, FileOffset, SEEK_SET))
-    printf ("Seek error for machine %d\n", MachineIndex), exit (1) ;
+    printf ("Seek error for machine %" PRIu64 "\n", MachineIndex), exit (1) ;
 
   ::Read (fpDatabase, SpecFromFile, SpecSizeInFile) ;
 
@@ -134,9 +257,423 @@ void TuringMachineReader::Read (uint32_t MachineIndex, uint8_t* MachineSpec, uin
   CheckMachineSpec (MachineSpec) ;
   }
 
+uint64_t TuringMachineReader::ReadIndex (FILE* fp) const
+  {
+  return ReadIndex (fp, FileVersion) ;
+  }
+
+void TuringMachineReader::WriteIndex (FILE* fp, uint64_t MachineIndex) const
+  {
+  WriteIndex (fp, FileVersion, MachineIndex) ;
+  }
+
+uint64_t TuringMachineReader::ReadInputIndex()
+  {
+  return CompressedInput ? InputReader.Next() : ReadIndex (fpInput) ;
+  }
+
+bool TuringMachineReader::InputAtEnd()
+  {
+  if (InputRangeEnds) return true ;
+  return CompressedInput ? InputReader.AtEnd() : CheckEndOfFile (fpInput) ;
+  }
+
+void TuringMachineReader::RewindInput()
+  {
+  if (CompressedInput) InputReader.Rewind() ;
+  else if (fseeko64 (fpInput, FileHeaderSize (FileVersion), SEEK_SET))
+    printf ("fseek failed\n"), exit (1) ;
+  SkipInput() ;
+  }
+
+// void TuringMachineReader::SelectRange (uint64_t Start, uint64_t End)
+//
+// Restricts the machines read to entries Start to End - 1 of the input file, or of
+// the database or enumeration if there is no input file (-R)
+
+void TuringMachineReader::SelectRange (uint64_t Start, uint64_t End)
+  {
+  if (End > nMachines) End = nMachines ;
+  if (Start > End)
+    printf ("-R: range starts after the last machine (%" PRIu64 ")\n", nMachines), exit (1) ;
+  RangeStart = Start ;
+  RangeEnd = End ;
+
+  if (fpInput)
+    {
+    InputRangeEnds = End < nMachines ;
+    SkipInput() ;
+    }
+  else if (EnumeratedDatabase)
+    {
+    uint64_t MachineIndex ;
+    for (uint64_t i = 0 ; i < Start ; i++) Enumerator.Next (MachineIndex) ;
+    }
+  else IndicesRead = Start ;
+
+  nMachines = End - Start ;
+  }
+
+// void TuringMachineReader::SkipInput()
+//
+// Skips the input file entries before the range, from the start of the input file
+
+void TuringMachineReader::SkipInput()
+  {
+  if (RangeStart == 0) return ;
+  if (CompressedInput) for (uint64_t i = 0 ; i < RangeStart ; i++) InputReader.Next() ;
+  else if (fseeko64 (fpInput, FileHeaderSize (FileVersion) + RangeStart * IndexSize (FileVersion), SEEK_SET))
+    printf ("fseek failed\n"), exit (1) ;
+  }
+
+// void TuringMachineReader::SkipEntries (uint64_t n)
+//
+// Skips the first n entries of the range (and their snapshots, if there is a
+// snapshot file), when a Decider resumes from a checkpoint
+
+void TuringMachineReader::SkipEntries (uint64_t n)
+  {
+  if (fpInput)
+    {
+    if (CompressedInput) for (uint64_t i = 0 ; i < n ; i++) InputReader.Next() ;
+    else if (fseeko64 (fpInput, FileHeaderSize (FileVersion) + (RangeStart + n) * IndexSize (FileVersion), SEEK_SET))
+      printf ("fseek failed\n"), exit (1) ;
+    }
+  else
+    {
+    if (EnumeratedDatabase)
+      {
+      uint64_t MachineIndex ;
+      for (uint64_t i = 0 ; i < n ; i++) Enumerator.Next (MachineIndex) ;
+      }
+    IndicesRead += n ;
+    }
+
+  if (fpSnapshot)
+    {
+    MachineSnapshot Snapshot ;
+    for (uint64_t i = 0 ; i < n ; i++) Snapshot.Read (fpSnapshot) ;
+    }
+  MachinesRead += n ;
+  }
+
+uint64_t TuringMachineReader::TimeLimitedInRange() const
+  {
+  return std::min (std::max ((uint64_t)nTimeLimited, RangeStart), RangeEnd) - RangeStart ;
+  }
+
+// void TuringMachineReader::WriteUndecidedHeader (FILE* fp)
+// void TuringMachineReader::WriteUndecided (FILE* fp, uint64_t MachineIndex)
+// void TuringMachineReader::CloseUndecided (FILE* fp)
+//
+// Write a umf (compressed if CompressedOutput is set); fp can be null
+
+void TuringMachineReader::WriteUndecidedHeader (FILE* fp)
+  {
+  if (fp == nullptr) return ;
+  if (CompressedOutput) UndecidedWriters[fp].Open (fp) ;
+  else WriteFileVersion (fp, FileVersion) ;
+  }
+
+void TuringMachineReader::WriteUndecided (FILE* fp, uint64_t MachineIndex)
+  {
+  if (fp == nullptr) return ;
+  if (CompressedOutput) UndecidedWriters[fp].Add (MachineIndex) ;
+  else WriteIndex (fp, MachineIndex) ;
+  }
+
+void TuringMachineReader::CloseUndecided (FILE* fp)
+  {
+  if (fp == nullptr) return ;
+  if (CompressedOutput)
+    {
+    UndecidedWriters[fp].Flush() ;
+    UndecidedWriters.erase (fp) ;
+    }
+  fclose (fp) ;
+  }
+
+// void TuringMachineReader::SaveUndecided (FILE* fp, FILE* fpCheckpoint)
+// void TuringMachineReader::ResumeUndecided (FILE* fp, FILE* fpCheckpoint)
+//
+// Save and restore the state of a compressed umf writer in a checkpoint file; an
+// uncompressed umf needs nothing more than its length
+
+void TuringMachineReader::SaveUndecided (FILE* fp, FILE* fpCheckpoint)
+  {
+  if (CompressedOutput) UndecidedWriters[fp].SaveState (fpCheckpoint) ;
+  }
+
+void TuringMachineReader::ResumeUndecided (FILE* fp, FILE* fpCheckpoint)
+  {
+  if (CompressedOutput) UndecidedWriters[fp].RestoreState (fp, fpCheckpoint) ;
+  }
+
+// void TuringMachineReader::WriteVerificationHeader (FILE* fp, uint64_t nEntries) const
+//
+// Deciders write the header with nEntries = 0 before the first entry, and again
+// with the final count when they have finished (it is the same size either way)
+
+void TuringMachineReader::WriteVerificationHeader (FILE* fp, uint64_t nEntries) const
+  {
+  uint32_t Version = VerificationVersion() ;
+  WriteFileVersion (fp, Version) ;
+  if (Version == 1) Write32 (fp, nEntries) ;
+  else Write64 (fp, nEntries) ;
+  }
+
+// void TuringMachineReader::WriteVerificationEntry (FILE* fp, uint64_t MachineIndex,
+//   const uint8_t* VerificationEntry, uint32_t Length)
+//
+// Writes a dvf entry, and adds it to the dvf index. The index is opened when the
+// first entry is written, by which time a Decider that is resuming from a checkpoint
+// has cut it back (see Checkpoint.h)
+
+void TuringMachineReader::WriteVerificationEntry (FILE* fp, uint64_t MachineIndex,
+  const uint8_t* VerificationEntry, uint32_t Length)
+  {
+  if (fp == nullptr) return ;
+  if (fp == Params -> fpVerify && fpVerifyIndex)
+    {
+    if (!VerificationIndex.IsOpen()) VerificationIndex.Open (fpVerifyIndex) ;
+    VerificationIndex.Add (MachineIndex, ftello64 (fp)) ;
+    }
+  if (CompactVerification)
+    {
+    VerificationWriter.Write (fp, MachineIndex, DeciderTag (Load32 (VerificationEntry + 4)),
+      ustring_view (VerificationEntry + 12, Length - 12)) ;
+    }
+  else
+    {
+    WriteIndex (fp, MachineIndex) ;
+    Write (fp, VerificationEntry + 4, Length - 4) ;
+    }
+  }
+
+// void TuringMachineReader::CloseVerification (FILE* fp, uint64_t nEntries)
+//
+// Rewrites the dvf header with the final count, closes the dvf, and finishes off
+// its index
+
+void TuringMachineReader::CloseVerification (FILE* fp, uint64_t nEntries)
+  {
+  bool Indexed = fp == Params -> fpVerify && fpVerifyIndex ;
+  if (fseeko64 (fp, 0, SEEK_END)) printf ("\nfseek failed\n"), exit (1) ;
+  uint64_t DvfLength = ftello64 (fp) ;
+  if (fseeko64 (fp, 0, SEEK_SET)) printf ("\nfseek failed\n"), exit (1) ;
+  WriteVerificationHeader (fp, nEntries) ;
+  fclose (fp) ;
+
+  if (Indexed)
+    {
+    if (!VerificationIndex.IsOpen()) VerificationIndex.Open (fpVerifyIndex) ;
+    VerificationIndex.Close (DvfLength) ;
+    }
+  }
+
+// void TuringMachineReader::SaveVerification (FILE* fpCheckpoint) const
+// void TuringMachineReader::ResumeVerification (FILE* fpCheckpoint)
+//
+// Save and restore the machine index of the last entry of a compact dvf in a
+// checkpoint file, since the next entry is coded relative to it; any other dvf
+// needs nothing more than its length
+
+void TuringMachineReader::SaveVerification (FILE* fpCheckpoint) const
+  {
+  if (CompactVerification) Write64 (fpCheckpoint, VerificationWriter.LastIndex) ;
+  }
+
+void TuringMachineReader::ResumeVerification (FILE* fpCheckpoint)
+  {
+  if (CompactVerification) VerificationWriter.LastIndex = Read64 (fpCheckpoint) ;
+  }
+
+// void TuringMachineReader::SeekVerificationEntry (uint64_t MachineIndex)
+//
+// For a Verifier given -X: leaves the verification file at the entry of the test
+// machine, which is found with the dvf index if there is one that matches the dvf,
+// or else by reading the entries until we come to it
+
+void TuringMachineReader::SeekVerificationEntry (uint64_t MachineIndex)
+  {
+  DvfIndex Index ;
+  uint64_t Offset = Verification.Offset() ;
+  bool Found = false ;
+  if (Index.Open (Params -> VerificationFilename, VerificationFile.Data().size(), nMachines))
+    Found = Index.Find (MachineIndex, Offset) ;
+  else for (uint64_t i = 0 ; !Found && i < nMachines ; i++)
+    {
+    Offset = Verification.Offset() ;
+    if (CompactVerification)
+      {
+      // Don't expand the entries we skip
+      VerificationReader.ReadEntry (Verification) ;
+      Found = VerificationReader.MachineIndex == MachineIndex ;
+      }
+    else Found = ReadVerificationEntry().MachineIndex == MachineIndex ;
+    }
+  if (!Found)
+    printf ("Machine %" PRIu64 " is not in %s\n", MachineIndex, Params -> VerificationFilename.c_str()), exit (1) ;
+  Verification.Seek (Offset) ;
+
+  if (CompactVerification)
+    {
+    // Read the IndexDelta of the entry, to find the index of the entry before it
+    ByteReader Entry = Verification ;
+    VerificationReader.LastIndex = 0 ;
+    VerificationReader.ReadEntry (Entry) ;
+    VerificationReader.LastIndex = MachineIndex - VerificationReader.MachineIndex ;
+    }
+  }
+
+// TuringMachineReader::DvfEntry TuringMachineReader::ReadVerificationEntry()
+//
+// Reads the next entry of the verification file. The Info reader covers exactly
+// InfoLength bytes (of the expanded VerificationInfo, for a compact dvf), so a
+// Verifier can check that it has read all of them with Info.AtEnd().
+
+TuringMachineReader::DvfEntry TuringMachineReader::ReadVerificationEntry()
+  {
+  DvfEntry Entry ;
+  if (CompactVerification)
+    {
+    VerificationReader.ReadEntry (Verification) ;
+    Entry.MachineIndex = VerificationReader.MachineIndex ;
+    Entry.Tag = VerificationReader.Tag ;
+    Entry.Info = VerificationReader.Info() ;
+    return Entry ;
+    }
+  Entry.MachineIndex = FileVersion == 1 ? Verification.Read32() : Verification.Read64() ;
+  Entry.Tag = DeciderTag (Verification.Read32()) ;
+  uint32_t InfoLength = Verification.Read32() ;
+  Entry.Info = Verification.Block (InfoLength) ;
+  return Entry ;
+  }
+
+uint32_t TuringMachineReader::ReadFileVersion (FILE* fp)
+  {
+  uint32_t Mark = Read32 (fp) ;
+  if (Mark != FILE_VERSION_MARK)
+    {
+    if (fseeko64 (fp, -4, SEEK_CUR)) printf ("fseek failed\n"), exit (1) ;
+    return 1 ;
+    }
+  uint32_t Version = Read32 (fp) ;
+  if (Version != 2 && Version != COMPRESSED_UMF_VERSION && Version != COMPACT_DVF_VERSION) printf ("Unsupported file version %d\n", Version), exit (1) ;
+  return Version ;
+  }
+
+void TuringMachineReader::WriteFileVersion (FILE* fp, uint32_t Version)
+  {
+  if (Version == 1) return ; // No header
+  Write32 (fp, FILE_VERSION_MARK) ;
+  Write32 (fp, Version) ;
+  }
+
+uint64_t TuringMachineReader::ReadIndex (FILE* fp, uint32_t Version)
+  {
+  return Version == 1 ? Read32 (fp) : Read64 (fp) ;
+  }
+
+void TuringMachineReader::WriteIndex (FILE* fp, uint32_t Version, uint64_t MachineIndex)
+  {
+  if (Version == 1) Write32 (fp, MachineIndex) ;
+  else Write64 (fp, MachineIndex) ;
+  }
+
+// static void TuringMachineReader::CheckIndex32 (const DeciderParams& Params, const char* Param)
+//
+// Called before the output files are opened, so it opens the input file and the
+// database for itself. The indices of a version 1 input file fit in 32 bits, and
+// those of any other input file are read and checked. Without an input file, the
+// indices are positions in the database (or in the -R range), or packed machine
+// specs in an enumeration (see Enumerator.h).
+
+void TuringMachineReader::CheckIndex32 (const DeciderParams& Params, const char* Param)
+  {
+  uint64_t IndexLimit = 0 ; // Greater than any machine index that will be read
+  if (!Params.MachineSpec.empty()) return ;
+  else if (Params.TestMachinePresent) IndexLimit = Params.TestMachine + 1 ;
+  else if (!Params.InputFilename.empty())
+    {
+    FILE* fp = CommonParams::OpenFile (Params.InputFilename, "rb") ;
+    if (fseeko64 (fp, 0, SEEK_END)) printf ("fseek failed\n"), exit (1) ;
+    uint64_t FileSize = ftello64 (fp) ;
+    if (fseeko64 (fp, 0, SEEK_SET)) printf ("fseek failed\n"), exit (1) ;
+    uint32_t Version = FileSize ? ReadFileVersion (fp) : 1 ;
+    if (Version == 2 || Version == COMPRESSED_UMF_VERSION)
+      {
+      CompressedUmfReader Indices ;
+      Indices.Open (fp, Version) ;
+      while (!Indices.AtEnd())
+        IndexLimit = std::max (IndexLimit, Indices.Next() + 1) ;
+      }
+    fclose (fp) ;
+    }
+  else if (TNFEnumerator::IsEnumeration (Params.DatabaseFilename))
+    IndexLimit = TNFEnumerator::MachineIndexLimit (Params.MachineStates) ;
+  else if (Params.RangePresent && Params.RangeEnd < FILE_VERSION_MARK) return ;
+  else if (Params.DatabaseFilename.empty()) return ; // SeedDatabase.bin
+  else
+    {
+    FILE* fp = CommonParams::OpenFile (Params.DatabaseFilename, "rb") ;
+    uint8_t Header[PACKED_DATABASE_HEADER_LENGTH] ;
+    size_t n = fread (Header, 1, PACKED_DATABASE_HEADER_LENGTH, fp) ;
+    if (n == PACKED_DATABASE_HEADER_LENGTH && Load32 (Header) == PACKED_DATABASE_MAGIC)
+      IndexLimit = Load64 (Header + 16) ;
+    else
+      {
+      if (fseeko64 (fp, 0, SEEK_END)) printf ("fseek failed\n"), exit (1) ;
+      uint64_t SpecSize = (Params.BinaryMachineSpecs ? 6 : 7) * Params.MachineStates ;
+      IndexLimit = (ftello64 (fp) + SpecSize - 1) / SpecSize ;
+      }
+    fclose (fp) ;
+    }
+
+  if (IndexLimit >= FILE_VERSION_MARK)
+    printf ("%s can't be used with machine indices of 2^32 - 1 or more\n", Param), exit (1) ;
+  }
+
+// bool TuringMachineReader::ReadPackedHeader()
+//
+// Returns false, leaving the database file where it was, if it isn't a packed database
+
+bool TuringMachineReader::ReadPackedHeader()
+  {
+  uint8_t Header[PACKED_DATABASE_HEADER_LENGTH] ;
+  size_t n = fread (Header, 1, PACKED_DATABASE_HEADER_LENGTH, fpDatabase) ;
+  if (fseeko64 (fpDatabase, 0, SEEK_SET)) printf ("fseek failed\n"), exit (1) ;
+  if (n < 4 || Load32 (Header) != PACKED_DATABASE_MAGIC) return false ;
+
+  if (n != PACKED_DATABASE_HEADER_LENGTH) printf ("Invalid packed database\n"), exit (1) ;
+  if (Load32 (Header + 4) != PACKED_DATABASE_VERSION)
+    printf ("Unsupported packed database version %d\n", Load32 (Header + 4)), exit (1) ;
+  if (Load32 (Header + 8) != Params -> MachineStates)
+    printf ("Database has %d-state machines\n", Load32 (Header + 8)), exit (1) ;
+  PackedFlags = Load32 (Header + 12) ;
+  MachinesInDatabase = Load64 (Header + 16) ;
+  nTimeLimited = Load32 (Header + 24) ;
+  nSpaceLimited = Load32 (Header + 28) ;
+  OrigSeedDatabase = (PackedFlags & PACKED_DATABASE_TIME_LIMITED) != 0 ;
+  SpecSizeInFile = 2 * Params -> MachineStates ;
+
+  if (fseeko64 (fpDatabase, 0, SEEK_END)) printf ("fseek failed\n"), exit (1) ;
+  uint64_t FileSize = ftello64 (fpDatabase) ;
+  if (FileSize != PACKED_DATABASE_HEADER_LENGTH + MachinesInDatabase * SpecSizeInFile)
+    printf ("Invalid packed database file size\n"), exit (1) ;
+
+  PackedDatabase = true ;
+  return true ;
+  }
+
 void TuringMachineReader::ConvertToBinary (uint8_t* BinSpec, const uint8_t* TextSpec)
   {
-  for (uint32_t i = 0 ; i < Params -> MachineStates ; i++)
+  ConvertToBinary (BinSpec, TextSpec, Params -> MachineStates) ;
+  }
+
+void TuringMachineReader::ConvertToBinary (uint8_t* BinSpec, const uint8_t* TextSpec, uint32_t MachineStates)
+  {
+  for (uint32_t i = 0 ; i < MachineStates ; i++)
     {
     for (int j = 0 ; j < 2 ; j++)
       {
@@ -164,13 +701,34 @@ void TuringMachineReader::ConvertToBinary (uint8_t* BinSpec, const uint8_t* Text
 
 void TuringMachineReader::CheckMachineSpec (uint8_t* MachineSpec)
   {
-  for (uint32_t i = 0 ; i < 2 * Params -> MachineStates ; i++)
+  CheckMachineSpec (MachineSpec, Params -> MachineStates) ;
+  }
+
+void TuringMachineReader::CheckMachineSpec (const uint8_t* MachineSpec, uint32_t MachineStates)
+  {
+  for (uint32_t i = 0 ; i < 2 * MachineStates ; i++)
     {
     if (*MachineSpec++ > 1)
       printf ("Invalid Write field in machine spec\n"), exit (1) ;
     if (*MachineSpec++ > 1)
       printf ("Invalid Move field in machine spec\n"), exit (1) ;
-    if (*MachineSpec++ > Params -> MachineStates)
+    if (*MachineSpec++ > MachineStates)
       printf ("Invalid Move field in machine spec\n"), exit (1) ;
     }
   }
+
+void TuringMachineReader::PackMachineSpec (uint8_t* Packed, const uint8_t* MachineSpec, uint32_t MachineStates)
+  {
+  for (uint32_t i = 0 ; i < 2 * MachineStates ; i++, MachineSpec += 3)
+    *Packed++ = (MachineSpec[0] << 4) | (MachineSpec[1] << 3) | MachineSpec[2] ;
+  }
+
+void TuringMachineReader::UnpackMachineSpec (uint8_t* MachineSpec, const uint8_t* Packed, uint32_t MachineStates)
+  {
+  for (uint32_t i = 0 ; i < 2 * MachineStates ; i++, Packed++)
+    {
+    *MachineSpec++ = *Packed >> 4 ;
+    *MachineSpec++ = (*Packed >> 3) & 1 ;
+    *MachineSpec++ = *Packed & 7 ;
+    }
+  }
@@ -21,8 +21,95 @@
 //
 // If MachineStates = 5 and Binary is true, we expect a 30-byte header starting with
 // (nTimeLimited, nSpaceLimited, nMachines).
+//
+// Whatever the parameters, a file that starts with PACKED_DATABASE_MAGIC is a packed
+// database (written by Convert/ConvertDatabase), which can hold machines with any
+// number of states:
+//
+//   uint Magic          -- PACKED_DATABASE_MAGIC
+//   uint Version        -- 1
+//   uint MachineStates
+//   uint Flags          -- PACKED_DATABASE_VALIDATED: every spec has been checked
+//                       -- PACKED_DATABASE_TIME_LIMITED: machines 0 to nTimeLimited-1
+//                       --   are time-limited, and the rest space-limited (as in
+//                       --   SeedDatabase.bin)
+//   ulong nMachines
+//   uint nTimeLimited
+//   uint nSpaceLimited
+//   ubyte Spec[nMachines][2 * MachineStates]
+//
+// Each transition is packed into one byte, (Write << 4) | (Move << 3) | State, so
+// reading a machine is a matter of seeking to a computed offset and unpacking
+// 2 * MachineStates bytes; there is no text to parse, and the specs of a validated
+// database are not checked again.
+//
+// A database name of the form TNF[:<options>] (-DTNF...) selects a TNFEnumerator
+// (see Enumerator.h) instead of a database file: the machines are generated as they
+// are read, and each machine index is the machine's own spec packed into a 64-bit
+// key, so Read works for any valid key. The number of machines in the enumeration
+// is needed up front, so SetParams counts them, which means running the
+// enumeration twice. The machine indices are not in increasing order, so a Decider
+// can only write a compressed umf from an enumeration if it has an input file.
+//
+// Input files (umf) and verification files (dvf) come in two versions. Version 1
+// files have 32-bit machine indices and counts:
+//
+//   umf: uint SeedDatabaseIndex[]
+//   dvf: uint nEntries
+//        VerificationEntry[nEntries], each starting with
+//          uint SeedDatabaseIndex, uint DeciderTag, uint InfoLength
+//
+// Version 2 files have an 8-byte header, and 64-bit machine indices and counts:
+//
+//   uint FILE_VERSION_MARK (0xFFFFFFFF)
+//   uint Version (2)
+//   umf: ulong SeedDatabaseIndex[]
+//   dvf: ulong nEntries
+//        VerificationEntry[nEntries], each starting with
+//          ulong SeedDatabaseIndex, uint DeciderTag, uint InfoLength
+//
+// The Reader detects the version of the input file (or, in a Verifier, of the
+// verification file). A Decider writes its umf and dvf in the same version as its
+// input file; or, with no input file, in version 2 if the database has too many
+// machines for 32-bit indices. Convert/ConvertFiles converts files from one version
+// to the other.
+//
+// A umf can also be compressed (version 3; see CompressedUmf.h). A Decider reads a
+// compressed input file an index at a time, and writes a compressed umf if its input
+// file is compressed, or if it is given -G; its dvf is then a compact dvf (version 4;
+// see CompactDvf.h). The Deciders write all their umfs through WriteUndecided, which
+// compresses them if need be, and close them with CloseUndecided.
+//
+// A Decider given -R<start>:<end> reads only entries <start> to <end>-1 of its
+// input file or, with no input file, of the database (or enumeration); machine
+// indices are unchanged. The umfs and dvfs written by Deciders run on consecutive
+// ranges can be merged into the files that a single run would have written (see
+// Convert/MergeFiles).
+//
+// A long Decider run can save checkpoints, and resume from the last one if it is
+// interrupted (see Checkpoint.h). SkipEntries skips the input entries that were
+// completed before the checkpoint, and SaveUndecided and ResumeUndecided save and
+// restore the state of a compressed umf writer.
+//
+// Verification entries are built in memory with a 32-bit SeedDatabaseIndex, which
+// WriteVerificationEntry replaces with the full machine index (coding the entry if
+// the dvf is compact). With -XI, a Decider's dvf entries are also added to its dvf index
+// (see DvfIndex.h), which CloseVerification finishes off along with the dvf.
+//
+// In a Verifier, SetParams maps the verification file into memory (see MappedFile.h),
+// and ReadVerificationEntry returns the next entry, with a ByteReader for its
+// VerificationInfo, straight from the mapping (or, for a compact dvf, from the
+// expanded entry). Given -X, the Reader starts at the entry of the test machine,
+// with nMachines = 1.
 
 #include "bbchallenge.h"
+#include "Snapshot.h"
+#include "CompressedUmf.h"
+#include "Enumerator.h"
+#include "DvfIndex.h"
+#include "MappedFile.h"
+#include "CompactDvf.h"
+#include <map>
 
 #define MAX_MACHINE_SPEC_SIZE (MAX_MACHINE_STATES * (MAX_MACHINE_STATES + 1))
 
@@ -39,27 +126,119 @@ public:
   void SetParams (const CommonParams* Params) ;
   void SetParams (const DeciderParams* Params) ;
 
-  void Read (uint32_t MachineIndex, uint8_t* MachineSpec, uint32_t n = 1) ;
-  uint32_t Next (uint8_t* MachineSpec) ;
+  void Read (uint64_t MachineIndex, uint8_t* MachineSpec, uint32_t n = 1) ;
+  uint64_t Next (uint8_t* MachineSpec) ;
+
+  // The index of the next machine (from the input file, the enumeration, or the
+  // database in order), for Deciders that read their machines themselves
+  uint64_t NextIndex() ;
+
+  // With a snapshot file (which must match the input file entry for entry), Next
+  // also reads the snapshot of each machine; without one, it returns the initial
+  // configuration (see Snapshot.h)
+  void SetSnapshotFile (FILE* fp) ;
+  uint64_t Next (uint8_t* MachineSpec, MachineSnapshot& Snapshot) ;
+
+  // Reading and writing umf and dvf files in the right version (see above)
+  uint64_t ReadIndex (FILE* fp) const ;
+  void WriteIndex (FILE* fp, uint64_t MachineIndex) const ;
+  uint64_t ReadInputIndex() ;
+  bool InputAtEnd() ; // Also true at the end of a range (-R) that stops short of it
+  void RewindInput() ; // To the start of the range
+  void SkipEntries (uint64_t n) ; // From the start of the range
+  void WriteUndecidedHeader (FILE* fp) ;
+  void WriteUndecided (FILE* fp, uint64_t MachineIndex) ;
+  void CloseUndecided (FILE* fp) ;
+  void SaveUndecided (FILE* fp, FILE* fpCheckpoint) ;
+  void ResumeUndecided (FILE* fp, FILE* fpCheckpoint) ;
+  void WriteVerificationHeader (FILE* fp, uint64_t nEntries) const ;
+  void WriteVerificationEntry (FILE* fp, uint64_t MachineIndex,
+    const uint8_t* VerificationEntry, uint32_t Length) ;
+  void CloseVerification (FILE* fp, uint64_t nEntries) ;
+  void SaveVerification (FILE* fpCheckpoint) const ;
+  void ResumeVerification (FILE* fpCheckpoint) ;
+  uint32_t VerificationVersion() const
+    { return CompactVerification ? COMPACT_DVF_VERSION : FileVersion ; }
+
+  // Reading the verification file in a Verifier
+  struct DvfEntry
+    {
+    uint64_t MachineIndex ;
+    DeciderTag Tag ;
+    ByteReader Info ; // The VerificationInfo
+    } ;
+  DvfEntry ReadVerificationEntry() ;
+  bool VerificationAtEnd() const { return Verification.AtEnd() ; }
+
+  // Reads the version of a umf or dvf file (1, 2, 3 for a compressed umf, or 4 for a
+  // compact dvf), leaving fp after the version header
+  static uint32_t ReadFileVersion (FILE* fp) ;
+  static void WriteFileVersion (FILE* fp, uint32_t Version) ;
+  static uint64_t ReadIndex (FILE* fp, uint32_t Version) ;
+  static void WriteIndex (FILE* fp, uint32_t Version, uint64_t MachineIndex) ;
+  static uint32_t FileHeaderSize (uint32_t Version) { return Version == 1 ? 0 : 8 ; }
+  static uint32_t IndexSize (uint32_t Version) { return Version == 1 ? 4 : 8 ; }
+
+  // For the 5-state seed database without an input file: the number of
+  // time-limited machines in the range being read
+  uint64_t TimeLimitedInRange() const ;
+
+  // Cost hint and snapshot files have 32-bit machine indices, so Param can't be
+  // used if any machine index that will be read doesn't fit. Call it before
+  // Params.OpenFiles, so that a refusal leaves the output files alone.
+  static void CheckIndex32 (const DeciderParams& Params, const char* Param) ;
 
   const CommonParams* Params ;
 
   bool OrigSeedDatabase ; // Original SeedDatabase.bin file
-  uint32_t nMachines ;
+  uint64_t nMachines ;
+  uint64_t MachinesInDatabase ;
+  uint64_t RangeStart ;     // Entries of the input file, or of the database or
+  uint64_t RangeEnd ;       // enumeration, that are read (see SelectRange)
   uint32_t MachineSpecSize ;
   bool SingleEntry ;
+  uint32_t FileVersion = 1 ; // Of the input or verification file, and the output files
+  bool CompressedInput = false ;
+  bool CompressedOutput = false ; // umf only
+  bool CompactVerification = false ; // dvf in version 4
 
   // For binary 5-state SeedDatabaseIndex only:
   uint32_t nTimeLimited ;
   uint32_t nSpaceLimited ;
 
+  bool PackedDatabase ;
+  uint32_t PackedFlags ;
+  bool EnumeratedDatabase ;
+
+  // Converting machine specs from the compact ASCII form, and to and from the
+  // packed form
+  static void ConvertToBinary (uint8_t* BinSpec, const uint8_t* TextSpec, uint32_t MachineStates) ;
+  static void CheckMachineSpec (const uint8_t* MachineSpec, uint32_t MachineStates) ;
+  static void PackMachineSpec (uint8_t* Packed, const uint8_t* MachineSpec, uint32_t MachineStates) ;
+  static void UnpackMachineSpec (uint8_t* MachineSpec, const uint8_t* Packed, uint32_t MachineStates) ;
+
 protected:
   void ConvertToBinary (uint8_t* BinSpec, const uint8_t* TextSpec) ;
   void CheckMachineSpec (uint8_t* MachineSpec) ;
+  bool ReadPackedHeader() ;
+  void SelectRange (uint64_t Start, uint64_t End) ;
+  void SkipInput() ;
+  void SeekVerificationEntry (uint64_t MachineIndex) ;
 
   FILE* fpDatabase ;
   FILE* fpInput ;
-  uint32_t MachinesInDatabase ;
-  uint32_t MachinesRead ;
+  FILE* fpSnapshot = nullptr ;
+  TNFEnumerator Enumerator ;
+  CompressedUmfReader InputReader ;
+  std::map<FILE*, CompressedUmfWriter> UndecidedWriters ;
+  FILE* fpVerifyIndex = nullptr ;
+  DvfIndexWriter VerificationIndex ;
+  CompactDvfWriter VerificationWriter ;
+  MappedFile VerificationFile ;
+  ByteReader Verification ;
+  CompactDvfReader VerificationReader ;
+  uint64_t MachinesRead ;
+  uint64_t IndicesRead ;
   uint32_t SpecSizeInFile ;
+  bool InputRangeEnds = false ; // The range stops short of the end of the input file
   } ;
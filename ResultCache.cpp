@@ -0,0 +1,204 @@
+#include "ResultCache.h"
+#include "TuringMachine.h"
+
+ResultCache::ResultCache (const std::string& Filename, DeciderTag Decider,
+  uint32_t MachineStates, uint32_t nLimits)
+  : Filename (Filename)
+  , Decider (Decider)
+  , MachineStates (MachineStates)
+  , nLimits (nLimits)
+  {
+  if (nLimits > MAX_CACHE_LIMITS) printf ("Too many result cache limits\n"), exit (1) ;
+
+  FILE* fp = fopen (Filename.c_str(), "rb") ;
+  if (fp == nullptr) return ; // New cache
+
+  if (Read32 (fp) != (uint32_t)Decider)
+    printf ("Result cache \"%s\" belongs to a different Decider\n", Filename.c_str()), exit (1) ;
+  if (Read32 (fp) != MachineStates)
+    printf ("Result cache \"%s\" has different machine states\n", Filename.c_str()), exit (1) ;
+  if (Read32 (fp) != nLimits)
+    printf ("Result cache \"%s\" has different parameters\n", Filename.c_str()), exit (1) ;
+  uint32_t nResults = Read32 (fp) ;
+
+  for (uint32_t i = 0 ; i < nResults ; i++)
+    {
+    uint64_t k = Read32 (fp) ;
+    k = (k << 32) | Read32 (fp) ;
+    CacheEntry& E = EntryMap[k] ;
+    uint32_t Result = Read32 (fp) ;
+    CachedResult& C = Result == DECIDED ? E.Decided : E.Undecided ;
+    C.Present = true ;
+    C.Result = Result ;
+    for (uint32_t j = 0 ; j < nLimits ; j++)
+      {
+      C.RangeList[j].Min = Read32 (fp) ;
+      C.RangeList[j].Max = Read32 (fp) ;
+      }
+    if (Result == DECIDED)
+      {
+      C.EntryOffset = EntryData.size() ;
+      uint8_t Header[8] ;
+      Read (fp, Header, 8) ;
+      uint32_t InfoLength = Load32 (Header + 4) ;
+      EntryData.append (Header, 8) ;
+      EntryData.resize (EntryData.size() + InfoLength) ;
+      Read (fp, &EntryData[C.EntryOffset + 8], InfoLength) ;
+      }
+    }
+  if (!CheckEndOfFile (fp)) printf ("Result cache \"%s\" is invalid\n", Filename.c_str()), exit (1) ;
+  fclose (fp) ;
+  }
+
+// bool ResultCache::Lookup (const uint8_t* MachineSpec, uint32_t SeedDatabaseIndex,
+//   const uint32_t* Limits, uint8_t* VerificationEntry, uint32_t& Result)
+//
+// If the cache has a result for the machine that holds for Limits, sets Result and
+// returns true; if the result is DECIDED, the Verification Entry (starting with
+// SeedDatabaseIndex) is copied to VerificationEntry
+
+bool ResultCache::Lookup (const uint8_t* MachineSpec, uint32_t SeedDatabaseIndex,
+  const uint32_t* Limits, uint8_t* VerificationEntry, uint32_t& Result)
+  {
+  auto Iter = EntryMap.find (Key (MachineSpec)) ;
+  if (Iter != EntryMap.end())
+    {
+    const CacheEntry& E = Iter -> second ;
+    if (InRange (E.Decided, Limits))
+      {
+      const uint8_t* p = &EntryData[E.Decided.EntryOffset] ;
+      Save32 (VerificationEntry, SeedDatabaseIndex) ;
+      memcpy (VerificationEntry + 4, p, 8 + Load32 (p + 4)) ;
+      Result = DECIDED ;
+      nDecidedHits++ ;
+      return true ;
+      }
+    if (InRange (E.Undecided, Limits))
+      {
+      Result = E.Undecided.Result ;
+      nUndecidedHits++ ;
+      return true ;
+      }
+    }
+  nMisses++ ;
+  return false ;
+  }
+
+// void ResultCache::Add (const uint8_t* MachineSpec, const Range* RangeList, uint32_t Result,
+//   const uint8_t* VerificationEntry)
+//
+// Records the result of running the machine. For a decided machine, VerificationEntry
+// is the complete Verification Entry (including SeedDatabaseIndex, which isn't stored).
+
+void ResultCache::Add (const uint8_t* MachineSpec, const Range* RangeList, uint32_t Result,
+  const uint8_t* VerificationEntry)
+  {
+  CacheEntry& E = EntryMap[Key (MachineSpec)] ;
+  CachedResult& C = Result == DECIDED ? E.Decided : E.Undecided ;
+  if (C.Present)
+    {
+    uint32_t j ;
+    for (j = 0 ; j < nLimits ; j++)
+      if (RangeList[j].Min < C.RangeList[j].Min || RangeList[j].Max > C.RangeList[j].Max) break ;
+    if (j == nLimits) return ; // Nothing new
+    }
+
+  if (Result == DECIDED)
+    {
+    uint32_t Length = 8 + Load32 (VerificationEntry + 8) ;
+    if (C.Present && Load32 (&EntryData[C.EntryOffset + 4]) + 8 == Length)
+      memcpy (&EntryData[C.EntryOffset], VerificationEntry + 4, Length) ; // Reuse the space
+    else
+      {
+      C.EntryOffset = EntryData.size() ;
+      EntryData.append (VerificationEntry + 4, Length) ;
+      }
+    }
+  C.Present = true ;
+  C.Result = Result ;
+  memcpy (C.RangeList, RangeList, nLimits * sizeof (Range)) ;
+  }
+
+// void ResultCache::Save()
+//
+// Writes the cache to a temporary file, and then renames it, so that the old cache
+// survives if the Decider is interrupted
+
+void ResultCache::Save()
+  {
+  std::string TempFilename = Filename + ".tmp" ;
+  FILE* fp = fopen (TempFilename.c_str(), "wb") ;
+  if (fp == nullptr) printf ("Can't open file \"%s\"\n", TempFilename.c_str()), exit (1) ;
+
+  uint32_t nResults = 0 ;
+  for (const auto& [k, E] : EntryMap)
+    nResults += E.Decided.Present + E.Undecided.Present ;
+
+  Write32 (fp, (uint32_t)Decider) ;
+  Write32 (fp, MachineStates) ;
+  Write32 (fp, nLimits) ;
+  Write32 (fp, nResults) ;
+  for (const auto& [k, E] : EntryMap)
+    for (const CachedResult* C : { &E.Decided, &E.Undecided })
+      {
+      if (!C -> Present) continue ;
+      Write32 (fp, k >> 32) ;
+      Write32 (fp, (uint32_t)k) ;
+      Write32 (fp, C -> Result) ;
+      for (uint32_t j = 0 ; j < nLimits ; j++)
+        {
+        Write32 (fp, C -> RangeList[j].Min) ;
+        Write32 (fp, C -> RangeList[j].Max) ;
+        }
+      if (C -> Result == DECIDED)
+        {
+        const uint8_t* p = &EntryData[C -> EntryOffset] ;
+        Write (fp, p, 8 + Load32 (p + 4)) ;
+        }
+      }
+  fclose (fp) ;
+
+  remove (Filename.c_str()) ;
+  if (rename (TempFilename.c_str(), Filename.c_str()))
+    printf ("Can't rename \"%s\"\n", TempFilename.c_str()), exit (1) ;
+  }
+
+// bool ResultCache::UndecidedUpTo (const uint8_t* MachineSpec, const uint32_t* Limits,
+//   uint32_t Limit, uint32_t& Max) const
+//
+// If the machine has an undecided result whose ranges include Limits, except for
+// parameter number Limit, sets Max to the largest value of that parameter for which
+// the machine is known to be undecided, and returns true
+
+bool ResultCache::UndecidedUpTo (const uint8_t* MachineSpec, const uint32_t* Limits,
+  uint32_t Limit, uint32_t& Max) const
+  {
+  auto Iter = EntryMap.find (Key (MachineSpec)) ;
+  if (Iter == EntryMap.end()) return false ;
+  const CachedResult& C = Iter -> second.Undecided ;
+  if (!InRange (C, Limits, Limit)) return false ;
+  Max = C.RangeList[Limit].Max ;
+  return true ;
+  }
+
+void ResultCache::PrintStats() const
+  {
+  printf ("\nResult cache: %d decided and %d undecided machines found, %d machines run\n",
+    (int)nDecidedHits, (int)nUndecidedHits, (int)nMisses) ;
+  }
+
+uint64_t ResultCache::Key (const uint8_t* MachineSpec) const
+  {
+  TuringMachineSpec TM (MachineStates) ;
+  TM.Initialise (0, MachineSpec) ;
+  return TM.CanonicalKey (0) ;
+  }
+
+bool ResultCache::InRange (const CachedResult& C, const uint32_t* Limits, uint32_t Except) const
+  {
+  if (!C.Present) return false ;
+  for (uint32_t j = 0 ; j < nLimits ; j++)
+    if (j != Except && (Limits[j] < C.RangeList[j].Min || Limits[j] > C.RangeList[j].Max))
+      return false ;
+  return true ;
+  }
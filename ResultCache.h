@@ -0,0 +1,116 @@
+// ResultCache.h
+//
+// ResultCache class
+
+#pragma once
+
+// class ResultCache
+//
+// On-disk cache of Decider results, so that a Decider that is run again with
+// different parameters only runs the machines whose outcome could change.
+//
+// Constructor:
+//
+//   ResultCache (const std::string& Filename, DeciderTag Decider, uint32_t MachineStates,
+//     uint32_t nLimits)
+//
+// Loads the cache from Filename, if it exists. Decider identifies the Decider that
+// owns the cache, and nLimits the number of its parameters that can affect its
+// results (e.g. time and space limits).
+//
+// Machines are looked up by their exact machine spec (TuringMachineSpec::CanonicalKey
+// with Flags = 0), so a cache can be used with any seed database or input file.
+// Each machine can have a decided result (with its Verification Entry) and an
+// undecided result (with a Decider-specific code). Along with each result, the
+// Decider records the range of values of each of its parameters that are known to
+// give the same result: for instance, a machine that was decided within a given
+// time limit will be decided in the same way with any larger time limit, and one
+// that was undecided will still be undecided with any smaller one. Lookup only
+// returns a result if every parameter of the current run is in its range; Add
+// replaces any earlier result of the same kind, unless its ranges include the new
+// ones (so adding a result that came from the cache changes nothing).
+//
+// A Decider that can carry on from where an earlier run left off (for instance, by
+// trying only the segment widths that haven't been tried yet) can call
+// UndecidedUpTo to find how far the earlier run went.
+//
+// Lookup can be called by several threads at once, but not while Add is being
+// called. Save writes the cache back to Filename.
+//
+// Format of cache file:
+//
+//   uint DeciderTag
+//   uint MachineStates
+//   uint nLimits
+//   uint nResults
+//   Result[nResults]
+//
+//   Result format:
+//     uint KeyHigh, KeyLow -- Machine spec key
+//     uint Result          -- 0 = decided, otherwise the Decider's undecided code
+//     uint Range[nLimits][2] -- Min and Max of each parameter
+//     (if decided:)
+//     uint DeciderType
+//     uint InfoLength
+//     byte DeciderSpecificInfo[InfoLength]
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <unordered_map>
+
+#include "bbchallenge.h"
+
+#define MAX_CACHE_LIMITS 4
+
+class ResultCache
+  {
+public:
+  ResultCache (const std::string& Filename, DeciderTag Decider, uint32_t MachineStates,
+    uint32_t nLimits) ;
+
+  static const uint32_t DECIDED = 0 ;
+
+  struct Range
+    {
+    uint32_t Min ;
+    uint32_t Max ;
+    } ;
+
+  bool Lookup (const uint8_t* MachineSpec, uint32_t SeedDatabaseIndex, const uint32_t* Limits,
+    uint8_t* VerificationEntry, uint32_t& Result) ;
+  void Add (const uint8_t* MachineSpec, const Range* RangeList, uint32_t Result,
+    const uint8_t* VerificationEntry = nullptr) ;
+  bool UndecidedUpTo (const uint8_t* MachineSpec, const uint32_t* Limits, uint32_t Limit,
+    uint32_t& Max) const ;
+  void Save() ;
+  void PrintStats() const ;
+
+  std::atomic<uint32_t> nDecidedHits = 0 ;
+  std::atomic<uint32_t> nUndecidedHits = 0 ;
+  std::atomic<uint32_t> nMisses = 0 ;
+
+private:
+  struct CachedResult
+    {
+    bool Present = false ;
+    uint32_t Result ;
+    Range RangeList[MAX_CACHE_LIMITS] ;
+    uint32_t EntryOffset ; // Decided: DeciderType, InfoLength and Info in EntryData
+    } ;
+  struct CacheEntry
+    {
+    CachedResult Decided ;
+    CachedResult Undecided ;
+    } ;
+
+  uint64_t Key (const uint8_t* MachineSpec) const ;
+  bool InRange (const CachedResult& C, const uint32_t* Limits, uint32_t Except = UINT32_MAX) const ;
+
+  std::string Filename ;
+  DeciderTag Decider ;
+  uint32_t MachineStates ;
+  uint32_t nLimits ;
+  std::unordered_map<uint64_t, CacheEntry> EntryMap ;
+  ustring EntryData ;
+  } ;
@@ -0,0 +1,72 @@
+// Snapshot.h
+//
+// MachineSnapshot struct
+
+#pragma once
+
+// struct MachineSnapshot
+//
+// A snapshot of a machine that a Decider has run for many steps without deciding
+// it, so that a later Decider can resume from there instead of starting again from
+// a blank tape (see TuringMachine::TakeSnapshot and TuringMachine::Resume).
+//
+// A Decider that writes snapshots (with -Z<snapshot file>) writes one for every
+// machine that it writes to the umf, in the same order. A machine that was not run,
+// or that halted or ran out of tape, gets a snapshot of the initial configuration
+// (StepCount = 0). A Decider that reads them (with -J<snapshot file>) reads them
+// through TuringMachineReader::Next, alongside the umf as its input file.
+//
+// Format of Snapshot File:
+//
+//   uint SeedDatabaseIndex
+//   uint StepCount
+//   ubyte State
+//   int TapeHead
+//   int Leftmost            -- Leftmost tape head position so far
+//   int Rightmost           -- Rightmost tape head position so far
+//   ubyte Tape[(Rightmost - Leftmost + 8) / 8] -- Cells Leftmost to Rightmost,
+//                                                 eight to a byte, top bit first
+
+#include "bbchallenge.h"
+
+struct MachineSnapshot
+  {
+  uint32_t SeedDatabaseIndex = 0 ;
+  uint32_t StepCount = 0 ;
+  uint8_t State = 1 ;
+  int TapeHead = 0 ;
+  int Leftmost = 0 ;
+  int Rightmost = 0 ;
+  ustring Tape = ustring (1, 0) ; // Packed, as in the file
+
+  uint8_t Cell (int i) const
+    {
+    i -= Leftmost ;
+    return (Tape[i >> 3] >> (7 - (i & 7))) & 1 ;
+    }
+
+  void Read (FILE* fp)
+    {
+    SeedDatabaseIndex = Read32 (fp) ;
+    StepCount = Read32 (fp) ;
+    State = Read8u (fp) ;
+    TapeHead = Read32 (fp) ;
+    Leftmost = Read32 (fp) ;
+    Rightmost = Read32 (fp) ;
+    if (Rightmost < Leftmost || TapeHead < Leftmost || TapeHead > Rightmost)
+      printf ("Invalid snapshot for machine %d\n", SeedDatabaseIndex), exit (1) ;
+    Tape.resize ((Rightmost - Leftmost + 8) >> 3) ;
+    ::Read (fp, Tape.data(), Tape.size()) ;
+    }
+
+  void Write (FILE* fp) const
+    {
+    Write32 (fp, SeedDatabaseIndex) ;
+    Write32 (fp, StepCount) ;
+    Write8 (fp, State) ;
+    Write32 (fp, TapeHead) ;
+    Write32 (fp, Leftmost) ;
+    Write32 (fp, Rightmost) ;
+    ::Write (fp, Tape.data(), Tape.size()) ;
+    }
+  } ;
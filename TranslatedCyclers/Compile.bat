@@ -1,2 +1,2 @@
-g++ -std=c++20 -Wall -O3 -oDecideTranslatedCyclers DecideTranslatedCyclers.cpp TranslatedCycler.cpp ../Params.obj ../Reader.obj ../TuringMachine.obj
-g++ -std=c++20 -Wall -O3 -oVerifyTranslatedCyclers VerifyTranslatedCyclers.cpp ../Params.obj ../Reader.obj ../TuringMachine.obj
+g++ -std=c++20 -Wall -O3 -oDecideTranslatedCyclers DecideTranslatedCyclers.cpp TranslatedCycler.cpp ../Params.obj ../Reader.obj ../CompressedUmf.obj ../Enumerator.obj ../DvfIndex.obj ../MappedFile.obj ../CompactDvf.obj ../TuringMachine.obj ../CostHints.obj ../Checkpoint.obj
+g++ -std=c++20 -Wall -O3 -oVerifyTranslatedCyclers VerifyTranslatedCyclers.cpp ../Params.obj ../Reader.obj ../CompressedUmf.obj ../Enumerator.obj ../DvfIndex.obj ../MappedFile.obj ../CompactDvf.obj ../TuringMachine.obj
@@ -4,24 +4,47 @@
 //            -V<verification file> Output file: verification data for decided machines
 //            -I<input file>        Input file: list of machines to be analysed (default=all machines)
 //            -U<undecided file>    Output file: remaining undecided machines
+//            -G                    Write a compressed umf and a compact dvf
+//            -XI                   Write a dvf index along with the dvf (see ../DvfIndex.h)
 //            -X<test machine>      Machine to test
 //            -M<machine spec>      Compact machine code (ASCII spec) to test
 //            -L<machine limit>     Max no. of machines to test
+//            -R<start>:<end>       Machines <start> to <end>-1 of the input file or database
 //            -H<threads>           Number of threads to use
 //            -O                    Print trace output
 //            -T<time limit>        Max no. of steps
 //            -S<space limit>       Max absolute value of tape head
+//            -Q<cost hint file>    Give the most expensive machines of each batch out first (see ../CostHints.h)
+//            -Y<cost hint file>    Output file: steps and time for each machine that is run
+//            -Z<snapshot file>     Output file: snapshots of the undecided machines (see ../Snapshot.h)
+//
+// Each batch of machines is read into memory and shared out between the threads,
+// in contiguous chunks. With -Q, the machines are given out longest first, each to
+// the thread with the least work so far. Either way, the output files are written
+// in input order.
+//
+// With -Z, a snapshot of each undecided machine is written alongside the umf, so that
+// a later Decider (e.g. DecideBouncers -J<snapshot file>) can resume it where this one
+// left off, instead of running it again from a blank tape.
+//
+// A checkpoint is saved every few minutes, after a batch has been written, so that
+// if the run is interrupted, running it again with the same parameters resumes from
+// the last checkpoint (see ../Checkpoint.h).
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <inttypes.h> // for PRIu64
 #include <ctype.h>
 #include <string>
 #include <vector>
+#include <numeric>
+#include <chrono>
 
 #include "TranslatedCycler.h"
 #include "../Params.h"
+#include "../Checkpoint.h"
 
 #if NEED_BOOST_THREADS
   #include <boost/thread.hpp>
@@ -40,47 +63,80 @@ public:
   virtual void PrintHelpAndExit [[noreturn]] (int status) ;
   uint32_t TimeLimit ;  bool TimeLimitPresent = false ;
   uint32_t SpaceLimit ; bool SpaceLimitPresent = false ;
+  std::string CostHintFilename ;
+  std::string CostOutputFilename ;
+  std::string SnapshotFilename ;
+  FILE* fpCostOutput = 0 ;
+  FILE* fpSnapshot = 0 ;
+
+  virtual void OpenFiles() override
+    {
+    DeciderParams::OpenFiles() ;
+    fpCostOutput = OpenOutputFile (CostOutputFilename) ;
+    fpSnapshot = OpenOutputFile (SnapshotFilename) ;
+    }
   } ;
   
 static CommandLineParams Params ;
+static TuringMachineReader Reader ;
+
+static void WriteUndecided (uint64_t MachineIndex, const MachineSnapshot* Snapshot = nullptr) ;
 
 int main (int argc, char** argv)
   {
   Params.Parse (argc, argv) ;
   Params.CheckParameters() ;
+  if (!Params.CostOutputFilename.empty()) TuringMachineReader::CheckIndex32 (Params, "-Y") ;
+  if (!Params.SnapshotFilename.empty()) TuringMachineReader::CheckIndex32 (Params, "-Z") ;
+  Checkpoint Check (Params, Reader, argc, argv) ;
   Params.OpenFiles() ;
 
-  TuringMachineReader Reader (&Params) ;
+  Reader.SetParams (&Params) ;
 
   // If we are using the 5-state seed database, then we know which machines
   // are time-limited and which are space-limited, so we can restrict the
   // search to space-limited machines:
-  uint32_t nTimeLimited = 0 ;
-  uint32_t nSpaceLimited = Reader.nMachines ;
+  uint64_t nTimeLimited = 0 ;
+  uint64_t nSpaceLimited = Reader.nMachines ;
   if (Reader.OrigSeedDatabase)
     {
     if (Params.fpInput == 0)
       {
-      nTimeLimited = Reader.nTimeLimited ;
-      nSpaceLimited = Reader.nSpaceLimited ;
+      nTimeLimited = Reader.TimeLimitedInRange() ;
+      nSpaceLimited = Reader.RangeEnd - Reader.RangeStart - nTimeLimited ;
       }
     else
       {
       // Count the space-limited machines in the input file (this is just
       // so we can give informative percentages in the progress report)
       nSpaceLimited = 0 ;
-      for (uint32_t i = 0 ; i < Reader.nMachines ; i++)
+      for (uint64_t i = 0 ; i < Reader.nMachines ; i++)
         {
-        if (Read32 (Params.fpInput) < Reader.nTimeLimited) nTimeLimited++ ;
+        if (Reader.ReadInputIndex() < Reader.nTimeLimited) nTimeLimited++ ;
         else nSpaceLimited++ ;
         }
-      if (fseek (Params.fpInput, 0, SEEK_SET))
-        printf ("fseek failed\n"), exit (1) ;
+      Reader.RewindInput() ;
       }
     }
 
-  // Write dummy dvf header
-  Write32 (Params.fpVerify, 0) ;
+  uint64_t nDecided = 0 ;
+  uint64_t nTimeLimitedComplete = 0 ;
+  uint64_t nSpaceLimitedComplete = 0 ;
+
+  Check.AddOutputFile (Params.fpUndecided, true) ;
+  Check.AddOutputFile (Params.fpVerify) ;
+  Check.AddOutputFile (Params.fpVerifyIndex) ;
+  Check.AddOutputFile (Params.fpCostOutput) ;
+  Check.AddOutputFile (Params.fpSnapshot) ;
+  Check.AddCounter (nDecided) ;
+  Check.AddCounter (nTimeLimitedComplete) ;
+  Check.AddCounter (nSpaceLimitedComplete) ;
+  if (!Check.Resume())
+    {
+    // Write umf header and dummy dvf header
+    Reader.WriteUndecidedHeader (Params.fpUndecided) ;
+    Reader.WriteVerificationHeader (Params.fpVerify, 0) ;
+    }
 
   if (!Params.nThreadsPresent)
     {
@@ -102,10 +158,21 @@ int main (int argc, char** argv)
   clock_t Timer = clock() ;
 
   TranslatedCycler** DeciderArray = new TranslatedCycler*[Params.nThreads] ;
-  uint32_t** MachineIndexList = new uint32_t*[Params.nThreads] ;
+  uint64_t** MachineIndexList = new uint64_t*[Params.nThreads] ;
   uint8_t** MachineSpecList = new uint8_t*[Params.nThreads] ;
   uint8_t** VerificationEntryList = new uint8_t*[Params.nThreads] ;
   uint32_t* ChunkSize = new uint32_t[Params.nThreads] ;
+  const uint32_t** ThreadOrder = new const uint32_t*[Params.nThreads] ;
+
+  // With cost hints, a thread may be given more than its share of the (cheaper) machines
+  CostHints* Hints = nullptr ;
+  uint32_t MaxPerThread = CHUNK_SIZE ;
+  if (!Params.CostHintFilename.empty())
+    {
+    Hints = new CostHints (Params.CostHintFilename) ;
+    printf ("%d cost hints\n", Hints -> nHints) ;
+    MaxPerThread = 2 * CHUNK_SIZE ;
+    }
 
   // Allocate the per-thread workspace
   for (uint32_t i = 0 ; i < Params.nThreads ; i++)
@@ -114,22 +181,29 @@ int main (int argc, char** argv)
       Params.SpaceLimit, Params.TraceOutput) ;
     DeciderArray[i] -> Clone = new TranslatedCycler (Params.MachineStates, Params.TimeLimit,
       Params.SpaceLimit, Params.TraceOutput) ;
-    MachineIndexList[i] = new uint32_t[CHUNK_SIZE] ;
-    MachineSpecList[i] = new uint8_t[Reader.MachineSpecSize * CHUNK_SIZE] ;
-    VerificationEntryList[i] = new uint8_t[VERIF_ENTRY_LENGTH * CHUNK_SIZE] ;
+    if (Params.fpCostOutput) DeciderArray[i] -> CostList = new MachineCost[MaxPerThread] ;
+    if (Params.fpSnapshot) DeciderArray[i] -> SnapshotList = new MachineSnapshot[MaxPerThread] ;
+    MachineIndexList[i] = new uint64_t[MaxPerThread] ;
+    MachineSpecList[i] = new uint8_t[Reader.MachineSpecSize * MaxPerThread] ;
+    VerificationEntryList[i] = new uint8_t[VERIF_ENTRY_LENGTH * MaxPerThread] ;
     }
 
-  uint32_t nDecided = 0 ;
-  uint32_t nTimeLimitedComplete = 0 ;
-  uint32_t nSpaceLimitedComplete = 0 ;
+  // The current batch, in input order
+  uint32_t BatchSize = Params.nThreads * CHUNK_SIZE ;
+  uint64_t* BatchIndexList = new uint64_t[BatchSize] ;
+  uint8_t* BatchSpecList = new uint8_t[Reader.MachineSpecSize * BatchSize] ;
+  uint32_t* Order = new uint32_t[BatchSize] ; // Batch entries for thread 0, then thread 1...
+  const uint8_t** EntryList = new const uint8_t*[BatchSize] ; // Verification entry of each machine
+  MachineCost* BatchCostList = new MachineCost[BatchSize] ;
+  const MachineSnapshot** BatchSnapshotList = new const MachineSnapshot*[BatchSize] ;
+
   int LastPercent = -1 ;
 
   if (Params.MachineLimitPresent && nSpaceLimited > Params.MachineLimit)
     nSpaceLimited = Params.MachineLimit ;
-  uint32_t MachineCounter = 0 ;
   while (nSpaceLimitedComplete < nSpaceLimited)
     {
-    uint32_t nRemaining = nSpaceLimited - nSpaceLimitedComplete ;
+    uint64_t nRemaining = nSpaceLimited - nSpaceLimitedComplete ;
     if (nRemaining >= Params.nThreads * CHUNK_SIZE)
       {
       for (uint32_t i = 0 ; i < Params.nThreads ; i++) ChunkSize[i] = CHUNK_SIZE ;
@@ -143,31 +217,46 @@ int main (int argc, char** argv)
         }
       }
 
-    std::vector<thread*> ThreadList (Params.nThreads) ;
-    for (uint32_t i = 0 ; i < Params.nThreads ; i++)
+    uint32_t nBatch = 0 ;
+    for (uint32_t i = 0 ; i < Params.nThreads ; i++) nBatch += ChunkSize[i] ;
+    for (uint32_t Entry = 0 ; Entry < nBatch ; Entry++)
       {
-      for (uint32_t j = 0 ; j < ChunkSize[i] ; j++)
+      if (Reader.SingleEntry)
         {
-        if (Reader.SingleEntry)
-          {
-          if (Params.MachineSpec.empty()) MachineIndexList[i][0] = Params.TestMachine ;
-          else MachineIndexList[i][0] = 0 ;
-          Reader.Next (MachineSpecList[i]) ;
-          }
-        else
+        if (Params.MachineSpec.empty()) BatchIndexList[0] = Params.TestMachine ;
+        else BatchIndexList[0] = 0 ;
+        Reader.Next (BatchSpecList) ;
+        }
+      else
+        {
+        uint64_t MachineIndex = Reader.NextIndex() ;
+        if (Reader.OrigSeedDatabase) while (MachineIndex < Reader.nTimeLimited)
           {
-          uint32_t MachineIndex = Params.fpInput ? Read32 (Params.fpInput) : MachineCounter++ ;
-          if (Reader.OrigSeedDatabase) while (MachineIndex < Reader.nTimeLimited)
-            {
-            Write32 (Params.fpUndecided, MachineIndex) ;
-            nTimeLimitedComplete++ ;
-            MachineIndex = Params.fpInput ? Read32 (Params.fpInput) : MachineCounter++ ;
-            }
-          MachineIndexList[i][j] = MachineIndex ;
-          Reader.Read (MachineIndex, MachineSpecList[i] + j * Reader.MachineSpecSize) ;
+          WriteUndecided (MachineIndex) ;
+          nTimeLimitedComplete++ ;
+          MachineIndex = Reader.NextIndex() ;
           }
+        BatchIndexList[Entry] = MachineIndex ;
+        Reader.Read (MachineIndex, BatchSpecList + Entry * Reader.MachineSpecSize) ;
+        }
+      }
+    nSpaceLimitedComplete += nBatch ;
+
+    // Share the batch out between the threads
+    if (Hints) Hints -> Schedule (BatchIndexList, nBatch, Params.nThreads, MaxPerThread, Order, ChunkSize) ;
+    else std::iota (Order, Order + nBatch, 0) ;
+
+    std::vector<thread*> ThreadList (Params.nThreads) ;
+    const uint32_t* Entry = Order ;
+    for (uint32_t i = 0 ; i < Params.nThreads ; i++)
+      {
+      ThreadOrder[i] = Entry ;
+      for (uint32_t j = 0 ; j < ChunkSize[i] ; j++, Entry++)
+        {
+        MachineIndexList[i][j] = BatchIndexList[*Entry] ;
+        memcpy (MachineSpecList[i] + j * Reader.MachineSpecSize,
+          BatchSpecList + *Entry * Reader.MachineSpecSize, Reader.MachineSpecSize) ;
         }
-      nSpaceLimitedComplete += ChunkSize[i] ;
 
       // Run inline if single thread (for ease of debugging)
       if (Params.nThreads == 1) DeciderArray[i] -> ThreadFunction (ChunkSize[i],
@@ -183,28 +272,34 @@ int main (int argc, char** argv)
         ThreadList[i] -> join() ; // Wait for thread i to finish
         delete ThreadList[i] ;
         }
-
-      const uint8_t* MachineSpec = MachineSpecList[i] ;
-      const uint8_t* VerificationEntry = VerificationEntryList[i] ;
       for (uint32_t j = 0 ; j < ChunkSize[i] ; j++)
         {
-        if (Load32 (VerificationEntry + 4))
-          {
-          if (Params.fpVerify && fwrite (VerificationEntry, VERIF_ENTRY_LENGTH, 1, Params.fpVerify) != 1)
-            printf ("Error writing file\n"), exit (1) ;
-          nDecided++ ;
-          }
-        else Write32 (Params.fpUndecided, MachineIndexList[i][j]) ;
-        MachineSpec += Reader.MachineSpecSize ;
-        VerificationEntry += VERIF_ENTRY_LENGTH ;
+        EntryList[ThreadOrder[i][j]] = VerificationEntryList[i] + j * VERIF_ENTRY_LENGTH ;
+        if (Params.fpCostOutput) BatchCostList[ThreadOrder[i][j]] = DeciderArray[i] -> CostList[j] ;
+        if (Params.fpSnapshot) BatchSnapshotList[ThreadOrder[i][j]] = &DeciderArray[i] -> SnapshotList[j] ;
+        }
+      }
+
+    // Write the output files in input order
+    for (uint32_t Entry = 0 ; Entry < nBatch ; Entry++)
+      {
+      const uint8_t* VerificationEntry = EntryList[Entry] ;
+      if (Load32 (VerificationEntry + 4))
+        {
+        Reader.WriteVerificationEntry (Params.fpVerify, BatchIndexList[Entry],
+          VerificationEntry, VERIF_ENTRY_LENGTH) ;
+        nDecided++ ;
         }
+      else WriteUndecided (BatchIndexList[Entry], Params.fpSnapshot ? BatchSnapshotList[Entry] : nullptr) ;
+      if (Params.fpCostOutput) CostHints::Write (Params.fpCostOutput, BatchIndexList[Entry], BatchCostList[Entry]) ;
       }
+    Check.Save (nTimeLimitedComplete + nSpaceLimitedComplete) ;
 
     int Percent = (nSpaceLimitedComplete * 100LL) / nSpaceLimited ;
     if (Percent != LastPercent)
       {
       LastPercent = Percent ;
-      printf ("\r%d%% %d %d", Percent, nSpaceLimitedComplete, nDecided) ;
+      printf ("\r%d%% %" PRIu64 " %" PRIu64, Percent, nSpaceLimitedComplete, nDecided) ;
       fflush (stdout) ;
       }
     }
@@ -214,35 +309,31 @@ int main (int argc, char** argv)
     {
     while (nTimeLimitedComplete < nTimeLimited)
       {
-      uint32_t MachineIndex = Params.fpInput ? Read32 (Params.fpInput) : MachineCounter++ ;
-      Write32 (Params.fpUndecided, MachineIndex) ;
+      uint64_t MachineIndex = Reader.NextIndex() ;
+      WriteUndecided (MachineIndex) ;
       }
-    fclose (Params.fpUndecided) ;
+    Reader.CloseUndecided (Params.fpUndecided) ;
     }
+  if (Params.fpSnapshot) fclose (Params.fpSnapshot) ;
 
   printf ("\n") ;
 
   // Check that we've reached the end of the input file
-  if (!Params.MachineLimitPresent && Params.fpInput &&
-    fread (&nTimeLimitedComplete, 1, 1, Params.fpInput) != 0) // Use nTimeLimitedComplete as buff
-      printf ("\nInput file too long!\n"), exit (1) ;
+  if (!Params.MachineLimitPresent && Params.fpInput && !Reader.InputAtEnd())
+    printf ("\nInput file too long!\n"), exit (1) ;
 
-  if (Params.fpVerify)
-    {
-    // Write the verification file header
-    if (fseek (Params.fpVerify, 0 , SEEK_SET))
-      printf ("\nfseek failed\n"), exit (1) ;
-    Write32 (Params.fpVerify, nDecided) ;
-    fclose (Params.fpVerify) ;
-    }
+  // Write the verification file header, and finish off the dvf index
+  if (Params.fpVerify) Reader.CloseVerification (Params.fpVerify, nDecided) ;
 
   Timer = clock() - Timer ;
 
   if (Params.fpInput) fclose (Params.fpInput) ;
+  if (Params.fpCostOutput) fclose (Params.fpCostOutput) ;
+  Check.Remove() ;
 
   if (Reader.OrigSeedDatabase)
-    printf ("\nDecided %d out of %d space-limited machines\n", nDecided, nSpaceLimitedComplete) ;
-  else printf ("\nDecided %d out of %d\n", nDecided, nSpaceLimitedComplete) ;
+    printf ("\nDecided %" PRIu64 " out of %" PRIu64 " space-limited machines\n", nDecided, nSpaceLimitedComplete) ;
+  else printf ("\nDecided %" PRIu64 " out of %" PRIu64 "\n", nDecided, nSpaceLimitedComplete) ;
   printf ("Elapsed time %.3f\n", (double)Timer / CLOCKS_PER_SEC) ;
 
   int MinStat = INT_MAX ;
@@ -272,14 +363,38 @@ int main (int argc, char** argv)
   else if (MaxStat != INT_MIN) printf ("\n%d: MaxStat = %d\n", MaxStatMachine, MaxStat) ;
   }
 
-void TranslatedCycler::ThreadFunction (int nMachines, const uint32_t* MachineIndexList,
+// static void WriteUndecided (uint64_t MachineIndex, const MachineSnapshot* Snapshot)
+//
+// Writes an undecided machine to the umf, and its snapshot (or, if there is none,
+// the initial configuration) to the snapshot file
+
+static void WriteUndecided (uint64_t MachineIndex, const MachineSnapshot* Snapshot)
+  {
+  Reader.WriteUndecided (Params.fpUndecided, MachineIndex) ;
+  if (Params.fpSnapshot)
+    {
+    MachineSnapshot Initial ;
+    Initial.SeedDatabaseIndex = MachineIndex ;
+    (Snapshot ? Snapshot : &Initial) -> Write (Params.fpSnapshot) ;
+    }
+  }
+
+void TranslatedCycler::ThreadFunction (int nMachines, const uint64_t* MachineIndexList,
   const uint8_t* MachineSpecList, uint8_t* VerificationEntryList)
   {
-  while (nMachines--)
+  for (int i = 0 ; i < nMachines ; i++)
     {
+    auto StartTime = std::chrono::steady_clock::now() ;
     SeedDatabaseIndex = *MachineIndexList++ ;
     Save32 (VerificationEntryList + 4, uint32_t (DeciderTag::NONE)) ;
-    Run (MachineSpecList, VerificationEntryList) ;
+    bool Decided = Run (MachineSpecList, VerificationEntryList) ;
+    if (SnapshotList && !Decided) TakeSnapshot (SnapshotList[i]) ;
+    if (CostList)
+      {
+      CostList[i].Steps = StepCount ;
+      CostList[i].Microseconds = std::chrono::duration_cast<std::chrono::microseconds>
+        (std::chrono::steady_clock::now() - StartTime).count() ;
+      }
 
     MachineSpecList += MachineSpecSize ;
     VerificationEntryList += VERIF_ENTRY_LENGTH ;
@@ -306,6 +421,21 @@ void CommandLineParams::Parse (int argc, char** argv)
         SpaceLimitPresent = true ;
         break ;
 
+      case 'Q':
+        if (argv[0][2] == 0) printf ("%s: filename expected\n", argv[0]), PrintHelpAndExit (1) ;
+        CostHintFilename = std::string (&argv[0][2]) ;
+        break ;
+
+      case 'Y':
+        if (argv[0][2] == 0) printf ("%s: filename expected\n", argv[0]), PrintHelpAndExit (1) ;
+        CostOutputFilename = std::string (&argv[0][2]) ;
+        break ;
+
+      case 'Z':
+        if (argv[0][2] == 0) printf ("%s: filename expected\n", argv[0]), PrintHelpAndExit (1) ;
+        SnapshotFilename = std::string (&argv[0][2]) ;
+        break ;
+
       default:
         printf ("Invalid parameter \"%s\"\n", argv[0]) ;
         PrintHelpAndExit (1) ;
@@ -314,6 +444,8 @@ void CommandLineParams::Parse (int argc, char** argv)
 
   if (!TimeLimitPresent) printf ("Time limit not specified\n"), PrintHelpAndExit (1) ;
   if (!SpaceLimitPresent) SpaceLimit = 100000 ;
+  if (!SnapshotFilename.empty() && UndecidedFilename.empty())
+    printf ("-Z needs an undecided file (-U)\n"), exit (1) ;
   }
 
 void CommandLineParams::PrintHelpAndExit (int status)
@@ -323,6 +455,9 @@ void CommandLineParams::PrintHelpAndExit (int status)
   printf (R"*RAW*(
            -T<time limit>        Max no. of steps
            -S<space limit>       Max absolute value of tape head
+           -Q<cost hint file>    Give the most expensive machines of each batch out first
+           -Y<cost hint file>    Output file: steps and time for each machine that is run
+           -Z<snapshot file>     Output file: snapshots of the undecided machines
 )*RAW*") ;
   exit (status) ;
   }
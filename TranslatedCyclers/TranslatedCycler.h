@@ -3,6 +3,7 @@
 #include <limits.h>
 #include <vector>
 #include "../TuringMachine.h"
+#include "../CostHints.h"
 
 // Decider-specific Verification Data:
 #define VERIF_INFO_LENGTH 32
@@ -27,7 +28,7 @@ public:
     MaxStat = INT_MIN ;
     }
 
-  void ThreadFunction (int nMachines, const uint32_t* MachineIndexList,
+  void ThreadFunction (int nMachines, const uint64_t* MachineIndexList,
     const uint8_t* MachineSpecList, uint8_t* VerificationEntryList) ;
 
   bool Run (const uint8_t* MachineSpec, uint8_t* VerificationEntry) ;
@@ -48,6 +49,9 @@ public:
 
   TuringMachine* Clone ;
 
+  MachineCost* CostList = nullptr ; // -Y: ThreadFunction records the cost of each machine here
+  MachineSnapshot* SnapshotList = nullptr ; // -Z: and the snapshot of each undecided machine here
+
   bool DetectRepetition (Record* LatestRecord[], uint8_t State, uint8_t* VerificationEntry) ;
 
   // Whatever we may want to know from time to time:
@@ -1,6 +1,7 @@
 // VerifyTranslatedCyclers <param> <param>...
 //   <param>: -D<database>           Seed database file (defaults to ../SeedDatabase.bin)
 //            -V<verification file>  Input file: verification data to be checked
+//            -X<test machine>       Machine to verify (see ../DvfIndex.h)
 //            -S<space limit>        Max absolute value of tape head
 //
 // Format of verification info:
@@ -19,6 +20,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <time.h>
+#include <inttypes.h> // for PRIu64
 #include <string>
 
 #include "../TuringMachine.h"
@@ -46,7 +48,7 @@ public:
     MinLeftmost = MaxRightmost = 0 ;
     }
   void Verify (uint32_t SeedDatabaseIndex,
-    const uint8_t* MachineSpec, FILE* fp, bool TranslateLeft) ;
+    const uint8_t* MachineSpec, ByteReader Info, bool TranslateLeft) ;
   uint8_t* MatchContents ;
 
   // Stats
@@ -72,7 +74,7 @@ int main (int argc, char** argv)
 
   clock_t Timer = clock() ;
 
-  for (uint32_t Entry = 0 ; Entry < Reader.nMachines ; Entry++)
+  for (uint64_t Entry = 0 ; Entry < Reader.nMachines ; Entry++)
     {
     int Percent = ((Entry + 1) * 100LL) / Reader.nMachines ;
     if (Percent != LastPercent)
@@ -82,25 +84,25 @@ int main (int argc, char** argv)
       LastPercent = Percent ;
       }
 
-    uint32_t MachineIndex = Read32 (Params.fpVerify) ;
+    TuringMachineReader::DvfEntry VerifEntry = Reader.ReadVerificationEntry() ;
     bool TranslateLeft ;
-    switch (DeciderTag (Read32 (Params.fpVerify)))
+    switch (VerifEntry.Tag)
       {
       case DeciderTag::TRANSLATED_CYCLER_LEFT: TranslateLeft = true ; break ;
       case DeciderTag::TRANSLATED_CYCLER_RIGHT: TranslateLeft = false ; break ;
       default: printf ("\nUnrecognised DeciderTag\n") ; exit (1) ;
       }
 
-    Reader.Read (MachineIndex, MachineSpec) ;
-    Verifier.Verify (MachineIndex, MachineSpec, Params.fpVerify, TranslateLeft) ;
+    Reader.Read (VerifEntry.MachineIndex, MachineSpec) ;
+    Verifier.Verify (VerifEntry.MachineIndex, MachineSpec, VerifEntry.Info, TranslateLeft) ;
     }
 
   Timer = clock() - Timer ;
 
-  if (fread (MachineSpec, 1, 1, Params.fpVerify) != 0)
+  if (!Reader.SingleEntry && !Reader.VerificationAtEnd())
     printf ("File too long!\n"), exit (1) ;
   fclose (Params.fpVerify) ;
-  printf ("\n%d TranslatedCyclers verified\n", Reader.nMachines) ;
+  printf ("\n%" PRIu64 " TranslatedCyclers verified\n", Reader.nMachines) ;
   printf ("Max %d steps\n", Verifier.MaxSteps) ;
   printf ("Max match length %d\n", Verifier.MaxMatchLength) ;
   printf ("Max period %d\n", Verifier.MaxPeriod) ;
@@ -110,21 +112,21 @@ int main (int argc, char** argv)
   }
 
 void TranslatedCyclerVerifier::Verify (uint32_t SeedDatabaseIndex,
-  const uint8_t* MachineSpec, FILE* fp, bool TranslateLeft)
+  const uint8_t* MachineSpec, ByteReader Info, bool TranslateLeft)
   {
   Initialise (SeedDatabaseIndex, MachineSpec) ;
 
   // Read the verification data from the input file
-  if (Read32 (fp) != VERIF_INFO_LENGTH)
+  if (Info.Remaining() != VERIF_INFO_LENGTH)
     printf ("%d: Invalid TranslatedCyclers verification data\n", SeedDatabaseIndex), exit (1) ;
-  int32_t ExpectedLeftmost = Read32 (fp) ;
-  int32_t ExpectedRightmost = Read32 (fp) ;
-  uint32_t FinalState = Read32 (fp) ;
-  int32_t InitialTapeHead = Read32 (fp) ;
-  int32_t FinalTapeHead = Read32 (fp) ;
-  uint32_t InitialStepCount = Read32 (fp) ;
-  uint32_t FinalStepCount = Read32 (fp) ;
-  int32_t MatchLength = Read32 (fp) ;
+  int32_t ExpectedLeftmost = Info.Read32() ;
+  int32_t ExpectedRightmost = Info.Read32() ;
+  uint32_t FinalState = Info.Read32() ;
+  int32_t InitialTapeHead = Info.Read32() ;
+  int32_t FinalTapeHead = Info.Read32() ;
+  uint32_t InitialStepCount = Info.Read32() ;
+  uint32_t FinalStepCount = Info.Read32() ;
+  int32_t MatchLength = Info.Read32() ;
 
   // Perform some sanity checks on the data
   if (ExpectedLeftmost > 0)
@@ -32,6 +32,103 @@ void TuringMachineSpec::UnpackSpec (Transition* S, const uint8_t* MachineSpec)
     TM_ERROR() ;
   }
 
+// uint64_t TuringMachineSpec::CanonicalKey (uint32_t Flags, bool* Mirrored,
+//   uint8_t* StateMap) const
+//
+// Returns a key that is the same for all the machines that only differ in the
+// ways given by Flags:
+//
+//   CANONICAL_RENAME: states B, C,... are renumbered in the order in which they are
+//     first reached from A, taking the transitions in the order A0, A1, B0, B1...
+//     (states that can't be reached keep their order, after the others)
+//   CANONICAL_UNUSED: all the transitions of states that can't be reached from A
+//     become HALT transitions, and the Write and Move of HALT transitions are ignored
+//   CANONICAL_MIRROR: the machine and its mirror image (with every Move reversed)
+//     are both packed, and the smaller key is returned. If Mirrored is given, it is
+//     set to true if the key is the mirror image's
+//
+// If StateMap is given, StateMap[s] is set to the number of state s in the key, for
+// s = 0 (HALT) to MachineStates.
+//
+// The key packs each transition (after renumbering) into 5 bits, Write + 2 * Move
+// + 4 * Next, starting with A0 in the most significant bits; with Flags = 0, it is
+// just the machine itself, and KeyToSpec converts it back.
+
+uint64_t TuringMachineSpec::CanonicalKey (uint32_t Flags, bool* Mirrored, uint8_t* StateMap) const
+  {
+  uint64_t Key = PackKey (Flags, false, StateMap) ;
+  if (Mirrored) *Mirrored = false ;
+  if (Flags & CANONICAL_MIRROR)
+    {
+    uint64_t MirrorKey = PackKey (Flags, true) ;
+    if (MirrorKey < Key)
+      {
+      Key = MirrorKey ;
+      if (Mirrored) *Mirrored = true ;
+      }
+    }
+  return Key ;
+  }
+
+uint64_t TuringMachineSpec::PackKey (uint32_t Flags, bool Mirror, uint8_t* StateMap) const
+  {
+  // Find the states that can be reached from A, in the order they are reached
+  uint8_t OldState[MAX_MACHINE_STATES + 1] ; // OldState[n] becomes state n
+  bool Reached[MAX_MACHINE_STATES + 1] = { } ;
+  OldState[1] = 1 ;
+  Reached[1] = true ;
+  uint32_t nReached = 1 ;
+  for (uint32_t n = 1 ; n <= nReached ; n++)
+    for (uint32_t r = 0 ; r <= 1 ; r++)
+      {
+      uint8_t t = TM[OldState[n]][r].Next ;
+      if (t && !Reached[t])
+        {
+        Reached[t] = true ;
+        OldState[++nReached] = t ;
+        }
+      }
+
+  uint8_t NewState[MAX_MACHINE_STATES + 1] ;
+  NewState[0] = 0 ; // HALT
+  if (Flags & CANONICAL_RENAME)
+    {
+    uint32_t n = nReached ;
+    for (uint32_t s = 1 ; s <= MachineStates ; s++)
+      if (!Reached[s]) OldState[++n] = s ;
+    }
+  else for (uint32_t s = 1 ; s <= MachineStates ; s++) OldState[s] = s ;
+  for (uint32_t n = 1 ; n <= MachineStates ; n++) NewState[OldState[n]] = n ;
+  if (StateMap) memcpy (StateMap, NewState, MachineStates + 1) ;
+
+  uint64_t Key = 0 ;
+  for (uint32_t n = 1 ; n <= MachineStates ; n++)
+    for (uint32_t r = 0 ; r <= 1 ; r++)
+      {
+      const Transition& T = TM[OldState[n]][r] ;
+      Key <<= 5 ;
+      if ((Flags & CANONICAL_UNUSED) && (T.Next == 0 || !Reached[OldState[n]])) continue ;
+      Key |= T.Write | (T.Move ^ Mirror) << 1 | NewState[T.Next] << 2 ;
+      }
+  return Key ;
+  }
+
+// void TuringMachineSpec::KeyToSpec (uint64_t Key, uint8_t* MachineSpec) const
+//
+// Converts a key from CanonicalKey back to a machine spec (in the format of the
+// seed database)
+
+void TuringMachineSpec::KeyToSpec (uint64_t Key, uint8_t* MachineSpec) const
+  {
+  for (uint32_t i = 2 * MachineStates ; i-- > 0 ; )
+    {
+    MachineSpec[3 * i] = Key & 1 ;            // Write
+    MachineSpec[3 * i + 1] = (Key >> 1) & 1 ; // Move
+    MachineSpec[3 * i + 2] = (Key >> 2) & 7 ; // Next
+    Key >>= 5 ;
+    }
+  }
+
 TuringMachine::TuringMachine (uint32_t  MachineStates, uint32_t SpaceLimit)
 : TuringMachineSpec (MachineStates), SpaceLimit (SpaceLimit)
   {
@@ -103,3 +200,38 @@ StepResult TuringMachine::Step()
   StepCount++ ;
   return State ? StepResult::OK : StepResult::HALT ;
   }
+
+void TuringMachine::TakeSnapshot (MachineSnapshot& Snapshot) const
+  {
+  Snapshot = MachineSnapshot() ;
+  Snapshot.SeedDatabaseIndex = SeedDatabaseIndex ;
+  if (State == 0 || Leftmost <= -(int)SpaceLimit || Rightmost >= (int)SpaceLimit)
+    return ;
+
+  Snapshot.StepCount = StepCount ;
+  Snapshot.State = State ;
+  Snapshot.TapeHead = TapeHead ;
+  Snapshot.Leftmost = Leftmost ;
+  Snapshot.Rightmost = Rightmost ;
+  Snapshot.Tape.assign ((Rightmost - Leftmost + 8) >> 3, 0) ;
+  for (int i = Leftmost ; i <= Rightmost ; i++)
+    if (Tape[i]) Snapshot.Tape[(i - Leftmost) >> 3] |= 0x80 >> ((i - Leftmost) & 7) ;
+  }
+
+bool TuringMachine::Resume (const MachineSnapshot& Snapshot)
+  {
+  if (Snapshot.SeedDatabaseIndex != SeedDatabaseIndex)
+    printf ("Snapshot is for machine %d, not %d\n", Snapshot.SeedDatabaseIndex, SeedDatabaseIndex), exit (1) ;
+  if (Snapshot.Leftmost <= -(int)SpaceLimit || Snapshot.Rightmost >= (int)SpaceLimit)
+    return false ;
+
+  for (int i = Snapshot.Leftmost ; i <= Snapshot.Rightmost ; i++)
+    Tape[i] = Snapshot.Cell (i) ;
+  TapeHead = Snapshot.TapeHead ;
+  State = Snapshot.State ;
+  Leftmost = Snapshot.Leftmost ;
+  Rightmost = Snapshot.Rightmost ;
+  StepCount = Snapshot.StepCount ;
+  RecordBroken = 0 ;
+  return true ;
+  }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "bbchallenge.h"
+#include "Snapshot.h"
 
 class TuringMachineReader ;
 
@@ -20,11 +21,26 @@ public:
   void Initialise (int Index, const uint8_t* MachineSpec) ;
   void UnpackSpec (Transition* S, const uint8_t* MachineSpec) ;
 
+  // Canonical forms (see CanonicalKey)
+  enum CanonicalFlags
+    {
+    CANONICAL_RENAME = 1, // Number the states in the order they are reached from A
+    CANONICAL_UNUSED = 2, // Ignore states that can't be reached, and the Write and Move of HALT transitions
+    CANONICAL_MIRROR = 4, // Identify each machine with its mirror image
+    CANONICAL_ALL    = 7
+    } ;
+  uint64_t CanonicalKey (uint32_t Flags = CANONICAL_ALL, bool* Mirrored = nullptr,
+    uint8_t* StateMap = nullptr) const ;
+  void KeyToSpec (uint64_t Key, uint8_t* MachineSpec) const ;
+
   uint32_t MachineStates ;
   uint32_t SeedDatabaseIndex ;
   uint32_t MachineSpecSize ;
 
   Transition TM[MAX_MACHINE_STATES + 1][2] ;
+
+private:
+  uint64_t PackKey (uint32_t Flags, bool Mirror, uint8_t* StateMap = nullptr) const ;
   } ;
 
 class TuringMachine : public TuringMachineSpec
@@ -57,6 +73,13 @@ public:
   TuringMachine& operator= (const TuringMachine& Src) ;
   StepResult Step() ;
 
+  // TakeSnapshot records the current configuration (or the initial configuration,
+  // if the machine has halted or run out of tape). Resume restores a snapshot of
+  // this machine after Initialise; if it doesn't fit in SpaceLimit, it returns
+  // false, leaving the machine in its initial configuration:
+  void TakeSnapshot (MachineSnapshot& Snapshot) const ;
+  bool Resume (const MachineSnapshot& Snapshot) ;
+
 protected:
 
   uint8_t* TapeWorkspace ;
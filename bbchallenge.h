@@ -31,6 +31,17 @@ typedef std::basic_string_view<uint8_t> ustring_view ;
 
 #define VERIF_HEADER_LENGTH 12 // Verification data header length
 
+// Version 2 umf and dvf files (with 64-bit machine indices and counts) start with
+// FILE_VERSION_MARK, which can't begin a version 1 file (see Reader.h)
+#define FILE_VERSION_MARK 0xFFFFFFFF
+
+// Packed machine databases (see Reader.h)
+#define PACKED_DATABASE_MAGIC 0x544D4442 // "TMDB"
+#define PACKED_DATABASE_VERSION 1
+#define PACKED_DATABASE_HEADER_LENGTH 32
+#define PACKED_DATABASE_VALIDATED 1
+#define PACKED_DATABASE_TIME_LIMITED 2
+
 #define TM_ERROR() \
   printf ("\n#%d: Error at line %d in %s\n", \
   SeedDatabaseIndex, __LINE__, __FUNCTION__), exit (1)
@@ -75,6 +86,13 @@ inline uint32_t Load32 (const void* p)
     : *(uint32_t*)p ;
   }
 
+inline uint64_t Load64 (const void* p)
+  {
+  return (std::endian::native == std::endian::little)
+    ? __builtin_bswap64 (*(uint64_t*)p)
+    : *(uint64_t*)p ;
+  }
+
 inline uint16_t Load16 (const void* p)
   {
   return (std::endian::native == std::endian::little)
@@ -89,6 +107,13 @@ inline uint32_t Save32 (void* p, uint32_t n)
   return 4 ;
   }
 
+inline uint32_t Save64 (void* p, uint64_t n)
+  {
+  if constexpr (std::endian::native == std::endian::little) n = __builtin_bswap64 (n) ;
+  *(uint64_t*)p = n ;
+  return 8 ;
+  }
+
 inline uint32_t Save16 (void* p, uint16_t n)
   {
   if constexpr (std::endian::native == std::endian::little) n = __builtin_bswap16 (n) ;
@@ -98,6 +123,7 @@ inline uint32_t Save16 (void* p, uint16_t n)
 
 // inline uint32_t Read (FILE* fp, void* p, size_t len)
 //
+// inline uint64_t Read64 (FILE* fp)
 // inline uint32_t Read32 (FILE* fp)
 // inline uint32_t Read16u (FILE* fp)
 // inline int32_t Read16s (FILE* fp)
@@ -112,6 +138,13 @@ inline void Read (FILE* fp, void* p, size_t len)
   if (len && fread (p, len, 1, fp) != 1) printf ("\nRead error\n"), exit (1) ;
   }
 
+inline uint64_t Read64 (FILE* fp)
+  {
+  uint64_t t ; Read (fp, &t, 8) ;
+  if constexpr (std::endian::native == std::endian::little) t = __builtin_bswap64 (t) ;
+  return t ;
+  }
+
 inline uint32_t Read32 (FILE* fp)
   {
   uint32_t t ; Read (fp, &t, 4) ;
@@ -154,6 +187,7 @@ inline bool CheckEndOfFile (FILE* fp)
 
 // inline void Write (FILE* fp, const void* p, size_t len)
 //
+// inline void Write64 (FILE* fp, uint64_t n)
 // inline void Write32 (FILE* fp, uint32_t n)
 // inline void Write16 (FILE* fp, uint32_t n)
 // inline void Write8 (FILE* fp, uint32_t n)
@@ -166,6 +200,12 @@ inline void Write (FILE* fp, const void* p, size_t len)
     printf ("Write error\n"), exit (1) ;
   }
 
+inline void Write64 (FILE* fp, uint64_t n)
+  {
+  if (std::endian::native == std::endian::little) n = __builtin_bswap64 (n) ;
+  Write (fp, &n, 8) ;
+  }
+
 inline void Write32 (FILE* fp, uint32_t n)
   {
   if (std::endian::native == std::endian::little) n = __builtin_bswap32 (n) ;
@@ -182,3 +222,76 @@ inline void Write8 (FILE* fp, uint8_t n)
   {
   Write (fp, &n, 1) ;
   }
+
+// class ByteReader
+//
+// Reads big-endian integers and byte arrays from a block of memory, such as a
+// mapped verification file (see MappedFile.h), as Read32 etc. read them from a
+// file. Nothing is copied: Bytes returns a view of the block, and Block returns a
+// ByteReader for part of it (e.g. the VerificationInfo of one dvf entry). Reading
+// past the end of the block is a read error.
+//
+// Offset is the offset from the start of the original block (i.e. the file
+// offset), even for a reader returned by Block, so that error messages can say
+// where in the file the error is.
+
+class ByteReader
+  {
+public:
+  ByteReader() { }
+  ByteReader (ustring_view Data)
+  : Start (Data.data()), p (Data.data()), End (Data.data() + Data.size()) { }
+
+  uint64_t Read64() { return Load64 (Advance (8)) ; }
+  uint32_t Read32() { return Load32 (Advance (4)) ; }
+  uint32_t Read16u() { return Load16 (Advance (2)) ; }
+  int32_t Read16s() { return (int16_t)Load16 (Advance (2)) ; }
+  uint32_t Read8u() { return *Advance (1) ; }
+  int32_t Read8s() { return (int8_t)*Advance (1) ; }
+
+  // A varint, as in a compact dvf (see CompactDvf.h)
+  uint64_t ReadVarint()
+    {
+    uint64_t n = 0 ;
+    for (uint32_t Shift = 0 ; Shift < 64 ; Shift += 7)
+      {
+      uint32_t Byte = *Advance (1) ;
+      n |= uint64_t (Byte & 0x7F) << Shift ;
+      if ((Byte & 0x80) == 0) return n ;
+      }
+    printf ("\nInvalid varint\n"), exit (1) ;
+    }
+
+  ustring_view Bytes (size_t Length)
+    {
+    return ustring_view (Advance (Length), Length) ;
+    }
+  ByteReader Block (size_t Length)
+    {
+    ByteReader B (*this) ;
+    B.End = Advance (Length) + Length ;
+    return B ;
+    }
+  void Seek (uint64_t Offset)
+    {
+    if (Offset > uint64_t (End - Start)) printf ("\nRead error\n"), exit (1) ;
+    p = Start + Offset ;
+    }
+
+  size_t Remaining() const { return End - p ; }
+  bool AtEnd() const { return p == End ; }
+  uint64_t Offset() const { return p - Start ; }
+
+private:
+  const uint8_t* Advance (size_t Length)
+    {
+    if (Length > size_t (End - p)) printf ("\nRead error\n"), exit (1) ;
+    const uint8_t* q = p ;
+    p += Length ;
+    return q ;
+    }
+
+  const uint8_t* Start = nullptr ;
+  const uint8_t* p = nullptr ;
+  const uint8_t* End = nullptr ;
+  } ;